@@ -0,0 +1,449 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardGenerator.h"
+#include "BoardLayoutAsset.h"
+#include "HexGrid.h"
+
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("BoardGenerator GenerateBoards"), STAT_BoardGeneratorGenerateBoards, STATGROUP_Conquest);
+
+namespace BoardGenerator
+{
+	/** Amount of candidates each worker generates at a time */
+	const int32 BatchSize = 256;
+
+	/** If board a is better than board b */
+	FORCEINLINE bool IsBetterBoard(const FBoardCandidate& A, const FBoardCandidate& B)
+	{
+		// Seed keeps results stable regardless of which thread found them
+		return A.Score < B.Score || (A.Score == B.Score && A.Seed < B.Seed);
+	}
+}
+
+FBoardGeneratorSettings::FBoardGeneratorSettings()
+{
+	Dimensions = FIntPoint(9, 15);
+	HexSize = 200.f;
+	ElementWeights[0] = 1.f;
+	ElementWeights[1] = 1.f;
+	ElementWeights[2] = 1.f;
+	ElementWeights[3] = 1.f;
+	ElementClumping = 0.5f;
+	NullTileChance = 0.05f;
+	NumObstacles = 3;
+	ObstacleSize = 4;
+	Symmetry = EHexGridSymmetry::MirrorColumns;
+	PortalCells[0] = INDEX_NONE;
+	PortalCells[1] = INDEX_NONE;
+	MinPortalPathLength = 8;
+	MaxPortalPathDetour = 4;
+	MaxTerritoryImbalance = 0.1f;
+	bRequireFullyConnected = true;
+}
+
+FBoardGenerator::FBoardGenerator(const FBoardGeneratorSettings& InSettings)
+	: Settings(InSettings)
+{
+	Settings.Dimensions.X = FMath::Max(1, Settings.Dimensions.X);
+	Settings.Dimensions.Y = FMath::Max(2, Settings.Dimensions.Y);
+
+	const FIntPoint& Dimensions = Settings.Dimensions;
+	const int32 NumCells = Dimensions.X * Dimensions.Y;
+
+	if (!FHexGrid::SupportsSymmetry(Settings.Symmetry, Dimensions))
+	{
+		UE_LOG(LogConquest, Warning, TEXT("FBoardGenerator: Symmetry %i is not supported by a %ix%i board. No symmetry will be applied"),
+			static_cast<int32>(Settings.Symmetry), Dimensions.X, Dimensions.Y);
+
+		Settings.Symmetry = EHexGridSymmetry::None;
+	}
+
+	// Default to the middle of the first column and the cell mirroring it
+	if (Settings.PortalCells[0] < 0 || Settings.PortalCells[0] >= NumCells)
+	{
+		Settings.PortalCells[0] = Dimensions.X / 2;
+	}
+
+	if (Settings.PortalCells[1] < 0 || Settings.PortalCells[1] >= NumCells || Settings.PortalCells[1] == Settings.PortalCells[0])
+	{
+		// Without symmetry, use the same row of the last column
+		const EHexGridSymmetry PortalSymmetry = Settings.Symmetry != EHexGridSymmetry::None ? Settings.Symmetry :
+			((Dimensions.Y % 2) == 1 ? EHexGridSymmetry::MirrorColumns : EHexGridSymmetry::Rotate);
+
+		Settings.PortalCells[1] = FHexGrid::GetMirroredCellIndex(Settings.PortalCells[0], PortalSymmetry, Dimensions);
+	}
+
+	TotalElementWeight = 0.f;
+	for (float& Weight : Settings.ElementWeights)
+	{
+		Weight = FMath::Max(0.f, Weight);
+		TotalElementWeight += Weight;
+	}
+
+	// Neighbours are looked up constantly while generating and validating, so cache them once
+	Neighbours.SetNumUninitialized(NumCells * 6);
+	for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+	{
+		const FIntVector Hex = FHexGrid::CellIndexToHex(CellIndex, Dimensions);
+		for (int32 Direction = 0; Direction < 6; ++Direction)
+		{
+			Neighbours[CellIndex * 6 + Direction] = FHexGrid::HexToCellIndex(Hex + FHexGrid::HexDirection(Direction), Dimensions);
+		}
+	}
+}
+
+void FBoardGenerator::GenerateCandidate(int32 Seed, FBoardCandidate& OutCandidate) const
+{
+	const FIntPoint& Dimensions = Settings.Dimensions;
+	const int32 NumCells = Dimensions.X * Dimensions.Y;
+
+	FRandomStream Stream(Seed);
+
+	// Candidates are reused by workers, so avoid freeing their cells
+	OutCandidate.Seed = Seed;
+	OutCandidate.PortalPathLength = 0;
+	OutCandidate.TerritoryImbalance = 0.f;
+	OutCandidate.Score = 0.f;
+	OutCandidate.PortalCells[0] = Settings.PortalCells[0];
+	OutCandidate.PortalCells[1] = Settings.PortalCells[1];
+
+	TArray<uint8>& Cells = OutCandidate.Cells;
+	Cells.SetNumUninitialized(NumCells);
+
+	// Elements
+	for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+	{
+		Cells[CellIndex] = PickElement(Stream);
+	}
+
+	// Grow regions by copying elements from neighbours
+	if (Settings.ElementClumping > 0.f)
+	{
+		for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+		{
+			if (Stream.FRand() < Settings.ElementClumping)
+			{
+				const int32 Neighbour = GetRandomNeighbour(CellIndex, Stream);
+				if (Neighbour != INDEX_NONE)
+				{
+					Cells[CellIndex] = Cells[Neighbour];
+				}
+			}
+		}
+	}
+
+	// Scattered null tiles
+	if (Settings.NullTileChance > 0.f)
+	{
+		for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+		{
+			if (Stream.FRand() < Settings.NullTileChance)
+			{
+				Cells[CellIndex] |= UBoardLayoutAsset::CellNullBit;
+			}
+		}
+	}
+
+	// Obstacles are random walks of null tiles
+	for (int32 Obstacle = 0; Obstacle < Settings.NumObstacles; ++Obstacle)
+	{
+		int32 CellIndex = Stream.RandHelper(NumCells);
+		for (int32 Step = 0; Step < Settings.ObstacleSize && CellIndex != INDEX_NONE; ++Step)
+		{
+			Cells[CellIndex] |= UBoardLayoutAsset::CellNullBit;
+			CellIndex = GetRandomNeighbour(CellIndex, Stream);
+		}
+	}
+
+	// Mirrored cells copy whichever of the pair comes first
+	if (Settings.Symmetry != EHexGridSymmetry::None)
+	{
+		for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+		{
+			const int32 MirroredIndex = FHexGrid::GetMirroredCellIndex(CellIndex, Settings.Symmetry, Dimensions);
+			if (MirroredIndex < CellIndex)
+			{
+				Cells[CellIndex] = Cells[MirroredIndex];
+			}
+		}
+	}
+
+	// Portals can't be null tiles
+	for (int32 PortalCell : OutCandidate.PortalCells)
+	{
+		Cells[PortalCell] &= static_cast<uint8>(~UBoardLayoutAsset::CellNullBit);
+	}
+}
+
+bool FBoardGenerator::ValidateCandidate(FBoardCandidate& Candidate, FBoardGeneratorScratch& Scratch) const
+{
+	const TArray<uint8>& Cells = Candidate.Cells;
+	const int32 NumCells = Cells.Num();
+
+	if (NumCells != Settings.Dimensions.X * Settings.Dimensions.Y)
+	{
+		return false;
+	}
+
+	for (int32 Player = 0; Player < CSK_MAX_NUM_PLAYERS; ++Player)
+	{
+		FindCellDistances(Cells, Candidate.PortalCells[Player], Scratch.Distances[Player], Scratch.Queue);
+	}
+
+	const TArray<int32>& Player1Distances = Scratch.Distances[0];
+	const TArray<int32>& Player2Distances = Scratch.Distances[1];
+
+	// Portals need to be connected
+	const int32 PathLength = Player1Distances[Candidate.PortalCells[1]];
+	if (PathLength == INDEX_NONE || PathLength < Settings.MinPortalPathLength)
+	{
+		return false;
+	}
+
+	const FIntVector Portal1Hex = FHexGrid::CellIndexToHex(Candidate.PortalCells[0], Settings.Dimensions);
+	const FIntVector Portal2Hex = FHexGrid::CellIndexToHex(Candidate.PortalCells[1], Settings.Dimensions);
+
+	const int32 Detour = PathLength - FHexGrid::HexDisplacement(Portal1Hex, Portal2Hex);
+	if (Settings.MaxPortalPathDetour >= 0 && Detour > Settings.MaxPortalPathDetour)
+	{
+		return false;
+	}
+
+	// Compare how many cells (and of which element) each player can reach first
+	int32 NumWalkable = 0;
+	int32 Territory[CSK_MAX_NUM_PLAYERS] = { 0, 0 };
+	int32 ElementTerritory[CSK_MAX_NUM_PLAYERS][4] = { { 0, 0, 0, 0 }, { 0, 0, 0, 0 } };
+
+	for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+	{
+		const uint8 Cell = Cells[CellIndex];
+		if ((Cell & UBoardLayoutAsset::CellNullBit) != 0)
+		{
+			continue;
+		}
+
+		++NumWalkable;
+
+		const int32 Player1Distance = Player1Distances[CellIndex];
+		const int32 Player2Distance = Player2Distances[CellIndex];
+
+		// Both players can reach the same cells as the portals are connected
+		if (Player1Distance == INDEX_NONE)
+		{
+			if (Settings.bRequireFullyConnected)
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		if (Player1Distance == Player2Distance)
+		{
+			continue;
+		}
+
+		const int32 Player = Player1Distance < Player2Distance ? 0 : 1;
+		++Territory[Player];
+
+		for (int32 Bit = 0; Bit < 4; ++Bit)
+		{
+			if ((Cell & (1 << Bit)) != 0)
+			{
+				++ElementTerritory[Player][Bit];
+			}
+		}
+	}
+
+	const float Divisor = static_cast<float>(FMath::Max(1, NumWalkable));
+
+	const float TerritoryImbalance = FMath::Abs(Territory[0] - Territory[1]) / Divisor;
+	if (TerritoryImbalance > Settings.MaxTerritoryImbalance)
+	{
+		return false;
+	}
+
+	int32 ElementDifference = 0;
+	for (int32 Bit = 0; Bit < 4; ++Bit)
+	{
+		ElementDifference += FMath::Abs(ElementTerritory[0][Bit] - ElementTerritory[1][Bit]);
+	}
+
+	Candidate.PortalPathLength = PathLength;
+	Candidate.TerritoryImbalance = TerritoryImbalance;
+	Candidate.Score = TerritoryImbalance + ElementDifference / Divisor + static_cast<float>(Detour) / PathLength;
+
+	return true;
+}
+
+int32 FBoardGenerator::GenerateBoards(int32 NumCandidates, int32 BaseSeed, int32 NumToKeep, TArray<FBoardCandidate>& OutBoards) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_BoardGeneratorGenerateBoards);
+
+	OutBoards.Reset();
+	if (NumCandidates <= 0)
+	{
+		return 0;
+	}
+
+	NumToKeep = FMath::Max(1, NumToKeep);
+
+	// Each batch keeps its own best boards, so workers never need to share anything
+	const int32 NumBatches = FMath::DivideAndRoundUp(NumCandidates, BoardGenerator::BatchSize);
+
+	TArray<TArray<FBoardCandidate>> BatchBoards;
+	BatchBoards.SetNum(NumBatches);
+
+	TArray<int32> BatchNumValid;
+	BatchNumValid.SetNumZeroed(NumBatches);
+
+	ParallelFor(NumBatches, [&](int32 BatchIndex)->void
+	{
+		FBoardGeneratorScratch Scratch;
+		FBoardCandidate Candidate;
+		TArray<FBoardCandidate>& BestBoards = BatchBoards[BatchIndex];
+
+		const int32 First = BatchIndex * BoardGenerator::BatchSize;
+		const int32 Last = FMath::Min(First + BoardGenerator::BatchSize, NumCandidates);
+
+		for (int32 Index = First; Index < Last; ++Index)
+		{
+			GenerateCandidate(BaseSeed + Index, Candidate);
+			if (!ValidateCandidate(Candidate, Scratch))
+			{
+				continue;
+			}
+
+			++BatchNumValid[BatchIndex];
+
+			if (BestBoards.Num() == NumToKeep && !BoardGenerator::IsBetterBoard(Candidate, BestBoards.Last()))
+			{
+				continue;
+			}
+
+			// Keep boards sorted so the worst is always last
+			int32 InsertIndex = BestBoards.Num();
+			while (InsertIndex > 0 && BoardGenerator::IsBetterBoard(Candidate, BestBoards[InsertIndex - 1]))
+			{
+				--InsertIndex;
+			}
+
+			BestBoards.Insert(Candidate, InsertIndex);
+			if (BestBoards.Num() > NumToKeep)
+			{
+				BestBoards.Pop(false);
+			}
+		}
+	});
+
+	int32 NumValid = 0;
+	for (int32 BatchIndex = 0; BatchIndex < NumBatches; ++BatchIndex)
+	{
+		NumValid += BatchNumValid[BatchIndex];
+		OutBoards.Append(MoveTemp(BatchBoards[BatchIndex]));
+	}
+
+	OutBoards.Sort(&BoardGenerator::IsBetterBoard);
+	if (OutBoards.Num() > NumToKeep)
+	{
+		OutBoards.SetNum(NumToKeep);
+	}
+
+	return NumValid;
+}
+
+void FBoardGenerator::WriteToLayout(const FBoardCandidate& Candidate, UBoardLayoutAsset* Layout) const
+{
+	check(Layout);
+
+	Layout->InitLayout(Settings.Dimensions, Settings.HexSize);
+	check(Layout->GetNumCells() == Candidate.Cells.Num());
+
+	for (int32 CellIndex = 0; CellIndex < Candidate.Cells.Num(); ++CellIndex)
+	{
+		const uint8 Cell = Candidate.Cells[CellIndex];
+		Layout->SetCell(CellIndex,
+			static_cast<ECSKElementType>(Cell & UBoardLayoutAsset::CellElementMask),
+			(Cell & UBoardLayoutAsset::CellNullBit) != 0);
+	}
+
+	Layout->Player1PortalHex = FHexGrid::CellIndexToHex(Candidate.PortalCells[0], Settings.Dimensions);
+	Layout->Player2PortalHex = FHexGrid::CellIndexToHex(Candidate.PortalCells[1], Settings.Dimensions);
+}
+
+void FBoardGenerator::FindCellDistances(const TArray<uint8>& Cells, int32 Origin, TArray<int32>& OutDistances, TArray<int32>& Queue) const
+{
+	OutDistances.Init(INDEX_NONE, Cells.Num());
+	Queue.Reset(Cells.Num());
+
+	if (!Cells.IsValidIndex(Origin) || (Cells[Origin] & UBoardLayoutAsset::CellNullBit) != 0)
+	{
+		return;
+	}
+
+	OutDistances[Origin] = 0;
+	Queue.Add(Origin);
+
+	// Every step costs the same, so a breadth first search gives the shortest distances
+	for (int32 Head = 0; Head < Queue.Num(); ++Head)
+	{
+		const int32 CellIndex = Queue[Head];
+		const int32 NextDistance = OutDistances[CellIndex] + 1;
+
+		for (int32 Direction = 0; Direction < 6; ++Direction)
+		{
+			const int32 Neighbour = Neighbours[CellIndex * 6 + Direction];
+			if (Neighbour != INDEX_NONE && OutDistances[Neighbour] == INDEX_NONE && (Cells[Neighbour] & UBoardLayoutAsset::CellNullBit) == 0)
+			{
+				OutDistances[Neighbour] = NextDistance;
+				Queue.Add(Neighbour);
+			}
+		}
+	}
+}
+
+uint8 FBoardGenerator::PickElement(FRandomStream& Stream) const
+{
+	if (TotalElementWeight <= 0.f)
+	{
+		return static_cast<uint8>(ECSKElementType::Fire);
+	}
+
+	float Pick = Stream.FRand() * TotalElementWeight;
+	for (int32 Bit = 0; Bit < 4; ++Bit)
+	{
+		Pick -= Settings.ElementWeights[Bit];
+		if (Pick < 0.f)
+		{
+			return static_cast<uint8>(1 << Bit);
+		}
+	}
+
+	// Precision may leave us slightly over the total
+	for (int32 Bit = 3; Bit >= 0; --Bit)
+	{
+		if (Settings.ElementWeights[Bit] > 0.f)
+		{
+			return static_cast<uint8>(1 << Bit);
+		}
+	}
+
+	return static_cast<uint8>(ECSKElementType::Fire);
+}
+
+int32 FBoardGenerator::GetRandomNeighbour(int32 CellIndex, FRandomStream& Stream) const
+{
+	// Start at a random direction and take the first neighbour that exists
+	const int32 StartDirection = Stream.RandHelper(6);
+	for (int32 Offset = 0; Offset < 6; ++Offset)
+	{
+		const int32 Neighbour = Neighbours[CellIndex * 6 + (StartDirection + Offset) % 6];
+		if (Neighbour != INDEX_NONE)
+		{
+			return Neighbour;
+		}
+	}
+
+	return INDEX_NONE;
+}
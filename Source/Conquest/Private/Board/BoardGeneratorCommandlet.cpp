@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardGeneratorCommandlet.h"
+#include "BoardGenerator.h"
+#include "BoardLayoutAsset.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+
+UBoardGeneratorCommandlet::UBoardGeneratorCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+namespace BoardGeneratorCommandlet
+{
+	EHexGridSymmetry ParseSymmetry(const FString& Params, EHexGridSymmetry DefaultSymmetry)
+	{
+		FString SymmetryName;
+		if (FParse::Value(*Params, TEXT("Symmetry="), SymmetryName))
+		{
+			if (SymmetryName.Equals(TEXT("None"), ESearchCase::IgnoreCase))
+			{
+				return EHexGridSymmetry::None;
+			}
+			else if (SymmetryName.Equals(TEXT("MirrorColumns"), ESearchCase::IgnoreCase))
+			{
+				return EHexGridSymmetry::MirrorColumns;
+			}
+			else if (SymmetryName.Equals(TEXT("MirrorRows"), ESearchCase::IgnoreCase))
+			{
+				return EHexGridSymmetry::MirrorRows;
+			}
+			else if (SymmetryName.Equals(TEXT("Rotate"), ESearchCase::IgnoreCase))
+			{
+				return EHexGridSymmetry::Rotate;
+			}
+
+			UE_LOG(LogConquest, Warning, TEXT("BoardGenerator: Unknown symmetry %s"), *SymmetryName);
+		}
+
+		return DefaultSymmetry;
+	}
+
+	bool SaveLayout(const FBoardGenerator& Generator, const FBoardCandidate& Board, const FString& PackageName)
+	{
+		#if WITH_EDITOR
+		UPackage* Package = CreatePackage(nullptr, *PackageName);
+		if (!Package)
+		{
+			return false;
+		}
+
+		UBoardLayoutAsset* Layout = NewObject<UBoardLayoutAsset>(Package, *FPackageName::GetShortName(PackageName), RF_Public | RF_Standalone);
+		Generator.WriteToLayout(Board, Layout);
+		Package->MarkPackageDirty();
+
+		const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+		return UPackage::SavePackage(Package, Layout, RF_Public | RF_Standalone, *Filename);
+		#else
+		return false;
+		#endif
+	}
+}
+
+int32 UBoardGeneratorCommandlet::Main(const FString& Params)
+{
+	FBoardGeneratorSettings Settings;
+	int32 NumCandidates = 10000;
+	int32 NumToKeep = 10;
+	int32 Seed = 0;
+
+	FParse::Value(*Params, TEXT("Rows="), Settings.Dimensions.X);
+	FParse::Value(*Params, TEXT("Columns="), Settings.Dimensions.Y);
+	FParse::Value(*Params, TEXT("HexSize="), Settings.HexSize);
+	FParse::Value(*Params, TEXT("Fire="), Settings.ElementWeights[0]);
+	FParse::Value(*Params, TEXT("Water="), Settings.ElementWeights[1]);
+	FParse::Value(*Params, TEXT("Earth="), Settings.ElementWeights[2]);
+	FParse::Value(*Params, TEXT("Air="), Settings.ElementWeights[3]);
+	FParse::Value(*Params, TEXT("Clumping="), Settings.ElementClumping);
+	FParse::Value(*Params, TEXT("NullChance="), Settings.NullTileChance);
+	FParse::Value(*Params, TEXT("Obstacles="), Settings.NumObstacles);
+	FParse::Value(*Params, TEXT("ObstacleSize="), Settings.ObstacleSize);
+	FParse::Value(*Params, TEXT("MinPathLength="), Settings.MinPortalPathLength);
+	FParse::Value(*Params, TEXT("MaxDetour="), Settings.MaxPortalPathDetour);
+	FParse::Value(*Params, TEXT("MaxImbalance="), Settings.MaxTerritoryImbalance);
+	Settings.Symmetry = BoardGeneratorCommandlet::ParseSymmetry(Params, Settings.Symmetry);
+	Settings.bRequireFullyConnected = !FParse::Param(*Params, TEXT("AllowIsolated"));
+
+	FParse::Value(*Params, TEXT("Candidates="), NumCandidates);
+	FParse::Value(*Params, TEXT("Keep="), NumToKeep);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+
+	FString OutputPath = TEXT("/Game/Boards/Generated");
+	FString BaseName = TEXT("GeneratedBoard");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FParse::Value(*Params, TEXT("Name="), BaseName);
+
+	// Offset columns mean some boards can't be mirrored
+	if (!FHexGrid::SupportsSymmetry(Settings.Symmetry, Settings.Dimensions))
+	{
+		UE_LOG(LogConquest, Error, TEXT("BoardGenerator: Symmetry is not supported by a %ix%i board. MirrorColumns requires an odd amount of columns, Rotate an even amount and MirrorRows is never supported"),
+			Settings.Dimensions.X, Settings.Dimensions.Y);
+
+		return 1;
+	}
+
+	FBoardGenerator Generator(Settings);
+	const FIntPoint& Dimensions = Generator.GetSettings().Dimensions;
+
+	UE_LOG(LogConquest, Display, TEXT("BoardGenerator: Generating %i candidates for a %ix%i board (keeping the best %i)"),
+		NumCandidates, Dimensions.X, Dimensions.Y, NumToKeep);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<FBoardCandidate> Boards;
+	const int32 NumValid = Generator.GenerateBoards(NumCandidates, Seed, NumToKeep, Boards);
+
+	const double ElapsedTime = FMath::Max(FPlatformTime::Seconds() - StartTime, SMALL_NUMBER);
+
+	UE_LOG(LogConquest, Display, TEXT("BoardGenerator: %i of %i candidates were valid (%.1f%%)"),
+		NumValid, NumCandidates, 100.f * NumValid / FMath::Max(1, NumCandidates));
+	UE_LOG(LogConquest, Display, TEXT("BoardGenerator: Finished in %.3fs (%.0f candidates per second)"),
+		ElapsedTime, NumCandidates / ElapsedTime);
+
+	if (Boards.Num() == 0)
+	{
+		UE_LOG(LogConquest, Error, TEXT("BoardGenerator: No valid boards were generated, try relaxing the constraints"));
+		return 1;
+	}
+
+	const bool bDryRun = FParse::Param(*Params, TEXT("DryRun"));
+
+	int32 NumFailed = 0;
+	for (const FBoardCandidate& Board : Boards)
+	{
+		const FString PackageName = OutputPath / FString::Printf(TEXT("%s_%i"), *BaseName, Board.Seed);
+
+		UE_LOG(LogConquest, Display, TEXT("BoardGenerator: %s - Score: %.3f, Portal Path Length: %i, Territory Imbalance: %.1f%%"),
+			*PackageName, Board.Score, Board.PortalPathLength, 100.f * Board.TerritoryImbalance);
+
+		if (!bDryRun && !BoardGeneratorCommandlet::SaveLayout(Generator, Board, PackageName))
+		{
+			UE_LOG(LogConquest, Error, TEXT("BoardGenerator: Failed to save layout %s"), *PackageName);
+			++NumFailed;
+		}
+	}
+
+	return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardLayoutAsset.h"
+
+UBoardLayoutAsset::UBoardLayoutAsset()
+{
+	Dimensions = FIntPoint::ZeroValue;
+	HexSize = 200.f;
+	Player1PortalHex = FIntVector(-1);
+	Player2PortalHex = FIntVector(-1);
+}
+
+void UBoardLayoutAsset::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	// Cells are a single byte each, so can be copied straight from the archive
+	Cells.BulkSerialize(Ar);
+}
+
+void UBoardLayoutAsset::InitLayout(const FIntPoint& InDimensions, float InHexSize)
+{
+	Dimensions = FIntPoint(FMath::Max(0, InDimensions.X), FMath::Max(0, InDimensions.Y));
+	HexSize = InHexSize;
+	Player1PortalHex = FIntVector(-1);
+	Player2PortalHex = FIntVector(-1);
+
+	Cells.Init(static_cast<uint8>(ECSKElementType::Fire), Dimensions.X * Dimensions.Y);
+}
+
+bool UBoardLayoutAsset::IsValidLayout() const
+{
+	return Dimensions.X > 0 && Dimensions.Y > 0 && Dimensions.X * Dimensions.Y <= FBoardTileHandle::MaxBoardTiles
+		&& HexSize > 0.f && Cells.Num() == Dimensions.X * Dimensions.Y;
+}
+
+void UBoardLayoutAsset::SetCell(int32 Index, ECSKElementType Element, bool bIsNull)
+{
+	check(Cells.IsValidIndex(Index));
+	Cells[Index] = (static_cast<uint8>(Element) & CellElementMask) | (bIsNull ? CellNullBit : 0);
+}
@@ -1,9 +1,13 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "BoardManager.h"
+#include "BoardLayoutAsset.h"
 #include "UObject/ConstructorHelpers.h"
 
+#include "Async/Async.h"
+#include "Async/TaskGraphInterfaces.h"
 #include "Components/BillboardComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/World.h"
 #include "Materials/MaterialInstanceConstant.h"
@@ -18,14 +22,84 @@
 
 #define LOCTEXT_NAMESPACE "BoardManager"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("BoardManager Path Cache Hits"), STAT_BoardManagerPathCacheHits, STATGROUP_Conquest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("BoardManager Path Cache Misses"), STAT_BoardManagerPathCacheMisses, STATGROUP_Conquest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("BoardManager Range Cache Hits"), STAT_BoardManagerRangeCacheHits, STATGROUP_Conquest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("BoardManager Range Cache Misses"), STAT_BoardManagerRangeCacheMisses, STATGROUP_Conquest);
+DECLARE_CYCLE_STAT(TEXT("BoardManager BuildBoardFromLayout"), STAT_BoardManagerBuildBoardFromLayout, STATGROUP_Conquest);
+DECLARE_CYCLE_STAT(TEXT("BoardManager QueryTilesWithinDistance"), STAT_BoardManagerQueryTilesWithinDistance, STATGROUP_Conquest);
+DECLARE_CYCLE_STAT(TEXT("BoardManager FlushTileHighlights"), STAT_BoardManagerFlushTileHighlights, STATGROUP_Conquest);
+DECLARE_CYCLE_STAT(TEXT("BoardManager ApplyTileEdit"), STAT_BoardManagerApplyTileEdit, STATGROUP_Conquest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("BoardManager Highlights Applied"), STAT_BoardManagerHighlightsApplied, STATGROUP_Conquest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("BoardManager Highlights Skipped"), STAT_BoardManagerHighlightsSkipped, STATGROUP_Conquest);
+DECLARE_CYCLE_STAT(TEXT("BoardManager FlushTileInstances"), STAT_BoardManagerFlushTileInstances, STATGROUP_Conquest);
+
+void FBoardTileStateItem::PreReplicatedRemove(const FBoardTileStateArray& InArraySerializer)
+{
+	if (InArraySerializer.BoardManager)
+	{
+		InArraySerializer.BoardManager->OnTileStateRemoved(*this);
+	}
+}
+
+void FBoardTileStateItem::PostReplicatedAdd(const FBoardTileStateArray& InArraySerializer)
+{
+	if (InArraySerializer.BoardManager)
+	{
+		InArraySerializer.BoardManager->OnTileStateReplicated(*this);
+	}
+}
+
+void FBoardTileStateItem::PostReplicatedChange(const FBoardTileStateArray& InArraySerializer)
+{
+	// This will also be called once the occupant has resolved if it was yet to replicate when added
+	if (InArraySerializer.BoardManager)
+	{
+		InArraySerializer.BoardManager->OnTileStateReplicated(*this);
+	}
+}
+
+void FBoardTileStateArray::AddTileState(int32 TileIndex, AActor* Occupant, int8 OwnerID)
+{
+	int32 Index = Items.Add(FBoardTileStateItem(TileIndex, Occupant, OwnerID));
+	MarkItemDirty(Items[Index]);
+}
+
+const FBoardTileStateItem* FBoardTileStateArray::FindTileState(int32 TileIndex) const
+{
+	return Items.FindByPredicate([TileIndex](const FBoardTileStateItem& Item)->bool
+	{
+		return Item.TileIndex == TileIndex;
+	});
+}
+
+bool FBoardTileStateArray::RemoveTileState(int32 TileIndex)
+{
+	int32 Index = Items.IndexOfByPredicate([TileIndex](const FBoardTileStateItem& Item)->bool
+	{
+		return Item.TileIndex == TileIndex;
+	});
+
+	if (Index != INDEX_NONE)
+	{
+		Items.RemoveAtSwap(Index);
+		MarkArrayDirty();
+
+		return true;
+	}
+
+	return false;
+}
+
 ABoardManager::ABoardManager()
 {
-	// We only need to tick in editor
-	#if WITH_EDITORONLY_DATA
+	// We only tick while highlights are pending (or when drawing the debug board in editor). We
+	// tick late in the frame so all highlight changes made this frame are applied together
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+	#if WITH_EDITORONLY_DATA
 	PrimaryActorTick.bStartWithTickEnabled = true;
 	#else
-	PrimaryActorTick.bCanEverTick = false;
 	PrimaryActorTick.bStartWithTickEnabled = false;
 	#endif
 
@@ -60,9 +134,25 @@ ABoardManager::ABoardManager()
 
 	GridDimensions = FIntPoint(0, 0);
 	GridHexSize = 0.f;
+	GridStorageLayout = EHexGridStorageLayout::Dense;
 	Player1PortalHex = FIntVector(-1);
 	Player2PortalHex = FIntVector(-1);
 
+	BoardLayout = nullptr;
+	LayoutTileTemplate = ATile::StaticClass();
+
+	bEnableQueryCache = true;
+	QueryCacheSize = 64;
+	OccupancyVersion = 0;
+	CachedQueryVersion = MAX_uint32;
+
+	bUseInstancedTileRendering = false;
+	bInstancedTileRenderingActive = false;
+
+	NextAsyncQueryID = 1;
+
+	BoardState.BoardManager = this;
+
 	#if WITH_EDITORONLY_DATA
 	GridTileTemplate = nullptr;
 	bDrawDebugBoard = true;
@@ -73,17 +163,52 @@ void ABoardManager::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Levels using a layout don't have their tiles saved
+	if (!HexGrid.bGridGenerated && BoardLayout)
+	{
+		BuildBoardFromLayout();
+	}
+
+	// Cell states are not saved with the grid
+	HexGrid.SetStorageLayout(GridStorageLayout);
+	HexGrid.RefreshAllCellStates();
+	RebuildTileMasks();
+
+	// Board state may have replicated before our tiles existed
+	ApplyUnresolvedTileStates();
+
+	// Dedicated servers never render the board
+	if (bUseInstancedTileRendering && GetNetMode() != NM_DedicatedServer)
+	{
+		EnableInstancedTileRendering();
+	}
+
 	#if WITH_EDITORONLY_DATA
-	SetActorTickEnabled(bDrawDebugBoard);
+	SetActorTickEnabled(bDrawDebugBoard || PendingHighlightTiles.Num() > 0);
 	#else
-	SetActorTickEnabled(false);
+	SetActorTickEnabled(PendingHighlightTiles.Num() > 0);
 	#endif
 }
 
+void ABoardManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// Let any running searches know they can stop
+	for (TPair<uint32, FPendingPathQuery>& Pair : PendingPathQueries)
+	{
+		*Pair.Value.bCancelled = true;
+	}
+
+	PendingPathQueries.Empty();
+}
+
 void ABoardManager::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	FlushTileHighlights();
+
 	#if WITH_EDITORONLY_DATA
 	if (bDrawDebugBoard && HexGrid.bGridGenerated)
 	{
@@ -103,8 +228,7 @@ void ABoardManager::Tick(float DeltaTime)
 			}
 		};
 
-		TArray<ATile*> Tiles = HexGrid.GetAllTiles();
-		for (ATile* Tile : Tiles)
+		HexGrid.ForEachTile([&DrawHexagon](ATile* Tile)->void
 		{
 			if (Tile)
 			{
@@ -121,9 +245,33 @@ void ABoardManager::Tick(float DeltaTime)
 					DrawHexagon(Tile, FColor::Emerald, 2, 5.f);
 				}
 			}
-		}
+		});
 	}
 	#endif
+
+	// Tick will be re-enabled once another highlight is queued
+	#if WITH_EDITORONLY_DATA
+	if (!bDrawDebugBoard)
+	#endif
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+void ABoardManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ABoardManager, BoardState);
+}
+
+void ABoardManager::PostLoad()
+{
+	Super::PostLoad();
+
+	// Tiles have been loaded by now, so their state is valid
+	HexGrid.RefreshAllCellStates();
+	RebuildTileMasks();
 }
 
 #if WITH_EDITOR
@@ -131,6 +279,21 @@ void ABoardManager::CheckForErrors()
 {
 	Super::CheckForErrors();
 
+	// Tiles will be spawned from the layout when play begins
+	if (!HexGrid.bGridGenerated && BoardLayout)
+	{
+		if (!BoardLayout->IsValidLayout())
+		{
+			FFormatNamedArguments Arguments;
+			Arguments.Add(TEXT("ActorName"), FText::FromString(GetPathName()));
+			FMessageLog("MapCheck").Warning()
+				->AddToken(FUObjectToken::Create(this))
+				->AddToken(FTextToken::Create(FText::Format(LOCTEXT("MapCheck_Message_InvalidLayout", "{ActorName} : Board Manager has no tiles and its board layout is invalid."), Arguments)));
+		}
+
+		return;
+	}
+
 	if (!HexGrid.bGridGenerated)
 	{
 		FFormatNamedArguments Arguments;
@@ -177,9 +340,13 @@ void ABoardManager::PostEditChangeProperty(FPropertyChangedEvent& PropertyChange
 	{	
 		if (World->IsPlayInEditor())
 		{
-			SetActorTickEnabled(bDrawDebugBoard);
+			SetActorTickEnabled(bDrawDebugBoard || PendingHighlightTiles.Num() > 0);
 		}
 	}
+	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ABoardManager, GridStorageLayout))
+	{
+		HexGrid.SetStorageLayout(GridStorageLayout);
+	}
 	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ABoardManager, ElementHighlightMaterials))
 	{
 		// Update all non null tiles to match 
@@ -190,12 +357,11 @@ void ABoardManager::PostEditChangeProperty(FPropertyChangedEvent& PropertyChange
 				return;
 			}
 
-			TArray<ATile*> AllTiles = HexGrid.GetAllTiles();
-			for (ATile* Tile : AllTiles)
+			HexGrid.ForEachTile([this](ATile* Tile)->void
 			{
 				if (!Tile)
 				{
-					continue;
+					return;
 				}
 
 				UStaticMeshComponent* HighlightMesh = Tile->GetMesh();
@@ -205,12 +371,12 @@ void ABoardManager::PostEditChangeProperty(FPropertyChangedEvent& PropertyChange
 					UMaterialInstanceConstant* HighlightMat = ElementHighlightMaterials[Tile->TileType];
 					if (!HighlightMat)
 					{
-						continue;
+						return;
 					}
 					
 					HighlightMesh->SetMaterial(0, ElementHighlightMaterials[Tile->TileType]);
 				}
-			}
+			});
 		}
 	}
 	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ABoardManager, NullHighlightMaterial))
@@ -241,8 +407,48 @@ void ABoardManager::PostEditChangeProperty(FPropertyChangedEvent& PropertyChange
 		}
 	}
 }
+
+void ABoardManager::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	// Tiles restored by the transaction won't have notified us of their change
+	HexGrid.RefreshAllCellStates();
+	RebuildTileMasks();
+	++OccupancyVersion;
+
+	RefreshAllTilesHighlightMaterials();
+}
+
 #endif
 
+void ABoardManager::NotifyTileStateChanged(const ATile* Tile)
+{
+	if (Tile)
+	{
+		const FIntVector& TileHex = Tile->GetGridHexValue();
+		const int32 TileIndex = FHexGrid::HexToCellIndex(TileHex, HexGrid.GetGridDimensions());
+
+		HexGrid.RefreshCellState(TileHex);
+
+		// Clients can receive the state of a tile before the owner of its board piece
+		// has replicated, so we use the owner sent with the tiles state until then
+		if (!HasAuthority() && Tile->IsTileOccupied(false) && Tile->GetBoardPiecesOwnerPlayerID() == -1)
+		{
+			const FBoardTileStateItem* TileState = BoardState.FindTileState(TileIndex);
+			if (TileState)
+			{
+				HexGrid.SetCellOwnerID(TileHex, TileState->OwnerID);
+			}
+		}
+
+		UpdateTileMasks(TileIndex);
+	}
+
+	// Any cached queries may no longer be valid
+	++OccupancyVersion;
+}
+
 void ABoardManager::DestroyBoard()
 {
 	HexGrid.ClearGrid();
@@ -265,6 +471,7 @@ void ABoardManager::InitBoard(const FBoardInitData& InitData)
 	GridDimensions = InitData.Dimensions;
 	GridHexSize = InitData.HexSize;
 	GridTileTemplate = InitData.GetTileTemplate();
+	HexGrid.SetStorageLayout(GridStorageLayout);
 	SetActorLocationAndRotation(InitData.Origin, InitData.Rotation);
 
 	// Variables for the tile predicate to use
@@ -308,19 +515,22 @@ void ABoardManager::InitBoard(const FBoardInitData& InitData)
 
 	// Generate the grid
 	HexGrid.GenerateGrid(GridDimensions.X, GridDimensions.Y, TilePredicate);
+	++OccupancyVersion;
 
 	// We can keep portals that still fit inside the new grid
 	{
-		if (!HexGrid.GridMap.Contains(Player1PortalHex))
+		if (!HexGrid.Contains(Player1PortalHex))
 		{
 			Player1PortalHex = FIntVector(-1);
 		}
 
-		if (!HexGrid.GridMap.Contains(Player2PortalHex))
+		if (!HexGrid.Contains(Player2PortalHex))
 		{
 			Player2PortalHex = FIntVector(-1);
 		}
 	}
+
+	RebuildTileMasks();
 }
 
 void ABoardManager::SetPlayerPortal(int32 Player, const FIntVector& TileHex)
@@ -361,9 +571,13 @@ void ABoardManager::SetPlayerPortal(int32 Player, const FIntVector& TileHex)
 			// Spawn points can't be null tiles
 			TileAtSpawn->Modify();
 			TileAtSpawn->bIsNullTile = false;
+
+			NotifyTileStateChanged(TileAtSpawn);
+			RebuildTileMasks();
 		}
 	}
 }
+
 void ABoardManager::ResetPlayerPortal(int32 Player)
 {
 	if (!ensure(Player >= 0 && Player <= 1))
@@ -380,189 +594,953 @@ void ABoardManager::ResetPlayerPortal(int32 Player)
 	{
 		Player2PortalHex = FIntVector(-1);
 	}
+
+	RebuildTileMasks();
 }
-#endif
 
-ATile* ABoardManager::TraceBoard(const FVector& Origin, const FVector& End) const
+void ABoardManager::SaveBoardLayout(UBoardLayoutAsset* Layout) const
 {
-	ATile* Tile = nullptr;
-	if (HexGrid.bGridGenerated)
+	if (!Layout || !HexGrid.bGridGenerated)
 	{
-		FVector PlaneOrigin = GetActorLocation();
-		FVector PlaneNormal = GetActorUpVector();
-
-		FVector HitPoint = FMath::LinePlaneIntersection(Origin, End, FPlane(PlaneOrigin, PlaneNormal));
-		Tile = HexGrid.GetTile(FHexGrid::ConvertWorldToHex(HitPoint, PlaneOrigin, FVector(GridHexSize)));
+		return;
 	}
 
-	return Tile;
-}
+	Layout->Modify();
+	Layout->InitLayout(GridDimensions, GridHexSize);
+	Layout->Player1PortalHex = Player1PortalHex;
+	Layout->Player2PortalHex = Player2PortalHex;
 
-bool ABoardManager::FindPath(const ATile* Start, const ATile* Goal, FBoardPath& OutPath, bool bAllowPartial, int32 MaxDistance) const
-{
-	bool bSuccess = false;
-	FHexGridPathFindResultData ResultData;
-	if (HexGrid.GeneratePath(Start, Goal, ResultData, bAllowPartial, MaxDistance))
+	const FIntPoint Dimensions = GridDimensions;
+	HexGrid.ForEachTile([Layout, &Dimensions](ATile* Tile)->void
 	{
-		OutPath.Path = ResultData.Path;
-		bSuccess = true;
-	}
+		if (Tile)
+		{
+			int32 Index = FHexGrid::HexToCellIndex(Tile->GetGridHexValue(), Dimensions);
+			if (Index != INDEX_NONE)
+			{
+				Layout->SetCell(Index, Tile->TileType, Tile->bIsNullTile);
+			}
+		}
+	});
 
-	return bSuccess;
+	Layout->MarkPackageDirty();
 }
 
-bool ABoardManager::GetTilesWithinDistance(const ATile* Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreOccupiedTiles) const
+void ABoardManager::LoadBoardLayout(const UBoardLayoutAsset* Layout, TSubclassOf<ATile> TileTemplate)
 {
-	bool bSuccess = false;
-	if (Origin)
+	if (!Layout || !Layout->IsValidLayout())
 	{
-		const FIntVector& TileHex = Origin->GetGridHexValue();
-		bSuccess = HexGrid.GetAllTilesWithinRange(TileHex, Distance, OutTiles, bIgnoreOccupiedTiles);
+		UE_LOG(LogConquest, Warning, TEXT("Unable to load board layout as layout is invalid"));
+		return;
 	}
 
-	return bSuccess;
+	Modify();
+	InitBoard(FBoardInitData(Layout->Dimensions, Layout->HexSize, GetActorLocation(), GetActorRotation(), TileTemplate));
+
+	HexGrid.ForEachTile([this, Layout](ATile* Tile)->void
+	{
+		if (Tile)
+		{
+			int32 Index = FHexGrid::HexToCellIndex(Tile->GetGridHexValue(), GridDimensions);
+			Tile->TileType = Layout->GetCellElement(Index);
+			Tile->bIsNullTile = Layout->IsCellNull(Index);
+		}
+	});
+
+	HexGrid.RefreshAllCellStates();
+
+	ResetPlayerPortal(0);
+	ResetPlayerPortal(1);
+	SetPlayerPortal(0, Layout->Player1PortalHex);
+	SetPlayerPortal(1, Layout->Player2PortalHex);
+
+	RefreshAllTilesHighlightMaterials();
 }
 
-bool ABoardManager::GetOccupiedTilesWithinDistance(const ATile* Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreNullTiles, bool bIgnoreOrigin) const
+void ABoardManager::StripTilesForLayout()
 {
-	bool bSuccess = false;
-	if (Origin)
+	if (!BoardLayout)
 	{
-		const FIntVector& TileHex = Origin->GetGridHexValue();
-		bSuccess = HexGrid.GetAllOccupiedTilesWithinRange(TileHex, Distance, OutTiles, bIgnoreNullTiles, bIgnoreOrigin);
+		UE_LOG(LogConquest, Warning, TEXT("Unable to strip tiles as board manager has no layout to save the board to"));
+		return;
 	}
 
-	return bSuccess;
+	// Layout should always match the board that was stripped
+	SaveBoardLayout(BoardLayout);
+
+	Modify();
+	HexGrid.ClearGrid();
+	RebuildTileMasks();
 }
 
-int32 ABoardManager::IsPlayerPortalTile(const ATile* Tile) const
+int32 ABoardManager::ApplyTileEdit(const FBoardTileMask& Mask, const FBoardTileEdit& Edit)
 {
-	if (Tile)
+	if (!HexGrid.bGridGenerated || Mask.Num() != TileMask.Num())
 	{
-		const FIntVector& TileHex = Tile->GetGridHexValue();
-
-		if (TileHex == Player1PortalHex)
-		{
-			return 0;
-		}
-		else if (TileHex == Player2PortalHex)
-		{
-			return 1;
-		}
+		return 0;
 	}
 
-	return -1;
-}
+	SCOPE_CYCLE_COUNTER(STAT_BoardManagerApplyTileEdit);
 
-ATile* ABoardManager::GetTileAtLocation(const FVector& Location) const
-{
-	const FVector Origin = GetActorLocation();
-	const FVector Size = FVector(GridHexSize);
+	Modify();
 
-	return HexGrid.GetTile(FHexGrid::ConvertWorldToHex(Location, Origin, Size));
-}
+	const FIntPoint& Dimensions = HexGrid.GetGridDimensions();
+	const int32 Portal1Index = FHexGrid::HexToCellIndex(Player1PortalHex, Dimensions);
+	const int32 Portal2Index = FHexGrid::HexToCellIndex(Player2PortalHex, Dimensions);
 
-TArray<ATile*> ABoardManager::GetTilesWithMatchingElement(ECSKElementType Elements) const
-{
-	TArray<ATile*> Tiles;
+	int32 NumChanged = 0;
+	bool bPortalsChanged = false;
 
-	if (HexGrid.bGridGenerated)
+	ForEachTileInMask(Mask, [&](ATile* Tile)->void
 	{
-		TArray<ATile*> AllTiles = HexGrid.GetAllTiles();
-		for (ATile* Tile : AllTiles)
+		const ECSKElementType NewElement = Edit.bSetElement ? Edit.Element : Tile->TileType;
+		const bool bNewIsNull = Edit.bSetNull ? Edit.bIsNull : Tile->bIsNullTile;
+
+		if (NewElement == Tile->TileType && bNewIsNull == Tile->bIsNullTile)
+		{
+			return;
+		}
+
+		Tile->Modify();
+		Tile->TileType = NewElement;
+		Tile->bIsNullTile = bNewIsNull;
+
+		const FIntVector& Hex = Tile->GetGridHexValue();
+		const int32 TileIndex = FHexGrid::HexToCellIndex(Hex, Dimensions);
+
+		// Portals can't be null tiles. We avoid ResetPlayerPortal as it rebuilds every mask
+		if (bNewIsNull && (TileIndex == Portal1Index || TileIndex == Portal2Index))
 		{
-			if (ensure(Tile) && (Tile->TileType & Elements) != ECSKElementType::None)
+			if (TileIndex == Portal1Index)
+			{
+				Player1PortalHex = FIntVector(-1);
+			}
+			else
 			{
-				Tiles.Add(Tile);
+				Player2PortalHex = FIntVector(-1);
 			}
+
+			bPortalsChanged = true;
 		}
-	}
 
-	return Tiles;
-}
+		HexGrid.RefreshCellState(Hex);
+		UpdateTileMasks(TileIndex);
+		PendingHighlightTiles.Add(Tile);
 
-TArray<ATile*> ABoardManager::GetNullTiles() const
-{
-	TArray<ATile*> Tiles;
+		++NumChanged;
+	});
 
-	if (HexGrid.bGridGenerated)
+	if (NumChanged > 0)
 	{
-		TArray<ATile*> AllTiles = HexGrid.GetAllTiles();
-		for (ATile* Tile : AllTiles)
+		if (bPortalsChanged)
 		{
-			if (ensure(Tile) && Tile->bIsNullTile)
-			{
-				Tiles.Add(Tile);
-			}
+			RebuildTileMasks();
 		}
+
+		// Any cached queries may no longer be valid
+		++OccupancyVersion;
 	}
 
-	return Tiles;
+	FlushTileHighlights();
+	return NumChanged;
 }
 
-bool ABoardManager::CanPlaceTowerOnTile(const ATile* Tile) const
+#endif
+
+void ABoardManager::BuildBoardFromLayout()
 {
-	if (Tile && !Tile->IsTileOccupied())
+	SCOPE_CYCLE_COUNTER(STAT_BoardManagerBuildBoardFromLayout);
+
+	check(BoardLayout);
+
+	UWorld* World = GetWorld();
+	if (!World || !BoardLayout->IsValidLayout())
 	{
-		// Towers aren't allowed to be build on portal tiles
-		return IsPlayerPortalTile(Tile) == -1;
+		UE_LOG(LogConquest, Warning, TEXT("BoardManager: Unable to build board from layout %s as it is invalid"), *BoardLayout->GetName());
+		return;
 	}
 
-	return false;
-}
+	GridDimensions = BoardLayout->Dimensions;
+	GridHexSize = BoardLayout->HexSize;
+	Player1PortalHex = BoardLayout->Player1PortalHex;
+	Player2PortalHex = BoardLayout->Player2PortalHex;
+	HexGrid.SetStorageLayout(GridStorageLayout);
 
-bool ABoardManager::PlaceBoardPieceOnTile(AActor* BoardPiece, ATile* Tile)
-{
-	if (HasAuthority())
+	const UBoardLayoutAsset* Layout = BoardLayout;
+	const TSubclassOf<ATile> TileTemplate = LayoutTileTemplate ? LayoutTileTemplate : ATile::StaticClass();
+	const FVector Origin = GetActorLocation();
+	const FVector GridSize(GridHexSize, GridHexSize, 0.f);
+
+	auto TilePredicate = [this, World, Layout, TileTemplate, &Origin, &GridSize](const FHexGrid::FHex& Hex, int32 Row, int32 Column)->ATile*
 	{
-		if (Tile && Tile->SetBoardPiece(BoardPiece))
+		const int32 CellIndex = Column * Layout->Dimensions.X + Row;
+		const FTransform TileTransform(FHexGrid::ConvertHexToWorld(Hex, Origin, GridSize));
+		const FName TileName = GetLayoutTileName(CellIndex);
+
+		// Every machine spawns the same tile with the same name into our level, so the
+		// tiles can be referenced over the network like tiles that were saved with the level
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = this;
+		SpawnParams.Name = TileName;
+		SpawnParams.OverrideLevel = GetLevel();
+		SpawnParams.ObjectFlags |= RF_Transient;
+		SpawnParams.bDeferConstruction = true;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		// Spawning fails if the name is already taken, references to this tile would then resolve to another actor
+		ATile* Tile = World->SpawnActor<ATile>(TileTemplate, TileTransform, SpawnParams);
+		if (!ensureMsgf(Tile && Tile->GetFName() == TileName, TEXT("Failed to spawn board tile %s, references to it will not resolve"), *TileName.ToString()))
 		{
-			Multi_SetTileWithBoardPiece(Tile, true);
-			return true;
+			return nullptr;
 		}
-	}
 
-	return false;
-}
+		Tile->SetReplicates(false);
+		Tile->bNetStartup = true;
 
-bool ABoardManager::ClearBoardPieceOnTile(ATile* Tile)
-{
-	if (HasAuthority())
+		Tile->SetGridHexValue(Hex);
+		Tile->TileType = Layout->GetCellElement(CellIndex);
+		Tile->bIsNullTile = Layout->IsCellNull(CellIndex);
+
+		Tile->FinishSpawning(TileTransform);
+		Tile->AttachToActor(this, FAttachmentTransformRules::KeepWorldTransform);
+
+		return Tile;
+	};
+
+	HexGrid.GenerateGrid(GridDimensions.X, GridDimensions.Y, TilePredicate, true);
+
+	if (GetNetMode() != NM_DedicatedServer)
 	{
-		if (Tile && Tile->ClearBoardPiece())
-		{
-			Multi_SetTileWithBoardPiece(Tile, false);
-			return true;
-		}
+		RefreshAllTilesHighlightMaterials();
 	}
 
-	return false;
+	UE_LOG(LogConquest, Log, TEXT("BoardManager: Built %ix%i board from layout %s"), GridDimensions.X, GridDimensions.Y, *BoardLayout->GetName());
 }
 
-void ABoardManager::Multi_SetTileWithBoardPiece_Implementation(ATile* Tile, bool bHasBoardPiece)
+FName ABoardManager::GetLayoutTileName(int32 CellIndex)
 {
-	if (bHasBoardPiece)
-	{
-		TilesWithBoardPieces.Add(Tile);
-	}
-	else
+	return FName(TEXT("BoardTile"), CellIndex + 1);
+}
+
+ATile* ABoardManager::TraceBoard(const FVector& Origin, const FVector& End) const
+{
+	ATile* Tile = nullptr;
+	if (HexGrid.bGridGenerated)
 	{
-		TilesWithBoardPieces.Remove(Tile);
+		FVector PlaneOrigin = GetActorLocation();
+		FVector PlaneNormal = GetActorUpVector();
+
+		FVector HitPoint = FMath::LinePlaneIntersection(Origin, End, FPlane(PlaneOrigin, PlaneNormal));
+		Tile = HexGrid.GetTile(FHexGrid::ConvertWorldToHex(HitPoint, PlaneOrigin, FVector(GridHexSize)));
 	}
+
+	return Tile;
 }
 
-void ABoardManager::MoveBoardPieceUnderBoard(AActor* BoardPiece, float Scale) const
+bool ABoardManager::FindPath(const ATile* Start, const ATile* Goal, FBoardPath& OutPath, bool bAllowPartial, int32 MaxDistance) const
 {
-	if (Scale != 0.f)
+	const bool bUseCache = bEnableQueryCache && Start && Goal;
+	if (bUseCache)
 	{
-		if (BoardPiece)
+		ValidateQueryCaches();
+
+		FBoardPathQueryKey QueryKey(Start->GetGridHexValue(), Goal->GetGridHexValue(), MaxDistance, bAllowPartial);
+		const FBoardPathQueryResult* CachedResult = PathQueryCache.FindAndTouch(QueryKey);
+		if (CachedResult)
 		{
-			FVector Origin;
-			FVector BoxExtents;
-			BoardPiece->GetActorBounds(false, Origin, BoxExtents);
+			INC_DWORD_STAT(STAT_BoardManagerPathCacheHits);
 
-			// Origin of the bounds may not be exactly the actor location
-			Origin = BoardPiece->GetActorLocation();
+			if (CachedResult->bSuccess)
+			{
+				OutPath = CachedResult->Path;
+			}
+
+			return CachedResult->bSuccess;
+		}
+
+		INC_DWORD_STAT(STAT_BoardManagerPathCacheMisses);
+	}
+
+	bool bSuccess = false;
+	FHexGridPathFindResultData ResultData;
+	if (HexGrid.GeneratePath(Start, Goal, ResultData, bAllowPartial, MaxDistance))
+	{
+		OutPath.Path = MoveTemp(ResultData.Path);
+		bSuccess = true;
+	}
+
+	if (bUseCache)
+	{
+		FBoardPathQueryKey QueryKey(Start->GetGridHexValue(), Goal->GetGridHexValue(), MaxDistance, bAllowPartial);
+		PathQueryCache.Add(QueryKey, FBoardPathQueryResult(bSuccess, bSuccess ? OutPath : FBoardPath()));
+	}
+
+	return bSuccess;
+}
+
+FBoardAsyncQueryHandle ABoardManager::FindPathAsync(const ATile* Start, const ATile* Goal, const FBoardPathQueryFinished& Callback, bool bAllowPartial, int32 MaxDistance)
+{
+	check(IsInGameThread());
+
+	if (!Start || !Goal)
+	{
+		return FBoardAsyncQueryHandle();
+	}
+
+	// Skip zero if we wrap around as it's reserved for invalid handles
+	const uint32 QueryID = NextAsyncQueryID++;
+	if (NextAsyncQueryID == 0)
+	{
+		NextAsyncQueryID = 1;
+	}
+
+	FPendingPathQuery& Query = PendingPathQueries.Add(QueryID);
+	Query.Start = Start->GetGridHexValue();
+	Query.Goal = Goal->GetGridHexValue();
+	Query.bAllowPartial = bAllowPartial;
+	Query.MaxDistance = MaxDistance;
+	Query.Callback = Callback;
+
+	DispatchPathQuery(QueryID);
+	return FBoardAsyncQueryHandle(QueryID);
+}
+
+void ABoardManager::CancelAsyncQuery(FBoardAsyncQueryHandle& Handle)
+{
+	FPendingPathQuery Query;
+	if (PendingPathQueries.RemoveAndCopyValue(Handle.GetID(), Query))
+	{
+		*Query.bCancelled = true;
+	}
+
+	Handle.Invalidate();
+}
+
+void ABoardManager::DispatchPathQuery(uint32 QueryID)
+{
+	const FPendingPathQuery& Query = PendingPathQueries.FindChecked(QueryID);
+	TWeakObjectPtr<ABoardManager> WeakThis(this);
+	const uint32 Version = OccupancyVersion;
+
+	// Queries that don't require a search can finish straight away (we still wait for next frame to be consistent)
+	EHexGridPathFindResult PreSearchResult = HexGrid.CheckPathTargets(Query.Start, Query.Goal, Query.bAllowPartial, Query.MaxDistance);
+	if (PreSearchResult != EHexGridPathFindResult::Unknown)
+	{
+		const bool bSuccess = PreSearchResult == EHexGridPathFindResult::AlreadyAtGoal;
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, QueryID, Version, bSuccess]()->void
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnPathQueryFinished(QueryID, Version, bSuccess, TArray<FIntVector>());
+			}
+		});
+
+		return;
+	}
+
+	// Copy the cell states, so the board can continue to change while searching
+	TArray<FHexGridCellState> CellStates = HexGrid.GetCellStates();
+	const FIntPoint Dimensions = HexGrid.GetGridDimensions();
+
+	const FIntVector Start = Query.Start;
+	const FIntVector Goal = Query.Goal;
+	const bool bAllowPartial = Query.bAllowPartial;
+	const int32 MaxDistance = Query.MaxDistance;
+	TSharedRef<FThreadSafeBool, ESPMode::ThreadSafe> bCancelled = Query.bCancelled;
+
+	FFunctionGraphTask::CreateAndDispatchWhenReady([WeakThis, QueryID, Version, Start, Goal, bAllowPartial, MaxDistance, bCancelled, Dimensions, CellStates = MoveTemp(CellStates)]()->void
+	{
+		if (*bCancelled)
+		{
+			return;
+		}
+
+		FHexGridSearchScratch Scratch;
+		TArray<FIntVector> HexPath;
+
+		int32 EndIndex = INDEX_NONE;
+		bool bReachedGoal = false;
+
+		const bool bSuccess = FHexGrid::SearchCells(Dimensions, CellStates, Start, Goal, bAllowPartial, MaxDistance, Scratch, EndIndex, bReachedGoal);
+		if (bSuccess)
+		{
+			FHexGrid::ConvertSearchToHexPath(Dimensions, Scratch, EndIndex, HexPath);
+		}
+
+		// Results can only be applied on the game thread
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, QueryID, Version, bSuccess, HexPath = MoveTemp(HexPath)]()->void
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnPathQueryFinished(QueryID, Version, bSuccess, HexPath);
+			}
+		});
+	}, TStatId(), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+}
+
+void ABoardManager::OnPathQueryFinished(uint32 QueryID, uint32 Version, bool bSuccess, const TArray<FIntVector>& HexPath)
+{
+	// Query may have been cancelled
+	FPendingPathQuery* Query = PendingPathQueries.Find(QueryID);
+	if (!Query)
+	{
+		return;
+	}
+
+	// Board has changed since we started, the path might no longer be valid
+	if (Version != OccupancyVersion)
+	{
+		DispatchPathQuery(QueryID);
+		return;
+	}
+
+	FBoardPath Path;
+	Path.Path.Reserve(HexPath.Num());
+	for (const FIntVector& Hex : HexPath)
+	{
+		Path.Path.Add(HexGrid.GetTile(Hex));
+	}
+
+	// Remove before executing, as the callback might start another query
+	FBoardPathQueryFinished Callback = MoveTemp(Query->Callback);
+	PendingPathQueries.Remove(QueryID);
+
+	Callback.ExecuteIfBound(bSuccess, Path);
+}
+
+bool ABoardManager::GetTilesWithinDistance(const ATile* Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreOccupiedTiles) const
+{
+	return QueryTilesWithinDistance(Origin, Distance, OutTiles, false, bIgnoreOccupiedTiles, false);
+}
+
+bool ABoardManager::GetTilesAtDistance(const ATile* Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreOccupiedTiles) const
+{
+	if (!Origin)
+	{
+		OutTiles.Reset();
+		return false;
+	}
+
+	return HexGrid.GetAllTilesInRing(Origin->GetGridHexValue(), Distance, OutTiles, bIgnoreOccupiedTiles);
+}
+
+bool ABoardManager::GetOccupiedTilesWithinDistance(const ATile* Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreNullTiles, bool bIgnoreOrigin) const
+{
+	return QueryTilesWithinDistance(Origin, Distance, OutTiles, true, bIgnoreNullTiles, bIgnoreOrigin);
+}
+
+bool ABoardManager::QueryTilesWithinDistance(const ATile* Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bOccupiedOnly, bool bIgnoreFilteredTiles, bool bIgnoreOrigin) const
+{
+	if (!Origin)
+	{
+		OutTiles.Reset();
+		return false;
+	}
+
+	const FIntVector& TileHex = Origin->GetGridHexValue();
+	const FBoardRangeQueryKey QueryKey(TileHex, Distance, bOccupiedOnly, bIgnoreFilteredTiles, bIgnoreOrigin);
+
+	if (bEnableQueryCache)
+	{
+		ValidateQueryCaches();
+
+		const TArray<ATile*>* CachedTiles = RangeQueryCache.FindAndTouch(QueryKey);
+		if (CachedTiles)
+		{
+			INC_DWORD_STAT(STAT_BoardManagerRangeCacheHits);
+
+			OutTiles = *CachedTiles;
+			return OutTiles.Num() > 0;
+		}
+
+		INC_DWORD_STAT(STAT_BoardManagerRangeCacheMisses);
+	}
+
+	bool bSuccess = false;
+	if (Distance > 0)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_BoardManagerQueryTilesWithinDistance);
+
+		FBoardTileMask Mask;
+		GetRangeTileMask(Origin, Distance, Mask);
+
+		if (bOccupiedOnly)
+		{
+			FBoardTileMask Filter = OccupiedTileMask;
+			if (!bIgnoreFilteredTiles)
+			{
+				Filter |= NullTileMask;
+			}
+
+			Mask &= Filter;
+
+			if (bIgnoreOrigin)
+			{
+				const int32 OriginIndex = FHexGrid::HexToCellIndex(TileHex, HexGrid.GetGridDimensions());
+				if (OriginIndex != INDEX_NONE)
+				{
+					Mask.SetBit(OriginIndex, false);
+				}
+			}
+		}
+		else if (bIgnoreFilteredTiles)
+		{
+			Mask.RemoveBits(NullTileMask);
+			Mask.RemoveBits(OccupiedTileMask);
+		}
+
+		bSuccess = GetTilesInMask(Mask, OutTiles);
+	}
+	else
+	{
+		OutTiles.Empty();
+	}
+
+	if (bEnableQueryCache)
+	{
+		RangeQueryCache.Add(QueryKey, OutTiles);
+	}
+
+	return bSuccess;
+}
+
+void ABoardManager::ValidateQueryCaches() const
+{
+	if (CachedQueryVersion != OccupancyVersion)
+	{
+		PathQueryCache.Empty(QueryCacheSize);
+		RangeQueryCache.Empty(QueryCacheSize);
+
+		CachedQueryVersion = OccupancyVersion;
+	}
+}
+
+bool ABoardManager::GetReachableTiles(const ATile* Origin, int32 MaxDistance, FHexGridReachability& OutReachability) const
+{
+	bool bSuccess = false;
+	if (Origin)
+	{
+		const FIntVector& TileHex = Origin->GetGridHexValue();
+		bSuccess = HexGrid.FindReachableTiles(TileHex, MaxDistance, OutReachability);
+	}
+	else
+	{
+		OutReachability.Reset();
+	}
+
+	return bSuccess;
+}
+
+int32 ABoardManager::IsPlayerPortalTile(const ATile* Tile) const
+{
+	if (Tile)
+	{
+		const FIntVector& TileHex = Tile->GetGridHexValue();
+
+		if (TileHex == Player1PortalHex)
+		{
+			return 0;
+		}
+		else if (TileHex == Player2PortalHex)
+		{
+			return 1;
+		}
+	}
+
+	return -1;
+}
+
+TArray<ATile*> ABoardManager::GetTilesWithMatchingElement(ECSKElementType Elements) const
+{
+	FBoardTileMask Mask;
+	GetElementTileMask(Elements, Mask);
+
+	TArray<ATile*> Tiles;
+	GetTilesInMask(Mask, Tiles);
+
+	return Tiles;
+}
+
+TArray<ATile*> ABoardManager::GetNullTiles() const
+{
+	TArray<ATile*> Tiles;
+	GetTilesInMask(NullTileMask, Tiles);
+
+	return Tiles;
+}
+
+bool ABoardManager::CanPlaceTowerOnTile(const ATile* Tile) const
+{
+	if (Tile && !Tile->IsTileOccupied())
+	{
+		// Towers aren't allowed to be build on portal tiles
+		return IsPlayerPortalTile(Tile) == -1;
+	}
+
+	return false;
+}
+
+const FBoardTileMask& ABoardManager::GetPlayerTileMask(int32 PlayerID) const
+{
+	check(PlayerID >= 0 && PlayerID < CSK_MAX_NUM_PLAYERS);
+	return PlayerTileMasks[PlayerID];
+}
+
+void ABoardManager::GetElementTileMask(ECSKElementType Elements, FBoardTileMask& OutMask) const
+{
+	OutMask.Init(TileMask.Num());
+
+	for (int32 Bit = 0; Bit < ARRAY_COUNT(ElementTileMasks); ++Bit)
+	{
+		if ((static_cast<uint8>(Elements) & (1 << Bit)) != 0)
+		{
+			OutMask |= ElementTileMasks[Bit];
+		}
+	}
+}
+
+void ABoardManager::GetConnectedTileMask(const ATile* Origin, FBoardTileMask& OutMask) const
+{
+	const TArray<FHexGridCellState>& CellStates = HexGrid.GetCellStates();
+	const FIntPoint& Dimensions = HexGrid.GetGridDimensions();
+
+	OutMask.Init(TileMask.Num());
+
+	const int32 OriginIndex = Origin ? FHexGrid::HexToCellIndex(Origin->GetGridHexValue(), Dimensions) : INDEX_NONE;
+	if (!CellStates.IsValidIndex(OriginIndex) || !CellStates[OriginIndex].HasTile() || OutMask.Num() != CellStates.Num())
+	{
+		return;
+	}
+
+	const FHexGridCellState& OriginState = CellStates[OriginIndex];
+
+	// Flood outwards from origin, the mask doubles as the visited set
+	TArray<int32> OpenSet;
+	OpenSet.Add(OriginIndex);
+	OutMask.SetBit(OriginIndex);
+
+	while (OpenSet.Num() > 0)
+	{
+		const FIntVector Hex = FHexGrid::CellIndexToHex(OpenSet.Pop(false), Dimensions);
+		for (int32 Direction = 0; Direction < 6; ++Direction)
+		{
+			const int32 Index = FHexGrid::HexToCellIndex(Hex + FHexGrid::HexDirection(Direction), Dimensions);
+			if (Index == INDEX_NONE || OutMask.IsSet(Index))
+			{
+				continue;
+			}
+
+			const FHexGridCellState& State = CellStates[Index];
+			if (State.HasTile() && State.IsNull() == OriginState.IsNull() && State.Element == OriginState.Element)
+			{
+				OutMask.SetBit(Index);
+				OpenSet.Add(Index);
+			}
+		}
+	}
+}
+
+void ABoardManager::GetRangeTileMask(const ATile* Origin, int32 Distance, FBoardTileMask& OutMask) const
+{
+	const int32 NumCells = TileMask.Num();
+	const int32 TileIndex = Origin ? FHexGrid::HexToCellIndex(Origin->GetGridHexValue(), HexGrid.GetGridDimensions()) : INDEX_NONE;
+
+	if (TileIndex == INDEX_NONE || TileIndex >= NumCells || Distance < 0)
+	{
+		OutMask.Init(NumCells);
+		return;
+	}
+
+	if (!bEnableQueryCache || Distance == 0 || Distance > MaxCachedRangeMaskDistance)
+	{
+		BuildRangeTileMask(TileIndex, Distance, OutMask);
+		return;
+	}
+
+	if (RangeTileMaskCache.Max() != QueryCacheSize)
+	{
+		RangeTileMaskCache.Empty(QueryCacheSize);
+	}
+
+	const FIntPoint CacheKey(TileIndex, Distance);
+	const FBoardTileMask* CachedMask = RangeTileMaskCache.FindAndTouch(CacheKey);
+	if (CachedMask)
+	{
+		OutMask = *CachedMask;
+		return;
+	}
+
+	BuildRangeTileMask(TileIndex, Distance, OutMask);
+	RangeTileMaskCache.Add(CacheKey, OutMask);
+}
+
+bool ABoardManager::GetTilesInMask(const FBoardTileMask& Mask, TArray<ATile*>& OutTiles) const
+{
+	OutTiles.Reset(Mask.CountSetBits());
+	ForEachTileInMask(Mask, [&OutTiles](ATile* Tile)->void
+	{
+		OutTiles.Add(Tile);
+	});
+
+	return OutTiles.Num() > 0;
+}
+
+bool ABoardManager::GetBuildableTilesWithinDistance(const ATile* Origin, int32 Distance, TArray<ATile*>& OutTiles) const
+{
+	if (!Origin || Distance <= 0)
+	{
+		OutTiles.Reset();
+		return false;
+	}
+
+	FBoardTileMask Mask;
+	GetRangeTileMask(Origin, Distance, Mask);
+
+	Mask.RemoveBits(NullTileMask);
+	Mask.RemoveBits(OccupiedTileMask);
+	Mask.RemoveBits(PortalTileMask);
+
+	return GetTilesInMask(Mask, OutTiles);
+}
+
+void ABoardManager::RebuildTileMasks()
+{
+	const TArray<FHexGridCellState>& CellStates = HexGrid.GetCellStates();
+	const int32 NumCells = CellStates.Num();
+
+	TileMask.Init(NumCells);
+	NullTileMask.Init(NumCells);
+	OccupiedTileMask.Init(NumCells);
+	PortalTileMask.Init(NumCells);
+
+	for (FBoardTileMask& Mask : ElementTileMasks)
+	{
+		Mask.Init(NumCells);
+	}
+
+	for (FBoardTileMask& Mask : PlayerTileMasks)
+	{
+		Mask.Init(NumCells);
+	}
+
+	for (int32 Index = 0; Index < NumCells; ++Index)
+	{
+		UpdateTileMasks(Index);
+	}
+
+	// Portals only change while editing the board
+	const FIntPoint& Dimensions = HexGrid.GetGridDimensions();
+	const FIntVector PortalHexes[] = { Player1PortalHex, Player2PortalHex };
+	for (const FIntVector& PortalHex : PortalHexes)
+	{
+		const int32 Index = FHexGrid::HexToCellIndex(PortalHex, Dimensions);
+		if (Index != INDEX_NONE && Index < NumCells && TileMask.IsSet(Index))
+		{
+			PortalTileMask.SetBit(Index);
+		}
+	}
+
+	// Grid may have been resized
+	RangeTileMaskCache.Empty(QueryCacheSize);
+}
+
+void ABoardManager::UpdateTileMasks(int32 TileIndex)
+{
+	const TArray<FHexGridCellState>& CellStates = HexGrid.GetCellStates();
+	if (!CellStates.IsValidIndex(TileIndex))
+	{
+		return;
+	}
+
+	// Grid has changed size since masks were built
+	if (TileMask.Num() != CellStates.Num())
+	{
+		RebuildTileMasks();
+		return;
+	}
+
+	const FHexGridCellState& State = CellStates[TileIndex];
+	const bool bHasTile = State.HasTile();
+
+	TileMask.SetBit(TileIndex, bHasTile);
+	NullTileMask.SetBit(TileIndex, bHasTile && State.IsNull());
+	OccupiedTileMask.SetBit(TileIndex, bHasTile && State.IsOccupied());
+
+	for (int32 Bit = 0; Bit < ARRAY_COUNT(ElementTileMasks); ++Bit)
+	{
+		ElementTileMasks[Bit].SetBit(TileIndex, bHasTile && (State.Element & (1 << Bit)) != 0);
+	}
+
+	for (int32 PlayerID = 0; PlayerID < CSK_MAX_NUM_PLAYERS; ++PlayerID)
+	{
+		PlayerTileMasks[PlayerID].SetBit(TileIndex, bHasTile && State.IsOccupied() && State.OwnerID == PlayerID);
+	}
+}
+
+void ABoardManager::BuildRangeTileMask(int32 TileIndex, int32 Distance, FBoardTileMask& OutMask) const
+{
+	const FIntPoint& Dimensions = HexGrid.GetGridDimensions();
+	const FIntVector Origin = FHexGrid::CellIndexToHex(TileIndex, Dimensions);
+
+	OutMask.Init(TileMask.Num());
+
+	FHexGrid::ForEachHexInRange(Origin, Distance, [&OutMask, &Dimensions](const FIntVector& Hex)->void
+	{
+		const int32 Index = FHexGrid::HexToCellIndex(Hex, Dimensions);
+		if (Index != INDEX_NONE && Index < OutMask.Num())
+		{
+			OutMask.SetBit(Index);
+		}
+	});
+
+	// Cells without tiles are never part of a range
+	OutMask &= TileMask;
+}
+
+bool ABoardManager::PlaceBoardPieceOnTile(AActor* BoardPiece, ATile* Tile)
+{
+	if (HasAuthority())
+	{
+		if (Tile && Tile->SetBoardPiece(BoardPiece))
+		{
+			TilesWithBoardPieces.Add(Tile);
+
+			// Clients will place the board piece once this state replicates
+			int32 TileIndex = FHexGrid::HexToCellIndex(Tile->GetGridHexValue(), GridDimensions);
+			BoardState.AddTileState(TileIndex, BoardPiece, static_cast<int8>(Tile->GetBoardPiecesOwnerPlayerID()));
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ABoardManager::ClearBoardPieceOnTile(ATile* Tile)
+{
+	if (HasAuthority())
+	{
+		if (Tile && Tile->ClearBoardPiece())
+		{
+			TilesWithBoardPieces.Remove(Tile);
+
+			int32 TileIndex = FHexGrid::HexToCellIndex(Tile->GetGridHexValue(), GridDimensions);
+			BoardState.RemoveTileState(TileIndex);
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ABoardManager::OnTileStateReplicated(const FBoardTileStateItem& TileState)
+{
+	// Cell states (and tiles when spawning from our layout) are only built once we begin play
+	if (!HexGrid.bGridGenerated || HexGrid.GetCellStates().Num() == 0)
+	{
+		UnresolvedTileStates.AddUnique(TileState.TileIndex);
+		return;
+	}
+
+	ATile* Tile = GetTileAtTileIndex(TileState.TileIndex);
+	if (!Tile)
+	{
+		UE_LOG(LogConquest, Warning, TEXT("ABoardManager::OnTileStateReplicated: Tile index %i is not part of the board"), TileState.TileIndex);
+		return;
+	}
+
+	// The occupant may have yet to replicate, we will be notified again once it has
+	if (!TileState.Occupant)
+	{
+		return;
+	}
+
+	if (Tile->GetBoardPiece() != TileState.Occupant)
+	{
+		// Removals are always received before additions, but we still
+		// make sure the previous occupant has been removed off this tile
+		if (Tile->IsTileOccupied(false))
+		{
+			Tile->HandleBoardPieceCleared();
+		}
+
+		Tile->HandleBoardPieceSet(TileState.Occupant);
+		TilesWithBoardPieces.Add(Tile);
+	}
+
+	// Tiles only notify us when they can find the match board manager, which might not have
+	// replicated yet. This also applies owner changes when the occupant is already set
+	NotifyTileStateChanged(Tile);
+}
+
+void ABoardManager::OnTileStateRemoved(const FBoardTileStateItem& TileState)
+{
+	ATile* Tile = GetTileAtTileIndex(TileState.TileIndex);
+	if (Tile)
+	{
+		if (Tile->IsTileOccupied(false))
+		{
+			Tile->HandleBoardPieceCleared();
+		}
+
+		TilesWithBoardPieces.Remove(Tile);
+		NotifyTileStateChanged(Tile);
+	}
+	else
+	{
+		UnresolvedTileStates.Remove(TileState.TileIndex);
+	}
+}
+
+void ABoardManager::ApplyUnresolvedTileStates()
+{
+	TArray<int32> TileIndices = MoveTemp(UnresolvedTileStates);
+	UnresolvedTileStates.Reset();
+
+	for (int32 TileIndex : TileIndices)
+	{
+		// State may have been updated since it was queued, so use the latest state
+		const FBoardTileStateItem* TileState = BoardState.FindTileState(TileIndex);
+		if (TileState)
+		{
+			OnTileStateReplicated(*TileState);
+		}
+	}
+}
+
+FBoardTileHandle ABoardManager::GetTileHandle(const ATile* Tile) const
+{
+	if (Tile)
+	{
+		return FBoardTileHandle(FHexGrid::HexToCellIndex(Tile->GetGridHexValue(), GridDimensions));
+	}
+
+	return FBoardTileHandle();
+}
+
+ATile* ABoardManager::GetTileAtTileIndex(int32 TileIndex) const
+{
+	if (TileIndex >= 0 && TileIndex < GridDimensions.X * GridDimensions.Y)
+	{
+		return HexGrid.GetTile(FHexGrid::CellIndexToHex(TileIndex, GridDimensions));
+	}
+
+	return nullptr;
+}
+
+void ABoardManager::MoveBoardPieceUnderBoard(AActor* BoardPiece, float Scale) const
+{
+	if (Scale != 0.f)
+	{
+		if (BoardPiece)
+		{
+			FVector Origin;
+			FVector BoxExtents;
+			BoardPiece->GetActorBounds(false, Origin, BoxExtents);
+
+			// Origin of the bounds may not be exactly the actor location
+			Origin = BoardPiece->GetActorLocation();
 			FVector BoardOrigin = GetActorLocation();
 
 			// Scale the scaler by 2 as box extents if only half of the pieces actual size
@@ -575,14 +1553,10 @@ void ABoardManager::MoveBoardPieceUnderBoard(AActor* BoardPiece, float Scale) co
 
 void ABoardManager::RefreshAllTilesHighlightMaterials()
 {
-	if (HexGrid.bGridGenerated)
+	HexGrid.ForEachTile([this](ATile* Tile)->void
 	{
-		TArray<ATile*> AllTiles = HexGrid.GetAllTiles();
-		for (ATile* Tile : AllTiles)
-		{
-			SetTilesHighlightMaterial(Tile);
-		}
-	}
+		SetTilesHighlightMaterial(Tile);
+	});
 }
 
 UMaterialInstanceConstant* ABoardManager::GetHighlightMaterialForElement(ECSKElementType ElementType) const
@@ -606,94 +1580,294 @@ UMaterialInstanceDynamic* ABoardManager::GetPlayerHighlightMaterial(int32 Player
 	return nullptr;
 }
 
-void ABoardManager::SetTilesHighlightMaterial(ATile* Tile) const
+void ABoardManager::SetTilesHighlightMaterial(ATile* Tile)
 {
 	if (Tile)
 	{
-		// TODO: Add null checks for each material
-
-		UStaticMeshComponent* TilesHighlightMesh = Tile->GetMesh();
+		UMaterialInterface* HighlightMaterial = nullptr;
+		if (!GetTilesHighlightMaterial(Tile, HighlightMaterial))
+		{
+			return;
+		}
 
-		// Null takes priority
-		if (Tile->bIsNullTile)
+		if (bInstancedTileRenderingActive)
 		{
-			TilesHighlightMesh->SetMaterial(0, NullHighlightMaterial);
+			SetTilesInstancedMaterial(Tile, HighlightMaterial);
 			return;
 		}
 
-		bool bIsTileHovered = Tile->IsHovered();
+		// Changing materials will recreate the meshes render state, avoid it if nothing has changed
+		UStaticMeshComponent* TilesHighlightMesh = Tile->GetMesh();
+		if (TilesHighlightMesh->GetMaterial(0) != HighlightMaterial)
+		{
+			TilesHighlightMesh->SetMaterial(0, HighlightMaterial);
+			INC_DWORD_STAT(STAT_BoardManagerHighlightsApplied);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_BoardManagerHighlightsSkipped);
+		}
+	}
+}
+
+void ABoardManager::QueueTileHighlightRefresh(ATile* Tile)
+{
+	if (!Tile)
+	{
+		return;
+	}
+
+	// Tiles being edited outside of play should be updated straight away
+	UWorld* World = GetWorld();
+	if (!World || !World->IsGameWorld() || !HasActorBegunPlay())
+	{
+		SetTilesHighlightMaterial(Tile);
+		return;
+	}
+
+	PendingHighlightTiles.Add(Tile);
+	SetActorTickEnabled(true);
+}
+
+void ABoardManager::FlushTileHighlights()
+{
+	if (PendingHighlightTiles.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_BoardManagerFlushTileHighlights);
 
-		// Tile has been marked as selectable or unselectable (e.g. highlighting
-		// tiles a player can move to during their action phase). For some visualizations,
-		// the selection takes priority over the hover highlight
-		ETileSelectionState SelectionState = Tile->GetSelectionState();
-		if (SelectionState != ETileSelectionState::NotSelectable)
+	for (ATile* Tile : PendingHighlightTiles)
+	{
+		// Tile may have been destroyed since being queued
+		if (Tile && !Tile->IsPendingKill())
 		{
-			UMaterialInstanceConstant* PriorityMat = nullptr;
+			SetTilesHighlightMaterial(Tile);
+		}
+	}
+
+	PendingHighlightTiles.Empty();
+
+	if (bInstancedTileRenderingActive)
+	{
+		FlushDirtyTileInstances();
+	}
+}
+
+bool ABoardManager::GetTilesHighlightMaterial(const ATile* Tile, UMaterialInterface*& OutMaterial) const
+{
+	check(Tile);
+
+	// TODO: Add null checks for each material
+
+	// Null takes priority
+	if (Tile->bIsNullTile)
+	{
+		OutMaterial = NullHighlightMaterial;
+		return true;
+	}
 
-			switch (SelectionState)
+	bool bIsTileHovered = Tile->IsHovered();
+
+	// Tile has been marked as selectable or unselectable (e.g. highlighting
+	// tiles a player can move to during their action phase). For some visualizations,
+	// the selection takes priority over the hover highlight
+	ETileSelectionState SelectionState = Tile->GetSelectionState();
+	if (SelectionState != ETileSelectionState::NotSelectable)
+	{
+		UMaterialInstanceConstant* PriorityMat = nullptr;
+
+		switch (SelectionState)
+		{
+			case ETileSelectionState::Selectable:
 			{
-				case ETileSelectionState::Selectable:
-				{
-					PriorityMat = bIsTileHovered ? nullptr : SelectableHighlightMaterial;
-					break;
-				}
-				case ETileSelectionState::Unselectable:
-				{
-					PriorityMat = bIsTileHovered ? nullptr : UnselectableHighlightMaterial;
-					break;
-				}
-				case ETileSelectionState::SelectablePriority:
-				{
-					PriorityMat = SelectableHighlightMaterial;
-					break;
-				}
-				case ETileSelectionState::UnselectablePriority:
-				{
-					PriorityMat = UnselectableHighlightMaterial;
-					break;
-				}
+				PriorityMat = bIsTileHovered ? nullptr : SelectableHighlightMaterial;
+				break;
 			}
-
-			if (PriorityMat)
+			case ETileSelectionState::Unselectable:
 			{
-				TilesHighlightMesh->SetMaterial(0, PriorityMat);
-				return;
+				PriorityMat = bIsTileHovered ? nullptr : UnselectableHighlightMaterial;
+				break;
+			}
+			case ETileSelectionState::SelectablePriority:
+			{
+				PriorityMat = SelectableHighlightMaterial;
+				break;
+			}
+			case ETileSelectionState::UnselectablePriority:
+			{
+				PriorityMat = UnselectableHighlightMaterial;
+				break;
+			}
+			case ETileSelectionState::Preview:
+			{
+				PriorityMat = HoveredHighlightMaterial;
+				break;
 			}
 		}
 
-		// Player can potentially select this tile, signal this to
-		// them by displaying a unique material just for hovering
-		if (bIsTileHovered)
+		if (PriorityMat)
 		{
-			TilesHighlightMesh->SetMaterial(0, HoveredHighlightMaterial);
-			return;
+			OutMaterial = PriorityMat;
+			return true;
 		}
+	}
+
+	// Player can potentially select this tile, signal this to
+	// them by displaying a unique material just for hovering
+	if (bIsTileHovered)
+	{
+		OutMaterial = HoveredHighlightMaterial;
+		return true;
+	}
+
+	// This tile could potentially be a players portal, match it to their color
+	int32 PortalID = IsPlayerPortalTile(Tile);
+	if (PortalID != -1)
+	{
+		OutMaterial = GetPlayerHighlightMaterial(PortalID);
+		return true;
+	}
+
+	// A player owns a board piece on this tile, we can
+	// highlight it with the players assigned color 
+	int32 OwnerID = Tile->GetBoardPiecesOwnerPlayerID();
+	if (OwnerID != -1)
+	{
+		OutMaterial = GetPlayerHighlightMaterial(OwnerID);
+		return true;
+	}
+
+	// Last case is simply based off tiles element
+	UMaterialInstanceConstant* const* ElementMatPtr = ElementHighlightMaterials.Find(Tile->TileType);
+	if (ElementMatPtr)
+	{
+		OutMaterial = *ElementMatPtr;
+		return true;
+	}
+
+	return false;
+}
+
+void ABoardManager::EnableInstancedTileRendering()
+{
+	if (bInstancedTileRenderingActive)
+	{
+		return;
+	}
+
+	bInstancedTileRenderingActive = true;
 
-		// This tile could potentially be a players portal, match it to their color
-		int32 PortalID = IsPlayerPortalTile(Tile);
-		if (PortalID != -1)
+	HexGrid.ForEachTile([this](ATile* Tile)->void
+	{
+		if (Tile)
 		{
-			TilesHighlightMesh->SetMaterial(0, GetPlayerHighlightMaterial(PortalID));
-			return;
+			// We still want the mesh for collision
+			Tile->GetMesh()->SetVisibility(false);
+			SetTilesHighlightMaterial(Tile);
 		}
+	});
+
+	FlushDirtyTileInstances();
+}
+
+void ABoardManager::SetTilesInstancedMaterial(ATile* Tile, UMaterialInterface* Material)
+{
+	check(Tile);
+
+	UMaterialInterface*& CurrentMaterial = InstancedTileMaterials.FindOrAdd(Tile);
+	int32* InstanceIndexPtr = InstancedTileIndices.Find(Tile);
+	if (InstanceIndexPtr && CurrentMaterial == Material)
+	{
+		INC_DWORD_STAT(STAT_BoardManagerHighlightsSkipped);
+		return;
+	}
 
-		// A player owns a board piece on this tile, we can
-		// highlight it with the players assigned color 
-		int32 OwnerID = Tile->GetBoardPiecesOwnerPlayerID();
-		if (OwnerID != -1)
+	// Hide the tiles old instance rather than removing it, removing instances would shift the index of others.
+	// The hidden instance will be reused by the next tile that switches to the old material
+	if (InstanceIndexPtr)
+	{
+		UHierarchicalInstancedStaticMeshComponent* OldComponent = TileInstanceComponents.FindRef(CurrentMaterial);
+		if (OldComponent)
 		{
-			TilesHighlightMesh->SetMaterial(0, GetPlayerHighlightMaterial(OwnerID));
-			return;
+			FTransform HiddenTransform = Tile->GetMesh()->GetComponentTransform();
+			HiddenTransform.SetScale3D(FVector::ZeroVector);
+
+			OldComponent->UpdateInstanceTransform(*InstanceIndexPtr, HiddenTransform, true, false, true);
+			FreeTileInstances.FindOrAdd(CurrentMaterial).Add(*InstanceIndexPtr);
+			DirtyInstancedMaterials.Add(CurrentMaterial);
 		}
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* NewComponent = GetOrCreateTileInstanceComponent(Material, Tile);
+	const FTransform& TileTransform = Tile->GetMesh()->GetComponentTransform();
+
+	int32 InstanceIndex = INDEX_NONE;
+	TArray<int32>* FreeIndices = FreeTileInstances.Find(Material);
+	if (FreeIndices && FreeIndices->Num() > 0)
+	{
+		InstanceIndex = FreeIndices->Pop(false);
+		NewComponent->UpdateInstanceTransform(InstanceIndex, TileTransform, true, false, true);
+	}
+	else
+	{
+		InstanceIndex = NewComponent->AddInstanceWorldSpace(TileTransform);
+	}
+
+	InstancedTileIndices.Add(Tile, InstanceIndex);
+	DirtyInstancedMaterials.Add(Material);
+	CurrentMaterial = Material;
+
+	INC_DWORD_STAT(STAT_BoardManagerHighlightsApplied);
+
+	// Render state is only updated when flushing highlights
+	SetActorTickEnabled(true);
+}
+
+void ABoardManager::FlushDirtyTileInstances()
+{
+	if (DirtyInstancedMaterials.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_BoardManagerFlushTileInstances);
 
-		// Last case is simply based off tiles element
-		if (ElementHighlightMaterials.Contains(Tile->TileType))
+	// Instances have already been moved, we only need each changed component to update its render state once
+	for (UMaterialInterface* Material : DirtyInstancedMaterials)
+	{
+		UHierarchicalInstancedStaticMeshComponent* InstanceComponent = TileInstanceComponents.FindRef(Material);
+		if (InstanceComponent)
 		{
-			TilesHighlightMesh->SetMaterial(0, ElementHighlightMaterials[Tile->TileType]);
-			return;
+			InstanceComponent->MarkRenderStateDirty();
 		}
 	}
+
+	DirtyInstancedMaterials.Empty();
+}
+
+UHierarchicalInstancedStaticMeshComponent* ABoardManager::GetOrCreateTileInstanceComponent(UMaterialInterface* Material, ATile* TemplateTile)
+{
+	check(TemplateTile);
+
+	UHierarchicalInstancedStaticMeshComponent* const* ComponentPtr = TileInstanceComponents.Find(Material);
+	if (ComponentPtr)
+	{
+		return *ComponentPtr;
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* InstanceComponent = NewObject<UHierarchicalInstancedStaticMeshComponent>(this);
+	InstanceComponent->SetupAttachment(GetRootComponent());
+	InstanceComponent->SetStaticMesh(TemplateTile->GetMesh()->GetStaticMesh());
+	InstanceComponent->SetMaterial(0, Material);
+	
+	// Tiles themselves handle collision
+	InstanceComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	InstanceComponent->RegisterComponent();
+
+	TileInstanceComponents.Add(Material, InstanceComponent);
+	return InstanceComponent;
 }
 
 void ABoardManager::SetHighlightColorForPlayer(int32 PlayerID, FLinearColor Color)
@@ -728,7 +1902,7 @@ void ABoardManager::Multi_SetHighlightColorForPlayer_Implementation(int32 Player
 			// We want to refresh since a new material has been created
 			for (ATile* Tile : TilesWithBoardPieces)
 			{
-				SetTilesHighlightMaterial(Tile);
+				QueueTileHighlightRefresh(Tile);
 			}
 		}
 		else
@@ -0,0 +1,19 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardTypes.h"
+
+bool FBoardTileHandle::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	// Invalid handles are sent as zero, so every valid index is offset by one
+	uint32 Value = IsValid() ? static_cast<uint32>(TileIndex) + 1 : 0;
+	Ar.SerializeIntPacked(Value);
+
+	if (Ar.IsLoading())
+	{
+		// Indices outside of the board will fail to resolve to a tile, so we only need to bound them to a handle
+		TileIndex = (Value > 0 && Value <= static_cast<uint32>(MaxBoardTiles)) ? static_cast<uint16>(Value - 1) : InvalidIndex;
+	}
+
+	bOutSuccess = true;
+	return true;
+}
@@ -67,6 +67,7 @@ void ATile::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 	if (PropertyName == GET_MEMBER_NAME_CHECKED(ATile, TileType) ||
 		PropertyName == GET_MEMBER_NAME_CHECKED(ATile, bIsNullTile))
 	{
+		BoardManager->NotifyTileStateChanged(this);
 		BoardManager->SetTilesHighlightMaterial(this);
 	}
 }
@@ -173,8 +174,8 @@ bool ATile::SetBoardPiece(AActor* BoardPiece)
 	UE_LOG(LogConquest, Log, TEXT("Setting Board Piece %s for Tile %s (Hex Value %s)"),
 		*BoardPiece->GetName(), *GetName(), *GridHexIndex.ToString());
 
-	// Board piece is valid, have all clients update their occupant
-	Multi_SetBoardPiece(BoardPiece);
+	// Board piece is valid, the board manager will inform clients of the new occupant
+	HandleBoardPieceSet(BoardPiece);
 	return true;
 }
 
@@ -195,18 +196,20 @@ bool ATile::ClearBoardPiece()
 	UE_LOG(LogConquest, Log, TEXT("Clearing Board Piece %s for Tile %s (Hex Value %s)"),
 		*PieceOccupant.GetObject()->GetName(), *GetName(), *GridHexIndex.ToString());
 
-	// We have a board piece to clear, have all clients update their occupant
-	Multi_ClearBoardPiece();
+	// We have a board piece to clear, the board manager will inform clients of the change
+	HandleBoardPieceCleared();
 	return true;
 }
 
-void ATile::Multi_SetBoardPiece_Implementation(AActor* BoardPiece)
+void ATile::HandleBoardPieceSet(AActor* BoardPiece)
 {
 	if (BoardPiece && ensure(BoardPiece->Implements<UBoardPieceInterface>()))
 	{
 		PieceOccupant = BoardPiece;
 		PieceOccupant->PlacedOnTile(this);
 
+		NotifyBoardOfStateChange();
+
 		// We want to call this after placed on tile, as a board piece
 		// can never be hovered when not on a tile to hover over
 		if (IsHovered())
@@ -221,18 +224,9 @@ void ATile::Multi_SetBoardPiece_Implementation(AActor* BoardPiece)
 		RefreshHighlightMaterial();
 		RefreshHoveringPlayersBoardPieceUI();
 	}
-	else
-	{
-		// If we are clients and the board piece is null
-		if (!BoardPiece && !HasAuthority())
-		{
-			UE_LOG(LogConquest, Warning, TEXT("ATile::Multi_SetBoardPiece: Board Piece is null on the client. "
-				"This board piece may not be replicating or has yet to replicate."))
-		}
-	}
 }
 
-void ATile::Multi_ClearBoardPiece_Implementation()
+void ATile::HandleBoardPieceCleared()
 {
 	if (PieceOccupant.GetInterface() != nullptr)
 	{
@@ -251,6 +245,8 @@ void ATile::Multi_ClearBoardPiece_Implementation()
 		PieceOccupant->RemovedOffTile();
 		PieceOccupant = nullptr;
 
+		NotifyBoardOfStateChange();
+
 		// These should always be executed last
 		RefreshHighlightMaterial();
 		RefreshHoveringPlayersBoardPieceUI();
@@ -340,11 +336,20 @@ FBoardPieceUIData ATile::GetBoardPieceUIData() const
 	return UIData;
 }
 
+void ATile::NotifyBoardOfStateChange()
+{
+	ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
+	if (BoardManager)
+	{
+		BoardManager->NotifyTileStateChanged(this);
+	}
+}
+
 void ATile::RefreshHighlightMaterial()
 {
 	ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
 	if (BoardManager)
 	{
-		BoardManager->SetTilesHighlightMaterial(this);
+		BoardManager->QueueTileHighlightRefresh(this);
 	}
 }
\ No newline at end of file
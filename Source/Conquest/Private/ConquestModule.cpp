@@ -1,15 +1,60 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "ConquestModule.h"
+#include "Conquest.h"
+#include "Misc/QueuedThreadPool.h"
 
 class FConquestModule : public IConquestModule
 {
 public:
 
+	FConquestModule()
+		: SearchThreadPool(nullptr)
+	{
+
+	}
+
+	virtual void ShutdownModule() override
+	{
+		if (SearchThreadPool)
+		{
+			SearchThreadPool->Destroy();
+			delete SearchThreadPool;
+			SearchThreadPool = nullptr;
+		}
+	}
+
 	virtual bool IsGameModule() const
 	{
 		return true;
 	}
+
+	virtual FQueuedThreadPool* GetSearchThreadPool() override
+	{
+		check(IsInGameThread());
+
+		if (!SearchThreadPool && FPlatformProcess::SupportsMultithreading())
+		{
+			// Leave room for the game and render threads, searches run for their entire time budget
+			const int32 NumThreads = FMath::Max(1, FPlatformMisc::NumberOfWorkerThreadsToSpawn() - 2);
+
+			SearchThreadPool = FQueuedThreadPool::Allocate();
+			if (!SearchThreadPool->Create(NumThreads, 128 * 1024, TPri_BelowNormal))
+			{
+				UE_LOG(LogConquest, Warning, TEXT("FConquestModule: Failed to create search thread pool"));
+
+				delete SearchThreadPool;
+				SearchThreadPool = nullptr;
+			}
+		}
+
+		return SearchThreadPool;
+	}
+
+private:
+
+	/** Pool AI players search on, created on first use */
+	FQueuedThreadPool* SearchThreadPool;
 };
 
 IMPLEMENT_PRIMARY_GAME_MODULE(FConquestModule, Conquest, "Conquest");
@@ -5,8 +5,10 @@
 #include "Tile.h"
 
 DECLARE_CYCLE_STAT(TEXT("HexGrid FindPath"), STAT_HexGridFindPath, STATGROUP_Conquest);
+DECLARE_CYCLE_STAT(TEXT("HexGrid FindReachableTiles"), STAT_HexGridFindReachableTiles, STATGROUP_Conquest);
 DECLARE_CYCLE_STAT(TEXT("HexGrid GetAllTilesWithinRange"), STAT_HexGridGetAllTilesWithinRange, STATGROUP_Conquest);
 DECLARE_CYCLE_STAT(TEXT("HexGrid GetAllOccupiedTilesWithinRange"), STAT_HexGridGetAllOccupiedTilesWithinRange, STATGROUP_Conquest);
+DECLARE_CYCLE_STAT(TEXT("HexGrid GetAllTilesInRing"), STAT_HexGridGetAllTilesInRing, STATGROUP_Conquest);
 
 const FHexGrid::FHex FHexGrid::DirectionTable[] =
 {
@@ -14,6 +16,71 @@ const FHexGrid::FHex FHexGrid::DirectionTable[] =
 	FHex(-1, +1, 0), FHex(-1, 0, +1), FHex(0, -1, +1)
 };
 
+void FHexGridSearchScratch::BeginSearch(int32 NumCells)
+{
+	// Grid has been resized, the previous stamps are no longer valid
+	if (VisitStamps.Num() != NumCells)
+	{
+		CameFrom.SetNumUninitialized(NumCells);
+		CostSoFar.SetNumUninitialized(NumCells);
+
+		VisitStamps.Reset();
+		VisitStamps.SetNumZeroed(NumCells);
+		ClosedStamps.Reset();
+		ClosedStamps.SetNumZeroed(NumCells);
+
+		SearchStamp = 0;
+	}
+
+	// Stamps will eventually wrap around, at which point we need to clear old stamps
+	++SearchStamp;
+	if (SearchStamp == 0)
+	{
+		FMemory::Memzero(VisitStamps.GetData(), VisitStamps.Num() * sizeof(uint32));
+		FMemory::Memzero(ClosedStamps.GetData(), ClosedStamps.Num() * sizeof(uint32));
+
+		SearchStamp = 1;
+	}
+
+	OpenList.Reset();
+}
+
+void FHexGridReachability::GetReachableTiles(TArray<ATile*>& OutTiles) const
+{
+	OutTiles.Reset(FMath::Max(0, Tiles.Num() - 1));
+
+	// First entry is always the origin
+	for (int32 Index = 1; Index < Tiles.Num(); ++Index)
+	{
+		OutTiles.Add(Tiles[Index]);
+	}
+}
+
+bool FHexGridReachability::GetPathTo(const FIntVector& Goal, TArray<ATile*>& OutPath) const
+{
+	OutPath.Reset();
+
+	int32 Index = Find(Goal);
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// Steps tell us exactly how long the path is
+	OutPath.SetNumUninitialized(Steps[Index] + 1);
+
+	// Walk back from the goal, filling the path from last to first
+	for (int32 PathIndex = OutPath.Num() - 1; PathIndex >= 0; --PathIndex)
+	{
+		check(Index != INDEX_NONE);
+
+		OutPath[PathIndex] = Tiles[Index];
+		Index = Predecessors[Index];
+	}
+
+	return true;
+}
+
 void FHexGrid::GenerateGrid(int32 Rows, int32 Columns, const TFunction<ATile*(const FHex&, int32, int32)>& Predicate, bool bClearGrid)
 {
 	if (bClearGrid)
@@ -26,7 +93,18 @@ void FHexGrid::GenerateGrid(int32 Rows, int32 Columns, const TFunction<ATile*(co
 		RemoveCellsFrom(Rows, Columns);
 	}
 
-	GridMap.Reserve(Rows * Columns);
+	const bool bUseDenseLayout = StorageLayout == EHexGridStorageLayout::Dense;
+
+	// Tiles that survived the removal need to be shifted into the new layout
+	TArray<ATile*> NewDenseTiles;
+	if (bUseDenseLayout)
+	{
+		NewDenseTiles.SetNumZeroed(Rows * Columns);
+	}
+	else
+	{
+		GridMap.Reserve(Rows * Columns);
+	}
 
 	for (int32 c = 0; c < Columns; ++c)
 	{
@@ -34,7 +112,18 @@ void FHexGrid::GenerateGrid(int32 Rows, int32 Columns, const TFunction<ATile*(co
 		for (int32 r = -COffset; r < Rows - COffset; ++r)
 		{
 			FHex Hex = ConvertIndicesToHex(r, c);
-			if (GridMap.Contains(Hex))
+			
+			if (bUseDenseLayout)
+			{
+				// Dimensions have yet to be updated, so this checks if cell existed before
+				int32 OldIndex = bGridGenerated ? HexToDenseIndex(Hex) : INDEX_NONE;
+				if (OldIndex != INDEX_NONE)
+				{
+					NewDenseTiles[c * Rows + (r + COffset)] = DenseTiles[OldIndex];
+					continue;
+				}
+			}
+			else if (GridMap.Contains(Hex))
 			{
 				continue;
 			}
@@ -47,12 +136,26 @@ void FHexGrid::GenerateGrid(int32 Rows, int32 Columns, const TFunction<ATile*(co
 				UE_LOG(LogConquest, Warning, TEXT("Predicate for FHexGrid::GenerateGrid returned null"));
 			}
 
-			GridMap.Add(Hex, Tile);
+			if (bUseDenseLayout)
+			{
+				NewDenseTiles[c * Rows + (r + COffset)] = Tile;
+			}
+			else
+			{
+				GridMap.Add(Hex, Tile);
+			}
 		}
 	}
 
+	if (bUseDenseLayout)
+	{
+		DenseTiles = MoveTemp(NewDenseTiles);
+	}
+
 	GridDimensions = FIntPoint(Rows, Columns);
 	bGridGenerated = true;
+
+	RefreshAllCellStates();
 }
 
 void FHexGrid::ClearGrid()
@@ -60,20 +163,17 @@ void FHexGrid::ClearGrid()
 	if (bGridGenerated)
 	{
 		// Destroy any existing tiles
+		ForEachTile([](ATile* Tile)->void
 		{
-			TArray<ATile*> Tiles;
-			GridMap.GenerateValueArray(Tiles);
-
-			for (ATile* Tile : Tiles)
+			if (Tile)
 			{
-				if (Tile)
-				{
-					Tile->Destroy();
-				}
+				Tile->Destroy();
 			}
-		}
+		});
 
 		GridMap.Empty();
+		DenseTiles.Empty();
+		CellStates.Empty();
 		GridDimensions = FIntPoint::ZeroValue;
 		bGridGenerated = false;
 	}
@@ -92,6 +192,38 @@ void FHexGrid::RemoveCellsFrom(int32 Row, int32 Column)
 		return;
 	}
 
+	if (StorageLayout == EHexGridStorageLayout::Dense)
+	{
+		const int32 NewRows = FMath::Min(Row, GridDimensions.X);
+		const int32 NewCols = FMath::Min(Column, GridDimensions.Y);
+
+		// Compact the tiles that still fit into the new dimensions
+		TArray<ATile*> NewDenseTiles;
+		NewDenseTiles.SetNumZeroed(NewRows * NewCols);
+
+		for (int32 Index = 0; Index < DenseTiles.Num(); ++Index)
+		{
+			const int32 c = Index / GridDimensions.X;
+			const int32 r = Index % GridDimensions.X;
+
+			ATile* Tile = DenseTiles[Index];
+			if (r < NewRows && c < NewCols)
+			{
+				NewDenseTiles[c * NewRows + r] = Tile;
+			}
+			else if (ensure(Tile != nullptr))
+			{
+				Tile->Destroy();
+			}
+		}
+
+		DenseTiles = MoveTemp(NewDenseTiles);
+		GridDimensions = FIntPoint(NewRows, NewCols);
+
+		RefreshAllCellStates();
+		return;
+	}
+
 	int32 MaxRows = FMath::Max(Row, GridDimensions.X);
 	int32 MaxCols = FMath::Max(Column, GridDimensions.Y);
 
@@ -117,55 +249,238 @@ void FHexGrid::RemoveCellsFrom(int32 Row, int32 Column)
 	}
 
 	GridMap.Shrink();
+	RefreshAllCellStates();
+}
+
+void FHexGrid::SetStorageLayout(EHexGridStorageLayout NewLayout)
+{
+	if (StorageLayout == NewLayout)
+	{
+		return;
+	}
+
+	if (NewLayout == EHexGridStorageLayout::Dense)
+	{
+		MoveTilesToDenseArray();
+	}
+	else
+	{
+		MoveTilesToMap();
+	}
+
+	StorageLayout = NewLayout;
+	RefreshAllCellStates();
+}
+
+void FHexGrid::RefreshCellState(const FHex& Hex)
+{
+	int32 Index = bGridGenerated ? HexToDenseIndex(Hex) : INDEX_NONE;
+	if (CellStates.IsValidIndex(Index))
+	{
+		ATile* const* TilePtr = FindTile(Hex);
+		CellStates[Index] = CalculateCellState(TilePtr ? *TilePtr : nullptr);
+	}
+}
+
+void FHexGrid::SetCellOwnerID(const FHex& Hex, int8 OwnerID)
+{
+	int32 Index = bGridGenerated ? HexToDenseIndex(Hex) : INDEX_NONE;
+	if (CellStates.IsValidIndex(Index) && CellStates[Index].IsOccupied())
+	{
+		CellStates[Index].OwnerID = OwnerID;
+	}
+}
+
+void FHexGrid::RefreshAllCellStates()
+{
+	CellStates.Reset();
+
+	if (bGridGenerated)
+	{
+		const int32 NumCells = GridDimensions.X * GridDimensions.Y;
+		CellStates.SetNumUninitialized(NumCells);
+
+		for (int32 Index = 0; Index < NumCells; ++Index)
+		{
+			CellStates[Index] = CalculateCellState(GetTileAtCellIndex(Index));
+		}
+	}
+}
+
+void FHexGrid::PostSerialize(const FArchive& Ar)
+{
+	if (Ar.IsLoading() && bGridGenerated)
+	{
+		// Grids saved before dense storage was supported will only have the map filled out
+		if (StorageLayout == EHexGridStorageLayout::Dense && DenseTiles.Num() == 0 && GridMap.Num() > 0)
+		{
+			MoveTilesToDenseArray();
+		}
+	}
+}
+
+void FHexGrid::MoveTilesToDenseArray()
+{
+	DenseTiles.Reset();
+	DenseTiles.SetNumZeroed(GridDimensions.X * GridDimensions.Y);
+
+	for (const TPair<FIntVector, ATile*>& Pair : GridMap)
+	{
+		int32 Index = HexToDenseIndex(Pair.Key);
+		if (ensureMsgf(Index != INDEX_NONE, TEXT("Hex %s lies outside of grid dimensions"), *Pair.Key.ToString()))
+		{
+			DenseTiles[Index] = Pair.Value;
+		}
+	}
+
+	GridMap.Empty();
+}
+
+void FHexGrid::MoveTilesToMap()
+{
+	GridMap.Empty(DenseTiles.Num());
+
+	for (int32 Index = 0; Index < DenseTiles.Num(); ++Index)
+	{
+		GridMap.Add(DenseIndexToHex(Index), DenseTiles[Index]);
+	}
+
+	DenseTiles.Empty();
+}
+
+FHexGridCellState FHexGrid::CalculateCellState(const ATile* Tile)
+{
+	// Cells without tiles can never be moved onto
+	if (!Tile)
+	{
+		return FHexGridCellState();
+	}
+
+	EHexGridCellFlags Flags = EHexGridCellFlags::None;
+	if (Tile->bIsNullTile)
+	{
+		Flags |= EHexGridCellFlags::Null;
+	}
+
+	if (Tile->IsTileOccupied(false))
+	{
+		Flags |= EHexGridCellFlags::Occupied;
+	}
+
+	return FHexGridCellState(Flags, static_cast<int8>(Tile->GetBoardPiecesOwnerPlayerID()), static_cast<uint8>(Tile->TileType));
+}
+
+bool FHexGrid::SupportsSymmetry(EHexGridSymmetry Symmetry, const FIntPoint& Dimensions)
+{
+	switch (Symmetry)
+	{
+		case EHexGridSymmetry::None:
+		{
+			return true;
+		}
+		case EHexGridSymmetry::MirrorColumns:
+		{
+			// Mirrored columns need to have the same offset
+			return (Dimensions.Y % 2) == 1;
+		}
+		case EHexGridSymmetry::Rotate:
+		{
+			// Rotated columns need to have opposite offsets
+			return (Dimensions.Y % 2) == 0 || Dimensions.Y == 1;
+		}
+		default:
+		{
+			return false;
+		}
+	}
+}
+
+FHexGrid::FHex FHexGrid::GetMirroredHex(const FHex& Hex, EHexGridSymmetry Symmetry, const FIntPoint& Dimensions)
+{
+	switch (Symmetry)
+	{
+		case EHexGridSymmetry::MirrorColumns:
+		{
+			// Swapping the X and Z axes flips columns, which is then moved so the first column becomes the last
+			const FHex LastColumn = CellIndexToHex((Dimensions.Y - 1) * Dimensions.X, Dimensions);
+			return FHex(-Hex.Z, -Hex.Y, -Hex.X) + LastColumn;
+		}
+		case EHexGridSymmetry::Rotate:
+		{
+			// Center - (Hex - Center), with the first and last cell adding up to twice the center
+			const FHex TwiceCenter = CellIndexToHex(0, Dimensions) + CellIndexToHex(Dimensions.X * Dimensions.Y - 1, Dimensions);
+			return TwiceCenter - Hex;
+		}
+		default:
+		{
+			return Hex;
+		}
+	}
+}
+
+int32 FHexGrid::GetMirroredCellIndex(int32 Index, EHexGridSymmetry Symmetry, const FIntPoint& Dimensions)
+{
+	if (!SupportsSymmetry(Symmetry, Dimensions))
+	{
+		return INDEX_NONE;
+	}
+
+	return HexToCellIndex(GetMirroredHex(CellIndexToHex(Index, Dimensions), Symmetry, Dimensions), Dimensions);
 }
 
 bool FHexGrid::GeneratePath(const FHex& Start, const FHex& Goal, FHexGridPathFindResultData& OutResultData, bool bAllowPartial, int32 MaxDistance) const
+{
+	EHexGridPathFindResult PreSearchResult = CheckPathTargets(Start, Goal, bAllowPartial, MaxDistance);
+	if (PreSearchResult != EHexGridPathFindResult::Unknown)
+	{
+		OutResultData.Set(PreSearchResult);
+		return PreSearchResult == EHexGridPathFindResult::AlreadyAtGoal;
+	}
+
+	return FindPath(Start, Goal, OutResultData, bAllowPartial, MaxDistance);
+}
+
+EHexGridPathFindResult FHexGrid::CheckPathTargets(const FHex& Start, const FHex& Goal, bool bAllowPartial, int32 MaxDistance) const
 {
 	// No grid
 	if (!bGridGenerated)
 	{
-		OutResultData.Set(EHexGridPathFindResult::NoGridGenerated);
-		return false;
+		return EHexGridPathFindResult::NoGridGenerated;
 	}
 
 	// Invalid distance
 	if (MaxDistance <= 0)
 	{
-		OutResultData.Set(EHexGridPathFindResult::InvalidDistance);
-		return false;
+		return EHexGridPathFindResult::InvalidDistance;
 	}
 
 	// Invalid hex (goal can still be treated as valid if allowing partial path)
-	if (!GridMap.Contains(Start) || (!bAllowPartial && !GridMap.Contains(Goal)))
+	if (!Contains(Start) || (!bAllowPartial && !Contains(Goal)))
 	{
-		OutResultData.Set(EHexGridPathFindResult::InvalidTargets);
-		return false;
+		return EHexGridPathFindResult::InvalidTargets;
 	}
 
 	// Already at goal
 	if (Start == Goal)
 	{
-		OutResultData.Set(EHexGridPathFindResult::AlreadyAtGoal);
-		return true;
+		return EHexGridPathFindResult::AlreadyAtGoal;
 	}
 
 	// Start is blocked
-	const ATile* StartTile = GetTile(Start);
-	if (!StartTile || StartTile->bIsNullTile)
+	const FHexGridCellState* StartState = GetCellState(Start);
+	if (!StartState || StartState->IsNull())
 	{
-		OutResultData.Set(EHexGridPathFindResult::InvalidTargets);
-		return false;
+		return EHexGridPathFindResult::InvalidTargets;
 	}
 
 	// Goal is blocked (goal can still be treated as valid if allowing partial path)
-	const ATile* GoalTile = GetTile(Goal);
-	if (!GoalTile || (!bAllowPartial && GoalTile->bIsNullTile))
+	const FHexGridCellState* GoalState = GetCellState(Goal);
+	if (!GoalState || (!bAllowPartial && GoalState->IsNull()))
 	{
-		OutResultData.Set(EHexGridPathFindResult::InvalidTargets);
-		return false;
+		return EHexGridPathFindResult::InvalidTargets;
 	}
 
-	return FindPath(Start, Goal, OutResultData, bAllowPartial, MaxDistance);
+	return EHexGridPathFindResult::Unknown;
 }
 
 bool FHexGrid::GeneratePath(const ATile* Start, const ATile* Goal, FHexGridPathFindResultData& OutResultData, bool bAllowPartial, int32 MaxDistance) const
@@ -180,148 +495,108 @@ bool FHexGrid::GeneratePath(const ATile* Start, const ATile* Goal, FHexGridPathF
 	return GeneratePath(Start->GetGridHexValue(), Goal->GetGridHexValue(), OutResultData, bAllowPartial, MaxDistance);
 }
 
-// TODO: Needs to be fixed (as in partial path returning the tile that was closest to the goal, it doesn't right now)
 bool FHexGrid::FindPath(const FHex& Start, const FHex& Goal, FHexGridPathFindResultData& OutResultData, bool bAllowPartial, int32 MaxDistance) const
 {
-	struct FPathSegment
-	{
-		FPathSegment()
-			: Hex(0)
-			, Cost(FLT_MAX)
-			, Distance(0)
-		{
-
-		}
+	SCOPE_CYCLE_COUNTER(STAT_HexGridFindPath);
 
-		FPathSegment(const FHex& InHex, float InCost, int32 InDistance)
-			: Hex(InHex)
-			, Cost(InCost)
-			, Distance(InDistance)
-		{
+	int32 EndIndex = INDEX_NONE;
+	bool bReachedGoal = false;
 
-		}
+	if (!SearchCells(GridDimensions, CellStates, Start, Goal, bAllowPartial, MaxDistance, SearchScratch, EndIndex, bReachedGoal))
+	{
+		OutResultData.Set(EHexGridPathFindResult::Failure);
+		return false;
+	}
 
-		// Hex for this current segment
-		FHex Hex;
+	OutResultData.Result = bReachedGoal ? EHexGridPathFindResult::Success : EHexGridPathFindResult::Partial;
+	ConvertSearchToPath(EndIndex, OutResultData.Path);
 
-		// Cost for reaching this segment
-		float Cost;
+	return true;
+}
 
-		// Amount of tiles since origin
-		int32 Distance;
-	};
+bool FHexGrid::SearchCells(const FIntPoint& Dimensions, const TArray<FHexGridCellState>& Cells, const FHex& Start, const FHex& Goal,
+	bool bAllowPartial, int32 MaxDistance, FHexGridSearchScratch& Scratch, int32& OutEndIndex, bool& bOutReachedGoal)
+{
+	using FOpenNode = FHexGridSearchScratch::FOpenNode;
+	using FOpenNodePredicate = FHexGridSearchScratch::FOpenNodePredicate;
 
-	// Predicate for sorting queue
-	struct FPathPredicate
-	{
-		bool operator() (const FPathSegment& lhs, const FPathSegment rhs) const
-		{
-			return lhs.Cost > rhs.Cost;
-		}
-	};
+	check(Cells.Num() == Dimensions.X * Dimensions.Y);
 
-	SCOPE_CYCLE_COUNTER(STAT_HexGridFindPath);
-	
-	const ATile* GoalTile = GetTile(Goal);
-	check(GoalTile);
+	// The grid is always rectangular, so we can index cells densely regardless of storage layout
+	const int32 StartIndex = HexToCellIndex(Start, Dimensions);
+	const int32 GoalIndex = HexToCellIndex(Goal, Dimensions);
+	check(StartIndex != INDEX_NONE && GoalIndex != INDEX_NONE);
 
-	bool bGoalFound = false;
-	FHex LastHex = FHex(-1);
+	Scratch.BeginSearch(Dimensions.X * Dimensions.Y);
 
-	// Hex indices we have already visited
-	TSet<FHex> Visited;
+	const int32 StartHeuristic = PathHeuristic(Start, Goal);
+	Scratch.Visit(StartIndex, 0, INDEX_NONE);
+	Scratch.OpenList.HeapPush(FOpenNode(StartIndex, StartHeuristic, StartHeuristic), FOpenNodePredicate());
 
-	// Edges between the path being constructed
-	TMap<FHex, FHex> PathEdges;
-	PathEdges.Add(Start, Start);
+	// Closest cell to the goal, used as the end of partial paths
+	int32 ClosestIndex = StartIndex;
+	int32 ClosestHeuristic = StartHeuristic;
 
-	// Queue with cheapest hex tiles placed in the front
-	TArray<FPathSegment> Queue;
-	Queue.HeapPush(FPathSegment(Start, 0.f, 0), FPathPredicate());
+	bool bGoalFound = false;
 
-	while (true)
+	while (Scratch.OpenList.Num() > 0)
 	{
-		// Are we unable to continue?
-		if (Queue.Num() == 0)
+		FOpenNode Node(INDEX_NONE, 0, 0);
+		Scratch.OpenList.HeapPop(Node, FOpenNodePredicate(), false);
+
+		// Cells can be pushed multiple times if a cheaper path was found
+		if (Scratch.IsClosed(Node.Index))
 		{
-			break;
+			continue;
 		}
 
-		// Remove this hex from the queue
-		FPathSegment Segment;
-		Queue.HeapPop(Segment, FPathPredicate());
-		LastHex = Segment.Hex;
-		
 		// Have we reached our target?
-		if (Segment.Hex == Goal)
+		if (Node.Index == GoalIndex)
 		{
 			bGoalFound = true;
 			break;
 		}
 
-		// Marked as visit, so we don't return here
-		Visited.Add(Segment.Hex);
-	
-		int32 BestNeighborIndex = -1;
-		FHex BestNeighborHex = FHex(-1);
-		float BestNeighborCost = FLT_MAX;
-
-		// If goal was found but is null, we should forcefully exit
-		bool bForceExit = false;
-		
-		// Cycle through all this segments neighbors to determine which path to prioritize
-		TArray<FHex> Neighbors = GetNeighbors(Segment.Hex);
-		for (int32 i = 0; i < Neighbors.Num(); ++i)
-		{
-			const FHex& Neighbor = Neighbors[i];
-			const ATile* NeighborTile = GetTile(Neighbor);
-
-			// Ignore visited tiles as they probaly are in the queue
-			if (!Visited.Contains(Neighbor))
-			{
-				// Don't bother processing this tile since it's occupied
-				if (NeighborTile->IsTileOccupied())
-				{
-					// If finding partial paths, there is a chance of the goal tile being null
-					if (NeighborTile == GoalTile)
-					{
-						// Stop the search, we know we can't reach the goal
-						bForceExit = true;
-						break;
-					}
-					else
-					{
-						// There is still a chance of reaching the goal
-						continue;
-					}
-				}
+		Scratch.Close(Node.Index);
 
-				float NewCost = Segment.Cost + PathHeuristic(NeighborTile, GoalTile);
-				if (NewCost < BestNeighborCost)
-				{
-					BestNeighborIndex = i;
-					BestNeighborHex = Neighbor;
-					BestNeighborCost = NewCost;
-				}
-			}
+		// Prefer the closest cell that took the least steps to reach
+		const int32 NodeCost = Scratch.CostSoFar[Node.Index];
+		if (Node.Heuristic < ClosestHeuristic || (Node.Heuristic == ClosestHeuristic && NodeCost < Scratch.CostSoFar[ClosestIndex]))
+		{
+			ClosestIndex = Node.Index;
+			ClosestHeuristic = Node.Heuristic;
 		}
 
-		if (bForceExit)
+		// Can we still continue down this path?
+		const int32 NewCost = NodeCost + 1;
+		if (NewCost > MaxDistance)
 		{
-			break;
+			continue;
 		}
 
-		// Can we still continue down this path?
-		if (BestNeighborIndex != -1)
+		const FHex NodeHex = CellIndexToHex(Node.Index, Dimensions);
+		for (int32 i = 0; i < 6; ++i)
 		{
-			int32 NewDistance = Segment.Distance + 1;
-			if (NewDistance <= MaxDistance)
+			const FHex Neighbor = NodeHex + HexDirection(i);
+
+			// Don't bother processing this tile since it's either occupied or off the grid
+			const int32 NeighborIndex = HexToCellIndex(Neighbor, Dimensions);
+			if (NeighborIndex == INDEX_NONE || !Cells[NeighborIndex].IsWalkable())
+			{
+				continue;
+			}
+
+			if (Scratch.IsClosed(NeighborIndex))
+			{
+				continue;
+			}
+
+			if (!Scratch.IsVisited(NeighborIndex) || NewCost < Scratch.CostSoFar[NeighborIndex])
 			{
-				// Establish new path edge (increment distance)
-				Queue.HeapPush(FPathSegment(BestNeighborHex, BestNeighborCost, Segment.Distance + 1), FPathPredicate());
-				PathEdges[Segment.Hex] = BestNeighborHex;
+				const int32 Heuristic = PathHeuristic(Neighbor, Goal);
 
-				PathEdges.Add(BestNeighborHex, BestNeighborHex);
+				Scratch.Visit(NeighborIndex, NewCost, Node.Index);
+				Scratch.OpenList.HeapPush(FOpenNode(NeighborIndex, NewCost + Heuristic, Heuristic), FOpenNodePredicate());
 			}
 		}
 	}
@@ -329,62 +604,122 @@ bool FHexGrid::FindPath(const FHex& Start, const FHex& Goal, FHexGridPathFindRes
 	// Did we exit by reaching the goal?
 	if (bGoalFound)
 	{
-		TArray<ATile*> Tiles;
-		ConvertEdgesToPath(Start, Goal, PathEdges, Tiles);
-
-		OutResultData.Set(EHexGridPathFindResult::Success, Tiles);
+		OutEndIndex = GoalIndex;
+		bOutReachedGoal = true;
+		return true;
 	}
+
 	// We exited without reaching the goal but we can still use a partial path
-	else if (bAllowPartial)
+	if (bAllowPartial)
 	{
-		TArray<ATile*> Tiles;
-		ConvertEdgesToPath(Start, LastHex, PathEdges, Tiles);
+		OutEndIndex = ClosestIndex;
+		bOutReachedGoal = false;
+		return true;
+	}
 
-		OutResultData.Set(EHexGridPathFindResult::Partial, Tiles);
+	return false;
+}
 
-		// We still managed to find something
-		bGoalFound = true;
-	}
-	else
+void FHexGrid::ConvertSearchToPath(int32 GoalIndex, TArray<ATile*>& OutPath) const
+{
+	const FHexGridSearchScratch& Scratch = SearchScratch;
+
+	// Cost is the amount of steps, so we know exactly how long the path will be
+	OutPath.SetNumUninitialized(Scratch.CostSoFar[GoalIndex] + 1, false);
+
+	// Walk back from the goal, filling the path from last to first
+	int32 Current = GoalIndex;
+	for (int32 PathIndex = OutPath.Num() - 1; PathIndex >= 0; --PathIndex)
 	{
-		OutResultData.Set(EHexGridPathFindResult::Failure);
-	}
+		check(Current != INDEX_NONE);
 
-	return bGoalFound;
+		OutPath[PathIndex] = GetTile(DenseIndexToHex(Current));
+		Current = Scratch.CameFrom[Current];
+	}
 }
 
-void FHexGrid::ConvertEdgesToPath(const FHex& Start, const FHex& Goal, const TMap<FHex, FHex>& Edges, TArray<ATile*>& OutPath) const
+void FHexGrid::ConvertSearchToHexPath(const FIntPoint& Dimensions, const FHexGridSearchScratch& Scratch, int32 EndIndex, TArray<FHex>& OutPath)
 {
-	OutPath.Empty();
+	OutPath.SetNumUninitialized(Scratch.CostSoFar[EndIndex] + 1, false);
 
-	// Cycle through the path edges that were generated
-	// to get the path of tiles in the correct order
-	FHex Current = Start;
-	while (Current != Goal)
+	// Walk back from the end, filling the path from last to first
+	int32 Current = EndIndex;
+	for (int32 PathIndex = OutPath.Num() - 1; PathIndex >= 0; --PathIndex)
 	{
-		OutPath.Add(GetTile(Current));
+		check(Current != INDEX_NONE);
 
-		// Move onto next segment
-		Current = Edges[Current];
+		OutPath[PathIndex] = CellIndexToHex(Current, Dimensions);
+		Current = Scratch.CameFrom[Current];
 	}
-
-	// Add goal tile as well
-	OutPath.Add(GetTile(Goal));
 }
 
-float FHexGrid::PathHeuristic(const ATile* T1, const ATile* T2)
+bool FHexGrid::FindReachableTiles(const FHex& Origin, int32 MaxDistance, FHexGridReachability& OutReachability) const
 {
-	if (T1 && T2)
+	OutReachability.Reset();
+
+	if (!Contains(Origin) || MaxDistance <= 0)
+	{
+		return false;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_HexGridFindReachableTiles);
+
+	// A hex range of N contains 3N(N+1)+1 cells, which is the most we can reach
+	const int32 MaxCells = 3 * MaxDistance * (MaxDistance + 1) + 1;
+	OutReachability.Hexes.Reserve(MaxCells);
+	OutReachability.Tiles.Reserve(MaxCells);
+	OutReachability.Steps.Reserve(MaxCells);
+	OutReachability.Predecessors.Reserve(MaxCells);
+	OutReachability.HexLookup.Reserve(MaxCells);
+
+	OutReachability.Origin = Origin;
+	OutReachability.Hexes.Add(Origin);
+	OutReachability.Tiles.Add(GetTile(Origin));
+	OutReachability.Steps.Add(0);
+	OutReachability.Predecessors.Add(INDEX_NONE);
+	OutReachability.HexLookup.Add(Origin, 0);
+
+	// The entries double as the queue, since every step is the same cost
+	// the entries will be ordered by amount of steps required to reach them
+	for (int32 Current = 0; Current < OutReachability.Hexes.Num(); ++Current)
 	{
-		return T1->GetSquaredDistanceTo(T2);
+		const int32 NextSteps = OutReachability.Steps[Current] + 1;
+		if (NextSteps > MaxDistance)
+		{
+			// Every entry after this one will also exceed max distance
+			break;
+		}
+
+		const FHex CurrentHex = OutReachability.Hexes[Current];
+		for (int32 i = 0; i < 6; ++i)
+		{
+			const FHex Neighbor = CurrentHex + HexDirection(i);
+			if (OutReachability.HexLookup.Contains(Neighbor) || IsHexBlocked(Neighbor))
+			{
+				continue;
+			}
+
+			int32 Index = OutReachability.Hexes.Add(Neighbor);
+			OutReachability.Tiles.Add(GetTile(Neighbor));
+			OutReachability.Steps.Add(NextSteps);
+			OutReachability.Predecessors.Add(Current);
+			OutReachability.HexLookup.Add(Neighbor, Index);
+		}
 	}
 
-	return MAX_FLT;
+	return OutReachability.Num() > 1;
+}
+
+bool FHexGrid::IsHexBlocked(const FHex& Hex) const
+{
+	const FHexGridCellState* CellState = GetCellState(Hex);
+	return !CellState || !CellState->IsWalkable();
 }
 
 bool FHexGrid::GetAllTilesWithinRange(const FHex& Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreOccupiedTiles) const
 {
-	OutTiles.Empty();
+	// Keep the callers allocation, as they are likely to query again
+	OutTiles.Reset();
 
 	// Invalid distance
 	if (Distance <= 0)
@@ -394,30 +729,21 @@ bool FHexGrid::GetAllTilesWithinRange(const FHex& Origin, int32 Distance, TArray
 
 	SCOPE_CYCLE_COUNTER(STAT_HexGridGetAllTilesWithinRange);
 
-	// Thanks to: https://www.redblobgames.com/grids/hexagons/#range for the fast for loop version
-	for (int32 x = -Distance; x <= Distance; ++x)
+	// Use cell states to avoid needing to check the tile itself
+	ForEachTileInRange(Origin, Distance, [&OutTiles, bIgnoreOccupiedTiles](ATile* Tile, const FHexGridCellState& State)->void
 	{
-		for (int32 y = FMath::Max(-Distance, -x - Distance); y <= FMath::Min(Distance, -x + Distance); ++y)
+		if (!bIgnoreOccupiedTiles || State.IsWalkable())
 		{
-			ATile* const* TilePtr = GridMap.Find(Origin + ConvertIndicesToHex(x, y));
-			if (TilePtr)
-			{
-				ATile* Tile = *TilePtr;
-
-				if (!bIgnoreOccupiedTiles || !Tile->IsTileOccupied())
-				{
-					OutTiles.Add(*TilePtr);
-				}
-			}
+			OutTiles.Add(Tile);
 		}
-	}
+	});
 
 	return OutTiles.Num() > 0;
 }
 
 bool FHexGrid::GetAllOccupiedTilesWithinRange(const FHex& Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreNullTiles, bool bIgnoreOrigin) const
 {
-	OutTiles.Empty();
+	OutTiles.Reset();
 
 	// Invalid distance
 	if (Distance <= 0)
@@ -427,28 +753,42 @@ bool FHexGrid::GetAllOccupiedTilesWithinRange(const FHex& Origin, int32 Distance
 
 	SCOPE_CYCLE_COUNTER(STAT_HexGridGetAllOccupiedTilesWithinRange);
 
-	// Thanks to: https://www.redblobgames.com/grids/hexagons/#range for the fast for loop version
-	for (int32 x = -Distance; x <= Distance; ++x)
+	const EHexGridCellFlags OccupiedFlags = bIgnoreNullTiles ? EHexGridCellFlags::Occupied : (EHexGridCellFlags::Null | EHexGridCellFlags::Occupied);
+
+	// Origin is always the first ring
+	for (int32 Radius = bIgnoreOrigin ? 1 : 0; Radius <= Distance; ++Radius)
 	{
-		for (int32 y = FMath::Max(-Distance, -x - Distance); y <= FMath::Min(Distance, -x + Distance); ++y)
+		ForEachTileInRing(Origin, Radius, [&OutTiles, OccupiedFlags](ATile* Tile, const FHexGridCellState& State)->void
 		{
-			ATile* const* TilePtr = GridMap.Find(Origin + ConvertIndicesToHex(x, y));
-			if (TilePtr)
+			if (EnumHasAnyFlags(State.Flags, OccupiedFlags))
 			{
-				ATile* Tile = *TilePtr;
+				OutTiles.Add(Tile);
+			}
+		});
+	}
 
-				if (bIgnoreOrigin && Tile->GetGridHexValue() == Origin)
-				{
-					continue;
-				}
+	return OutTiles.Num() > 0;
+}
 
-				if (Tile->IsTileOccupied(!bIgnoreNullTiles))
-				{
-					OutTiles.Add(*TilePtr);
-				}
-			}
-		}
+bool FHexGrid::GetAllTilesInRing(const FHex& Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreOccupiedTiles) const
+{
+	OutTiles.Reset();
+
+	// Invalid distance
+	if (Distance <= 0)
+	{
+		return false;
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_HexGridGetAllTilesInRing);
+
+	ForEachTileInRing(Origin, Distance, [&OutTiles, bIgnoreOccupiedTiles](ATile* Tile, const FHexGridCellState& State)->void
+	{
+		if (!bIgnoreOccupiedTiles || State.IsWalkable())
+		{
+			OutTiles.Add(Tile);
+		}
+	});
+
 	return OutTiles.Num() > 0;
 }
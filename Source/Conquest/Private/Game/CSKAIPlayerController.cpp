@@ -0,0 +1,482 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CSKAIPlayerController.h"
+#include "CSKGameMode.h"
+#include "CSKGameState.h"
+#include "CSKPlayerState.h"
+
+#include "BoardManager.h"
+#include "Castle.h"
+#include "ConquestModule.h"
+#include "SpellCard.h"
+#include "Tile.h"
+#include "TimerManager.h"
+#include "TowerConstructionData.h"
+#include "Async/Async.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("AIPlayerController CaptureMatchState"), STAT_AIPlayerControllerCaptureMatchState, STATGROUP_Conquest);
+DECLARE_CYCLE_STAT(TEXT("AIPlayerController FindSpellTarget"), STAT_AIPlayerControllerFindSpellTarget, STATGROUP_Conquest);
+
+ACSKAIPlayerController::ACSKAIPlayerController()
+{
+	bShowMouseCursor = false;
+	bPrecomputeSpellTargets = false;
+
+	TurnTimeBudget = 10.f;
+	NumSearchThreads = 2;
+	MaxSearchIterations = 0;
+	MaxPlayOutRounds = 20;
+	MaxBuildCandidates = 4;
+	ActionDelay = 0.5f;
+
+	bSimInitialized = false;
+	bWasActionPhase = false;
+	bHasPendingAction = false;
+	bEndActionPhaseRejected = false;
+	PendingActionDelay = 0.f;
+	RemainingTurnBudget = 0.f;
+	BlockedActionTypes = 0;
+	ActiveSearchID = 0;
+	NextSearchID = 1;
+}
+
+void ACSKAIPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	CancelSearch();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ACSKAIPlayerController::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// Replays act on our behalf, so we only fill the player slot while replaying
+	ACSKGameMode* GameMode = UConquestFunctionLibrary::GetCSKGameMode(this);
+	if (!GameMode || !GameMode->IsMatchInProgress() || GameMode->IsReplayingMatch())
+	{
+		return;
+	}
+
+	// We might have been asked to counter our opponents spell
+	SkipPendingSelections();
+
+	const bool bIsActionPhase = IsPerformingActionPhase();
+	if (bIsActionPhase != bWasActionPhase)
+	{
+		bWasActionPhase = bIsActionPhase;
+
+		CancelSearch();
+		bHasPendingAction = false;
+
+		RemainingTurnBudget = TurnTimeBudget;
+		BlockedActionTypes = 0;
+		bEndActionPhaseRejected = false;
+	}
+
+	// Wait for the previous action to finish before deciding on the next one
+	if (!bIsActionPhase || bEndActionPhaseRejected || GameMode->IsWaitingForAction() || ActiveSearchID != 0)
+	{
+		return;
+	}
+
+	if (bHasPendingAction)
+	{
+		PendingActionDelay -= DeltaTime;
+		if (PendingActionDelay <= 0.f)
+		{
+			bHasPendingAction = false;
+			PerformSearchAction(GameMode, PendingAction);
+		}
+	}
+	else
+	{
+		StartSearch(GameMode);
+	}
+}
+
+void ACSKAIPlayerController::Client_TransitionToCoinSequence_Implementation(ACoinSequenceActor* SequenceActor)
+{
+	GetWorldTimerManager().SetTimerForNextTick(this, &ACSKAIPlayerController::FinishTransitionSequence);
+}
+
+void ACSKAIPlayerController::Client_TransitionToBoard_Implementation()
+{
+	GetWorldTimerManager().SetTimerForNextTick(this, &ACSKAIPlayerController::FinishTransitionSequence);
+}
+
+void ACSKAIPlayerController::InitFromOptions(const FString& Options)
+{
+	if (UGameplayStatics::HasOption(Options, TEXT("AITurnBudget")))
+	{
+		TurnTimeBudget = FMath::Max(0.1f, FCString::Atof(*UGameplayStatics::ParseOption(Options, TEXT("AITurnBudget"))));
+	}
+
+	if (UGameplayStatics::HasOption(Options, TEXT("AIThreads")))
+	{
+		NumSearchThreads = FMath::Max(1, UGameplayStatics::GetIntOption(Options, TEXT("AIThreads"), NumSearchThreads));
+	}
+
+	if (UGameplayStatics::HasOption(Options, TEXT("AIActionDelay")))
+	{
+		ActionDelay = FMath::Max(0.f, FCString::Atof(*UGameplayStatics::ParseOption(Options, TEXT("AIActionDelay"))));
+	}
+}
+
+void ACSKAIPlayerController::FinishTransitionSequence()
+{
+	Server_TransitionSequenceFinished();
+}
+
+void ACSKAIPlayerController::SkipPendingSelections()
+{
+	if (bCanSelectNullifyQuickEffect || bCanSelectPostQuickEffect)
+	{
+		Server_SkipQuickEffectSelection();
+	}
+
+	if (bCanSelectBonusSpellTarget)
+	{
+		Server_SkipBonusSpellSelection();
+	}
+}
+
+bool ACSKAIPlayerController::CaptureMatchState(const ACSKGameMode* GameMode, FCSKSimMatchState& OutState) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_AIPlayerControllerCaptureMatchState);
+
+	check(GameMode);
+
+	const ACSKGameState* CSKGameState = UConquestFunctionLibrary::GetCSKGameState(this);
+	const ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
+	if (!CSKGameState || !BoardManager)
+	{
+		return false;
+	}
+
+	const ECSKRoundState RoundState = GameMode->GetRoundState();
+	if (RoundState != ECSKRoundState::FirstActionPhase && RoundState != ECSKRoundState::SecondActionPhase)
+	{
+		return false;
+	}
+
+	OutState.Cells = BoardManager->GetHexGrid().GetCellStates();
+	OutState.RoundState = RoundState;
+	OutState.StartingPlayerID = GameMode->GetStartingPlayersID();
+	OutState.NumRounds = CSKGameState->GetRound();
+	OutState.bActionPhaseInProgress = true;
+	OutState.TowerInstanceCounts.Init(0, SimRules.Towers.Num());
+
+	const TArray<TSubclassOf<UTowerConstructionData>>& AvailableTowers = GameMode->GetAvailableTowers();
+	const TArray<TSubclassOf<USpellCard>>& AvailableSpellCards = GameMode->GetAvailableSpellCards();
+
+	// Spell cards are tracked by their index in the rules
+	auto ConvertSpellCards = [&](const TArray<TSubclassOf<USpellCard>>& SpellCards, TArray<int32>& OutSpells)->void
+	{
+		OutSpells.Reset(SpellCards.Num());
+		for (const TSubclassOf<USpellCard>& SpellCard : SpellCards)
+		{
+			const int32 SpellIndex = SimRules.SpellCardIndices.Find(AvailableSpellCards.Find(SpellCard));
+			if (SpellIndex != INDEX_NONE)
+			{
+				OutSpells.Add(SpellIndex);
+			}
+		}
+	};
+
+	for (int32 i = 0; i < CSK_MAX_NUM_PLAYERS; ++i)
+	{
+		const ACSKPlayerController* Controller = GameMode->GetPlayers()[i];
+		const ACSKPlayerState* PlayerState = Controller ? Controller->GetCSKPlayerState() : nullptr;
+		const ACastle* Castle = Controller ? Controller->GetCastlePawn() : nullptr;
+		const ATile* CastleTile = Castle ? Castle->GetCachedTile() : nullptr;
+
+		if (!PlayerState || !CastleTile)
+		{
+			return false;
+		}
+
+		FCSKSimPlayerState& Player = OutState.Players[i];
+		Player.Gold = PlayerState->GetGold();
+		Player.Mana = PlayerState->GetMana();
+		Player.CastleHex = CastleTile->GetGridHexValue();
+		Player.TilesTraversedThisRound = PlayerState->GetTilesTraversedThisRound();
+		Player.SpellsCastThisRound = PlayerState->GetSpellsCastThisRound();
+
+		const FCSKTowerRegistry& TowerRegistry = PlayerState->GetOwnedTowerRegistry();
+		Player.NumNormalTowers = TowerRegistry.GetNumNormalTowers();
+		Player.NumLegendaryTowers = TowerRegistry.GetNumLegendaryTowers();
+		Player.TowerCounts.Init(0, SimRules.Towers.Num());
+
+		for (int32 TowerIndex = 0; TowerIndex < SimRules.Towers.Num(); ++TowerIndex)
+		{
+			const UTowerConstructionData* ConstructData = AvailableTowers[SimRules.Towers[TowerIndex].SourceIndex].GetDefaultObject();
+			const int32 NumInstances = TowerRegistry.GetNumInstances(ConstructData->TowerClass.Get());
+
+			Player.TowerCounts[TowerIndex] = NumInstances;
+			OutState.TowerInstanceCounts[TowerIndex] += NumInstances;
+		}
+
+		ConvertSpellCards(PlayerState->GetSpellCardsInHand(), Player.SpellsInHand);
+		ConvertSpellCards(PlayerState->GetSpellCardDeck(), Player.SpellDeck);
+
+		Player.Policy = ECSKSimPolicy::Greedy;
+	}
+
+	return true;
+}
+
+void ACSKAIPlayerController::StartSearch(const ACSKGameMode* GameMode)
+{
+	check(GameMode);
+	check(ActiveSearchID == 0);
+
+	// Rules and board only need to be copied once
+	if (!bSimInitialized)
+	{
+		SimRules.CopyFromGameMode(GameMode);
+		bSimInitialized = SimBoard.InitFromBoardManager(UConquestFunctionLibrary::GetMatchBoardManager(this));
+
+		if (!bSimInitialized)
+		{
+			UE_LOG(LogConquest, Warning, TEXT("ACSKAIPlayerController: Unable to initialize simulator board, ending action phase"));
+			TryEndActionPhase();
+			return;
+		}
+	}
+
+	if (!CaptureMatchState(GameMode, SearchState))
+	{
+		UE_LOG(LogConquest, Warning, TEXT("ACSKAIPlayerController: Unable to capture match state, ending action phase"));
+		TryEndActionPhase();
+		return;
+	}
+
+	// Later actions have less to choose from, so we only ever spend half of what remains
+	FCSKMatchSearchSettings Settings;
+	Settings.TimeBudget = FMath::Max(0.05f, RemainingTurnBudget * 0.5f);
+	Settings.MaxIterations = MaxSearchIterations;
+	Settings.NumThreads = NumSearchThreads;
+	Settings.MaxPlayOutRounds = MaxPlayOutRounds;
+	Settings.MaxBuildCells = MaxBuildCandidates;
+	Settings.ExcludedActionTypes = BlockedActionTypes;
+
+	RemainingTurnBudget = FMath::Max(0.f, RemainingTurnBudget - Settings.TimeBudget);
+
+	const uint32 SearchID = NextSearchID++;
+	if (NextSearchID == 0)
+	{
+		NextSearchID = 1;
+	}
+
+	ActiveSearchID = SearchID;
+	bAbortSearch = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>(false);
+
+	TWeakObjectPtr<ACSKAIPlayerController> WeakThis(this);
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> bAbort = bAbortSearch;
+	const int32 Seed = FMath::Rand();
+
+	// Searches keep every thread they use busy for their entire budget, so they run on their own pool rather than the task graph.
+	// Without a pool (no multithreading) the search runs on the game thread instead
+	FQueuedThreadPool* ThreadPool = IConquestModule::GetConquestModule().GetSearchThreadPool();
+
+	(new FAutoDeleteAsyncTask<FCSKMatchSearchTask>([WeakThis, SearchID, bAbort, Seed, Settings, ThreadPool, Rules = SimRules, Board = SimBoard, RootState = SearchState]()->void
+	{
+		if (*bAbort)
+		{
+			return;
+		}
+
+		FCSKMatchSearch Search(Rules, Board, Settings);
+		FCSKMatchSearchResult SearchResult = Search.Search(RootState, Seed, bAbort.Get(), ThreadPool);
+
+		// Results can only be applied on the game thread
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, SearchID, SearchResult]()->void
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnSearchFinished(SearchID, SearchResult);
+			}
+		});
+	}))->StartBackgroundTask(ThreadPool);
+}
+
+void ACSKAIPlayerController::TryEndActionPhase()
+{
+	Server_EndActionPhase();
+
+	// Searching again would most likely only end up here again, so we let the action phase time out instead
+	if (IsPerformingActionPhase())
+	{
+		const ACSKGameMode* GameMode = UConquestFunctionLibrary::GetCSKGameMode(this);
+		if (GameMode && GameMode->GetActionPhaseTime() <= 0)
+		{
+			UE_LOG(LogConquest, Warning, TEXT("ACSKAIPlayerController: Request to end action phase by Player %i was rejected, "
+				"but action phases never time out. Player will stay idle until the action phase ends"), CSKPlayerID + 1);
+		}
+		else
+		{
+			UE_LOG(LogConquest, Log, TEXT("ACSKAIPlayerController: Request to end action phase by Player %i was rejected, "
+				"waiting for action phase to time out"), CSKPlayerID + 1);
+		}
+
+		CancelSearch();
+		bHasPendingAction = false;
+		bEndActionPhaseRejected = true;
+	}
+}
+
+void ACSKAIPlayerController::CancelSearch()
+{
+	if (bAbortSearch.IsValid())
+	{
+		*bAbortSearch = true;
+		bAbortSearch.Reset();
+	}
+
+	ActiveSearchID = 0;
+}
+
+void ACSKAIPlayerController::OnSearchFinished(uint32 SearchID, const FCSKMatchSearchResult& SearchResult)
+{
+	// Search may have been cancelled
+	if (SearchID != ActiveSearchID)
+	{
+		return;
+	}
+
+	ActiveSearchID = 0;
+	bAbortSearch.Reset();
+
+	UE_LOG(LogConquest, Verbose, TEXT("ACSKAIPlayerController: Player %i searched %i iterations in %.2fs (expected value %.2f)"),
+		CSKPlayerID + 1, SearchResult.NumIterations, SearchResult.ElapsedTime, SearchResult.ExpectedValue);
+
+	// Ending our phase is always a valid fallback
+	PendingAction = SearchResult.bIsValid ? SearchResult.Action : FCSKSimAction();
+	PendingActionDelay = ActionDelay;
+	bHasPendingAction = true;
+}
+
+bool ACSKAIPlayerController::PerformSearchAction(ACSKGameMode* GameMode, const FCSKSimAction& Action)
+{
+	check(GameMode);
+
+	const ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
+	if (!BoardManager)
+	{
+		return false;
+	}
+
+	bool bRequested = false;
+
+	switch (Action.Type)
+	{
+		case ECSKSimActionType::EndActionPhase:
+		{
+			TryEndActionPhase();
+			return !bEndActionPhaseRejected;
+		}
+		case ECSKSimActionType::MoveCastle:
+		{
+			SetActionMode(ECSKActionPhaseMode::MoveCastle);
+			Server_RequestCastleMoveAction(FBoardTileHandle(Action.CellIndex));
+			bRequested = true;
+			break;
+		}
+		case ECSKSimActionType::BuildTower:
+		{
+			if (SimRules.Towers.IsValidIndex(Action.Index))
+			{
+				TSubclassOf<UTowerConstructionData> TowerData = GameMode->GetAvailableTowers()[SimRules.Towers[Action.Index].SourceIndex];
+
+				SetActionMode(ECSKActionPhaseMode::BuildTowers);
+				Server_RequestBuildTowerAction(TowerData, FBoardTileHandle(Action.CellIndex));
+				bRequested = true;
+			}
+
+			break;
+		}
+		case ECSKSimActionType::CastSpell:
+		{
+			const TArray<int32>& SpellsInHand = SearchState.Players[CSKPlayerID].SpellsInHand;
+			if (SpellsInHand.IsValidIndex(Action.Index))
+			{
+				TSubclassOf<USpellCard> SpellCard = GameMode->GetAvailableSpellCards()[SimRules.SpellCardIndices[SpellsInHand[Action.Index]]];
+
+				ATile* TargetTile = FindSpellTarget(SpellCard);
+				if (TargetTile)
+				{
+					SetActionMode(ECSKActionPhaseMode::CastSpell);
+					Server_RequestCastSpellAction(SpellCard, 0, BoardManager->GetTileHandle(TargetTile), 0);
+					bRequested = true;
+				}
+			}
+
+			break;
+		}
+	}
+
+	// Game mode only starts waiting once it has accepted the request
+	const bool bAccepted = bRequested && GameMode->IsWaitingForAction();
+	SetActionMode(ECSKActionPhaseMode::None);
+
+	if (!bAccepted)
+	{
+		UE_LOG(LogConquest, Log, TEXT("ACSKAIPlayerController: Request for action %i by Player %i was rejected, "
+			"ignoring action for the rest of the action phase"), static_cast<int32>(Action.Type), CSKPlayerID + 1);
+
+		BlockedActionTypes |= 1 << static_cast<uint8>(Action.Type);
+	}
+
+	return bAccepted;
+}
+
+ATile* ACSKAIPlayerController::FindSpellTarget(TSubclassOf<USpellCard> SpellCard) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_AIPlayerControllerFindSpellTarget);
+
+	const ACSKGameState* CSKGameState = UConquestFunctionLibrary::GetCSKGameState(this);
+	const ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
+	if (!CSKGameState || !BoardManager)
+	{
+		return nullptr;
+	}
+
+	const ACSKGameMode* GameMode = UConquestFunctionLibrary::GetCSKGameMode(this);
+	const ACSKPlayerController* Opponent = GameMode ? GameMode->GetOpposingPlayersController(CSKPlayerID) : nullptr;
+	const ACastle* OpponentCastle = Opponent ? Opponent->GetCastlePawn() : nullptr;
+	const ATile* OpponentTile = OpponentCastle ? OpponentCastle->GetCachedTile() : nullptr;
+
+	if (!OpponentTile)
+	{
+		return nullptr;
+	}
+
+	const FHexGrid::FHex OpponentHex = OpponentTile->GetGridHexValue();
+
+	ATile* BestTile = nullptr;
+	int32 BestDistance = MAX_int32;
+
+	// We never aim at null tiles, so skip them before asking each spell
+	FBoardTileMask CandidateMask = BoardManager->GetTileMask();
+	CandidateMask.RemoveBits(BoardManager->GetNullTileMask());
+
+	// Spell effects aren't simulated, so we aim for whatever is closest to our opponent
+	BoardManager->ForEachTileInMask(CandidateMask, [&](ATile* Tile)->void
+	{
+		const int32 Distance = FHexGrid::HexDisplacement(Tile->GetGridHexValue(), OpponentHex);
+		if (Distance < BestDistance && CSKGameState->CanPlayerCastSpell(this, Tile, SpellCard, 0, 0))
+		{
+			BestTile = Tile;
+			BestDistance = Distance;
+		}
+	});
+
+	return BestTile;
+}
@@ -1,6 +1,7 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "CSKGameMode.h"
+#include "CSKAIPlayerController.h"
 #include "CSKGameInstance.h"
 #include "CSKGameState.h"
 #include "CSKHUD.h"
@@ -25,10 +26,68 @@
 #include "TowerConstructionData.h"
 #include "WinnerSequenceActor.h"
 #include "Engine/Engine.h"
+#include "Engine/NetDriver.h"
 #include "Engine/World.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/Paths.h"
 
 #define LOCTEXT_NAMESPACE "CSKGameMode"
 
+uint64 FEndRoundActionSchedule::MakeSortKey(int32 Priority, bool bOwnedByStartingPlayer, uint32 InsertionOrder)
+{
+	// Flipping the sign bit keeps negative priorities ordered before positive ones
+	const uint64 PriorityBits = static_cast<uint64>(static_cast<uint32>(Priority) ^ 0x80000000u);
+	const uint64 PlayerBit = bOwnedByStartingPlayer ? 0 : 1;
+
+	return (PriorityBits << 32) | (PlayerBit << 31) | (InsertionOrder & 0x7FFFFFFFu);
+}
+
+void FEndRoundActionSchedule::Add(ATower* Tower, bool bOwnedByStartingPlayer)
+{
+	if (!ensure(Tower) || TowerKeys.Contains(Tower))
+	{
+		return;
+	}
+
+	const uint64 SortKey = MakeSortKey(Tower->GetEndRoundActionPriority(), bOwnedByStartingPlayer, NextInsertionOrder++);
+	TowerKeys.Add(Tower, SortKey);
+
+	// Keys are unique, so there will never be an entry with the same key
+	const int32 Index = LowerBound(SortKey);
+	Entries.Insert(FEndRoundActionEntry(Tower, SortKey), Index);
+}
+
+bool FEndRoundActionSchedule::Remove(ATower* Tower)
+{
+	uint64 SortKey = 0;
+	if (!TowerKeys.RemoveAndCopyValue(Tower, SortKey))
+	{
+		return false;
+	}
+
+	const int32 Index = LowerBound(SortKey);
+	if (ensure(Entries.IsValidIndex(Index) && Entries[Index].Tower == Tower))
+	{
+		Entries.RemoveAt(Index, 1, false);
+	}
+
+	return true;
+}
+
+void FEndRoundActionSchedule::Reset()
+{
+	Entries.Reset();
+	TowerKeys.Reset();
+	NextInsertionOrder = 0;
+}
+
+int32 FEndRoundActionSchedule::LowerBound(uint64 SortKey) const
+{
+	return Algo::LowerBoundBy(Entries, SortKey, [](const FEndRoundActionEntry& Entry)->uint64 { return Entry.SortKey; });
+}
+
 ACSKGameMode::ACSKGameMode()
 {
 	PrimaryActorTick.bCanEverTick = true;
@@ -46,6 +105,8 @@ ACSKGameMode::ACSKGameMode()
 	Player1CastleClass = ACastle::StaticClass();
 	Player2CastleClass = ACastle::StaticClass();
 	CastleAIControllerClass = ACastleAIController::StaticClass();
+	AIPlayerControllerClass = ACSKAIPlayerController::StaticClass();
+	NumAIPlayers = 0;
 
 	MatchState = ECSKMatchState::EnteringGame;
 	RoundState = ECSKRoundState::Invalid;
@@ -81,6 +142,20 @@ ACSKGameMode::ACSKGameMode()
 	InitialMatchDelay = 2.f;
 	PostMatchDelay = 15.f;
 
+	bRecordMatches = false;
+	ReplayTimeDilation = 20.f;
+	ReplayRequestIndex = 0;
+	ReplayStartTime = 0.0;
+	bIsReplayingMatch = false;
+	bIsFeedingReplayRequest = false;
+	bReplayStopped = false;
+	bReplayMatchedRecord = false;
+
+	bThrottleIdleServer = true;
+	IdleServerTickRate = 10;
+	ActiveServerTickRate = 0;
+	bServerTickThrottled = false;
+
 	PortalReachedSequenceClass = AWinnerSequenceActor::StaticClass();
 	CastleDestroyedSequenceClass = AWinnerSequenceActor::StaticClass();
 
@@ -98,6 +173,37 @@ void ACSKGameMode::InitGame(const FString& MapName, const FString& Options, FStr
 
 	Super::InitGame(MapName, Options, ErrorMessage);
 
+	// Players can be replaced with AI using options
+	if (UGameplayStatics::HasOption(Options, TEXT("AIPlayers")))
+	{
+		NumAIPlayers = FMath::Clamp(UGameplayStatics::GetIntOption(Options, TEXT("AIPlayers"), NumAIPlayers), 0, CSK_MAX_NUM_PLAYERS);
+	}
+
+	// Matches can be recorded or replayed using options
+	if (UGameplayStatics::HasOption(Options, TEXT("RecordMatch")))
+	{
+		bRecordMatches = true;
+	}
+
+	FString ReplayFilename = UGameplayStatics::ParseOption(Options, TEXT("Replay"));
+	if (!ReplayFilename.IsEmpty())
+	{
+		if (FPaths::IsRelative(ReplayFilename))
+		{
+			ReplayFilename = FCSKMatchRecord::GetRecordDirectory() / ReplayFilename;
+		}
+
+		FCSKMatchRecord Record;
+		if (Record.LoadFromFile(ReplayFilename))
+		{
+			StartReplay(Record);
+		}
+		else
+		{
+			UE_LOG(LogConquest, Warning, TEXT("ACSKGameMode: Failed to load match record %s for replay"), *ReplayFilename);
+		}
+	}
+
 	// Entering game is default state, we call it here anyways to fire off events
 	EnterMatchState(ECSKMatchState::EnteringGame);
 
@@ -125,6 +231,8 @@ void ACSKGameMode::StartPlay()
 		EnterMatchState(ECSKMatchState::WaitingPreMatch);
 	}
 
+	SpawnAIPlayers();
+
 	// We might be able to start immediately
 	if (ShouldStartMatch())
 	{
@@ -137,6 +245,25 @@ void ACSKGameMode::StartPlay()
 	}
 }
 
+void ACSKGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// The net driver persists through seamless travel
+	bThrottleIdleServer = false;
+	UpdateServerTickRate();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ACSKGameMode::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (bIsReplayingMatch)
+	{
+		TickReplay();
+	}
+}
+
 void ACSKGameMode::Logout(AController* Exiting)
 {
 	ACSKPlayerController* Controller = Cast<ACSKPlayerController>(Exiting);
@@ -227,6 +354,59 @@ void ACSKGameMode::PostEditChangeProperty(FPropertyChangedEvent& PropertyChanged
 }
 #endif
 
+void ACSKGameMode::SpawnAIPlayers()
+{
+	// AI players are still spawned while replaying, as replays only start once both players have joined.
+	// They stay idle for the replay, with the replay requesting actions on their behalf
+	if (NumAIPlayers <= 0 || !AIPlayerControllerClass)
+	{
+		return;
+	}
+
+	// Standalone treats every player controller as local, which AI players can't be
+	if (GetNetMode() == NM_Standalone)
+	{
+		UE_LOG(LogConquest, Warning, TEXT("ACSKGameMode: AI players require the match to be hosted (e.g. using the listen option)"));
+		return;
+	}
+
+	int32 NumFreeSlots = 0;
+	for (ACSKPlayerController* Controller : Players)
+	{
+		if (!Controller)
+		{
+			++NumFreeSlots;
+		}
+	}
+
+	const int32 NumToSpawn = FMath::Min(NumAIPlayers, NumFreeSlots);
+	for (int32 i = 0; i < NumToSpawn; ++i)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Instigator = Instigator;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		ACSKAIPlayerController* Controller = GetWorld()->SpawnActor<ACSKAIPlayerController>(AIPlayerControllerClass, SpawnParams);
+		if (!Controller)
+		{
+			UE_LOG(LogConquest, Warning, TEXT("ACSKGameMode: Failed to spawn AI player"));
+			break;
+		}
+
+		if (Controller->PlayerState)
+		{
+			Controller->PlayerState->bIsABot = true;
+			Controller->PlayerState->SetPlayerName(DefaultPlayerName.ToString());
+		}
+
+		Controller->InitFromOptions(OptionsString);
+
+		// AI players join the same way as everyone else
+		HandleStartingNewPlayer(Controller);
+	}
+}
+
 bool ACSKGameMode::IsMatchValid() const
 {
 	if (HasMatchStarted())
@@ -448,6 +628,8 @@ void ACSKGameMode::EnterMatchState(ECSKMatchState NewState)
 		{
 			CSKGameState->SetMatchState(NewState);
 		}
+
+		UpdateServerTickRate();
 	}
 }
 
@@ -494,6 +676,8 @@ void ACSKGameMode::EnterRoundState(ECSKRoundState NewState)
 		{
 			CSKGameState->SetRoundState(NewState);
 		}
+
+		UpdateServerTickRate();
 	}
 }
 
@@ -503,7 +687,7 @@ void ACSKGameMode::StartMatch()
 	{
 		// We start the match by going to the coin flip, this
 		// will also handle skipping the flip sequence if needed
-		EnterMatchStateAfterDelay(ECSKMatchState::CoinFlip, 2.f);
+		EnterMatchStateAfterDelay(ECSKMatchState::CoinFlip, GetMatchDelay(2.f));
 
 		// This could possibly be called from TryStartMatch
 		FTimerManager& TimerManager = GetWorldTimerManager();
@@ -717,6 +901,15 @@ void ACSKGameMode::OnCoinFlipStart()
 	PlayersAtCoinSequence = 0;
 	bExecutingCoinSequnce = false;
 
+	// Replays already know who won the coin toss
+	if (bIsReplayingMatch)
+	{
+		StartingPlayerID = ReplayRecord.StartingPlayerID;
+		EnterMatchStateAfterDelay(ECSKMatchState::Running, 0.f);
+
+		return;
+	}
+
 	// We need to find a sequence actor to use
 	CoinSequenceActor = UConquestFunctionLibrary::FindCoinSequenceActor(this);
 
@@ -745,17 +938,34 @@ void ACSKGameMode::OnCoinFlipStart()
 
 		// Force match to start
 		StartingPlayerID = GenerateCoinFlipWinner() ? 0 : 1;
-		EnterMatchStateAfterDelay(ECSKMatchState::Running, 2.f);
+		EnterMatchStateAfterDelay(ECSKMatchState::Running, GetMatchDelay(2.f));
 	}
 }
 
 void ACSKGameMode::OnMatchStart()
 {
-	SetActorTickEnabled(false);
+	// Replays are fed during tick
+	SetActorTickEnabled(bIsReplayingMatch);
+
+	// Towers are only built once the match has started
+	EndRoundActionSchedule.Reset();
 
 	// Give players the default resources
 	ResetResourcesForPlayers();
 
+	if (bRecordMatches)
+	{
+		MatchRecord.Reset(UWorld::RemovePIEPrefix(GetWorld()->GetMapName()));
+		MatchRecord.StartingPlayerID = StartingPlayerID;
+		MatchRecord.DeckReshuffleSeed = DeckReshuffleStream.GetInitialSeed();
+	}
+
+	if (bIsReplayingMatch)
+	{
+		UGameplayStatics::SetGlobalTimeDilation(this, ReplayTimeDilation);
+		ReplayStartTime = FPlatformTime::Seconds();
+	}
+
 	AWorldSettings* WorldSettings = GetWorldSettings();
 	WorldSettings->NotifyMatchStarted();
 
@@ -787,6 +997,29 @@ void ACSKGameMode::OnMatchFinished()
 	FTimerManager& TimerManager = GetWorldTimerManager();
 	TimerManager.ClearAllTimersForObject(this);
 
+	const uint32 FinalChecksum = CalculateMatchChecksum();
+
+	if (bRecordMatches)
+	{
+		MatchRecord.FinalChecksum = FinalChecksum;
+		SaveMatchRecord();
+	}
+
+	if (bIsReplayingMatch)
+	{
+		// Every request should have been replayed and the match should have ended the same way
+		bool bDesynced = ReplayRequestIndex < ReplayRecord.Requests.Num();
+		if (FinalChecksum != ReplayRecord.FinalChecksum)
+		{
+			UE_LOG(LogConquest, Error, TEXT("ACSKGameMode: Replay desynced as final checksum was %08x but %08x was recorded"),
+				FinalChecksum, ReplayRecord.FinalChecksum);
+
+			bDesynced = true;
+		}
+
+		StopReplay(bDesynced);
+	}
+
 	// Delay exiting so players can read post match states
 	EnterMatchStateAfterDelay(ECSKMatchState::LeavingGame, FMath::Max(1.f, PostMatchDelay));
 }
@@ -820,6 +1053,16 @@ void ACSKGameMode::OnMatchAbort()
 	FTimerManager& TimerManager = GetWorldTimerManager();
 	TimerManager.ClearAllTimersForObject(this);
 
+	// Aborted matches can still be useful for tracking down issues
+	if (bRecordMatches && IsMatchInProgress())
+	{
+		MatchRecord.FinalChecksum = CalculateMatchChecksum();
+		SaveMatchRecord();
+	}
+
+	// Replays can't finish without the match finishing
+	StopReplay(true);
+
 	OnFinishedWaitingPostMatch();
 }
 
@@ -862,7 +1105,7 @@ void ACSKGameMode::OnEndRoundPhaseStart()
 	// Clear from action phases
 	ClearHealthReports();
 
-	EndRoundRunningTower = 0;
+	EndRoundNextSortKey = 0;
 	bRunningTowerEndRoundAction = false;
 	bInitiatingTowerEndRoundAction = false;
 
@@ -926,6 +1169,8 @@ void ACSKGameMode::EnterRoundStateAfterDelay(ECSKRoundState NewState, float Dela
 		return;
 	}
 
+	Delay = GetMatchDelay(Delay);
+
 	FTimerManager& TimerManager = GetWorldTimerManager();
 	if (TimerManager.IsTimerActive(Handle_EnterRoundState))
 	{
@@ -1169,8 +1414,7 @@ void ACSKGameMode::DelayThenStartCollectionPhaseSequence()
 {
 	check(IsCollectionPhaseInProgress());
 
-	FTimerManager& TimerManager = GetWorldTimerManager();
-	TimerManager.SetTimer(Handle_CollectionSequences, this, &ACSKGameMode::StartCollectionPhaseSequence, 2.f);
+	SetMatchTimer(Handle_CollectionSequences, &ACSKGameMode::StartCollectionPhaseSequence, 2.f);
 }
 
 void ACSKGameMode::StartCollectionPhaseSequence()
@@ -1179,8 +1423,8 @@ void ACSKGameMode::StartCollectionPhaseSequence()
 
 	CollectResourcesForPlayers();
 
-	FTimerManager& TimerManager = GetWorldTimerManager();
-	TimerManager.SetTimer(Handle_CollectionSequences, this, &ACSKGameMode::ForceCollectionPhaseSequenceEnd, 10.f);
+	// Replays don't wait for players to finish their sequences
+	SetMatchTimer(Handle_CollectionSequences, &ACSKGameMode::ForceCollectionPhaseSequenceEnd, 10.f);
 }
 
 void ACSKGameMode::ForceCollectionPhaseSequenceEnd()
@@ -1193,7 +1437,15 @@ void ACSKGameMode::ForceCollectionPhaseSequenceEnd()
 
 void ACSKGameMode::ResetResourcesForPlayers()
 {
-	DeckReshuffleStream.GenerateNewSeed();
+	// Replays need to shuffle decks the same as the recorded match
+	if (bIsReplayingMatch)
+	{
+		DeckReshuffleStream.Initialize(ReplayRecord.DeckReshuffleSeed);
+	}
+	else
+	{
+		DeckReshuffleStream.GenerateNewSeed();
+	}
 
 	for (int32 i = 0; i < CSK_MAX_NUM_PLAYERS; ++i)
 	{
@@ -1323,7 +1575,7 @@ void ACSKGameMode::NotifyCollectionPhaseSequenceFinished(ACSKPlayerController* P
 
 bool ACSKGameMode::RequestEndActionPhase(bool bTimeOut)
 {
-	if (bWinnerSequenceActorSpawned)
+	if (bWinnerSequenceActorSpawned || IsRequestBlockedByReplay())
 	{
 		return false;
 	}
@@ -1346,6 +1598,7 @@ bool ACSKGameMode::RequestEndActionPhase(bool bTimeOut)
 		return false;
 	}
 
+	RecordRequest(ECSKRecordedRequestType::EndActionPhase, nullptr, nullptr, 0, 0, bTimeOut);
 	ActionPhaseActiveController->SetActionPhaseEnabled(false);
 
 	// Move onto next phase
@@ -1355,7 +1608,7 @@ bool ACSKGameMode::RequestEndActionPhase(bool bTimeOut)
 
 bool ACSKGameMode::RequestCastleMove(ATile* Goal)
 {
-	if (!Goal)
+	if (!Goal || IsRequestBlockedByReplay())
 	{
 		return false;
 	}
@@ -1411,11 +1664,15 @@ bool ACSKGameMode::RequestCastleMove(ATile* Goal)
 		ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
 		check(BoardManager);
 
-		// Confirm request if path is successfully found
-		FBoardPath OutBoardPath;
-		if (BoardManager->FindPath(Origin, Goal, OutBoardPath, false, TileSegments))
+		// Confirm request if goal is reachable. This is the same search the game state uses to highlight
+		// the tiles a player can move to, so any highlighted tile is accepted and we get its path for free
+		FHexGridReachability Reachability;
+		FBoardPath BoardPath;
+		if (BoardManager->GetReachableTiles(Origin, TileSegments, Reachability) &&
+			Reachability.GetPathTo(Goal->GetGridHexValue(), BoardPath.Path) && ConfirmCastleMove(BoardPath))
 		{
-			return ConfirmCastleMove(OutBoardPath);
+			RecordRequest(ECSKRecordedRequestType::CastleMove, Goal);
+			return true;
 		}
 	}
 
@@ -1424,7 +1681,7 @@ bool ACSKGameMode::RequestCastleMove(ATile* Goal)
 
 bool ACSKGameMode::RequestBuildTower(TSubclassOf<UTowerConstructionData> TowerTemplate, ATile* Tile)
 {
-	if (!Tile)
+	if (!Tile || IsRequestBlockedByReplay())
 	{
 		return false;
 	}
@@ -1493,9 +1750,10 @@ bool ACSKGameMode::RequestBuildTower(TSubclassOf<UTowerConstructionData> TowerTe
 
 		// Confirm request if tower was successfully spawned
 		ATower* NewTower = SpawnTowerFor(TowerClass, Tile, ConstructData, ActionPhaseActiveController->GetCSKPlayerState());
-		if (NewTower)
+		if (NewTower && ConfirmBuildTower(NewTower, Tile, ConstructData))
 		{
-			return ConfirmBuildTower(NewTower, Tile, ConstructData);
+			RecordRequest(ECSKRecordedRequestType::BuildTower, Tile, TowerTemplate);
+			return true;
 		}
 	}
 
@@ -1504,7 +1762,7 @@ bool ACSKGameMode::RequestBuildTower(TSubclassOf<UTowerConstructionData> TowerTe
 
 bool ACSKGameMode::RequestCastSpell(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, ATile* TargetTile, int32 AdditionalMana)
 {
-	if (!SpellCard.Get() || !TargetTile)
+	if (!SpellCard.Get() || !TargetTile || IsRequestBlockedByReplay())
 	{
 		return false;
 	}
@@ -1589,14 +1847,17 @@ bool ACSKGameMode::RequestCastSpell(TSubclassOf<USpellCard> SpellCard, int32 Spe
 		if (OpposingPlayerState && OpposingPlayerState->CanCastQuickEffectSpell(true))
 		{
 			SaveActionSpellRequestAndWaitForCounterSelection(SpellCard, SpellIndex, TargetTile, FinalCost, AdditionalMana);
+			RecordRequest(ECSKRecordedRequestType::CastSpell, TargetTile, SpellCard, SpellIndex, AdditionalMana);
+
 			return true;
 		}
 
 		// Confirm request of spell if successfully spawned
 		ASpellActor* SpellActor = SpawnSpellActor(DefaultSpell, TargetTile, FinalCost, AdditionalMana, PlayerState);
-		if (SpellActor)
+		if (SpellActor && ConfirmCastSpell(DefaultSpell, DefaultSpellCard, SpellActor, FinalCost, TargetTile, EActiveSpellContext::Action))
 		{
-			return ConfirmCastSpell(DefaultSpell, DefaultSpellCard, SpellActor, FinalCost, TargetTile, EActiveSpellContext::Action);
+			RecordRequest(ECSKRecordedRequestType::CastSpell, TargetTile, SpellCard, SpellIndex, AdditionalMana);
+			return true;
 		}
 	}
 
@@ -1605,7 +1866,7 @@ bool ACSKGameMode::RequestCastSpell(TSubclassOf<USpellCard> SpellCard, int32 Spe
 
 bool ACSKGameMode::RequestCastQuickEffect(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, ATile* TargetTile, int32 AdditionalMana)
 {
-	if (!SpellCard.Get() || !TargetTile)
+	if (!SpellCard.Get() || !TargetTile || IsRequestBlockedByReplay())
 	{
 		return false;
 	}
@@ -1721,11 +1982,12 @@ bool ACSKGameMode::RequestCastQuickEffect(TSubclassOf<USpellCard> SpellCard, int
 
 		// Confirm request of spell if successfully spawned
 		ASpellActor* SpellActor = SpawnSpellActor(DefaultSpell, TargetTile, FinalCost, AdditionalMana, PlayerState);
-		if (SpellActor)
+		// We only consume mana from active player if we are casting a nullify quick effect
+		if (SpellActor && ConfirmCastSpell(DefaultSpell, DefaultSpellCard, SpellActor, FinalCost, 
+			TargetTile, EActiveSpellContext::Counter, bWaitingOnPostQuickEffectSelection))
 		{
-			// We only consume mana from active player if we are casting a nullify quick effect
-			return ConfirmCastSpell(DefaultSpell, DefaultSpellCard, SpellActor, FinalCost, 
-				TargetTile, EActiveSpellContext::Counter, bWaitingOnPostQuickEffectSelection);
+			RecordRequest(ECSKRecordedRequestType::CastQuickEffect, TargetTile, SpellCard, SpellIndex, AdditionalMana);
+			return true;
 		}
 	}
 
@@ -1734,8 +1996,10 @@ bool ACSKGameMode::RequestCastQuickEffect(TSubclassOf<USpellCard> SpellCard, int
 
 bool ACSKGameMode::RequestSkipQuickEffect()
 {
-	if (IsActionPhaseInProgress() && (bWaitingOnNullifyQuickEffectSelection || bWaitingOnPostQuickEffectSelection))
+	if (!IsRequestBlockedByReplay() && IsActionPhaseInProgress() && (bWaitingOnNullifyQuickEffectSelection || bWaitingOnPostQuickEffectSelection))
 	{
+		RecordRequest(ECSKRecordedRequestType::SkipQuickEffect, nullptr);
+
 		if (bWaitingOnNullifyQuickEffectSelection)
 		{
 			ensure(ActivePlayerPendingSpellRequest.IsValid());
@@ -1768,7 +2032,7 @@ bool ACSKGameMode::RequestSkipQuickEffect()
 
 bool ACSKGameMode::RequestCastBonusSpell(ATile* TargetTile)
 {
-	if (!TargetTile)
+	if (!TargetTile || IsRequestBlockedByReplay())
 	{
 		return false;
 	}
@@ -1807,7 +2071,11 @@ bool ACSKGameMode::RequestCastBonusSpell(ATile* TargetTile)
 		if (SpellActor)
 		{
 			BonusSpellContext = ActiveSpellContext;
-			return ConfirmCastSpell(DefaultSpell, nullptr, SpellActor, 0, TargetTile, EActiveSpellContext::Bonus);
+			if (ConfirmCastSpell(DefaultSpell, nullptr, SpellActor, 0, TargetTile, EActiveSpellContext::Bonus))
+			{
+				RecordRequest(ECSKRecordedRequestType::CastBonusSpell, TargetTile);
+				return true;
+			}
 		}
 	}
 
@@ -1816,8 +2084,9 @@ bool ACSKGameMode::RequestCastBonusSpell(ATile* TargetTile)
 
 bool ACSKGameMode::RequestSkipBonusSpell()
 {
-	if (IsActionPhaseInProgress() && bWaitingOnBonusSpellSelection)
+	if (!IsRequestBlockedByReplay() && IsActionPhaseInProgress() && bWaitingOnBonusSpellSelection)
 	{
+		RecordRequest(ECSKRecordedRequestType::SkipBonusSpell, nullptr);
 		FinishCastSpell(true, true);
 		bWaitingOnBonusSpellSelection = false;
 
@@ -1827,6 +2096,344 @@ bool ACSKGameMode::RequestSkipBonusSpell()
 	return false;
 }
 
+bool ACSKGameMode::StartReplay(const FCSKMatchRecord& Record)
+{
+	if (HasMatchStarted())
+	{
+		UE_LOG(LogConquest, Warning, TEXT("ACSKGameMode::StartReplay: Unable to replay match as match has already started"));
+		return false;
+	}
+
+	ReplayRecord = Record;
+	ReplayRequestIndex = 0;
+	bIsReplayingMatch = true;
+	bReplayStopped = false;
+	bReplayMatchedRecord = false;
+
+	UE_LOG(LogConquest, Log, TEXT("Replaying match recorded on %s (%i requests)"), *Record.MapName, Record.Requests.Num());
+	return true;
+}
+
+uint32 ACSKGameMode::CalculateMatchChecksum() const
+{
+	TArray<int32, TInlineAllocator<32>> MatchValues;
+
+	ACSKGameState* CSKGameState = GetGameState<ACSKGameState>();
+	MatchValues.Add(CSKGameState ? CSKGameState->GetRound() : 0);
+	MatchValues.Add(static_cast<int32>(RoundState));
+	MatchValues.Add(CSKGameState ? CSKGameState->GetMatchWinnerPlayerID() : -1);
+
+	ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this, false);
+	MatchValues.Add(BoardManager ? static_cast<int32>(BoardManager->GetOccupancyVersion()) : 0);
+
+	for (const ACSKPlayerController* Controller : Players)
+	{
+		const ACSKPlayerState* PlayerState = Controller ? Controller->GetCSKPlayerState() : nullptr;
+		if (PlayerState)
+		{
+			MatchValues.Add(PlayerState->GetGold());
+			MatchValues.Add(PlayerState->GetMana());
+			MatchValues.Add(PlayerState->GetNumTowersOwned());
+			MatchValues.Add(PlayerState->GetNumSpellsInHand());
+		}
+
+		const ACastle* Castle = Controller ? Controller->GetCastlePawn() : nullptr;
+		if (Castle)
+		{
+			const ATile* CastleTile = Castle->GetCachedTile();
+			MatchValues.Add(Castle->GetHealthComponent()->GetHealth());
+			MatchValues.Add(CastleTile ? CastleTile->GetGridHexValue().X : 0);
+			MatchValues.Add(CastleTile ? CastleTile->GetGridHexValue().Y : 0);
+		}
+	}
+
+	return FCrc::MemCrc32(MatchValues.GetData(), MatchValues.Num() * sizeof(int32));
+}
+
+void ACSKGameMode::RecordRequest(ECSKRecordedRequestType Type, const ATile* Tile, UClass* Class, int32 SpellIndex, int32 AdditionalMana, bool bTimedOut)
+{
+	if (!bRecordMatches && !bIsReplayingMatch)
+	{
+		return;
+	}
+
+	ACSKGameState* CSKGameState = GetGameState<ACSKGameState>();
+	ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
+
+	FCSKRecordedRequest Request;
+	Request.Type = Type;
+	Request.PlayerID = ActionPhaseActiveController ? ActionPhaseActiveController->CSKPlayerID : -1;
+	Request.bTimedOut = bTimedOut;
+	Request.Round = CSKGameState ? CSKGameState->GetRound() : 0;
+	Request.TileIndex = BoardManager ? BoardManager->GetTileHandle(Tile).GetTileIndex() : INDEX_NONE;
+	Request.SpellIndex = SpellIndex;
+	Request.AdditionalMana = AdditionalMana;
+	Request.Checksum = CalculateMatchChecksum();
+
+	if (bIsReplayingMatch)
+	{
+		// Requests are only made by the replay, so this should be the request being replayed
+		const FCSKRecordedRequest* Expected = ReplayRecord.Requests.IsValidIndex(ReplayRequestIndex) ? &ReplayRecord.Requests[ReplayRequestIndex] : nullptr;
+		if (!Expected || Expected->Type != Request.Type || Expected->Checksum != Request.Checksum)
+		{
+			UE_LOG(LogConquest, Error, TEXT("ACSKGameMode: Replay desynced at request %i during round %i. Checksum was %08x but %08x was recorded"),
+				ReplayRequestIndex + 1, Request.Round, Request.Checksum, Expected ? Expected->Checksum : 0);
+
+			StopReplay(true);
+		}
+		else
+		{
+			++ReplayRequestIndex;
+		}
+	}
+
+	if (bRecordMatches)
+	{
+		Request.ClassIndex = MatchRecord.FindOrAddClass(Class);
+		MatchRecord.Requests.Add(Request);
+	}
+}
+
+void ACSKGameMode::TickReplay()
+{
+	ACSKGameState* CSKGameState = GetGameState<ACSKGameState>();
+	if (!IsMatchInProgress() || !CSKGameState)
+	{
+		return;
+	}
+
+	// Multiple requests can be replayed in a single frame
+	while (bIsReplayingMatch && ReplayRecord.Requests.IsValidIndex(ReplayRequestIndex))
+	{
+		const FCSKRecordedRequest& Request = ReplayRecord.Requests[ReplayRequestIndex];
+
+		// We have moved past the point this request was made
+		if (CSKGameState->GetRound() > Request.Round)
+		{
+			UE_LOG(LogConquest, Error, TEXT("ACSKGameMode: Replay desynced as request %i was not made during round %i"), 
+				ReplayRequestIndex + 1, Request.Round);
+
+			StopReplay(true);
+			return;
+		}
+
+		if (!CanReplayRequest(Request))
+		{
+			return;
+		}
+
+		const int32 RequestIndex = ReplayRequestIndex;
+		ReplayRequest(Request);
+
+		// Request would have advanced the replay if it was accepted
+		if (bIsReplayingMatch && ReplayRequestIndex == RequestIndex)
+		{
+			UE_LOG(LogConquest, Error, TEXT("ACSKGameMode: Replay desynced as request %i was denied"), RequestIndex + 1);
+
+			StopReplay(true);
+			return;
+		}
+	}
+}
+
+bool ACSKGameMode::CanReplayRequest(const FCSKRecordedRequest& Request) const
+{
+	ACSKGameState* CSKGameState = GetGameState<ACSKGameState>();
+	if (!CSKGameState || CSKGameState->GetRound() != Request.Round)
+	{
+		return false;
+	}
+
+	if (!IsActionPhaseInProgress() || !ActionPhaseActiveController || ActionPhaseActiveController->CSKPlayerID != Request.PlayerID)
+	{
+		return false;
+	}
+
+	switch (Request.Type)
+	{
+		case ECSKRecordedRequestType::CastQuickEffect:
+		case ECSKRecordedRequestType::SkipQuickEffect:
+		{
+			return bWaitingOnNullifyQuickEffectSelection || bWaitingOnPostQuickEffectSelection;
+		}
+		case ECSKRecordedRequestType::CastBonusSpell:
+		case ECSKRecordedRequestType::SkipBonusSpell:
+		{
+			return bWaitingOnBonusSpellSelection;
+		}
+		default:
+		{
+			// Castle might still be moving or a tower still being built
+			return !IsWaitingForAction();
+		}
+	}
+}
+
+void ACSKGameMode::ReplayRequest(const FCSKRecordedRequest& Request)
+{
+	ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
+	ATile* Tile = BoardManager ? BoardManager->GetTileFromHandle(FBoardTileHandle(Request.TileIndex)) : nullptr;
+
+	// Requests not made by the replay are rejected
+	bIsFeedingReplayRequest = true;
+
+	switch (Request.Type)
+	{
+		case ECSKRecordedRequestType::EndActionPhase:
+		{
+			RequestEndActionPhase(Request.bTimedOut);
+			break;
+		}
+		case ECSKRecordedRequestType::CastleMove:
+		{
+			RequestCastleMove(Tile);
+			break;
+		}
+		case ECSKRecordedRequestType::BuildTower:
+		{
+			RequestBuildTower(ReplayRecord.GetClass(Request.ClassIndex), Tile);
+			break;
+		}
+		case ECSKRecordedRequestType::CastSpell:
+		{
+			RequestCastSpell(ReplayRecord.GetClass(Request.ClassIndex), Request.SpellIndex, Tile, Request.AdditionalMana);
+			break;
+		}
+		case ECSKRecordedRequestType::CastQuickEffect:
+		{
+			RequestCastQuickEffect(ReplayRecord.GetClass(Request.ClassIndex), Request.SpellIndex, Tile, Request.AdditionalMana);
+			break;
+		}
+		case ECSKRecordedRequestType::SkipQuickEffect:
+		{
+			RequestSkipQuickEffect();
+			break;
+		}
+		case ECSKRecordedRequestType::CastBonusSpell:
+		{
+			RequestCastBonusSpell(Tile);
+			break;
+		}
+		case ECSKRecordedRequestType::SkipBonusSpell:
+		{
+			RequestSkipBonusSpell();
+			break;
+		}
+	}
+
+	bIsFeedingReplayRequest = false;
+}
+
+void ACSKGameMode::StopReplay(bool bDesynced)
+{
+	if (!bIsReplayingMatch)
+	{
+		return;
+	}
+
+	bIsReplayingMatch = false;
+	bReplayStopped = true;
+	bReplayMatchedRecord = !bDesynced;
+	UGameplayStatics::SetGlobalTimeDilation(this, 1.f);
+
+	const double ElapsedTime = FPlatformTime::Seconds() - ReplayStartTime;
+	if (bDesynced)
+	{
+		UE_LOG(LogConquest, Error, TEXT("Replay stopped after %i of %i requests (%.3fs)"), 
+			ReplayRequestIndex, ReplayRecord.Requests.Num(), ElapsedTime);
+	}
+	else
+	{
+		UE_LOG(LogConquest, Log, TEXT("Replay of %i requests finished in %.3fs"), ReplayRecord.Requests.Num(), ElapsedTime);
+	}
+}
+
+void ACSKGameMode::SaveMatchRecord() const
+{
+	const FString Filename = FCSKMatchRecord::GetRecordDirectory() / FString::Printf(TEXT("%s_%s.cskrecord"),
+		*MatchRecord.MapName, *FDateTime::Now().ToString());
+
+	if (MatchRecord.SaveToFile(Filename))
+	{
+		UE_LOG(LogConquest, Log, TEXT("Saved match record to %s (%i requests)"), *Filename, MatchRecord.Requests.Num());
+	}
+	else
+	{
+		UE_LOG(LogConquest, Warning, TEXT("ACSKGameMode: Failed to save match record to %s"), *Filename);
+	}
+}
+
+void ACSKGameMode::SetMatchTimer(FTimerHandle& Handle, void (ACSKGameMode::*Callback)(), float Delay)
+{
+	FTimerManager& TimerManager = GetWorldTimerManager();
+
+	Delay = GetMatchDelay(Delay);
+	if (Delay > 0.f)
+	{
+		TimerManager.SetTimer(Handle, this, Callback, Delay, false);
+	}
+	else
+	{
+		TimerManager.ClearTimer(Handle);
+		TimerManager.SetTimerForNextTick(this, Callback);
+	}
+}
+
+void ACSKGameMode::UpdateServerTickRate()
+{
+	// Listen servers render at their tick rate, so only dedicated servers are throttled
+	UNetDriver* NetDriver = GetNetDriver();
+	if (!NetDriver || GetNetMode() != NM_DedicatedServer)
+	{
+		return;
+	}
+
+	const bool bThrottle = bThrottleIdleServer && !bIsReplayingMatch && IsMatchIdle();
+	if (bThrottle == bServerTickThrottled)
+	{
+		return;
+	}
+
+	bServerTickThrottled = bThrottle;
+
+	// Dedicated servers limit both the world and net driver to this rate. Requests received while throttled wait for the next
+	// frame, so we never throttle while players are able to make requests, as the rate would only be restored after the fact
+	if (bServerTickThrottled)
+	{
+		ActiveServerTickRate = NetDriver->NetServerMaxTickRate;
+		NetDriver->NetServerMaxTickRate = FMath::Min(IdleServerTickRate, ActiveServerTickRate);
+	}
+	else
+	{
+		NetDriver->NetServerMaxTickRate = ActiveServerTickRate;
+	}
+
+	UE_LOG(LogConquest, Verbose, TEXT("ACSKGameMode: Server tick rate set to %i"), NetDriver->NetServerMaxTickRate);
+}
+
+bool ACSKGameMode::IsMatchIdle() const
+{
+	switch (MatchState)
+	{
+		case ECSKMatchState::CoinFlip:
+		case ECSKMatchState::WaitingPostMatch:
+		{
+			return true;
+		}
+		case ECSKMatchState::Running:
+		{
+			// Players can make requests at any time during action phases (including quick effects during their
+			// opponents action phase) and the end round phase runs sequences, leaving only the collection phase
+			return RoundState == ECSKRoundState::CollectionPhase;
+		}
+		default:
+		{
+			// Players are still joining (which sends plenty of packets) or the match is over
+			return false;
+		}
+	}
+}
+
 ASpellActor* ACSKGameMode::CastSubSpellForActiveSpell(TSubclassOf<USpell> SubSpell, ATile* TargetTile, int32 AdditionalMana, int32 OverrideCost)
 {
 	if (!SubSpell || !TargetTile)
@@ -1913,9 +2520,18 @@ ASpellActor* ACSKGameMode::CastSubSpellForActiveSpell(TSubclassOf<USpell> SubSpe
 		DelayedCallback.BindUObject(this, &ACSKGameMode::OnStartSubSpellCast, SpellActor);
 
 		// Give the sub spell some time to replicate
-		FTimerHandle TempHandle;
 		FTimerManager& TimerManager = GetWorldTimerManager();
-		TimerManager.SetTimer(TempHandle, DelayedCallback, .5f, false);
+
+		const float Delay = GetMatchDelay(.5f);
+		if (Delay > 0.f)
+		{
+			FTimerHandle TempHandle;
+			TimerManager.SetTimer(TempHandle, DelayedCallback, Delay, false);
+		}
+		else
+		{
+			TimerManager.SetTimerForNextTick(DelayedCallback);
+		}
 	}
 
 	return SpellActor;
@@ -2211,7 +2827,7 @@ bool ACSKGameMode::ConfirmBuildTower(ATower* Tower, ATile* Tile, UTowerConstruct
 			{
 				// We will pass the target tile instead of the new tower,
 				// as we don't know if tower will replicate in time
-				Controller->Client_OnTowerBuildRequestConfirmed(Tile);
+				Controller->Client_OnTowerBuildRequestConfirmed(Controller->GetTileHandle(Tile));
 			}
 		}
 	}
@@ -2225,8 +2841,7 @@ bool ACSKGameMode::ConfirmBuildTower(ATower* Tower, ATile* Tile, UTowerConstruct
 	ActivePlayerPendingTowerTile = Tile;
 
 	// Give tower 2 seconds to replicate
-	FTimerManager& TimerManager = GetWorldTimerManager();
-	TimerManager.SetTimer(Handle_ActivePlayerStartBuildSequence, this, &ACSKGameMode::OnStartActivePlayersBuildSequence, 2.f, false);
+	SetMatchTimer(Handle_ActivePlayerStartBuildSequence, &ACSKGameMode::OnStartActivePlayersBuildSequence, 2.f);
 
 	return true;
 }
@@ -2445,7 +3060,7 @@ bool ACSKGameMode::ConfirmCastSpell(USpell* Spell, USpellCard* SpellCard, ASpell
 			if (Controller)
 			{
 				// We will pass the target tile so players can focus on the target point first
-				Controller->Client_OnCastSpellRequestConfirmed(Context, Tile);
+				Controller->Client_OnCastSpellRequestConfirmed(Context, Controller->GetTileHandle(Tile));
 			}
 		}
 	}
@@ -2457,8 +3072,7 @@ bool ACSKGameMode::ConfirmCastSpell(USpell* Spell, USpellCard* SpellCard, ASpell
 	ActiveSpellContext = Context;
 
 	// Give spell half a second to replicate
-	FTimerManager& TimerManager = GetWorldTimerManager();
-	TimerManager.SetTimer(Handle_ExecuteSpellCast, this, &ACSKGameMode::OnStartActiveSpellCast, .5f, false);
+	SetMatchTimer(Handle_ExecuteSpellCast, &ACSKGameMode::OnStartActiveSpellCast, .5f);
 
 	return true;
 }
@@ -2859,7 +3473,7 @@ void ACSKGameMode::OnStartWaitForCounterSelection(bool bNullify, TSubclassOf<USp
 	}
 
 	// Notify the opposing player to select a counter spell;
-	OpposingController->Client_OnSelectCounterSpell(bNullify, SpellToCounter, TargetTile);
+	OpposingController->Client_OnSelectCounterSpell(bNullify, SpellToCounter, OpposingController->GetTileHandle(TargetTile));
 
 	// Notify the active player to wait
 	ActionPhaseActiveController->Client_OnWaitForCounterSpell(bNullify);
@@ -2873,6 +3487,19 @@ void ACSKGameMode::OnStartWaitForCounterSelection(bool bNullify, TSubclassOf<USp
 
 
 
+void ACSKGameMode::NotifyTowerAdded(const ACSKPlayerState* Owner, ATower* Tower)
+{
+	if (Owner && Tower)
+	{
+		EndRoundActionSchedule.Add(Tower, Owner->GetCSKPlayerID() == StartingPlayerID);
+	}
+}
+
+void ACSKGameMode::NotifyTowerRemoved(ATower* Tower)
+{
+	EndRoundActionSchedule.Remove(Tower);
+}
+
 void ACSKGameMode::NotifyEndRoundActionFinished(ATower* Tower)
 {
 	if ((bRunningTowerEndRoundAction || bInitiatingTowerEndRoundAction) && Tower)
@@ -2886,27 +3513,10 @@ void ACSKGameMode::NotifyEndRoundActionFinished(ATower* Tower)
 			return;
 		}
 
-		// If we should end the end round phase and move back onto the collection phase
-		bool bEndPhase = false;
-
-		if (ensure(EndRoundActionTowers.IsValidIndex(EndRoundRunningTower)))
-		{
-			// Double check
-			//check(EndRoundActionTowers[EndRoundRunningTower] == Tower);
-			bRunningTowerEndRoundAction = false;
-		}
-		else
-		{
-			UE_LOG(LogConquest, Warning, TEXT("ACSKGameMode: Index of tower executing end round action is invalid. Forcing end of end round phase"));
-			bEndPhase = true;
-		}
+		bRunningTowerEndRoundAction = false;
 
 		// End phase if no more towers are awaiting action execution
-		if (!bEndPhase)
-		{
-			++EndRoundRunningTower;
-			bEndPhase = EndRoundRunningTower == EndRoundActionTowers.Num();
-		}
+		bool bEndPhase = EndRoundActionSchedule.LowerBound(EndRoundNextSortKey) == EndRoundActionSchedule.Num();
 
 		if (bEndPhase)
 		{
@@ -2925,146 +3535,83 @@ void ACSKGameMode::NotifyEndRoundActionFinished(ATower* Tower)
 	}
 }
 
-// TODO: Optomize by associating towers with a CSKPlayerID before sorting
-// right now, the sorting predicate will constantly use get player state which involes casting
 bool ACSKGameMode::PrepareEndRoundActionTowers()
 {
-	// We will most likely have the same amount of tiles as last round
-	// (Maybe one or two towers were added since the last round)
-	TArray<ATower*> ActionTowers;
-	ActionTowers.Reserve(EndRoundActionTowers.Num());
-
-	// First get all towers that will run an action this round
-	for (ACSKPlayerController* Controller : Players)
+	// Schedule is already sorted, we only need to know if any tower will run an action this round
+	for (const FEndRoundActionEntry& Entry : EndRoundActionSchedule.GetEntries())
 	{
-		if (Controller)
-		{
-			ACSKPlayerState* PlayerState = Controller->GetCSKPlayerState();
-			check(PlayerState);
-
-			const TArray<ATower*>& PlayerTower = PlayerState->GetOwnedTowers();
-			for (ATower* Tower : PlayerTower)
-			{
-				// TODO: We might not need to check WantsEndRoundPhaseEvent here anymore!
-				if (ensure(Tower) && Tower->WantsEndRoundPhaseEvent())
-				{
-					ActionTowers.Add(Tower);
-				}
-			}
-		}
-	}
-
-	// If two towers happen to share the same priority, we decide
-	// who goes first based on the player who won the coin toss 
-	int32 PlayerWithPriority = StartingPlayerID;
-
-	// Now sort action towers based on their priority
-	ActionTowers.Sort([PlayerWithPriority](const ATower& lhs, const ATower& rhs)->bool
-	{
-		int32 T1Priority = lhs.GetEndRoundActionPriority();
-		int32 T2Priority = rhs.GetEndRoundActionPriority();
-
-		if (T1Priority < T2Priority)
+		if (ensure(Entry.Tower) && Entry.Tower->WantsEndRoundPhaseEvent())
 		{
 			return true;
 		}
-		else if (T1Priority > T2Priority)
-		{
-			return false;
-		}
-		else
-		{
-			ACSKPlayerState* T1PlayerState = lhs.GetBoardPieceOwnerPlayerState();
-			if (T1PlayerState->GetCSKPlayerID() == PlayerWithPriority)
-			{
-				// Starting player always takes priority
-				return true;
-			}
-			else
-			{
-				ACSKPlayerState* T2PlayerState = lhs.GetBoardPieceOwnerPlayerState();
-				return T2PlayerState->GetCSKPlayerID() != PlayerWithPriority;
-			}
-		}
-	});
+	}
 
-	// We can perform end round phase if there are any towers that can perform an action
-	EndRoundActionTowers = MoveTemp(ActionTowers);
-	return EndRoundActionTowers.Num() > 0;
+	return false;
 }
 
-bool ACSKGameMode::StartRunningTowersEndRoundAction(int32 Index)
+bool ACSKGameMode::StartNextTowersEndRoundAction()
 {
-	bool bResult = false;
+	ATower* TowerToRun = nullptr;
 
 	// Safety lock
 	bInitiatingTowerEndRoundAction = true;
 
-	if (!bRunningTowerEndRoundAction && EndRoundActionTowers.IsValidIndex(Index))
+	if (!bRunningTowerEndRoundAction)
 	{
 		check(IsEndRoundPhaseInProgress());
 
-		// This tower might not need to perform it's end round anymore,
-		// this could be due to another action affecting it's calculations
-		ATower* TowerToRun = EndRoundActionTowers[Index];
-		if (!TowerToRun->WantsEndRoundPhaseEvent())
+		// Towers might not need to perform their end round anymore, this could be due to
+		// another action affecting their calculations. Keep cycling till we reach one that does
+		for (int32 Index = EndRoundActionSchedule.LowerBound(EndRoundNextSortKey); Index < EndRoundActionSchedule.Num(); ++Index)
 		{
-			TowerToRun = nullptr;
+			const FEndRoundActionEntry& Entry = EndRoundActionSchedule[Index];
+			EndRoundNextSortKey = Entry.SortKey + 1;
 
-			// Keep cycling through each tower till we reach the next tower that can
-			while (EndRoundActionTowers.IsValidIndex(++Index))
+			if (Entry.Tower && Entry.Tower->WantsEndRoundPhaseEvent())
 			{
-				ATower* Tower = EndRoundActionTowers[Index];
-				if (Tower->WantsEndRoundPhaseEvent())
-				{
-					TowerToRun = Tower;
-					break;
-				}
+				TowerToRun = Entry.Tower;
+
+				UE_LOG(LogConquest, Log, TEXT("Executing end round action for Tower %s. Action index = %i"),
+					*TowerToRun->GetFName().ToString(), Index + 1);
+
+				break;
 			}
 		}
 
-		// Possibility of TowerToRun being null (meaning it or remaining towers no longer need it)
+		// Possibility of TowerToRun being null (meaning remaining towers no longer need it)
 		if (TowerToRun)
 		{
-			UE_LOG(LogConquest, Log, TEXT("Executing end round action for Tower %s. Action index = %i"), 
-				*TowerToRun->GetFName().ToString(), Index + 1);
-
 			// We can track any damage or healing applied (some towers may use it)
 			CacheAndClearHealthReports();
 
-			TowerToRun->ExecuteEndRoundPhaseAction();
 			bRunningTowerEndRoundAction = true;
-
-			// Track this for use when this towers action ends
-			EndRoundRunningTower = Index;
-
-			bResult = true;
+			TowerToRun->ExecuteEndRoundPhaseAction();
 		}
 	}
 
 	// Safety lock
 	bInitiatingTowerEndRoundAction = false;
 
-	if (bResult)
+	if (TowerToRun)
 	{
-		check(EndRoundActionTowers.IsValidIndex(EndRoundRunningTower));
-
 		// Notify players to concentrate on tower
-		ATile* TileWithTower = EndRoundActionTowers[EndRoundRunningTower]->GetCachedTile();
+		ATile* TileWithTower = TowerToRun->GetCachedTile();
 		for (ACSKPlayerController* Controller : Players)
 		{
 			if (Controller)
 			{
-				Controller->Client_OnTowerActionStart(TileWithTower);
+				Controller->Client_OnTowerActionStart(Controller->GetTileHandle(TileWithTower));
 			}
 		}
 	}
 
-	return bResult;
+	return TowerToRun != nullptr;
 }
 
 void ACSKGameMode::StartNextEndRoundActionAfterDelay(float Delay)
 {
+	Delay = GetMatchDelay(Delay);
+
 	if (IsEndRoundPhaseInProgress())
 	{
 		if (bRunningTowerEndRoundAction)
@@ -3093,7 +3640,7 @@ void ACSKGameMode::StartNextEndRoundActionAfterDelay(float Delay)
 
 void ACSKGameMode::OnStartNextEndRoundAction()
 {
-	if (IsEndRoundPhaseInProgress() && !StartRunningTowersEndRoundAction(EndRoundRunningTower))
+	if (IsEndRoundPhaseInProgress() && !StartNextTowersEndRoundAction())
 	{
 		EnterRoundStateAfterDelay(ECSKRoundState::CollectionPhase, 1.f);
 	}
@@ -3157,7 +3704,7 @@ void ACSKGameMode::OnBoardPieceHealthChanged(UHealthComponent* HealthComp, int32
 		{
 			ATower* DestroyedTower = CastChecked<ATower>(CompOwner);
 
-			// Remove references from both board and player
+			// Remove references from both board and player (which removes it from end round phase actions)
 			{
 				ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
 				BoardManager->ClearBoardPieceOnTile(DestroyedTower->GetCachedTile());
@@ -3177,31 +3724,12 @@ void ACSKGameMode::OnBoardPieceHealthChanged(UHealthComponent* HealthComp, int32
 				CSKGameState->HandleTowerDestroyed(DestroyedTower, false);
 			}
 
-			// We need to make sure this tower is removed from end round phase actions
-			if (IsEndRoundPhaseInProgress())
+			if (IsEndRoundPhaseInProgress() && DestroyedTower->IsExecutingEndRoundAction())
 			{
-				// This tower could possibly be a tower with an end round action
-				int32 Index = EndRoundActionTowers.Find(DestroyedTower);
-				if (Index != -1)
-				{
-					if (Index == EndRoundRunningTower)
-					{
-						check(EndRoundActionTowers[Index] == DestroyedTower);
-						UE_LOG(LogConquest, Warning, TEXT("Tower %s has destroyed itself during it's action. "
-							"Is this intended?"), *DestroyedTower->GetFName().ToString());
+				UE_LOG(LogConquest, Warning, TEXT("Tower %s has destroyed itself during it's action. "
+					"Is this intended?"), *DestroyedTower->GetFName().ToString());
 
-						// We let this tower finish it's execution
-					}
-
-					// We need to revert the index back one if this tower has already,
-					// executed as not doing so will skip one towers end round action
-					if (Index >= EndRoundRunningTower)
-					{
-						--EndRoundRunningTower;
-					}
-
-					EndRoundActionTowers.RemoveAt(Index);
-				}
+				// We let this tower finish it's execution
 			}
 
 			// Cache this tower to be destroyed after the current action
@@ -3235,25 +3763,36 @@ void ACSKGameMode::OnBoardPieceHealthChanged(UHealthComponent* HealthComp, int32
 
 void ACSKGameMode::ClearHealthReports()
 {
-	ActiveActionHealthReports.Empty();
-	PreviousActionHealthReports.Empty();
+	ActiveActionHealthReports.Reset();
 
 	ACSKGameState* CSKGameState = CastChecked<ACSKGameState>(GameState);
 	if (CSKGameState)
 	{
-		CSKGameState->SetLatestActionHealthReports(PreviousActionHealthReports);
+		CSKGameState->ClearLatestActionHealthReports();
 	}
 }
 
 void ACSKGameMode::CacheAndClearHealthReports()
 {
-	PreviousActionHealthReports = MoveTemp(ActiveActionHealthReports);
-
 	ACSKGameState* CSKGameState = CastChecked<ACSKGameState>(GameState);
 	if (CSKGameState)
 	{
-		CSKGameState->SetLatestActionHealthReports(PreviousActionHealthReports);
+		// Game state takes ownership of the reports
+		CSKGameState->SetLatestActionHealthReports(MoveTemp(ActiveActionHealthReports));
+	}
+
+	ActiveActionHealthReports.Reset();
+}
+
+TArray<FHealthChangeReport> ACSKGameMode::GetPreviousActionHealthReports() const
+{
+	const ACSKGameState* CSKGameState = GetGameState<ACSKGameState>();
+	if (CSKGameState)
+	{
+		return CSKGameState->GetLatestActionHealthReports();
 	}
+
+	return TArray<FHealthChangeReport>();
 }
 
 void ACSKGameMode::ClearDestroyedTowers()
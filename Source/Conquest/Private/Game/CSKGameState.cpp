@@ -17,6 +17,184 @@
 #include "Engine/World.h"
 
 DECLARE_CYCLE_STAT(TEXT("ACSKGameState GetTilesPlayerCanMoveTo Pathfind"), STAT_CSKGameStateGetTilesPlayerCanMoveToPathfind, STATGROUP_Conquest);
+DECLARE_CYCLE_STAT(TEXT("ACSKGameState Update Buildable Towers"), STAT_CSKGameStateUpdateBuildableTowers, STATGROUP_Conquest);
+
+const TBitArray<> ACSKGameState::EmptyBuildableTowers;
+
+namespace HealthReports
+{
+	bool AreReportsEqual(const FHealthChangeReport& Lhs, const FHealthChangeReport& Rhs)
+	{
+		return Lhs.Building == Rhs.Building && Lhs.Owner == Rhs.Owner && Lhs.Delta == Rhs.Delta &&
+			Lhs.bIsCastle == Rhs.bIsCastle && Lhs.bWasDamaged == Rhs.bWasDamaged && Lhs.bKilled == Rhs.bKilled;
+	}
+}
+
+void FHealthReportItem::PreReplicatedRemove(const FHealthReportArray& InArraySerializer)
+{
+	InArraySerializer.MarkPartitionsDirty();
+}
+
+void FHealthReportItem::PostReplicatedAdd(const FHealthReportArray& InArraySerializer)
+{
+	InArraySerializer.MarkPartitionsDirty();
+}
+
+void FHealthReportItem::PostReplicatedChange(const FHealthReportArray& InArraySerializer)
+{
+	// This will also be called once the building or owner has resolved
+	InArraySerializer.MarkPartitionsDirty();
+}
+
+void FHealthReportArray::SetReports(TArray<FHealthChangeReport>&& InReports)
+{
+	// Items are kept in partition order, so similar actions reuse the same slots
+	InReports.StableSort([](const FHealthChangeReport& Lhs, const FHealthChangeReport& Rhs)
+	{
+		return GetPartition(Lhs) < GetPartition(Rhs);
+	});
+
+	// Reuse existing items so only the reports that have changed are replicated
+	const int32 NumReports = InReports.Num();
+	if (Items.Num() > NumReports)
+	{
+		Items.RemoveAt(NumReports, Items.Num() - NumReports, false);
+		MarkArrayDirty();
+	}
+
+	for (int32 i = 0; i < NumReports; ++i)
+	{
+		const FHealthChangeReport& Report = InReports[i];
+		if (Items.IsValidIndex(i))
+		{
+			if (!HealthReports::AreReportsEqual(Items[i].Report, Report))
+			{
+				Items[i].Report = Report;
+				MarkItemDirty(Items[i]);
+			}
+		}
+		else
+		{
+			int32 Index = Items.Add(FHealthReportItem(Report));
+			MarkItemDirty(Items[Index]);
+		}
+	}
+
+	BuildPartitions();
+	++Version;
+}
+
+void FHealthReportArray::ClearReports()
+{
+	if (Items.Num() > 0)
+	{
+		Items.Reset();
+		MarkArrayDirty();
+	}
+
+	BuildPartitions();
+	++Version;
+}
+
+FHealthReportView FHealthReportArray::Query(bool bDamaged, const ACSKPlayerState* InOwner, bool bExcludeDead) const
+{
+	UpdatePartitions();
+
+	// Types are partitioned as damaged, killed then healed
+	const int32 FirstType = bDamaged ? 0 : 2;
+	const int32 LastType = bDamaged && !bExcludeDead ? 1 : FirstType;
+
+	if (!InOwner)
+	{
+		// Partitions of a type for every owner are next to each other
+		return FHealthReportView(Items, GetPartitionRange(FirstType * NumOwnerSlots, (LastType + 1) * NumOwnerSlots - 1),
+			TArrayView<const int32>());
+	}
+
+	// The last owner slot is shared by every report without a valid owner, so isn't for any player
+	const int32 PlayerID = InOwner->GetCSKPlayerID();
+	if (PlayerID < 0 || PlayerID >= CSK_MAX_NUM_PLAYERS)
+	{
+		return FHealthReportView();
+	}
+
+	const int32 FirstPartition = FirstType * NumOwnerSlots + PlayerID;
+	const int32 LastPartition = LastType * NumOwnerSlots + PlayerID;
+
+	return FHealthReportView(Items, GetPartitionRange(FirstPartition, FirstPartition), LastPartition != FirstPartition ?
+		GetPartitionRange(LastPartition, LastPartition) : TArrayView<const int32>());
+}
+
+void FHealthReportArray::BuildPartitions() const
+{
+	const int32 NumReports = Items.Num();
+	int32 Counts[NumPartitions] = { 0 };
+
+	TArray<int32, TInlineAllocator<32>> ItemPartitions;
+	ItemPartitions.SetNumUninitialized(NumReports);
+
+	for (int32 i = 0; i < NumReports; ++i)
+	{
+		const int32 Partition = GetPartition(Items[i].Report);
+		ItemPartitions[i] = Partition;
+		++Counts[Partition];
+	}
+
+	PartitionStarts[0] = 0;
+	for (int32 i = 0; i < NumPartitions; ++i)
+	{
+		PartitionStarts[i + 1] = PartitionStarts[i] + Counts[i];
+	}
+
+	int32 Offsets[NumPartitions];
+	FMemory::Memcpy(Offsets, PartitionStarts, sizeof(Offsets));
+
+	// Items are placed in the order they were recieved within each partition
+	PartitionedIndices.SetNumUninitialized(NumReports, false);
+	for (int32 i = 0; i < NumReports; ++i)
+	{
+		PartitionedIndices[Offsets[ItemPartitions[i]]++] = i;
+	}
+
+	bPartitionsDirty = false;
+}
+
+void FHealthReportArray::UpdatePartitions() const
+{
+	if (bPartitionsDirty)
+	{
+		BuildPartitions();
+	}
+}
+
+TArrayView<const int32> FHealthReportArray::GetPartitionRange(int32 FirstPartition, int32 LastPartition) const
+{
+	check(FirstPartition >= 0 && LastPartition < NumPartitions && FirstPartition <= LastPartition);
+
+	const int32 Start = PartitionStarts[FirstPartition];
+	return TArrayView<const int32>(PartitionedIndices.GetData() + Start, PartitionStarts[LastPartition + 1] - Start);
+}
+
+int32 FHealthReportArray::GetPartition(const FHealthChangeReport& Report)
+{
+	return GetTypeIndex(Report) * NumOwnerSlots + GetOwnerSlot(Report.Owner);
+}
+
+int32 FHealthReportArray::GetOwnerSlot(const ACSKPlayerState* InOwner)
+{
+	const int32 PlayerID = InOwner ? InOwner->GetCSKPlayerID() : -1;
+	return PlayerID >= 0 && PlayerID < CSK_MAX_NUM_PLAYERS ? PlayerID : NumOwnerSlots - 1;
+}
+
+int32 FHealthReportArray::GetTypeIndex(const FHealthChangeReport& Report)
+{
+	if (!Report.bWasDamaged)
+	{
+		return 2;
+	}
+
+	return Report.bKilled ? 1 : 0;
+}
 
 ACSKGameState::ACSKGameState()
 {
@@ -45,6 +223,16 @@ ACSKGameState::ACSKGameState()
 	MaxTileMovements = 2;
 
 	RoundsPlayed = 0;
+
+	TowerRulesHash = 0;
+}
+
+void ACSKGameState::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// Rules could have been changed by blueprints
+	UpdateTowerRulesHash();
 }
 
 void ACSKGameState::OnRep_ReplicatedHasBegunPlay()
@@ -398,41 +586,48 @@ int32 ACSKGameState::GetCountdownTimeRemaining(bool& bOutIsInfinite) const
 
 int32 ACSKGameState::GetTowerInstanceCount(TSubclassOf<ATower> Tower) const
 {
-	const int32* Num = TowerInstanceTable.Find(Tower);
-	if (Num != nullptr)
+	return BoardTowerRegistry.GetNumInstances(Tower);
+}
+
+void ACSKGameState::SetLatestActionHealthReports(TArray<FHealthChangeReport>&& InHealthReports)
+{
+	if (HasAuthority())
 	{
-		return *Num;
+		LatestActionHealthReports.SetReports(MoveTemp(InHealthReports));
 	}
-
-	return 0;
 }
 
-void ACSKGameState::SetLatestActionHealthReports(const TArray<FHealthChangeReport>& InHealthReports)
+void ACSKGameState::ClearLatestActionHealthReports()
 {
 	if (HasAuthority())
 	{
-		LatestActionHealthReports = InHealthReports;
+		LatestActionHealthReports.ClearReports();
 	}
 }
 
+TArray<FHealthChangeReport> ACSKGameState::GetLatestActionHealthReports() const
+{
+	return LatestActionHealthReports.GetAllReports().ToArray();
+}
+
 TArray<FHealthChangeReport> ACSKGameState::GetDamageHealthReports(bool bFilterOutDead) const
 {
-	return QueryLatestHealthReports(true, nullptr, bFilterOutDead);
+	return QueryLatestHealthReports(true, nullptr, bFilterOutDead).ToArray();
 }
 
 TArray<FHealthChangeReport> ACSKGameState::GetHealingHealthReports() const
 {
-	return QueryLatestHealthReports(false, nullptr, true);
+	return QueryLatestHealthReports(false, nullptr, true).ToArray();
 }
 
 TArray<FHealthChangeReport> ACSKGameState::GetPlayersDamagedHealthReports(ACSKPlayerState* PlayerState, bool bFilterOutDead) const
 {
-	return QueryLatestHealthReports(true, PlayerState, bFilterOutDead);
+	return QueryLatestHealthReports(true, PlayerState, bFilterOutDead).ToArray();
 }
 
 TArray<FHealthChangeReport> ACSKGameState::GetPlayersHealingHealthReports(ACSKPlayerState* PlayerState) const
 {
-	return QueryLatestHealthReports(false, PlayerState, true);
+	return QueryLatestHealthReports(false, PlayerState, true).ToArray();
 }
 
 void ACSKGameState::ActivateTickTimer(ECSKTimerState InTimerState, int32 InTime)
@@ -490,6 +685,13 @@ void ACSKGameState::SetTickTimerEnabled(bool bEnable)
 {
 	if (HasAuthority())
 	{
+		// Timeouts are fed from the record when replaying a match
+		ACSKGameMode* CSKGameMode = Cast<ACSKGameMode>(AuthorityGameMode);
+		if (bEnable && CSKGameMode && CSKGameMode->IsReplayingMatch())
+		{
+			return;
+		}
+
 		FTimerManager& TimerManager = GetWorldTimerManager();
 		if (bEnable && !TimerManager.IsTimerActive(Handle_TickTimer))
 		{
@@ -603,41 +805,6 @@ void ACSKGameState::ExecuteCustomTimerFinishedEvent(bool bWasSkipped)
 	}
 }
 
-TArray<FHealthChangeReport> ACSKGameState::QueryLatestHealthReports(bool bDamaged, ACSKPlayerState* InOwner, bool bExcludeDead) const
-{
-	TArray<FHealthChangeReport> Reports;
-	for (const FHealthChangeReport& Repo : LatestActionHealthReports)
-	{
-		// Filter owner
-		if (InOwner)
-		{
-			if (Repo.Owner != InOwner)
-			{
-				continue;
-			}
-		}
-
-		// Filter out differen type
-		if (bDamaged != Repo.bWasDamaged)
-		{
-			continue;
-		}
-
-		// Only filter killed if checking damaged
-		if (bDamaged)
-		{
-			if (bExcludeDead && Repo.bKilled)
-			{
-				continue;
-			}
-		}
-
-		Reports.Add(Repo);
-	}
-
-	return Reports;
-}
-
 void ACSKGameState::HandleMoveRequestConfirmed()
 {
 	if (IsActionPhaseActive() && HasAuthority())
@@ -796,35 +963,25 @@ bool ACSKGameState::GetTilesPlayerCanMoveTo(const ACSKPlayerController* Controll
 		int32 MaxDistance = GetPlayersNumRemainingMoves(PlayerState);
 		if (MaxDistance > 0)
 		{
-			TArray<ATile*> Candidates;
-			if (BoardManager->GetTilesWithinDistance(CastlePawn->GetCachedTile(), MaxDistance, Candidates))
+			if (bPathfind)
 			{
-				if (bPathfind)
-				{
-					SCOPE_CYCLE_COUNTER(STAT_CSKGameStateGetTilesPlayerCanMoveToPathfind);
-					
-					// Initialize this here to avoid creation every loop
-					FBoardPath BoardPath;
-
-					for (ATile* Tile : Candidates)
-					{
-						if (BoardManager->FindPath(CastlePawn->GetCachedTile(), Tile, BoardPath, false, MaxDistance))
-						{
-							OutTiles.Add(Tile);
-						}
-					}
-
-					return OutTiles.Num() > 0;
-				}
-				else
+				SCOPE_CYCLE_COUNTER(STAT_CSKGameStateGetTilesPlayerCanMoveToPathfind);
+
+				// A single search from the castle gives us every tile that can be walked to
+				FHexGridReachability Reachability;
+				if (BoardManager->GetReachableTiles(CastlePawn->GetCachedTile(), MaxDistance, Reachability))
 				{
-					// Not all these tiles may be reachable in given moves (player might need to walk
-					// around an obstacle) but they are within MaxDistance tiles of eachother 
-					// This is usefull for small move ranges (eg 1 or 2 tiles max)
-					OutTiles = MoveTemp(Candidates);
+					Reachability.GetReachableTiles(OutTiles);
 					return true;
 				}
 			}
+			else
+			{
+				// Not all these tiles may be reachable in given moves (player might need to walk
+				// around an obstacle) but they are within MaxDistance tiles of eachother 
+				// This is usefull for small move ranges (eg 1 or 2 tiles max)
+				return BoardManager->GetTilesWithinDistance(CastlePawn->GetCachedTile(), MaxDistance, OutTiles);
+			}
 		}
 	}
 
@@ -843,14 +1000,11 @@ bool ACSKGameState::GetTilesPlayerCanBuildOn(const ACSKPlayerController* Control
 	const ACSKPlayerState* PlayerState = Controller ? Controller->GetCSKPlayerState() : nullptr;
 	if (PlayerState)
 	{
+		// Excludes null, occupied and portal tiles
 		ACastle* CastlePawn = PlayerState->GetCastle();
-		if (BoardManager->GetTilesWithinDistance(CastlePawn->GetCachedTile(), MaxBuildRange, OutTiles))
+		if (CastlePawn)
 		{
-			// We need to remove any portal tiles
-			OutTiles.RemoveAll([this](const ATile* Tile)->bool
-			{
-				return !BoardManager->IsPlayerPortalTile(Tile);
-			});
+			BoardManager->GetBuildableTilesWithinDistance(CastlePawn->GetCachedTile(), MaxBuildRange, OutTiles);
 		}
 	}
 
@@ -876,13 +1030,7 @@ bool ACSKGameState::CanPlayerBuildMoreTowers(const ACSKPlayerController* Control
 		const ACSKPlayerState* PlayerState = Controller ? Controller->GetCSKPlayerState() : nullptr;
 		if (PlayerState)
 		{
-			for (TSubclassOf<UTowerConstructionData> TowerTemplate : AvailableTowers)
-			{
-				if (CanPlayerBuildTower(PlayerState, TowerTemplate))
-				{
-					return true;
-				}
-			}
+			return GetBuildableTowers(PlayerState).Find(true) != INDEX_NONE;
 		}
 	}
 
@@ -899,12 +1047,10 @@ bool ACSKGameState::GetTowersPlayerCanBuild(const ACSKPlayerController* Controll
 		const ACSKPlayerState* PlayerState = Controller ? Controller->GetCSKPlayerState() : nullptr;
 		if (PlayerState)
 		{
-			for (TSubclassOf<UTowerConstructionData> TowerTemplate : AvailableTowers)
+			const TBitArray<>& BuildableTowers = GetBuildableTowers(PlayerState);
+			for (TConstSetBitIterator<> It(BuildableTowers); It; ++It)
 			{
-				if (CanPlayerBuildTower(PlayerState, TowerTemplate))
-				{
-					OutTowers.Add(TowerTemplate);
-				}
+				OutTowers.Add(AvailableTowers[It.GetIndex()]);
 			}
 		}
 	}
@@ -912,6 +1058,45 @@ bool ACSKGameState::GetTowersPlayerCanBuild(const ACSKPlayerController* Controll
 	return OutTowers.Num() > 0;
 }
 
+const TBitArray<>& ACSKGameState::GetBuildableTowers(const ACSKPlayerState* PlayerState) const
+{
+	const int32 PlayerID = PlayerState ? PlayerState->GetCSKPlayerID() : -1;
+	if (PlayerID < 0 || PlayerID >= CSK_MAX_NUM_PLAYERS)
+	{
+		return EmptyBuildableTowers;
+	}
+
+	FBuildableTowersCache& Cache = BuildableTowersCache[PlayerID];
+
+	const FCSKTowerRegistry& OwnedTowers = PlayerState->GetOwnedTowerRegistry();
+
+	// Nothing that affects what can be built has changed
+	if (Cache.Towers.Num() == AvailableTowers.Num() && Cache.Gold == PlayerState->GetGold() && Cache.Mana == PlayerState->GetMana() &&
+		Cache.OwnedTowersVersion == OwnedTowers.GetVersion() && Cache.BoardTowersVersion == BoardTowerRegistry.GetVersion() && Cache.RulesHash == TowerRulesHash)
+	{
+		return Cache.Towers;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_CSKGameStateUpdateBuildableTowers);
+
+	Cache.Towers.Init(false, AvailableTowers.Num());
+	for (int32 Index = 0; Index < AvailableTowers.Num(); ++Index)
+	{
+		if (CanPlayerBuildTower(PlayerState, AvailableTowers[Index]))
+		{
+			Cache.Towers[Index] = true;
+		}
+	}
+
+	Cache.Gold = PlayerState->GetGold();
+	Cache.Mana = PlayerState->GetMana();
+	Cache.OwnedTowersVersion = OwnedTowers.GetVersion();
+	Cache.BoardTowersVersion = BoardTowerRegistry.GetVersion();
+	Cache.RulesHash = TowerRulesHash;
+
+	return Cache.Towers;
+}
+
 int32 ACSKGameState::GetPlayerNumRemainingSpellCasts(const ACSKPlayerState* PlayerState, bool& bOutInfinite) const
 {
 	bOutInfinite = false;
@@ -991,6 +1176,7 @@ void ACSKGameState::UpdateRules()
 		MaxTileMovements = GameMode->GetMaxTileMovementsPerTurn();
 
 		AvailableTowers = GameMode->GetAvailableTowers();
+		UpdateTowerRulesHash();
 		
 		// Zero means indefinite
 		if (ActionPhaseTime == 0)
@@ -1092,15 +1278,7 @@ void ACSKGameState::Multi_HandleBuildRequestFinished_Implementation(ATower* NewT
 	if (ensure(NewTower))
 	{
 		// Update tower instance counters
-		TSubclassOf<ATower> TowerClass = NewTower->GetClass();
-		if (TowerInstanceTable.Contains(TowerClass))
-		{
-			TowerInstanceTable[TowerClass]++;
-		}
-		else
-		{
-			TowerInstanceTable.Add(TowerClass, 1);
-		}
+		BoardTowerRegistry.AddTower(NewTower);
 	}
 	else
 	{
@@ -1108,6 +1286,26 @@ void ACSKGameState::Multi_HandleBuildRequestFinished_Implementation(ATower* NewT
 	}
 }
 
+void ACSKGameState::UpdateTowerRulesHash()
+{
+	uint32 Hash = GetTypeHash(MaxNumTowers);
+	Hash = HashCombine(Hash, GetTypeHash(MaxNumDuplicatedTowers));
+	Hash = HashCombine(Hash, GetTypeHash(MaxNumDuplicatedTowerTypes));
+	Hash = HashCombine(Hash, GetTypeHash(MaxNumLegendaryTowers));
+
+	for (const TSubclassOf<UTowerConstructionData>& TowerTemplate : AvailableTowers)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(TowerTemplate.Get()));
+	}
+
+	TowerRulesHash = Hash;
+}
+
+void ACSKGameState::OnRep_TowerRules()
+{
+	UpdateTowerRulesHash();
+}
+
 void ACSKGameState::Multi_HandleSpellRequestConfirmed_Implementation(EActiveSpellContext Context, ATile* TargetTile)
 {
 
@@ -1170,23 +1368,10 @@ void ACSKGameState::Multi_HandleTowerDestroyed_Implementation(ATower* DestroyedT
 {
 	if (ensure(DestroyedTower))
 	{
-		// Update tower instance counters
-		TSubclassOf<ATower> TowerClass = DestroyedTower->GetClass();
-		if (TowerInstanceTable.Contains(TowerClass))
-		{
-			int32& InstanceCount = TowerInstanceTable[TowerClass];
-			InstanceCount = FMath::Max(0, InstanceCount - 1);
-			
-			// We remove this tower from table if no more of it exists
-			if (InstanceCount == 0)
-			{
-				TowerInstanceTable.Remove(TowerClass);
-			}
-		}
-		// Only log on server
-		else if (HasAuthority())
+		// Update tower instance counters. Only log on server
+		if (!BoardTowerRegistry.RemoveTower(DestroyedTower) && HasAuthority())
 		{
-			UE_LOG(LogConquest, Warning, TEXT("ACSKGameState::Multi_HandleTowerDestroyed: Class %s was not in instance table"), *TowerClass->GetName());
+			UE_LOG(LogConquest, Warning, TEXT("ACSKGameState::Multi_HandleTowerDestroyed: Tower %s was not in instance table"), *DestroyedTower->GetName());
 		}
 	}
 	else
@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CSKMatchRecord.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+const uint32 FCSKMatchRecord::FileMagic = 0x4353524D; // CSRM
+const int32 FCSKMatchRecord::FileVersion = 2;
+
+namespace MatchRecord
+{
+	/** Packs given signed value. Values are expected to be small and rarely below -1 */
+	void SerializeSmallInt(FArchive& Ar, int32& Value)
+	{
+		uint32 Packed = static_cast<uint32>(Value + 1);
+		Ar.SerializeIntPacked(Packed);
+		Value = static_cast<int32>(Packed) - 1;
+	}
+}
+
+FArchive& operator << (FArchive& Ar, FCSKRecordedRequest& Request)
+{
+	// Type and flags share a single byte
+	uint8 Header = static_cast<uint8>(Request.Type) | (Request.bTimedOut ? 0x80 : 0);
+	Ar << Header;
+
+	Request.Type = static_cast<ECSKRecordedRequestType>(Header & 0x7F);
+	Request.bTimedOut = (Header & 0x80) != 0;
+
+	Ar << Request.PlayerID;
+
+	MatchRecord::SerializeSmallInt(Ar, Request.Round);
+	MatchRecord::SerializeSmallInt(Ar, Request.TileIndex);
+
+	// Only spells and towers need these
+	switch (Request.Type)
+	{
+		case ECSKRecordedRequestType::BuildTower:
+		{
+			MatchRecord::SerializeSmallInt(Ar, Request.ClassIndex);
+			break;
+		}
+		case ECSKRecordedRequestType::CastSpell:
+		case ECSKRecordedRequestType::CastQuickEffect:
+		{
+			MatchRecord::SerializeSmallInt(Ar, Request.ClassIndex);
+			MatchRecord::SerializeSmallInt(Ar, Request.SpellIndex);
+			MatchRecord::SerializeSmallInt(Ar, Request.AdditionalMana);
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+
+	Ar << Request.Checksum;
+	return Ar;
+}
+
+FCSKMatchRecord::FCSKMatchRecord()
+	: StartingPlayerID(0)
+	, DeckReshuffleSeed(0)
+	, FinalChecksum(0)
+{
+
+}
+
+void FCSKMatchRecord::Reset(const FString& InMapName)
+{
+	MapName = InMapName;
+	StartingPlayerID = 0;
+	DeckReshuffleSeed = 0;
+	FinalChecksum = 0;
+
+	Classes.Reset();
+	Requests.Reset();
+}
+
+int32 FCSKMatchRecord::FindOrAddClass(UClass* Class)
+{
+	if (!Class)
+	{
+		return INDEX_NONE;
+	}
+
+	FSoftClassPath ClassPath(Class);
+
+	int32 Index = Classes.Find(ClassPath);
+	if (Index == INDEX_NONE)
+	{
+		Index = Classes.Add(ClassPath);
+	}
+
+	return Index;
+}
+
+UClass* FCSKMatchRecord::GetClass(int32 Index) const
+{
+	if (Classes.IsValidIndex(Index))
+	{
+		return Classes[Index].TryLoadClass<UObject>();
+	}
+
+	return nullptr;
+}
+
+bool FCSKMatchRecord::SaveToFile(const FString& Filename) const
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	uint32 Magic = FileMagic;
+	int32 Version = FileVersion;
+	Writer << Magic;
+	Writer << Version;
+	Writer << const_cast<FCSKMatchRecord&>(*this);
+
+	return FFileHelper::SaveArrayToFile(Data, *Filename);
+}
+
+bool FCSKMatchRecord::LoadFromFile(const FString& Filename)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Filename))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Reader << Magic;
+	Reader << Version;
+
+	if (Magic != FileMagic || Version != FileVersion)
+	{
+		UE_LOG(LogConquest, Warning, TEXT("FCSKMatchRecord: %s is either not a match record or is an unsupported version"), *Filename);
+		return false;
+	}
+
+	Reader << *this;
+	return !Reader.IsError();
+}
+
+FString FCSKMatchRecord::GetRecordDirectory()
+{
+	return FPaths::ProjectSavedDir() / TEXT("MatchRecords");
+}
+
+FArchive& operator << (FArchive& Ar, FCSKMatchRecord& Record)
+{
+	Ar << Record.MapName;
+	Ar << Record.StartingPlayerID;
+	Ar << Record.DeckReshuffleSeed;
+	Ar << Record.Classes;
+	Ar << Record.Requests;
+	Ar << Record.FinalChecksum;
+
+	return Ar;
+}
@@ -0,0 +1,334 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CSKMatchSearch.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/QueuedThreadPool.h"
+
+DECLARE_CYCLE_STAT(TEXT("MatchSearch Search"), STAT_MatchSearchSearch, STATGROUP_Conquest);
+DECLARE_CYCLE_STAT(TEXT("MatchSearch GrowTree"), STAT_MatchSearchGrowTree, STATGROUP_Conquest);
+
+FCSKMatchSearchSettings::FCSKMatchSearchSettings()
+{
+	TimeBudget = 1.f;
+	MaxIterations = 0;
+	NumThreads = 1;
+	MaxPlayOutRounds = 20;
+	MaxBuildCells = 4;
+	ExplorationConstant = 1.41f;
+	ExcludedActionTypes = 0;
+}
+
+FCSKMatchSearch::FCSKMatchSearch(const FCSKSimRules& InRules, const FCSKSimBoard& InBoard, const FCSKMatchSearchSettings& InSettings)
+	: Rules(InRules)
+	, Board(InBoard)
+	, Settings(InSettings)
+{
+	check(Board.IsValid());
+}
+
+FCSKMatchSearchResult FCSKMatchSearch::Search(const FCSKSimMatchState& RootState, int32 Seed, const FThreadSafeBool* bAbort,
+	FQueuedThreadPool* ThreadPool) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_MatchSearchSearch);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double EndTime = StartTime + FMath::Max(0.f, Settings.TimeBudget);
+
+	FCSKMatchSearchResult SearchResult;
+
+	// There is nothing to decide if only one action can be performed
+	{
+		FCSKMatchSimulator Simulator(Rules, Board);
+		Simulator.SetMatchState(RootState, Seed);
+
+		TArray<FCSKSimAction> Actions;
+		GetSearchActions(Simulator, Actions);
+
+		if (Actions.Num() <= 1)
+		{
+			SearchResult.bIsValid = Actions.Num() == 1;
+			SearchResult.Action = SearchResult.bIsValid ? Actions[0] : FCSKSimAction();
+			SearchResult.ElapsedTime = FPlatformTime::Seconds() - StartTime;
+
+			return SearchResult;
+		}
+	}
+
+	// The calling thread always grows the first tree
+	const int32 NumTrees = ThreadPool ? FMath::Max(1, Settings.NumThreads) : 1;
+
+	const int32 MaxTreeIterations = Settings.MaxIterations > 0 ? FMath::DivideAndRoundUp(Settings.MaxIterations, NumTrees) : 0;
+
+	// Each tree is grown in isolation, so threads never need to share anything
+	TArray<TArray<FNode>> Trees;
+	Trees.SetNum(NumTrees);
+
+	TArray<int32> TreeIterations;
+	TreeIterations.SetNumZeroed(NumTrees);
+
+	TArray<TUniquePtr<FAsyncTask<FCSKMatchSearchTask>>> TreeTasks;
+	TreeTasks.Reserve(NumTrees - 1);
+
+	for (int32 TreeIndex = 1; TreeIndex < NumTrees; ++TreeIndex)
+	{
+		TreeTasks.Emplace(MakeUnique<FAsyncTask<FCSKMatchSearchTask>>([&, TreeIndex]()->void
+		{
+			TreeIterations[TreeIndex] = GrowTree(RootState, Seed + TreeIndex, EndTime, MaxTreeIterations, bAbort, Trees[TreeIndex]);
+		}));
+
+		TreeTasks.Last()->StartBackgroundTask(ThreadPool);
+	}
+
+	TreeIterations[0] = GrowTree(RootState, Seed, EndTime, MaxTreeIterations, bAbort, Trees[0]);
+
+	// Trees still waiting for a thread are cancelled rather than waited on. We
+	// might be running on the same pool, so these might never get a thread
+	for (TUniquePtr<FAsyncTask<FCSKMatchSearchTask>>& Task : TreeTasks)
+	{
+		if (!Task->Cancel())
+		{
+			Task->EnsureCompletion(false);
+		}
+	}
+
+	// Every tree expands the root with the same actions, so children can be merged by index
+	const FNode& Root = Trees[0][0];
+	for (int32 i = 0; i < Root.NumChildren; ++i)
+	{
+		int32 NumVisits = 0;
+		float TotalValue = 0.f;
+
+		for (const TArray<FNode>& Nodes : Trees)
+		{
+			// Cancelled trees were never grown
+			if (Nodes.Num() == 0)
+			{
+				continue;
+			}
+
+			if (ensure(Nodes[0].NumChildren == Root.NumChildren))
+			{
+				const FNode& Child = Nodes[Nodes[0].FirstChild + i];
+				NumVisits += Child.NumVisits;
+				TotalValue += Child.TotalValue;
+			}
+		}
+
+		// Most visited is the most robust choice, ties are broken by value
+		const float ExpectedValue = NumVisits > 0 ? TotalValue / static_cast<float>(NumVisits) : 0.f;
+		if (!SearchResult.bIsValid || NumVisits > SearchResult.NumVisits ||
+			(NumVisits == SearchResult.NumVisits && ExpectedValue > SearchResult.ExpectedValue))
+		{
+			SearchResult.Action = Trees[0][Root.FirstChild + i].Action;
+			SearchResult.bIsValid = true;
+			SearchResult.NumVisits = NumVisits;
+			SearchResult.ExpectedValue = ExpectedValue;
+		}
+	}
+
+	for (int32 Iterations : TreeIterations)
+	{
+		SearchResult.NumIterations += Iterations;
+	}
+
+	SearchResult.ElapsedTime = FPlatformTime::Seconds() - StartTime;
+	return SearchResult;
+}
+
+float FCSKMatchSearch::EvaluateMatch(const FCSKMatchSimulator& Simulator, int32 PlayerID)
+{
+	const FCSKSimMatchResult& Result = Simulator.GetResult();
+	if (Result.Winner != -1)
+	{
+		return Result.Winner == PlayerID ? 1.f : 0.f;
+	}
+
+	const FCSKSimMatchState& State = Simulator.GetMatchState();
+	if (State.NumRounds >= Simulator.GetRules().MaxRounds)
+	{
+		return 0.5f;
+	}
+
+	const int32 OpponentID = PlayerID == 0 ? 1 : 0;
+	const FCSKSimBoard& SimBoard = Simulator.GetBoard();
+
+	const int32 Distance = FHexGrid::HexDisplacement(State.Players[PlayerID].CastleHex, SimBoard.PortalHexes[OpponentID]);
+	const int32 OpponentDistance = FHexGrid::HexDisplacement(State.Players[OpponentID].CastleHex, SimBoard.PortalHexes[PlayerID]);
+
+	// Never as good (or as bad) as actually finishing the match
+	const float Lead = static_cast<float>(OpponentDistance - Distance) / static_cast<float>(FMath::Max(1, Distance + OpponentDistance));
+	return 0.5f + 0.45f * Lead;
+}
+
+int32 FCSKMatchSearch::GrowTree(const FCSKSimMatchState& RootState, int32 Seed, double EndTime, int32 MaxIterations,
+	const FThreadSafeBool* bAbort, TArray<FNode>& OutNodes) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_MatchSearchGrowTree);
+
+	FRandomStream Stream(Seed);
+	FCSKMatchSimulator Simulator(Rules, Board);
+
+	FCSKSimMatchState TreeState = RootState;
+	Simulator.SetMatchState(TreeState, Seed);
+
+	const int32 PlayerID = Simulator.GetActionPhasePlayer();
+	check(PlayerID != -1);
+
+	ShuffleHiddenCards(TreeState, PlayerID, Stream);
+
+	OutNodes.Reset();
+	OutNodes.Add(FNode(FCSKSimAction()));
+
+	TArray<FCSKSimAction> Actions;
+	TArray<int32> Path;
+
+	int32 NumIterations = 0;
+	while (MaxIterations <= 0 || NumIterations < MaxIterations)
+	{
+		// Always run at least one iteration, so the root is expanded
+		if (NumIterations > 0 && (FPlatformTime::Seconds() >= EndTime || (bAbort && *bAbort)))
+		{
+			break;
+		}
+
+		Simulator.SetMatchState(TreeState, Stream.RandHelper(MAX_int32));
+
+		Path.Reset();
+		Path.Add(0);
+
+		// Select down the tree until we reach a node that hasn't been visited
+		int32 NodeIndex = 0;
+		while (!OutNodes[NodeIndex].bIsTerminal)
+		{
+			if (OutNodes[NodeIndex].FirstChild == INDEX_NONE)
+			{
+				// Leaves are only expanded once they have been played out from
+				if (NodeIndex != 0 && OutNodes[NodeIndex].NumVisits == 0)
+				{
+					break;
+				}
+
+				GetSearchActions(Simulator, Actions);
+				if (Actions.Num() == 0)
+				{
+					OutNodes[NodeIndex].bIsTerminal = true;
+					break;
+				}
+
+				// Adding nodes may reallocate, so node is accessed by index
+				OutNodes[NodeIndex].FirstChild = OutNodes.Num();
+				OutNodes[NodeIndex].NumChildren = Actions.Num();
+
+				for (const FCSKSimAction& Action : Actions)
+				{
+					OutNodes.Add(FNode(Action));
+				}
+			}
+
+			NodeIndex = SelectChild(OutNodes, NodeIndex);
+			Path.Add(NodeIndex);
+
+			FNode& Node = OutNodes[NodeIndex];
+			if (!Simulator.PerformAction(Node.Action) || Node.Action.Type == ECSKSimActionType::EndActionPhase || Simulator.HasMatchFinished())
+			{
+				Node.bIsTerminal = true;
+			}
+		}
+
+		// Play out the rest of the match, with both players using their policy
+		Simulator.PlayOut(Settings.MaxPlayOutRounds);
+		const float Value = EvaluateMatch(Simulator, PlayerID);
+
+		for (int32 Index : Path)
+		{
+			FNode& Node = OutNodes[Index];
+			++Node.NumVisits;
+			Node.TotalValue += Value;
+		}
+
+		++NumIterations;
+	}
+
+	return NumIterations;
+}
+
+void FCSKMatchSearch::GetSearchActions(FCSKMatchSimulator& Simulator, TArray<FCSKSimAction>& OutActions) const
+{
+	Simulator.GetAvailableActions(OutActions, Settings.MaxBuildCells);
+
+	if (Settings.ExcludedActionTypes != 0)
+	{
+		OutActions.RemoveAll([this](const FCSKSimAction& Action)->bool
+		{
+			return Action.Type != ECSKSimActionType::EndActionPhase &&
+				(Settings.ExcludedActionTypes & (1 << static_cast<uint8>(Action.Type))) != 0;
+		});
+	}
+}
+
+int32 FCSKMatchSearch::SelectChild(const TArray<FNode>& Nodes, int32 NodeIndex) const
+{
+	const FNode& Parent = Nodes[NodeIndex];
+	check(Parent.NumChildren > 0);
+
+	const float LogParentVisits = FMath::Loge(static_cast<float>(FMath::Max(1, Parent.NumVisits)));
+
+	int32 BestChild = INDEX_NONE;
+	float BestScore = 0.f;
+
+	// Every tree action belongs to the searching player, so
+	// we are always picking the child that is best for them
+	for (int32 i = Parent.FirstChild; i < Parent.FirstChild + Parent.NumChildren; ++i)
+	{
+		const FNode& Child = Nodes[i];
+		if (Child.NumVisits == 0)
+		{
+			return i;
+		}
+
+		const float Visits = static_cast<float>(Child.NumVisits);
+		const float Score = Child.TotalValue / Visits + Settings.ExplorationConstant * FMath::Sqrt(LogParentVisits / Visits);
+
+		if (BestChild == INDEX_NONE || Score > BestScore)
+		{
+			BestChild = i;
+			BestScore = Score;
+		}
+	}
+
+	return BestChild;
+}
+
+void FCSKMatchSearch::ShuffleHiddenCards(FCSKSimMatchState& State, int32 PlayerID, FRandomStream& Stream)
+{
+	auto Shuffle = [&Stream](TArray<int32>& Cards)->void
+	{
+		int32 LastIndex = Cards.Num() - 1;
+		for (int32 i = 0; i < LastIndex; ++i)
+		{
+			int32 Index = Stream.RandRange(i, LastIndex);
+			if (i != Index)
+			{
+				Cards.Swap(i, Index);
+			}
+		}
+	};
+
+	// Our own hand is known, only the order of our deck isn't
+	Shuffle(State.Players[PlayerID].SpellDeck);
+
+	// Opponents hand could be any of the cards they have yet to play, so we deal it again from those
+	FCSKSimPlayerState& Opponent = State.Players[PlayerID == 0 ? 1 : 0];
+	const int32 HandSize = Opponent.SpellsInHand.Num();
+
+	Opponent.SpellDeck.Append(Opponent.SpellsInHand);
+	Opponent.SpellsInHand.Reset();
+
+	Shuffle(Opponent.SpellDeck);
+
+	for (int32 i = 0; i < HandSize && Opponent.SpellDeck.Num() > 0; ++i)
+	{
+		Opponent.SpellsInHand.Add(Opponent.SpellDeck.Pop(false));
+	}
+}
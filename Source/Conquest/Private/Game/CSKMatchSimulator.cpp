@@ -0,0 +1,902 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CSKMatchSimulator.h"
+#include "CSKGameMode.h"
+
+#include "BoardManager.h"
+#include "Spell.h"
+#include "SpellCard.h"
+#include "Tile.h"
+#include "Tower.h"
+#include "TowerConstructionData.h"
+
+DECLARE_CYCLE_STAT(TEXT("MatchSimulator PlayMatch"), STAT_MatchSimulatorPlayMatch, STATGROUP_Conquest);
+
+FCSKSimRules::FCSKSimRules()
+{
+	// Mirrors the defaults of the game mode
+	StartingGold = 5;
+	StartingMana = 3;
+	CollectionPhaseGold = 3;
+	CollectionPhaseMana = 2;
+	MaxGold = 30;
+	MaxMana = 30;
+
+	MaxNumTowers = 7;
+	MaxNumDuplicatedTowers = 2;
+	MaxNumDuplicatedTowerTypes = 2;
+	MaxNumLegendaryTowers = 1;
+	MaxBuildRange = 4;
+
+	MinTileMovements = 1;
+	MaxTileMovements = 2;
+
+	MaxSpellUses = 1;
+	MaxSpellCardsInHand = 3;
+
+	MaxRounds = 100;
+}
+
+void FCSKSimRules::CopyFromGameMode(const ACSKGameMode* GameMode)
+{
+	if (!ensure(GameMode))
+	{
+		return;
+	}
+
+	StartingGold = GameMode->StartingGold;
+	StartingMana = GameMode->StartingMana;
+	CollectionPhaseGold = GameMode->CollectionPhaseGold;
+	CollectionPhaseMana = GameMode->CollectionPhaseMana;
+	MaxGold = GameMode->MaxGold;
+	MaxMana = GameMode->MaxMana;
+
+	MaxNumTowers = GameMode->MaxNumTowers;
+	MaxNumDuplicatedTowers = GameMode->MaxNumDuplicatedTowers;
+	MaxNumDuplicatedTowerTypes = GameMode->MaxNumDuplicatedTowerTypes;
+	MaxNumLegendaryTowers = GameMode->MaxNumLegendaryTowers;
+	MaxBuildRange = GameMode->MaxBuildRange;
+
+	MinTileMovements = GameMode->MinTileMovements;
+	MaxTileMovements = GameMode->MaxTileMovements;
+
+	MaxSpellUses = GameMode->MaxSpellUses;
+	MaxSpellCardsInHand = GameMode->MaxSpellCardsInHand;
+
+	Towers.Reset();
+	for (int32 i = 0; i < GameMode->AvailableTowers.Num(); ++i)
+	{
+		const UTowerConstructionData* ConstructData = GameMode->AvailableTowers[i].GetDefaultObject();
+		if (!ConstructData || !ConstructData->TowerClass)
+		{
+			continue;
+		}
+
+		FCSKSimTowerData TowerData;
+		TowerData.GoldCost = ConstructData->GoldCost;
+		TowerData.ManaCost = ConstructData->ManaCost;
+		TowerData.bIsLegendary = ConstructData->TowerClass.GetDefaultObject()->IsLegendaryTower();
+		TowerData.SourceIndex = i;
+
+		Towers.Add(TowerData);
+	}
+
+	SpellCosts.Reset();
+	SpellCardIndices.Reset();
+	for (int32 i = 0; i < GameMode->AvailableSpellCards.Num(); ++i)
+	{
+		const USpellCard* DefaultSpellCard = GameMode->AvailableSpellCards[i].GetDefaultObject();
+		TSubclassOf<USpell> Spell = DefaultSpellCard ? DefaultSpellCard->GetSpellAtIndex(0) : nullptr;
+
+		// Final costs depend on the target, so we only consider the static cost
+		if (Spell)
+		{
+			SpellCosts.Add(Spell.GetDefaultObject()->GetSpellStaticCost());
+			SpellCardIndices.Add(i);
+		}
+	}
+}
+
+FCSKSimPlayerState::FCSKSimPlayerState()
+	: Gold(0)
+	, Mana(0)
+	, CastleHex(-1)
+	, TilesTraversedThisRound(0)
+	, SpellsCastThisRound(0)
+	, NumNormalTowers(0)
+	, NumLegendaryTowers(0)
+	, Policy(ECSKSimPolicy::Greedy)
+{
+
+}
+
+FCSKSimMatchState::FCSKSimMatchState()
+	: RoundState(ECSKRoundState::Invalid)
+	, StartingPlayerID(0)
+	, NumRounds(0)
+	, bActionPhaseInProgress(false)
+{
+
+}
+
+FCSKSimBoard::FCSKSimBoard()
+	: Dimensions(0, 0)
+{
+	for (FHexGrid::FHex& Portal : PortalHexes)
+	{
+		Portal = FHexGrid::FHex(-1);
+	}
+}
+
+bool FCSKSimBoard::InitFromBoardManager(const ABoardManager* BoardManager)
+{
+	if (!BoardManager)
+	{
+		return false;
+	}
+
+	Dimensions = BoardManager->GetGridDimensions();
+	Cells = BoardManager->GetHexGrid().GetCellStates();
+
+	for (int32 i = 0; i < CSK_MAX_NUM_PLAYERS; ++i)
+	{
+		const ATile* PortalTile = BoardManager->GetPlayerPortalTile(i);
+		PortalHexes[i] = PortalTile ? PortalTile->GetGridHexValue() : FHexGrid::FHex(-1);
+	}
+
+	return IsValid();
+}
+
+void FCSKSimBoard::InitEmpty(const FIntPoint& InDimensions)
+{
+	Dimensions = InDimensions;
+	Cells.Init(FHexGridCellState(EHexGridCellFlags::None, -1, 0), Dimensions.X * Dimensions.Y);
+
+	const int32 MiddleRow = Dimensions.X / 2;
+	PortalHexes[0] = FHexGrid::ConvertIndicesToHex(MiddleRow, 0);
+	PortalHexes[1] = FHexGrid::ConvertIndicesToHex(MiddleRow - FMath::DivideAndRoundDown(Dimensions.Y - 1, 2), Dimensions.Y - 1);
+}
+
+bool FCSKSimBoard::IsValid() const
+{
+	if (Dimensions.X <= 0 || Dimensions.Y <= 0 || Cells.Num() != Dimensions.X * Dimensions.Y)
+	{
+		return false;
+	}
+
+	for (const FHexGrid::FHex& Portal : PortalHexes)
+	{
+		int32 Index = FHexGrid::HexToCellIndex(Portal, Dimensions);
+		if (Index == INDEX_NONE || !Cells[Index].HasTile())
+		{
+			return false;
+		}
+	}
+
+	return PortalHexes[0] != PortalHexes[1];
+}
+
+FCSKMatchSimulator::FCSKMatchSimulator(const FCSKSimRules& InRules, const FCSKSimBoard& InBoard)
+	: Rules(InRules)
+	, Board(InBoard)
+	, RoundLimit(0)
+	, bMatchFinished(false)
+{
+	check(Board.IsValid());
+}
+
+FCSKSimMatchResult FCSKMatchSimulator::PlayMatch(int32 Seed, ECSKSimPolicy Player1Policy, ECSKSimPolicy Player2Policy)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MatchSimulatorPlayMatch);
+
+	ResetMatch(Seed, Player1Policy, Player2Policy);
+	PlayOut(Rules.MaxRounds);
+
+	return Result;
+}
+
+void FCSKMatchSimulator::SetMatchState(const FCSKSimMatchState& InState, int32 Seed)
+{
+	check(InState.Cells.Num() == Board.Cells.Num());
+
+	Stream.Initialize(Seed);
+
+	State = InState;
+	RoundLimit = Rules.MaxRounds;
+
+	Result = FCSKSimMatchResult();
+	Result.NumRounds = State.NumRounds;
+	bMatchFinished = false;
+
+	// A castle might have already reached a portal
+	for (int32 i = 0; i < CSK_MAX_NUM_PLAYERS; ++i)
+	{
+		if (CheckPortalReached(i))
+		{
+			break;
+		}
+	}
+}
+
+void FCSKMatchSimulator::GetAvailableActions(TArray<FCSKSimAction>& OutActions, int32 MaxBuildCells)
+{
+	OutActions.Reset();
+
+	const int32 PlayerID = GetActionPhasePlayer();
+	if (bMatchFinished || !State.bActionPhaseInProgress || PlayerID == -1)
+	{
+		return;
+	}
+
+	const FCSKSimPlayerState& Player = State.Players[PlayerID];
+	const FHexGrid::FHex& OpponentCastle = State.Players[GetOpponent(PlayerID)].CastleHex;
+
+	// Find every cell reachable with our remaining moves, with a single breadth first search from our castle
+	const int32 MaxDistance = GetPlayersNumRemainingMoves(Player);
+	if (MaxDistance > 0)
+	{
+		DistanceScratch.Init(INDEX_NONE, State.Cells.Num());
+		CandidateScratch.Reset();
+
+		const int32 StartIndex = FHexGrid::HexToCellIndex(Player.CastleHex, Board.Dimensions);
+		DistanceScratch[StartIndex] = 0;
+		CandidateScratch.Add(StartIndex);
+
+		for (int32 i = 0; i < CandidateScratch.Num(); ++i)
+		{
+			const int32 CellIndex = CandidateScratch[i];
+			const int32 Distance = DistanceScratch[CellIndex];
+
+			if (Distance > 0)
+			{
+				OutActions.Add(FCSKSimAction(ECSKSimActionType::MoveCastle, CellIndex, Distance));
+			}
+
+			if (Distance >= MaxDistance)
+			{
+				continue;
+			}
+
+			FHexGrid::ForEachHexInRing(FHexGrid::CellIndexToHex(CellIndex, Board.Dimensions), 1, [&](const FHexGrid::FHex& Hex)->void
+			{
+				const int32 NeighbourIndex = FHexGrid::HexToCellIndex(Hex, Board.Dimensions);
+				if (NeighbourIndex != INDEX_NONE && DistanceScratch[NeighbourIndex] == INDEX_NONE && State.Cells[NeighbourIndex].IsWalkable())
+				{
+					DistanceScratch[NeighbourIndex] = Distance + 1;
+					CandidateScratch.Add(NeighbourIndex);
+				}
+			});
+		}
+	}
+
+	// Players must move the minimum amount of tiles before ending their action phase, unless they are boxed in
+	if (Player.TilesTraversedThisRound >= Rules.MinTileMovements || OutActions.Num() == 0)
+	{
+		OutActions.Add(FCSKSimAction(ECSKSimActionType::EndActionPhase, INDEX_NONE, INDEX_NONE));
+	}
+
+	// Towers only block paths in the simulation, so cells closest to the opponent are the most interesting
+	bool bCanBuildAnyTower = false;
+	for (int32 i = 0; i < Rules.Towers.Num() && !bCanBuildAnyTower; ++i)
+	{
+		bCanBuildAnyTower = CanPlayerBuildTower(Player, i);
+	}
+
+	if (bCanBuildAnyTower && MaxBuildCells > 0)
+	{
+		CandidateScratch.Reset();
+		for (int32 i = 0; i < State.Cells.Num(); ++i)
+		{
+			if (CanPlayerBuildOnCell(Player, i))
+			{
+				CandidateScratch.Add(i);
+			}
+		}
+
+		const FIntPoint& Dimensions = Board.Dimensions;
+		CandidateScratch.Sort([&OpponentCastle, &Dimensions](int32 Lhs, int32 Rhs)->bool
+		{
+			const int32 LhsDistance = FHexGrid::HexDisplacement(OpponentCastle, FHexGrid::CellIndexToHex(Lhs, Dimensions));
+			const int32 RhsDistance = FHexGrid::HexDisplacement(OpponentCastle, FHexGrid::CellIndexToHex(Rhs, Dimensions));
+
+			return LhsDistance != RhsDistance ? LhsDistance < RhsDistance : Lhs < Rhs;
+		});
+
+		const int32 NumCells = FMath::Min(CandidateScratch.Num(), MaxBuildCells);
+		for (int32 i = 0; i < Rules.Towers.Num(); ++i)
+		{
+			if (!CanPlayerBuildTower(Player, i))
+			{
+				continue;
+			}
+
+			for (int32 j = 0; j < NumCells; ++j)
+			{
+				OutActions.Add(FCSKSimAction(ECSKSimActionType::BuildTower, CandidateScratch[j], i));
+			}
+		}
+	}
+
+	// Spells have no effect other than their cost, so duplicate cards in hand are the same action
+	for (int32 i = 0; i < Player.SpellsInHand.Num(); ++i)
+	{
+		if (CanPlayerCastSpell(Player, i) && Player.SpellsInHand.Find(Player.SpellsInHand[i]) == i)
+		{
+			OutActions.Add(FCSKSimAction(ECSKSimActionType::CastSpell, INDEX_NONE, i));
+		}
+	}
+}
+
+bool FCSKMatchSimulator::PerformAction(const FCSKSimAction& Action)
+{
+	const int32 PlayerID = GetActionPhasePlayer();
+	if (bMatchFinished || !State.bActionPhaseInProgress || PlayerID == -1)
+	{
+		return false;
+	}
+
+	switch (Action.Type)
+	{
+		case ECSKSimActionType::EndActionPhase:
+		{
+			State.bActionPhaseInProgress = false;
+			return true;
+		}
+		case ECSKSimActionType::MoveCastle:
+		{
+			return State.Cells.IsValidIndex(Action.CellIndex) && 
+				MoveCastleTowards(PlayerID, FHexGrid::CellIndexToHex(Action.CellIndex, Board.Dimensions));
+		}
+		case ECSKSimActionType::BuildTower:
+		{
+			return BuildTowerAt(PlayerID, Action.Index, Action.CellIndex);
+		}
+		case ECSKSimActionType::CastSpell:
+		{
+			return CastSpellInHand(PlayerID, Action.Index);
+		}
+	}
+
+	return false;
+}
+
+bool FCSKMatchSimulator::PlayOut(int32 MaxRoundsToPlay)
+{
+	RoundLimit = FMath::Min(Rules.MaxRounds, State.NumRounds + FMath::Max(0, MaxRoundsToPlay));
+
+	// The rest of an action phase in progress is decided by the players policy
+	if (!bMatchFinished && State.bActionPhaseInProgress)
+	{
+		const int32 PlayerID = GetActionPhasePlayer();
+		if (PlayerID != -1)
+		{
+			RunActionPhase(PlayerID, true);
+		}
+
+		State.bActionPhaseInProgress = false;
+	}
+
+	// Each state immediately handles itself, we only need to advance
+	// through them until the match has finished or ran out of rounds
+	while (!bMatchFinished)
+	{
+		EnterRoundState(GetNextRoundState(State.RoundState));
+	}
+
+	return Result.Winner != -1 || State.NumRounds >= Rules.MaxRounds;
+}
+
+int32 FCSKMatchSimulator::GetActionPhasePlayer() const
+{
+	switch (State.RoundState)
+	{
+		case ECSKRoundState::FirstActionPhase:		return State.StartingPlayerID;
+		case ECSKRoundState::SecondActionPhase:		return GetOpponent(State.StartingPlayerID);
+		default:									return -1;
+	}
+}
+
+void FCSKMatchSimulator::ResetMatch(int32 Seed, ECSKSimPolicy Player1Policy, ECSKSimPolicy Player2Policy)
+{
+	Stream.Initialize(Seed);
+
+	State.Cells = Board.Cells;
+	State.TowerInstanceCounts.Init(0, Rules.Towers.Num());
+	State.RoundState = ECSKRoundState::Invalid;
+	State.NumRounds = 0;
+	State.bActionPhaseInProgress = false;
+
+	Result = FCSKSimMatchResult();
+	bMatchFinished = false;
+
+	// Coin flip
+	State.StartingPlayerID = Stream.RandRange(0, 1);
+
+	for (int32 i = 0; i < CSK_MAX_NUM_PLAYERS; ++i)
+	{
+		FCSKSimPlayerState& Player = State.Players[i];
+		Player.CastleHex = Board.PortalHexes[i];
+		Player.TilesTraversedThisRound = 0;
+		Player.SpellsCastThisRound = 0;
+		Player.NumNormalTowers = 0;
+		Player.NumLegendaryTowers = 0;
+		Player.TowerCounts.Init(0, Rules.Towers.Num());
+		Player.SpellsInHand.Reset();
+		Player.Policy = i == 0 ? Player1Policy : Player2Policy;
+
+		// Castles start on their own portal
+		FHexGridCellState& Cell = State.Cells[FHexGrid::HexToCellIndex(Player.CastleHex, Board.Dimensions)];
+		Cell.Flags |= EHexGridCellFlags::Occupied;
+		Cell.OwnerID = i;
+
+		ResetPlayerResources(i);
+		ResetSpellDeck(Player);
+	}
+}
+
+void FCSKMatchSimulator::EnterRoundState(ECSKRoundState NewState)
+{
+	State.RoundState = NewState;
+
+	switch (NewState)
+	{
+		case ECSKRoundState::CollectionPhase:
+		{
+			if (State.NumRounds >= RoundLimit)
+			{
+				// Neither player was able to win, count this match as a draw
+				bMatchFinished = true;
+				break;
+			}
+
+			Result.NumRounds = ++State.NumRounds;
+
+			for (int32 i = 0; i < CSK_MAX_NUM_PLAYERS; ++i)
+			{
+				UpdatePlayerResources(i);
+			}
+
+			break;
+		}
+		case ECSKRoundState::FirstActionPhase:
+		case ECSKRoundState::SecondActionPhase:
+		{
+			RunActionPhase(GetActionPhasePlayer());
+			break;
+		}
+		case ECSKRoundState::EndRoundPhase:
+		{
+			// Tower end round actions are driven by blueprints, so there is nothing to simulate here
+			break;
+		}
+	}
+}
+
+void FCSKMatchSimulator::ResetPlayerResources(int32 PlayerID)
+{
+	FCSKSimPlayerState& Player = State.Players[PlayerID];
+	Player.Gold = Rules.StartingGold;
+	Player.Mana = Rules.StartingMana;
+}
+
+void FCSKMatchSimulator::UpdatePlayerResources(int32 PlayerID)
+{
+	FCSKSimPlayerState& Player = State.Players[PlayerID];
+
+	int32 GoldToGive = Rules.CollectionPhaseGold;
+	int32 ManaToGive = Rules.CollectionPhaseMana;
+
+	// Collect any additional resources from towers
+	for (int32 i = 0; i < Player.TowerCounts.Num(); ++i)
+	{
+		GoldToGive += Rules.Towers[i].CollectionGold * Player.TowerCounts[i];
+		ManaToGive += Rules.Towers[i].CollectionMana * Player.TowerCounts[i];
+	}
+
+	Player.Gold = FMath::Clamp(Player.Gold + GoldToGive, 0, Rules.MaxGold);
+	Player.Mana = FMath::Clamp(Player.Mana + ManaToGive, 0, Rules.MaxMana);
+
+	// Pick up a spell from the deck (reshuffle the discard pile if required)
+	if (Player.SpellDeck.Num() == 0 && Player.SpellsInHand.Num() == 0)
+	{
+		ResetSpellDeck(Player);
+	}
+
+	// Player can only carry X amount of cards in hand
+	if (Player.SpellsInHand.Num() < Rules.MaxSpellCardsInHand && Player.SpellDeck.Num() > 0)
+	{
+		Player.SpellsInHand.Add(Player.SpellDeck[0]);
+		Player.SpellDeck.RemoveAt(0, 1, false);
+	}
+}
+
+void FCSKMatchSimulator::RunActionPhase(int32 PlayerID, bool bContinue)
+{
+	FCSKSimPlayerState& Player = State.Players[PlayerID];
+	if (!bContinue)
+	{
+		Player.TilesTraversedThisRound = 0;
+		Player.SpellsCastThisRound = 0;
+	}
+
+	// Greedy players spend before moving, as moving closer to the
+	// opponents portal might end the match before resources are spent
+	if (Player.Policy == ECSKSimPolicy::Greedy || Stream.FRand() < 0.5f)
+	{
+		BuildTower(PlayerID);
+	}
+
+	if (Player.Policy == ECSKSimPolicy::Greedy || Stream.FRand() < 0.5f)
+	{
+		CastSpell(PlayerID);
+	}
+
+	// Players must move the minimum amount of tiles before ending their action phase, though
+	// there is a chance the castle is boxed in, which the game mode resolves with a time out
+	while (GetPlayersNumRemainingMoves(Player) > 0)
+	{
+		if (!MoveCastle(PlayerID) || bMatchFinished)
+		{
+			break;
+		}
+
+		// Random players are satisfied once they have moved the required amount
+		if (Player.Policy == ECSKSimPolicy::Random && Player.TilesTraversedThisRound >= Rules.MinTileMovements && Stream.FRand() < 0.5f)
+		{
+			break;
+		}
+	}
+}
+
+bool FCSKMatchSimulator::MoveCastle(int32 PlayerID)
+{
+	FCSKSimPlayerState& Player = State.Players[PlayerID];
+
+	int32 MaxDistance = GetPlayersNumRemainingMoves(Player);
+	if (MaxDistance <= 0)
+	{
+		return false;
+	}
+
+	FHexGrid::FHex Goal = Board.PortalHexes[GetOpponent(PlayerID)];
+
+	if (Player.Policy == ECSKSimPolicy::Random)
+	{
+		// Aim for any tile within range, the path finder will take us as close as possible
+		CandidateScratch.Reset();
+		for (int32 i = 0; i < State.Cells.Num(); ++i)
+		{
+			if (State.Cells[i].IsWalkable() && FHexGrid::HexDisplacement(Player.CastleHex, FHexGrid::CellIndexToHex(i, Board.Dimensions)) <= MaxDistance)
+			{
+				CandidateScratch.Add(i);
+			}
+		}
+
+		if (CandidateScratch.Num() == 0)
+		{
+			return false;
+		}
+
+		Goal = FHexGrid::CellIndexToHex(CandidateScratch[Stream.RandHelper(CandidateScratch.Num())], Board.Dimensions);
+	}
+
+	return MoveCastleTowards(PlayerID, Goal);
+}
+
+bool FCSKMatchSimulator::MoveCastleTowards(int32 PlayerID, const FHexGrid::FHex& Goal)
+{
+	FCSKSimPlayerState& Player = State.Players[PlayerID];
+
+	int32 MaxDistance = GetPlayersNumRemainingMoves(Player);
+	if (MaxDistance <= 0)
+	{
+		return false;
+	}
+
+	int32 EndIndex = INDEX_NONE;
+	bool bReachedGoal = false;
+	if (!FHexGrid::SearchCells(Board.Dimensions, State.Cells, Player.CastleHex, Goal, true, MaxDistance, SearchScratch, EndIndex, bReachedGoal))
+	{
+		return false;
+	}
+
+	FHexGrid::ConvertSearchToHexPath(Board.Dimensions, SearchScratch, EndIndex, PathScratch);
+
+	// Path includes the tile we are currently on
+	int32 Segments = PathScratch.Num() - 1;
+	if (Segments <= 0)
+	{
+		return false;
+	}
+
+	FHexGridCellState& OldCell = State.Cells[FHexGrid::HexToCellIndex(Player.CastleHex, Board.Dimensions)];
+	OldCell.Flags &= ~EHexGridCellFlags::Occupied;
+	OldCell.OwnerID = -1;
+
+	Player.CastleHex = PathScratch.Last();
+	Player.TilesTraversedThisRound += Segments;
+	Result.TilesTraversed += Segments;
+
+	FHexGridCellState& NewCell = State.Cells[EndIndex];
+	NewCell.Flags |= EHexGridCellFlags::Occupied;
+	NewCell.OwnerID = PlayerID;
+
+	CheckPortalReached(PlayerID);
+	return true;
+}
+
+bool FCSKMatchSimulator::BuildTower(int32 PlayerID)
+{
+	FCSKSimPlayerState& Player = State.Players[PlayerID];
+
+	// Greedy players build the most expensive tower they can
+	int32 TowerIndex = INDEX_NONE;
+	for (int32 i = 0; i < Rules.Towers.Num(); ++i)
+	{
+		if (!CanPlayerBuildTower(Player, i))
+		{
+			continue;
+		}
+
+		if (TowerIndex == INDEX_NONE)
+		{
+			TowerIndex = i;
+		}
+		else if (Player.Policy == ECSKSimPolicy::Greedy)
+		{
+			const FCSKSimTowerData& Best = Rules.Towers[TowerIndex];
+			const FCSKSimTowerData& Tower = Rules.Towers[i];
+
+			if (Tower.GoldCost + Tower.ManaCost > Best.GoldCost + Best.ManaCost)
+			{
+				TowerIndex = i;
+			}
+		}
+		else if (Stream.FRand() < 0.5f)
+		{
+			TowerIndex = i;
+		}
+	}
+
+	if (TowerIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	CandidateScratch.Reset();
+	for (int32 i = 0; i < State.Cells.Num(); ++i)
+	{
+		if (CanPlayerBuildOnCell(Player, i))
+		{
+			CandidateScratch.Add(i);
+		}
+	}
+
+	if (CandidateScratch.Num() == 0)
+	{
+		return false;
+	}
+
+	return BuildTowerAt(PlayerID, TowerIndex, CandidateScratch[Stream.RandHelper(CandidateScratch.Num())]);
+}
+
+bool FCSKMatchSimulator::BuildTowerAt(int32 PlayerID, int32 TowerIndex, int32 CellIndex)
+{
+	FCSKSimPlayerState& Player = State.Players[PlayerID];
+
+	if (!Rules.Towers.IsValidIndex(TowerIndex) || !CanPlayerBuildTower(Player, TowerIndex) || !CanPlayerBuildOnCell(Player, CellIndex))
+	{
+		return false;
+	}
+
+	FHexGridCellState& Cell = State.Cells[CellIndex];
+	Cell.Flags |= EHexGridCellFlags::Occupied;
+	Cell.OwnerID = PlayerID;
+
+	const FCSKSimTowerData& Tower = Rules.Towers[TowerIndex];
+	Player.Gold -= Tower.GoldCost;
+	Player.Mana -= Tower.ManaCost;
+
+	++Player.TowerCounts[TowerIndex];
+	++State.TowerInstanceCounts[TowerIndex];
+
+	if (Tower.bIsLegendary)
+	{
+		++Player.NumLegendaryTowers;
+	}
+	else
+	{
+		++Player.NumNormalTowers;
+	}
+
+	++Result.TowersBuilt;
+	return true;
+}
+
+bool FCSKMatchSimulator::CastSpell(int32 PlayerID)
+{
+	FCSKSimPlayerState& Player = State.Players[PlayerID];
+
+	// Greedy players cast the most expensive spell they can afford
+	int32 HandIndex = INDEX_NONE;
+	for (int32 i = 0; i < Player.SpellsInHand.Num(); ++i)
+	{
+		if (!CanPlayerCastSpell(Player, i))
+		{
+			continue;
+		}
+
+		if (HandIndex == INDEX_NONE)
+		{
+			HandIndex = i;
+		}
+		else if (Player.Policy == ECSKSimPolicy::Greedy)
+		{
+			if (Rules.SpellCosts[Player.SpellsInHand[i]] > Rules.SpellCosts[Player.SpellsInHand[HandIndex]])
+			{
+				HandIndex = i;
+			}
+		}
+		else if (Stream.FRand() < 0.5f)
+		{
+			HandIndex = i;
+		}
+	}
+
+	if (HandIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	return CastSpellInHand(PlayerID, HandIndex);
+}
+
+bool FCSKMatchSimulator::CastSpellInHand(int32 PlayerID, int32 HandIndex)
+{
+	FCSKSimPlayerState& Player = State.Players[PlayerID];
+
+	if (!CanPlayerCastSpell(Player, HandIndex))
+	{
+		return false;
+	}
+
+	Player.Mana -= Rules.SpellCosts[Player.SpellsInHand[HandIndex]];
+	Player.SpellsInHand.RemoveAt(HandIndex, 1, false);
+	++Player.SpellsCastThisRound;
+
+	++Result.SpellsCast;
+	return true;
+}
+
+bool FCSKMatchSimulator::CanPlayerBuildTower(const FCSKSimPlayerState& Player, int32 TowerIndex) const
+{
+	const FCSKSimTowerData& Tower = Rules.Towers[TowerIndex];
+
+	// Is tower to expensive?
+	if (Player.Gold < Tower.GoldCost || Player.Mana < Tower.ManaCost)
+	{
+		return false;
+	}
+
+	if (Tower.bIsLegendary)
+	{
+		// Has player built max amount of legendary towers allowed?
+		if (Rules.MaxNumLegendaryTowers > 0 && Player.NumLegendaryTowers >= Rules.MaxNumLegendaryTowers)
+		{
+			return false;
+		}
+
+		// There can only be one instance
+		return State.TowerInstanceCounts[TowerIndex] == 0;
+	}
+
+	// Has player built the max amount of normal towers allowed?
+	if (Rules.MaxNumTowers > 0 && Player.NumNormalTowers >= Rules.MaxNumTowers)
+	{
+		return false;
+	}
+
+	const int32 TowerInstanceCount = Player.TowerCounts[TowerIndex];
+
+	// Has player already built the max amount of duplicates for this tower?
+	if (Rules.MaxNumDuplicatedTowers > 0 && TowerInstanceCount >= Rules.MaxNumDuplicatedTowers)
+	{
+		return false;
+	}
+
+	// Has player already created too many duplicates for different towers?
+	if (Rules.MaxNumDuplicatedTowerTypes > 0 && TowerInstanceCount >= 1)
+	{
+		int32 NumDuplicateTypes = 0;
+		for (int32 Count : Player.TowerCounts)
+		{
+			if (Count >= 2)
+			{
+				++NumDuplicateTypes;
+			}
+		}
+
+		if (NumDuplicateTypes >= Rules.MaxNumDuplicatedTowerTypes)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FCSKMatchSimulator::CanPlayerBuildOnCell(const FCSKSimPlayerState& Player, int32 CellIndex) const
+{
+	if (!State.Cells.IsValidIndex(CellIndex) || !State.Cells[CellIndex].IsWalkable())
+	{
+		return false;
+	}
+
+	// Towers can't be built on portals or outside of build range
+	const FHexGrid::FHex Hex = FHexGrid::CellIndexToHex(CellIndex, Board.Dimensions);
+	return Hex != Board.PortalHexes[0] && Hex != Board.PortalHexes[1] && FHexGrid::HexDisplacement(Player.CastleHex, Hex) <= Rules.MaxBuildRange;
+}
+
+bool FCSKMatchSimulator::CanPlayerCastSpell(const FCSKSimPlayerState& Player, int32 HandIndex) const
+{
+	if (Player.SpellsCastThisRound >= Rules.MaxSpellUses || !Player.SpellsInHand.IsValidIndex(HandIndex))
+	{
+		return false;
+	}
+
+	return Rules.SpellCosts[Player.SpellsInHand[HandIndex]] <= Player.Mana;
+}
+
+int32 FCSKMatchSimulator::GetPlayersNumRemainingMoves(const FCSKSimPlayerState& Player) const
+{
+	// Bonus tile movements are granted by spells, which are not simulated
+	int32 CalculatedMaxMovements = FMath::Max(Rules.MinTileMovements, Rules.MaxTileMovements);
+	return FMath::Max(0, CalculatedMaxMovements - Player.TilesTraversedThisRound);
+}
+
+void FCSKMatchSimulator::ResetSpellDeck(FCSKSimPlayerState& Player)
+{
+	Player.SpellsInHand.Reset();
+
+	Player.SpellDeck.Reset(Rules.SpellCosts.Num());
+	for (int32 i = 0; i < Rules.SpellCosts.Num(); ++i)
+	{
+		Player.SpellDeck.Add(i);
+	}
+
+	// Shuffle deck (mimics ACSKPlayerState::ResetSpellDeck)
+	int32 LastIndex = Player.SpellDeck.Num() - 1;
+	for (int32 i = 0; i <= LastIndex; ++i)
+	{
+		int32 Index = Stream.RandRange(i, LastIndex);
+		if (i != Index)
+		{
+			Player.SpellDeck.Swap(i, Index);
+		}
+	}
+}
+
+bool FCSKMatchSimulator::CheckPortalReached(int32 PlayerID)
+{
+	if (State.Players[PlayerID].CastleHex == Board.PortalHexes[GetOpponent(PlayerID)])
+	{
+		Result.Winner = PlayerID;
+		Result.WinCondition = ECSKMatchWinCondition::PortalReached;
+		bMatchFinished = true;
+
+		return true;
+	}
+
+	return false;
+}
+
+ECSKRoundState FCSKMatchSimulator::GetNextRoundState(ECSKRoundState RoundState)
+{
+	switch (RoundState)
+	{
+		case ECSKRoundState::CollectionPhase:		return ECSKRoundState::FirstActionPhase;
+		case ECSKRoundState::FirstActionPhase:		return ECSKRoundState::SecondActionPhase;
+		case ECSKRoundState::SecondActionPhase:		return ECSKRoundState::EndRoundPhase;
+		default:									return ECSKRoundState::CollectionPhase;
+	}
+}
@@ -22,6 +22,8 @@
 #include "Engine/LocalPlayer.h"
 #include "Kismet/GameplayStatics.h"
 
+DECLARE_CYCLE_STAT(TEXT("CSKPlayerController UpdateSpellTargets"), STAT_CSKPlayerControllerUpdateSpellTargets, STATGROUP_Conquest);
+
 ACSKPlayerController::ACSKPlayerController()
 {
 	bShowMouseCursor = true;
@@ -41,6 +43,18 @@ ACSKPlayerController::ACSKPlayerController()
 	bCanSelectPostQuickEffect = false;
 	bCanSelectBonusSpellTarget = false;
 	bIgnoreCanSelectSpellFlags = false;
+
+	bPrecomputeSpellTargets = true;
+	bHighlightSpellTargets = false;
+	SpellTargetTilesPerFrame = 0;
+	NumSpellTargetsEvaluated = 0;
+	SpellTargetsCard = nullptr;
+	SpellTargetsSpellIndex = 0;
+	SpellTargetsAdditionalMana = 0;
+	SpellTargetsPlayerMana = 0;
+	SpellTargetsPlayerDiscount = 0;
+	SpellTargetsBoardVersion = 0;
+	SpellTargetsHealthReportsVersion = 0;
 }
 
 void ACSKPlayerController::ClientSetHUD_Implementation(TSubclassOf<AHUD> NewHUDClass)
@@ -108,6 +122,12 @@ void ACSKPlayerController::Tick(float DeltaTime)
 		ACSKGameState* GameState = UConquestFunctionLibrary::GetCSKGameState(this);
 		if (GameState && GameState->IsMatchInProgress())
 		{
+			// Evaluated before hovering so the hovered tile can use the results
+			if (bPrecomputeSpellTargets)
+			{
+				UpdateSpellTargets();
+			}
+
 			// Get tile player is hovering over
 			ATile* TileUnderMouse = GetTileUnderMouse();
 			if (TileUnderMouse != HoveredTile)
@@ -210,11 +230,11 @@ void ACSKPlayerController::SetSelectedSpellCard(TSubclassOf<USpellCard> InSpellC
 				// Execute instantly
 				if (IsPerformingActionPhase())
 				{
-					Server_RequestCastSpellAction(SelectedSpellCard, SelectedSpellIndex, TargetTile, SelectedSpellAdditionalMana);				
+					Server_RequestCastSpellAction(SelectedSpellCard, SelectedSpellIndex, GetTileHandle(TargetTile), SelectedSpellAdditionalMana);				
 				}
 				else if (bCanSelectNullifyQuickEffect || bCanSelectPostQuickEffect)
 				{
-					Server_RequestCastQuickEffectAction(SelectedSpellCard, SelectedSpellIndex, TargetTile, SelectedSpellAdditionalMana);
+					Server_RequestCastQuickEffectAction(SelectedSpellCard, SelectedSpellIndex, GetTileHandle(TargetTile), SelectedSpellAdditionalMana);
 				}
 			}
 		}
@@ -335,21 +355,22 @@ void ACSKPlayerController::OnNewTileHovered_Implementation(ATile* NewTile)
 		return;
 	}
 
-	bool bDisplaySpellSelection = false;
-
 	// We want to update the selectable tile based off our current spell we have selected
-	if (IsPerformingActionPhase())
-	{
-		bDisplaySpellSelection = SelectedAction == ECSKActionPhaseMode::CastSpell;
-	}
-	else if (bCanSelectNullifyQuickEffect || bCanSelectPostQuickEffect || bCanSelectBonusSpellTarget)
-	{
-		bDisplaySpellSelection = true;
-	}
-
-	if (bDisplaySpellSelection)
+	if (IsSelectingSpellTarget())
 	{
-		SetTileCandidatesSelectionState(ETileSelectionState::NotSelectable);
+		// The previously hovered tile remains highlighted if all valid targets are
+		for (ATile* Tile : SelectedActionTileCandidates)
+		{
+			bool bIsValidTarget = false;
+			if (Tile && bHighlightSpellTargets && GetEvaluatedSpellTarget(Tile, bIsValidTarget) && bIsValidTarget)
+			{
+				Tile->SetSelectionState(ETileSelectionState::Selectable);
+			}
+			else if (ensure(Tile))
+			{
+				Tile->SetSelectionState(ETileSelectionState::NotSelectable);
+			}
+		}
 
 		// Tile will be null if no longer hovering over the board
 		if (NewTile)
@@ -358,21 +379,28 @@ void ACSKPlayerController::OnNewTileHovered_Implementation(ATile* NewTile)
 			SelectedActionTileCandidates.Empty(1);
 			SelectedActionTileCandidates.Add(NewTile);
 
-			ACSKGameState* CSKGameState = UConquestFunctionLibrary::GetCSKGameState(this);
-			if (CSKGameState)
+			bool bCanCastSpell = false;
+			if (!GetEvaluatedSpellTarget(NewTile, bCanCastSpell))
 			{
-				// We want the selectable highlight to take priority over 
-				ETileSelectionState SelectionState = CSKGameState->CanPlayerCastSpell(this, NewTile, SelectedSpellCard, SelectedSpellIndex, SelectedSpellAdditionalMana)
-					? ETileSelectionState::SelectablePriority : ETileSelectionState::UnselectablePriority;
-
-				NewTile->SetSelectionState(SelectionState);
+				ACSKGameState* CSKGameState = UConquestFunctionLibrary::GetCSKGameState(this);
+				if (CSKGameState)
+				{
+					bCanCastSpell = CSKGameState->CanPlayerCastSpell(this, NewTile, SelectedSpellCard, SelectedSpellIndex, SelectedSpellAdditionalMana);
+				}
 			}
+
+			// We want the selectable highlight to take priority over 
+			NewTile->SetSelectionState(bCanCastSpell ? ETileSelectionState::SelectablePriority : ETileSelectionState::UnselectablePriority);
 		}
 		else
 		{
 			SelectedActionTileCandidates.Empty();
 		}
 	}
+	else if (IsPerformingActionPhase() && SelectedAction == ECSKActionPhaseMode::MoveCastle)
+	{
+		RefreshMoveCastlePreview(NewTile);
+	}
 }
 
 void ACSKPlayerController::NotifyFadeOutInSequenceFinished()
@@ -447,7 +475,7 @@ void ACSKPlayerController::SelectTile()
 	// (We can skip the check here completely if we are the server to prevent the check twice)
 	if (HasAuthority() || (!CustomCanSelectTile.IsBound() || CustomCanSelectTile.Execute(HoveredTile)))
 	{
-		Server_ExecuteCustomOnSelectTile(HoveredTile);
+		Server_ExecuteCustomOnSelectTile(GetTileHandle(HoveredTile));
 		return;
 	}
 }
@@ -466,13 +494,39 @@ void ACSKPlayerController::ResetCamera()
 	}
 }
 
-bool ACSKPlayerController::Server_ExecuteCustomOnSelectTile_Validate(ATile* SelectedTile)
+FBoardTileHandle ACSKPlayerController::GetTileHandle(const ATile* Tile) const
 {
-	return true;
+	ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
+	return BoardManager ? BoardManager->GetTileHandle(Tile) : FBoardTileHandle();
+}
+
+ATile* ACSKPlayerController::GetTileFromHandle(const FBoardTileHandle& Handle) const
+{
+	ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
+	return BoardManager ? BoardManager->GetTileFromHandle(Handle) : nullptr;
+}
+
+bool ACSKPlayerController::IsValidTileHandle(const FBoardTileHandle& Handle) const
+{
+	if (!Handle.IsValid())
+	{
+		return false;
+	}
+
+	// Without a board the request will be rejected anyways, we only check bounds when we can
+	ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
+	return !BoardManager || BoardManager->IsValidTileHandle(Handle);
+}
+
+bool ACSKPlayerController::Server_ExecuteCustomOnSelectTile_Validate(FBoardTileHandle SelectedTile)
+{
+	return IsValidTileHandle(SelectedTile);
 }
 
-void ACSKPlayerController::Server_ExecuteCustomOnSelectTile_Implementation(ATile* SelectedTile)
+void ACSKPlayerController::Server_ExecuteCustomOnSelectTile_Implementation(FBoardTileHandle SelectedTileHandle)
 {
+	ATile* SelectedTile = GetTileFromHandle(SelectedTileHandle);
+
 	// We can skip the can select if it's not bound (assume it returns true)
 	if (!CustomCanSelectTile.IsBound() || CustomCanSelectTile.Execute(SelectedTile))
 	{
@@ -896,6 +950,9 @@ bool ACSKPlayerController::CanRequestCastSpellAction() const
 
 void ACSKPlayerController::OnSelectionModeChanged_Implementation(ECSKActionPhaseMode NewMode)
 {
+	ClearMoveCastlePreview();
+	ResetSpellTargets();
+
 	// Mark previous tiles as disabled
 	SetTileCandidatesSelectionState(ETileSelectionState::NotSelectable);
 	SelectedActionTileCandidates.Empty();
@@ -939,6 +996,8 @@ void ACSKPlayerController::OnRep_bIsActionPhase()
 	}
 	else
 	{
+		ClearMoveCastlePreview();
+		ResetSpellTargets();
 		SetTileCandidatesSelectionState(ETileSelectionState::NotSelectable);
 		SelectedActionTileCandidates.Empty();
 	}
@@ -1023,6 +1082,7 @@ void ACSKPlayerController::Client_OnCastleMoveRequestConfirmed_Implementation(AC
 	// Mark tiles as not selectable while we move
 	if (IsPerformingActionPhase())
 	{
+		ClearMoveCastlePreview();
 		SetTileCandidatesSelectionState(ETileSelectionState::NotSelectable);
 	}
 }
@@ -1050,6 +1110,8 @@ void ACSKPlayerController::Client_OnCastleMoveRequestFinished_Implementation()
 		ACSKGameState* CSKGameState = UConquestFunctionLibrary::GetCSKGameState(this);
 		check(CSKGameState);
 
+		ClearMoveCastlePreview();
+
 		if (CSKGameState->GetTilesPlayerCanMoveTo(this, SelectedActionTileCandidates, true))
 		{
 			SetTileCandidatesSelectionState(ETileSelectionState::Selectable);
@@ -1057,8 +1119,10 @@ void ACSKPlayerController::Client_OnCastleMoveRequestFinished_Implementation()
 	}
 }
 
-void ACSKPlayerController::Client_OnTowerBuildRequestConfirmed_Implementation(ATile* TargetTile)
+void ACSKPlayerController::Client_OnTowerBuildRequestConfirmed_Implementation(FBoardTileHandle TargetTileHandle)
 {
+	ATile* TargetTile = GetTileFromHandle(TargetTileHandle);
+
 	SetCanSelectTile(false);
 	SetIgnoreMoveInput(true);
 
@@ -1105,7 +1169,7 @@ void ACSKPlayerController::Client_OnTowerBuildRequestFinished_Implementation()
 	}
 }
 
-void ACSKPlayerController::Client_OnCastSpellRequestConfirmed_Implementation(EActiveSpellContext SpellContext, ATile* TargetTile)
+void ACSKPlayerController::Client_OnCastSpellRequestConfirmed_Implementation(EActiveSpellContext SpellContext, FBoardTileHandle TargetTile)
 {
 	SetCanSelectTile(false);
 
@@ -1152,7 +1216,7 @@ void ACSKPlayerController::Client_OnCastSpellRequestFinished_Implementation(EAct
 	}
 }
 
-void ACSKPlayerController::Client_OnSelectCounterSpell_Implementation(bool bNullify, TSubclassOf<USpell> SpellToCounter, ATile* TargetTile)
+void ACSKPlayerController::Client_OnSelectCounterSpell_Implementation(bool bNullify, TSubclassOf<USpell> SpellToCounter, FBoardTileHandle TargetTile)
 {
 	SetCanSelectTile(true);
 	SetIgnoreMoveInput(false);
@@ -1160,7 +1224,7 @@ void ACSKPlayerController::Client_OnSelectCounterSpell_Implementation(bool bNull
 	if (CachedCSKHUD)
 	{
 		const USpell* DefaultSpell = SpellToCounter.GetDefaultObject();
-		CachedCSKHUD->OnQuickEffectSelection(true, bNullify, DefaultSpell, TargetTile);
+		CachedCSKHUD->OnQuickEffectSelection(true, bNullify, DefaultSpell, GetTileFromHandle(TargetTile));
 	}
 }
 
@@ -1221,8 +1285,10 @@ bool ACSKPlayerController::DisableActionMode(ECSKActionPhaseMode ActionMode)
 	return false;
 }
 
-void ACSKPlayerController::Client_OnTowerActionStart_Implementation(ATile* TileWithTower)
+void ACSKPlayerController::Client_OnTowerActionStart_Implementation(FBoardTileHandle TileWithTowerHandle)
 {
+	ATile* TileWithTower = GetTileFromHandle(TileWithTowerHandle);
+
 	ACSKPawn* CSKPawn = GetCSKPawn();
 	if (CSKPawn && TileWithTower)
 	{
@@ -1243,7 +1309,7 @@ void ACSKPlayerController::MoveCastleToHoveredTile()
 	{
 		if (HoveredTile)
 		{
-			Server_RequestCastleMoveAction(HoveredTile);
+			Server_RequestCastleMoveAction(GetTileHandle(HoveredTile));
 		}
 	}
 }
@@ -1260,7 +1326,7 @@ void ACSKPlayerController::BuildTowerAtHoveredTile(TSubclassOf<UTowerConstructio
 	{
 		if (HoveredTile)
 		{
-			Server_RequestBuildTowerAction(TowerConstructData, HoveredTile);
+			Server_RequestBuildTowerAction(TowerConstructData, GetTileHandle(HoveredTile));
 		}
 	}
 }
@@ -1277,7 +1343,7 @@ void ACSKPlayerController::CastSpellAtHoveredTile(TSubclassOf<USpellCard> SpellC
 	{
 		if (HoveredTile)
 		{
-			Server_RequestCastSpellAction(SpellCard, SpellIndex, HoveredTile, AdditionalMana);
+			Server_RequestCastSpellAction(SpellCard, SpellIndex, GetTileHandle(HoveredTile), AdditionalMana);
 		}
 	}
 }
@@ -1294,7 +1360,7 @@ void ACSKPlayerController::CastQuickEffectSpellAtHoveredTile(TSubclassOf<USpellC
 	{
 		if (HoveredTile)
 		{
-			Server_RequestCastQuickEffectAction(SpellCard, SpellIndex, HoveredTile, AdditionalMana);
+			Server_RequestCastQuickEffectAction(SpellCard, SpellIndex, GetTileHandle(HoveredTile), AdditionalMana);
 		}
 	}
 }
@@ -1325,7 +1391,7 @@ void ACSKPlayerController::CastBonusElementalSpellAtHoveredTile()
 	{
 		if (HoveredTile)
 		{
-			Server_RequestCastBonusSpellAction(HoveredTile);
+			Server_RequestCastBonusSpellAction(GetTileHandle(HoveredTile));
 		}
 	}
 }
@@ -1369,12 +1435,12 @@ void ACSKPlayerController::Server_EndActionPhase_Implementation()
 	}
 }
 
-bool ACSKPlayerController::Server_RequestCastleMoveAction_Validate(ATile* Goal)
+bool ACSKPlayerController::Server_RequestCastleMoveAction_Validate(FBoardTileHandle Goal)
 {
-	return true;
+	return IsValidTileHandle(Goal);
 }
 
-void ACSKPlayerController::Server_RequestCastleMoveAction_Implementation(ATile* Goal)
+void ACSKPlayerController::Server_RequestCastleMoveAction_Implementation(FBoardTileHandle Goal)
 {
 	bool bSuccess = false;
 
@@ -1383,7 +1449,7 @@ void ACSKPlayerController::Server_RequestCastleMoveAction_Implementation(ATile*
 		ACSKGameMode* GameMode = UConquestFunctionLibrary::GetCSKGameMode(this);
 		if (GameMode)
 		{
-			bSuccess = GameMode->RequestCastleMove(Goal);
+			bSuccess = GameMode->RequestCastleMove(GetTileFromHandle(Goal));
 		}		
 	}
 
@@ -1394,12 +1460,12 @@ void ACSKPlayerController::Server_RequestCastleMoveAction_Implementation(ATile*
 	}
 }
 
-bool ACSKPlayerController::Server_RequestBuildTowerAction_Validate(TSubclassOf<UTowerConstructionData> TowerConstructData, ATile* Target)
+bool ACSKPlayerController::Server_RequestBuildTowerAction_Validate(TSubclassOf<UTowerConstructionData> TowerConstructData, FBoardTileHandle Target)
 {
-	return true;
+	return IsValidTileHandle(Target);
 }
 
-void ACSKPlayerController::Server_RequestBuildTowerAction_Implementation(TSubclassOf<UTowerConstructionData> TowerConstructData, ATile* Target)
+void ACSKPlayerController::Server_RequestBuildTowerAction_Implementation(TSubclassOf<UTowerConstructionData> TowerConstructData, FBoardTileHandle Target)
 {
 	bool bSuccess = false;
 
@@ -1408,7 +1474,7 @@ void ACSKPlayerController::Server_RequestBuildTowerAction_Implementation(TSubcla
 		ACSKGameMode* GameMode = UConquestFunctionLibrary::GetCSKGameMode(this);
 		if (GameMode)
 		{
-			bSuccess = GameMode->RequestBuildTower(TowerConstructData, Target);
+			bSuccess = GameMode->RequestBuildTower(TowerConstructData, GetTileFromHandle(Target));
 		}
 	}
 
@@ -1419,12 +1485,12 @@ void ACSKPlayerController::Server_RequestBuildTowerAction_Implementation(TSubcla
 	}
 }
 
-bool ACSKPlayerController::Server_RequestCastSpellAction_Validate(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, ATile* Target, int32 AdditionalMana)
+bool ACSKPlayerController::Server_RequestCastSpellAction_Validate(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, FBoardTileHandle Target, int32 AdditionalMana)
 {
-	return true;
+	return IsValidTileHandle(Target);
 }
 
-void ACSKPlayerController::Server_RequestCastSpellAction_Implementation(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, ATile* Target, int32 AdditionalMana)
+void ACSKPlayerController::Server_RequestCastSpellAction_Implementation(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, FBoardTileHandle Target, int32 AdditionalMana)
 {
 	bool bSuccess = false;
 
@@ -1433,7 +1499,7 @@ void ACSKPlayerController::Server_RequestCastSpellAction_Implementation(TSubclas
 		ACSKGameMode* GameMode = UConquestFunctionLibrary::GetCSKGameMode(this);
 		if (GameMode)
 		{
-			bSuccess = GameMode->RequestCastSpell(SpellCard, SpellIndex, Target, AdditionalMana);
+			bSuccess = GameMode->RequestCastSpell(SpellCard, SpellIndex, GetTileFromHandle(Target), AdditionalMana);
 		}
 	}
 
@@ -1444,12 +1510,12 @@ void ACSKPlayerController::Server_RequestCastSpellAction_Implementation(TSubclas
 	}
 }
 
-bool ACSKPlayerController::Server_RequestCastQuickEffectAction_Validate(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, ATile* Target, int32 AdditionalMana)
+bool ACSKPlayerController::Server_RequestCastQuickEffectAction_Validate(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, FBoardTileHandle Target, int32 AdditionalMana)
 {
-	return true;
+	return IsValidTileHandle(Target);
 }
 
-void ACSKPlayerController::Server_RequestCastQuickEffectAction_Implementation(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, ATile* Target, int32 AdditionalMana)
+void ACSKPlayerController::Server_RequestCastQuickEffectAction_Implementation(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, FBoardTileHandle Target, int32 AdditionalMana)
 {
 	bool bSuccess = false;
 
@@ -1458,7 +1524,7 @@ void ACSKPlayerController::Server_RequestCastQuickEffectAction_Implementation(TS
 		ACSKGameMode* GameMode = UConquestFunctionLibrary::GetCSKGameMode(this);
 		if (GameMode)
 		{
-			bSuccess = GameMode->RequestCastQuickEffect(SpellCard, SpellIndex, Target, AdditionalMana);
+			bSuccess = GameMode->RequestCastQuickEffect(SpellCard, SpellIndex, GetTileFromHandle(Target), AdditionalMana);
 		}
 	}
 
@@ -1494,12 +1560,12 @@ void ACSKPlayerController::Server_SkipQuickEffectSelection_Implementation()
 	}
 }
 
-bool ACSKPlayerController::Server_RequestCastBonusSpellAction_Validate(ATile* Target)
+bool ACSKPlayerController::Server_RequestCastBonusSpellAction_Validate(FBoardTileHandle Target)
 {
-	return true;
+	return IsValidTileHandle(Target);
 }
 
-void ACSKPlayerController::Server_RequestCastBonusSpellAction_Implementation(ATile* Target)
+void ACSKPlayerController::Server_RequestCastBonusSpellAction_Implementation(FBoardTileHandle Target)
 {
 	bool bSuccess = false;
 
@@ -1508,7 +1574,7 @@ void ACSKPlayerController::Server_RequestCastBonusSpellAction_Implementation(ATi
 		ACSKGameMode* GameMode = UConquestFunctionLibrary::GetCSKGameMode(this);
 		if (GameMode)
 		{
-			bSuccess = GameMode->RequestCastBonusSpell(Target);
+			bSuccess = GameMode->RequestCastBonusSpell(GetTileFromHandle(Target));
 		}
 	}
 
@@ -1582,3 +1648,209 @@ void ACSKPlayerController::SetTileCandidatesSelectionState(ETileSelectionState S
 		}
 	}
 }
+
+bool ACSKPlayerController::IsSelectingSpellTarget() const
+{
+	if (IsPerformingActionPhase())
+	{
+		return SelectedAction == ECSKActionPhaseMode::CastSpell;
+	}
+
+	return bCanSelectNullifyQuickEffect || bCanSelectPostQuickEffect || bCanSelectBonusSpellTarget;
+}
+
+void ACSKPlayerController::UpdateSpellTargets()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CSKPlayerControllerUpdateSpellTargets);
+
+	// Custom selections are not spell casts
+	if (!SelectedSpellCard || CustomCanSelectTile.IsBound() || !IsSelectingSpellTarget())
+	{
+		if (SpellTargetsCard)
+		{
+			ResetSpellTargets();
+		}
+
+		return;
+	}
+
+	ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
+	ACSKGameState* CSKGameState = UConquestFunctionLibrary::GetCSKGameState(this);
+	const ACSKPlayerState* CSKPlayerState = GetCSKPlayerState();
+	if (!BoardManager || !CSKGameState || !CSKPlayerState)
+	{
+		return;
+	}
+
+	// Spending mana, discounts, changes to the board or health of board pieces can change which tiles are valid
+	if (!AreSpellTargetsCurrent(BoardManager, CSKGameState, CSKPlayerState))
+	{
+		ResetSpellTargets();
+
+		SpellTargetsCard = SelectedSpellCard;
+		SpellTargetsSpellIndex = SelectedSpellIndex;
+		SpellTargetsAdditionalMana = SelectedSpellAdditionalMana;
+		SpellTargetsPlayerMana = CSKPlayerState->GetMana();
+		SpellTargetsPlayerDiscount = CSKPlayerState->GetSpellDiscount();
+		SpellTargetsBoardVersion = BoardManager->GetOccupancyVersion();
+		SpellTargetsHealthReportsVersion = CSKGameState->GetLatestHealthReportsVersion();
+
+		SpellTargetMask.Init(BoardManager->GetTileMask().Num());
+	}
+
+	const int32 NumTiles = SpellTargetMask.Num();
+	if (NumSpellTargetsEvaluated >= NumTiles)
+	{
+		return;
+	}
+
+	const int32 EndIndex = SpellTargetTilesPerFrame > 0 ? FMath::Min(NumTiles, NumSpellTargetsEvaluated + SpellTargetTilesPerFrame) : NumTiles;
+	const FBoardTileMask& TileMask = BoardManager->GetTileMask();
+
+	for (int32 Index = NumSpellTargetsEvaluated; Index < EndIndex; ++Index)
+	{
+		if (!TileMask.IsSet(Index))
+		{
+			continue;
+		}
+
+		ATile* Tile = BoardManager->GetTileFromHandle(FBoardTileHandle(Index));
+		if (Tile && CSKGameState->CanPlayerCastSpell(this, Tile, SelectedSpellCard, SelectedSpellIndex, SelectedSpellAdditionalMana))
+		{
+			SpellTargetMask.SetBit(Index);
+
+			// Hovered tile is already displaying its priority highlight
+			if (bHighlightSpellTargets && Tile != HoveredTile)
+			{
+				Tile->SetSelectionState(ETileSelectionState::Selectable);
+			}
+		}
+	}
+
+	NumSpellTargetsEvaluated = EndIndex;
+}
+
+void ACSKPlayerController::ResetSpellTargets()
+{
+	if (bHighlightSpellTargets)
+	{
+		ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
+		if (BoardManager && SpellTargetMask.Num() == BoardManager->GetTileMask().Num())
+		{
+			BoardManager->ForEachTileInMask(SpellTargetMask, [this](ATile* Tile)->void
+			{
+				// Hovered tile is managed by the hover selection
+				if (Tile != HoveredTile)
+				{
+					Tile->SetSelectionState(ETileSelectionState::NotSelectable);
+				}
+			});
+		}
+	}
+
+	SpellTargetMask.ClearAll();
+	NumSpellTargetsEvaluated = 0;
+	SpellTargetsCard = nullptr;
+}
+
+bool ACSKPlayerController::AreSpellTargetsCurrent(const ABoardManager* BoardManager, const ACSKGameState* GameState, const ACSKPlayerState* PlayerState) const
+{
+	return SpellTargetsCard && SpellTargetsCard == SelectedSpellCard &&
+		SpellTargetsSpellIndex == SelectedSpellIndex &&
+		SpellTargetsAdditionalMana == SelectedSpellAdditionalMana &&
+		SpellTargetsPlayerMana == PlayerState->GetMana() &&
+		SpellTargetsPlayerDiscount == PlayerState->GetSpellDiscount() &&
+		SpellTargetsBoardVersion == BoardManager->GetOccupancyVersion() &&
+		SpellTargetsHealthReportsVersion == GameState->GetLatestHealthReportsVersion() &&
+		SpellTargetMask.Num() == BoardManager->GetTileMask().Num();
+}
+
+bool ACSKPlayerController::GetEvaluatedSpellTarget(const ATile* Tile, bool& bOutIsValid) const
+{
+	if (!bPrecomputeSpellTargets || !Tile)
+	{
+		return false;
+	}
+
+	const ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
+	const ACSKGameState* CSKGameState = UConquestFunctionLibrary::GetCSKGameState(this);
+	const ACSKPlayerState* CSKPlayerState = GetCSKPlayerState();
+	if (!BoardManager || !CSKGameState || !CSKPlayerState || !AreSpellTargetsCurrent(BoardManager, CSKGameState, CSKPlayerState))
+	{
+		return false;
+	}
+
+	const int32 Index = FHexGrid::HexToCellIndex(Tile->GetGridHexValue(), BoardManager->GetGridDimensions());
+	if (Index == INDEX_NONE || Index >= NumSpellTargetsEvaluated)
+	{
+		return false;
+	}
+
+	bOutIsValid = SpellTargetMask.IsSet(Index);
+	return true;
+}
+
+void ACSKPlayerController::RefreshMoveCastlePreview(ATile* NewTile)
+{
+	ClearMoveCastlePreview();
+
+	// We only preview moves to tiles we can actually move to
+	if (!NewTile || !CastlePawn || !SelectedActionTileCandidates.Contains(NewTile))
+	{
+		return;
+	}
+
+	ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this);
+	if (BoardManager)
+	{
+		// Searching is done off the game thread, so hovering remains responsive on large boards
+		MoveCastlePreviewHandle = BoardManager->FindPathAsync(CastlePawn->GetCachedTile(), NewTile,
+			FBoardPathQueryFinished::CreateUObject(this, &ACSKPlayerController::OnMoveCastlePreviewPathFound), false);
+	}
+}
+
+void ACSKPlayerController::ClearMoveCastlePreview()
+{
+	if (MoveCastlePreviewHandle.IsValid())
+	{
+		ABoardManager* BoardManager = UConquestFunctionLibrary::GetMatchBoardManager(this, false);
+		if (BoardManager)
+		{
+			BoardManager->CancelAsyncQuery(MoveCastlePreviewHandle);
+		}
+
+		MoveCastlePreviewHandle.Invalidate();
+	}
+
+	// Restore the tiles to how they were before previewing
+	for (ATile* Tile : MoveCastlePreviewTiles)
+	{
+		if (Tile)
+		{
+			Tile->SetSelectionState(SelectedActionTileCandidates.Contains(Tile) ? ETileSelectionState::Selectable : ETileSelectionState::NotSelectable);
+		}
+	}
+
+	MoveCastlePreviewTiles.Empty();
+}
+
+void ACSKPlayerController::OnMoveCastlePreviewPathFound(bool bSuccess, const FBoardPath& Path)
+{
+	MoveCastlePreviewHandle.Invalidate();
+
+	if (!bSuccess || !IsPerformingActionPhase() || SelectedAction != ECSKActionPhaseMode::MoveCastle)
+	{
+		return;
+	}
+
+	// Skip the castles tile and the hovered tile, so the hover highlight is still displayed
+	for (int32 i = 1; i < Path.Num() - 1; ++i)
+	{
+		ATile* Tile = Path[i];
+		if (Tile)
+		{
+			Tile->SetSelectionState(ETileSelectionState::Preview);
+			MoveCastlePreviewTiles.Add(Tile);
+		}
+	}
+}
@@ -2,6 +2,7 @@
 
 #include "CSKPlayerState.h"
 #include "CSKPlayerController.h"
+#include "CSKGameMode.h"
 #include "CSKGameState.h"
 #include "SpellCard.h"
 #include "Tower.h"
@@ -17,7 +18,6 @@ ACSKPlayerState::ACSKPlayerState()
 	Gold = 0;
 	Mana = 0;
 	BonusTileMovements = 0;
-	CachedNumLegendaryTowers = 0;
 	MaxNumSpellUses = 1;
 	bHasInfiniteSpellUses = false;
 	SpellDiscount = 0;
@@ -167,9 +167,14 @@ void ACSKPlayerState::AddTower(ATower* InTower)
 	if (HasAuthority() && InTower)
 	{
 		OwnedTowers.Add(InTower);
+		OwnedTowerRegistry.AddTower(InTower);
 
-		// Recalculate the cached counts we have
-		UpdateTowerCounts();
+		// Towers can be given to players from anywhere (including Blueprints), so we keep the schedule updated here
+		ACSKGameMode* GameMode = UConquestFunctionLibrary::GetCSKGameMode(this);
+		if (GameMode)
+		{
+			GameMode->NotifyTowerAdded(this, InTower);
+		}
 
 		if (InTower->IsLegendaryTower())
 		{
@@ -186,11 +191,15 @@ void ACSKPlayerState::RemoveTower(ATower* InTower)
 {
 	if (HasAuthority())
 	{
-		// We can avoid recalc if we don't remove anything
 		if (OwnedTowers.Remove(InTower) > 0)
 		{
-			// Recalculate the cached counts we have
-			UpdateTowerCounts();
+			OwnedTowerRegistry.RemoveTower(InTower);
+
+			ACSKGameMode* GameMode = UConquestFunctionLibrary::GetCSKGameMode(this);
+			if (GameMode)
+			{
+				GameMode->NotifyTowerRemoved(InTower);
+			}
 		}
 	}
 }
@@ -340,34 +349,12 @@ bool ACSKPlayerState::GetMaxAdditionalManaIfAffordable(int32 RequiredAmount, int
 
 int32 ACSKPlayerState::GetNumOwnedTowerDuplicates(TSubclassOf<ATower> Tower) const
 {
-	if (Tower)
-	{		
-		const int32* Num = CachedUniqueTowerCount.Find(Tower);
-		if (Num != nullptr)
-		{
-			return *Num;
-		}
-	}
-
-	return 0;
+	return OwnedTowerRegistry.GetNumInstances(Tower);
 }
 
 int32 ACSKPlayerState::GetNumOwnedTowerDuplicateTypes() const
 {
-	TArray<int32> TowerCounts;
-	CachedUniqueTowerCount.GenerateValueArray(TowerCounts);
-
-	int32 NumTypes = 0;
-	for (int32 Count : TowerCounts)
-	{
-		// Owning two of the same type means we have a duplicate
-		if (Count >= 2)
-		{
-			++NumTypes;
-		}
-	}
-
-	return NumTypes;
+	return OwnedTowerRegistry.GetNumDuplicateTypes();
 }
 
 bool ACSKPlayerState::CanCastAnotherSpell(bool bCheckCost) const
@@ -451,36 +438,8 @@ bool ACSKPlayerState::NeedsSpellDeckReshuffle() const
 
 void ACSKPlayerState::OnRep_OwnedTowers()
 {
-	UpdateTowerCounts();
-}
-
-void ACSKPlayerState::UpdateTowerCounts()
-{
-	CachedNumLegendaryTowers = 0;
-	CachedUniqueTowerCount.Reset();
-
-	for (ATower* Tower : OwnedTowers)
-	{
-		if (!ensure(Tower))
-		{
-			continue;
-		}
-
-		if (Tower->IsLegendaryTower())
-		{
-			++CachedNumLegendaryTowers;
-		}
-
-		TSubclassOf<ATower> TowerClass = Tower->GetClass();
-		if (CachedUniqueTowerCount.Contains(TowerClass))
-		{
-			CachedUniqueTowerCount[TowerClass]++;
-		}
-		else
-		{
-			CachedUniqueTowerCount.Add(TowerClass, 1);
-		}
-	}
+	// Only the towers that were added or removed are counted
+	OwnedTowerRegistry.SyncTowers(OwnedTowers);
 }
 
 void ACSKPlayerState::IncrementTilesTraversed()
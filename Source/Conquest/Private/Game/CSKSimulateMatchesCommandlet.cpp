@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CSKSimulateMatchesCommandlet.h"
+#include "CSKGameMode.h"
+#include "CSKMatchSimulator.h"
+
+#include "BoardManager.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/PlatformTime.h"
+
+UCSKSimulateMatchesCommandlet::UCSKSimulateMatchesCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+namespace SimulateMatches
+{
+	ECSKSimPolicy ParsePolicy(const FString& Params, const TCHAR* Switch)
+	{
+		FString PolicyName;
+		if (FParse::Value(*Params, Switch, PolicyName) && PolicyName.Equals(TEXT("Random"), ESearchCase::IgnoreCase))
+		{
+			return ECSKSimPolicy::Random;
+		}
+
+		return ECSKSimPolicy::Greedy;
+	}
+
+	ABoardManager* FindBoardManager(UWorld* World)
+	{
+		if (World && World->PersistentLevel)
+		{
+			for (AActor* Actor : World->PersistentLevel->Actors)
+			{
+				if (ABoardManager* BoardManager = Cast<ABoardManager>(Actor))
+				{
+					return BoardManager;
+				}
+			}
+		}
+
+		return nullptr;
+	}
+}
+
+int32 UCSKSimulateMatchesCommandlet::Main(const FString& Params)
+{
+	int32 NumMatches = 1000;
+	int32 Seed = 0;
+	int32 Rows = 9;
+	int32 Columns = 15;
+
+	FParse::Value(*Params, TEXT("Matches="), NumMatches);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Rows="), Rows);
+	FParse::Value(*Params, TEXT("Columns="), Columns);
+
+	const ECSKSimPolicy Player1Policy = SimulateMatches::ParsePolicy(Params, TEXT("P1="));
+	const ECSKSimPolicy Player2Policy = SimulateMatches::ParsePolicy(Params, TEXT("P2="));
+
+	UWorld* World = nullptr;
+	FCSKSimBoard Board;
+
+	FString MapName;
+	if (FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UPackage* MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+		World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+
+		if (!Board.InitFromBoardManager(SimulateMatches::FindBoardManager(World)))
+		{
+			UE_LOG(LogConquest, Error, TEXT("CSKSimulateMatches: Map %s either has no board manager or the board has no portals set"), *MapName);
+			return 1;
+		}
+	}
+	else
+	{
+		Board.InitEmpty(FIntPoint(FMath::Max(1, Rows), FMath::Max(2, Columns)));
+	}
+
+	// Use the game mode set for the map if one was not specified
+	TSubclassOf<ACSKGameMode> GameModeClass = ACSKGameMode::StaticClass();
+
+	FString GameModeName;
+	if (FParse::Value(*Params, TEXT("GameMode="), GameModeName))
+	{
+		GameModeClass = LoadClass<ACSKGameMode>(nullptr, *GameModeName);
+	}
+	else if (World && World->GetWorldSettings() && World->GetWorldSettings()->DefaultGameMode)
+	{
+		if (World->GetWorldSettings()->DefaultGameMode->IsChildOf(ACSKGameMode::StaticClass()))
+		{
+			GameModeClass = *World->GetWorldSettings()->DefaultGameMode;
+		}
+	}
+
+	if (!GameModeClass)
+	{
+		UE_LOG(LogConquest, Error, TEXT("CSKSimulateMatches: Game mode %s is not a CSK game mode"), *GameModeName);
+		return 1;
+	}
+
+	FCSKSimRules Rules;
+	Rules.CopyFromGameMode(GameModeClass.GetDefaultObject());
+	FParse::Value(*Params, TEXT("MaxRounds="), Rules.MaxRounds);
+
+	UE_LOG(LogConquest, Display, TEXT("CSKSimulateMatches: Simulating %i matches using %s on a %ix%i board (%i towers, %i spells)"),
+		NumMatches, *GameModeClass->GetName(), Board.Dimensions.X, Board.Dimensions.Y, Rules.Towers.Num(), Rules.SpellCosts.Num());
+
+	FCSKMatchSimulator Simulator(Rules, Board);
+
+	int32 Wins[CSK_MAX_NUM_PLAYERS] = { 0, 0 };
+	int32 Draws = 0;
+	int64 TotalRounds = 0;
+	int64 TotalTowersBuilt = 0;
+	int64 TotalSpellsCast = 0;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int32 i = 0; i < NumMatches; ++i)
+	{
+		FCSKSimMatchResult Result = Simulator.PlayMatch(Seed + i, Player1Policy, Player2Policy);
+		if (Result.Winner == -1)
+		{
+			++Draws;
+		}
+		else
+		{
+			++Wins[Result.Winner];
+		}
+
+		TotalRounds += Result.NumRounds;
+		TotalTowersBuilt += Result.TowersBuilt;
+		TotalSpellsCast += Result.SpellsCast;
+	}
+
+	const double ElapsedTime = FMath::Max(FPlatformTime::Seconds() - StartTime, SMALL_NUMBER);
+	const float Divisor = static_cast<float>(FMath::Max(1, NumMatches));
+
+	UE_LOG(LogConquest, Display, TEXT("CSKSimulateMatches: Player 1 Wins: %i (%.1f%%), Player 2 Wins: %i (%.1f%%), Draws: %i (%.1f%%)"),
+		Wins[0], 100.f * Wins[0] / Divisor, Wins[1], 100.f * Wins[1] / Divisor, Draws, 100.f * Draws / Divisor);
+	UE_LOG(LogConquest, Display, TEXT("CSKSimulateMatches: Average Rounds: %.2f, Average Towers Built: %.2f, Average Spells Cast: %.2f"),
+		TotalRounds / Divisor, TotalTowersBuilt / Divisor, TotalSpellsCast / Divisor);
+	UE_LOG(LogConquest, Display, TEXT("CSKSimulateMatches: Finished in %.3fs (%.0f matches per second)"),
+		ElapsedTime, NumMatches / ElapsedTime);
+
+	return 0;
+}
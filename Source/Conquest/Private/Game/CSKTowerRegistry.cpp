@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CSKTowerRegistry.h"
+#include "Tower.h"
+
+FCSKTowerRegistry::FCSKTowerRegistry()
+	: NumLegendaryTowers(0)
+	, NumDuplicateTypes(0)
+	, Version(0)
+{
+
+}
+
+bool FCSKTowerRegistry::AddTower(const ATower* Tower)
+{
+	if (!Tower || RegisteredTowers.Contains(Tower))
+	{
+		return false;
+	}
+
+	FRegisteredTower Entry;
+	Entry.Class = Tower->GetClass();
+	Entry.bIsLegendary = Tower->IsLegendaryTower();
+
+	RegisteredTowers.Add(Tower, Entry);
+	UpdateCounts(Entry.Class, Entry.bIsLegendary, 1);
+
+	return true;
+}
+
+bool FCSKTowerRegistry::RemoveTower(const ATower* Tower)
+{
+	FRegisteredTower Entry;
+	if (Tower && RegisteredTowers.RemoveAndCopyValue(Tower, Entry))
+	{
+		UpdateCounts(Entry.Class, Entry.bIsLegendary, -1);
+		return true;
+	}
+
+	return false;
+}
+
+void FCSKTowerRegistry::SyncTowers(const TArray<ATower*>& Towers)
+{
+	TSet<TWeakObjectPtr<const ATower>, DefaultKeyFuncs<TWeakObjectPtr<const ATower>>, TInlineSetAllocator<16>> TowerSet;
+	TowerSet.Reserve(Towers.Num());
+
+	for (const ATower* Tower : Towers)
+	{
+		if (Tower)
+		{
+			TowerSet.Add(Tower);
+		}
+	}
+
+	// Towers no longer in the set might have been destroyed, so only compare keys
+	for (auto It = RegisteredTowers.CreateIterator(); It; ++It)
+	{
+		if (!TowerSet.Contains(It.Key()))
+		{
+			UpdateCounts(It.Value().Class, It.Value().bIsLegendary, -1);
+			It.RemoveCurrent();
+		}
+	}
+
+	for (const ATower* Tower : Towers)
+	{
+		AddTower(Tower);
+	}
+}
+
+void FCSKTowerRegistry::Reset()
+{
+	RegisteredTowers.Reset();
+	ClassCounts.Reset();
+	NumLegendaryTowers = 0;
+	NumDuplicateTypes = 0;
+
+	++Version;
+}
+
+void FCSKTowerRegistry::UpdateCounts(const UClass* TowerClass, bool bIsLegendary, int32 Delta)
+{
+	int32& Count = ClassCounts.FindOrAdd(TowerClass);
+	const int32 OldCount = Count;
+	Count = FMath::Max(0, Count + Delta);
+
+	// Owning two of the same type means we have a duplicate
+	if (OldCount < 2 && Count >= 2)
+	{
+		++NumDuplicateTypes;
+	}
+	else if (OldCount >= 2 && Count < 2)
+	{
+		--NumDuplicateTypes;
+	}
+
+	if (Count == 0)
+	{
+		ClassCounts.Remove(TowerClass);
+	}
+
+	if (bIsLegendary)
+	{
+		NumLegendaryTowers = FMath::Max(0, NumLegendaryTowers + Delta);
+	}
+
+	++Version;
+}
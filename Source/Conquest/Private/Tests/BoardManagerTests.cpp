@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Tests/BoardTestWorld.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoardManagerPathCacheTest, "Conquest.Board.PathCache", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FBoardManagerPathCacheTest::RunTest(const FString& Parameters)
+{
+	FBoardTestWorld TestWorld(FIntPoint(8, 8));
+
+	ABoardManager* BoardManager = TestWorld.GetBoardManager();
+	if (!TestNotNull(TEXT("Board manager"), BoardManager))
+	{
+		return false;
+	}
+
+	ATile* Start = TestWorld.GetTile(9);
+	ATile* Goal = TestWorld.GetTile(45);
+	if (!TestNotNull(TEXT("Start tile"), Start) || !TestNotNull(TEXT("Goal tile"), Goal))
+	{
+		return false;
+	}
+
+	// Paths to self succeed with an empty path, the second query is answered by the cache
+	for (int32 Attempt = 0; Attempt < 2; ++Attempt)
+	{
+		FBoardPath Path;
+		TestTrue(FString::Printf(TEXT("Path to self succeeds (attempt %i)"), Attempt), BoardManager->FindPath(Start, Start, Path, false));
+		TestEqual(FString::Printf(TEXT("Path to self is empty (attempt %i)"), Attempt), Path.Num(), 0);
+	}
+
+	// Surround the goal with null tiles so it can't be reached
+	TArray<ATile*> WallTiles;
+	BoardManager->GetTilesAtDistance(Goal, 1, WallTiles, false);
+	for (ATile* Tile : WallTiles)
+	{
+		Tile->bIsNullTile = true;
+		BoardManager->NotifyTileStateChanged(Tile);
+	}
+
+	for (int32 Attempt = 0; Attempt < 2; ++Attempt)
+	{
+		FBoardPath Path;
+		TestFalse(FString::Printf(TEXT("Unreachable goal fails (attempt %i)"), Attempt), BoardManager->FindPath(Start, Goal, Path, false));
+		TestEqual(FString::Printf(TEXT("Unreachable goal has no path (attempt %i)"), Attempt), Path.Num(), 0);
+	}
+
+	// Partial paths to the same goal still succeed, and cached results must match the search
+	FBoardPath SearchedPath;
+	FBoardPath CachedPath;
+	TestTrue(TEXT("Partial path to unreachable goal succeeds"), BoardManager->FindPath(Start, Goal, SearchedPath, true));
+	TestTrue(TEXT("Cached partial path to unreachable goal succeeds"), BoardManager->FindPath(Start, Goal, CachedPath, true));
+	TestTrue(TEXT("Cached partial path matches searched path"), SearchedPath.Path == CachedPath.Path);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoardManagerTileHandleTest, "Conquest.Board.TileHandles", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FBoardManagerTileHandleTest::RunTest(const FString& Parameters)
+{
+	FBoardTestWorld TestWorld(FIntPoint(8, 8));
+
+	ABoardManager* BoardManager = TestWorld.GetBoardManager();
+	if (!TestNotNull(TEXT("Board manager"), BoardManager))
+	{
+		return false;
+	}
+
+	const int32 NumTiles = BoardManager->GetNumTiles();
+	TestEqual(TEXT("Every cell can be referenced"), NumTiles, 64);
+
+	// Handles of tiles on the board resolve back to the same tile
+	ATile* Tile = TestWorld.GetTile(NumTiles - 1);
+	if (TestNotNull(TEXT("Last tile"), Tile))
+	{
+		const FBoardTileHandle Handle = BoardManager->GetTileHandle(Tile);
+		TestTrue(TEXT("Last tile handle is valid"), BoardManager->IsValidTileHandle(Handle));
+		TestTrue(TEXT("Last tile handle resolves to last tile"), BoardManager->GetTileFromHandle(Handle) == Tile);
+	}
+
+	// Clients can send any index, these are rejected when validating RPCs
+	TestFalse(TEXT("Default handle is rejected"), BoardManager->IsValidTileHandle(FBoardTileHandle()));
+	TestFalse(TEXT("Negative handle is rejected"), BoardManager->IsValidTileHandle(FBoardTileHandle(-1)));
+	TestFalse(TEXT("Handle past last tile is rejected"), BoardManager->IsValidTileHandle(FBoardTileHandle(NumTiles)));
+	TestFalse(TEXT("Handle of max index is rejected"), BoardManager->IsValidTileHandle(FBoardTileHandle(FBoardTileHandle::MaxBoardTiles - 1)));
+	TestNull(TEXT("Handle past last tile resolves to null"), BoardManager->GetTileFromHandle(FBoardTileHandle(NumTiles)));
+
+	return true;
+}
+
+#endif
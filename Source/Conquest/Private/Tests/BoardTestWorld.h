@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "BoardManager.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+/**
+ * Transient game world containing a single board manager for tests to run against.
+ * The world (including the board and its tiles) is destroyed once this goes out of scope
+ */
+class FBoardTestWorld
+{
+public:
+
+	FBoardTestWorld(const FIntPoint& Dimensions, float HexSize = 100.f)
+		: World(nullptr)
+		, BoardManager(nullptr)
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false);
+		check(World);
+
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		BoardManager = World->SpawnActor<ABoardManager>();
+		if (BoardManager)
+		{
+			BoardManager->InitBoard(FBoardInitData(Dimensions, HexSize, FVector::ZeroVector, FRotator::ZeroRotator));
+		}
+	}
+
+	~FBoardTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+public:
+
+	/** Get the world we created */
+	FORCEINLINE UWorld* GetWorld() const { return World; }
+
+	/** Get the board manager of this world (can be null if it failed to spawn) */
+	FORCEINLINE ABoardManager* GetBoardManager() const { return BoardManager; }
+
+	/** Get the tile at given dense cell index of the board */
+	FORCEINLINE ATile* GetTile(int32 CellIndex) const
+	{
+		return BoardManager->GetTileAt(FHexGrid::CellIndexToHex(CellIndex, BoardManager->GetGridDimensions()));
+	}
+
+private:
+
+	/** The world we created */
+	UWorld* World;
+
+	/** The board manager spawned into the world */
+	ABoardManager* BoardManager;
+};
+
+#endif
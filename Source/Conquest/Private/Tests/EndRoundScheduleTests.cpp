@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Tests/BoardTestWorld.h"
+#include "CSKGameMode.h"
+#include "CSKPlayerState.h"
+#include "Tower.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+namespace EndRoundScheduleTests
+{
+	/** Tower spawned for the test. Towers are abstract, so we use one from content */
+	const TCHAR* TowerClassPath = TEXT("/Game/Board/Towers/Blueprints/BP_CannonTower.BP_CannonTower_C");
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEndRoundScheduleTowerRemovalTest, "Conquest.Game.EndRoundSchedule", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FEndRoundScheduleTowerRemovalTest::RunTest(const FString& Parameters)
+{
+	UClass* TowerClass = LoadClass<ATower>(nullptr, EndRoundScheduleTests::TowerClassPath);
+	if (!TestNotNull(TEXT("Tower class"), TowerClass))
+	{
+		return false;
+	}
+
+	FBoardTestWorld TestWorld(FIntPoint(4, 4));
+	UWorld* World = TestWorld.GetWorld();
+
+	// Player states find the game mode through the world
+	ACSKGameMode* GameMode = World->SpawnActor<ACSKGameMode>();
+	ACSKPlayerState* PlayerState = World->SpawnActor<ACSKPlayerState>();
+	if (!TestNotNull(TEXT("Game mode"), GameMode) || !TestNotNull(TEXT("Player state"), PlayerState))
+	{
+		return false;
+	}
+
+	World->AuthorityGameMode = GameMode;
+
+	ATower* FirstTower = World->SpawnActor<ATower>(TowerClass);
+	ATower* SecondTower = World->SpawnActor<ATower>(TowerClass);
+	if (!TestNotNull(TEXT("First tower"), FirstTower) || !TestNotNull(TEXT("Second tower"), SecondTower))
+	{
+		return false;
+	}
+
+	const FEndRoundActionSchedule& Schedule = GameMode->GetEndRoundActionSchedule();
+
+	PlayerState->AddTower(FirstTower);
+	PlayerState->AddTower(SecondTower);
+	TestEqual(TEXT("Added towers are scheduled"), Schedule.Num(), 2);
+
+	// Removing a tower without going through the game mode (e.g. from a spell Blueprint) must still unschedule it
+	PlayerState->RemoveTower(FirstTower);
+	TestEqual(TEXT("Removed tower is unscheduled"), Schedule.Num(), 1);
+	TestTrue(TEXT("Remaining tower is still scheduled"), Schedule.Num() == 1 && Schedule[0].Tower == SecondTower);
+
+	// Removing a tower the player doesn't own leaves the schedule alone
+	PlayerState->RemoveTower(FirstTower);
+	TestEqual(TEXT("Removing unowned tower keeps schedule"), Schedule.Num(), 1);
+
+	World->AuthorityGameMode = nullptr;
+	return true;
+}
+
+#endif
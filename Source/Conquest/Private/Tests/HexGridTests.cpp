@@ -0,0 +1,504 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Containers/HexGrid.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace HexGridTests
+{
+	/** Sizes of the boards tests are ran with */
+	static const int32 BoardSizes[] = { 8, 16, 32, 64, 128 };
+
+	/** Adds a test for each board size */
+	void GetBoardSizeTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands)
+	{
+		for (int32 Size : BoardSizes)
+		{
+			OutBeautifiedNames.Add(FString::Printf(TEXT("%ix%i"), Size, Size));
+			OutTestCommands.Add(FString::FromInt(Size));
+		}
+	}
+
+	/** Builds the cell states for a board of given dimensions. Some cells are made null or occupied, so
+	searches have to path around them. The same dimensions will always generate the same cells */
+	void BuildCells(const FIntPoint& Dimensions, TArray<FHexGridCellState>& OutCells)
+	{
+		FRandomStream RandomStream(Dimensions.X * Dimensions.Y);
+
+		OutCells.SetNum(Dimensions.X * Dimensions.Y);
+		for (FHexGridCellState& Cell : OutCells)
+		{
+			const float Roll = RandomStream.FRand();
+			if (Roll < 0.2f)
+			{
+				Cell = FHexGridCellState(EHexGridCellFlags::Null, -1, 0);
+			}
+			else if (Roll < 0.3f)
+			{
+				Cell = FHexGridCellState(EHexGridCellFlags::Occupied, 0, 0);
+			}
+			else
+			{
+				Cell = FHexGridCellState(EHexGridCellFlags::None, -1, 0);
+			}
+		}
+	}
+
+	/** Picks a random cell that can be walked on */
+	int32 PickWalkableCell(const TArray<FHexGridCellState>& Cells, FRandomStream& RandomStream)
+	{
+		int32 Index = RandomStream.RandHelper(Cells.Num());
+		while (!Cells[Index].IsWalkable())
+		{
+			Index = (Index + 1) % Cells.Num();
+		}
+
+		return Index;
+	}
+
+	/** Reference breadth first search. Neighbors are found by checking the surrounding rows and columns using
+	only hex displacement, so this doesn't share any code with the searches it is checking. Get steps to goal or -1 */
+	int32 BruteForceSteps(const FIntPoint& Dimensions, const TArray<FHexGridCellState>& Cells, int32 StartIndex, int32 GoalIndex)
+	{
+		TArray<int32> Steps;
+		Steps.Init(-1, Cells.Num());
+		Steps[StartIndex] = 0;
+
+		TArray<int32> Queue;
+		Queue.Add(StartIndex);
+
+		for (int32 Head = 0; Head < Queue.Num(); ++Head)
+		{
+			const int32 Index = Queue[Head];
+			if (Index == GoalIndex)
+			{
+				return Steps[Index];
+			}
+
+			const FIntVector Hex = FHexGrid::CellIndexToHex(Index, Dimensions);
+			const int32 Column = Index / Dimensions.X;
+			const int32 Row = Index % Dimensions.X;
+
+			for (int32 NeighborColumn = Column - 1; NeighborColumn <= Column + 1; ++NeighborColumn)
+			{
+				for (int32 NeighborRow = Row - 1; NeighborRow <= Row + 1; ++NeighborRow)
+				{
+					if (NeighborColumn < 0 || NeighborColumn >= Dimensions.Y || NeighborRow < 0 || NeighborRow >= Dimensions.X)
+					{
+						continue;
+					}
+
+					const int32 NeighborIndex = NeighborColumn * Dimensions.X + NeighborRow;
+					if (Steps[NeighborIndex] != -1 || !Cells[NeighborIndex].IsWalkable())
+					{
+						continue;
+					}
+
+					if (FHexGrid::HexDisplacement(Hex, FHexGrid::CellIndexToHex(NeighborIndex, Dimensions)) == 1)
+					{
+						Steps[NeighborIndex] = Steps[Index] + 1;
+						Queue.Add(NeighborIndex);
+					}
+				}
+			}
+		}
+
+		return -1;
+	}
+
+	/** Runs given query the amount of iterations specified, returning the average nanoseconds per query */
+	template <typename TFunc>
+	double TimeQuery(int32 Iterations, TFunc&& Func)
+	{
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			Func(i);
+		}
+
+		const uint64 EndCycles = FPlatformTime::Cycles64();
+		return (FPlatformTime::ToMilliseconds64(EndCycles - StartCycles) * 1000000.0) / static_cast<double>(Iterations);
+	}
+
+	/** Allocator that forwards to the allocator it replaced, counting allocations made by the thread that installed it.
+	This is never destroyed, as other threads may still be calling into it after it has been uninstalled */
+	class FCountingMalloc : public FMalloc
+	{
+	public:
+
+		/** Starts counting allocations made by this thread */
+		static FCountingMalloc& Install()
+		{
+			static FCountingMalloc* Instance = new FCountingMalloc();
+
+			check(GMalloc != Instance);
+			Instance->InnerMalloc = GMalloc;
+			Instance->ThreadID = FPlatformTLS::GetCurrentThreadId();
+			Instance->NumAllocations = 0;
+
+			GMalloc = Instance;
+			return *Instance;
+		}
+
+		/** Stops counting allocations, restoring the previous allocator */
+		void Uninstall()
+		{
+			check(GMalloc == this);
+			GMalloc = InnerMalloc;
+		}
+
+		/** Get the amount of allocations counted since installed */
+		FORCEINLINE int32 GetNumAllocations() const { return NumAllocations; }
+
+	public:
+
+		// Begin FMalloc Interface
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			InnerMalloc->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return InnerMalloc->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return InnerMalloc->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return InnerMalloc->IsInternallyThreadSafe();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return TEXT("HexGridTestCountingMalloc");
+		}
+		// End FMalloc Interface
+
+	private:
+
+		FCountingMalloc()
+			: InnerMalloc(nullptr)
+			, ThreadID(0)
+			, NumAllocations(0)
+		{
+
+		}
+
+		FORCEINLINE void CountAllocation()
+		{
+			if (FPlatformTLS::GetCurrentThreadId() == ThreadID)
+			{
+				++NumAllocations;
+			}
+		}
+
+	private:
+
+		/** The allocator we replaced */
+		FMalloc* InnerMalloc;
+
+		/** The thread whose allocations are counted */
+		uint32 ThreadID;
+
+		/** Allocations counted since installed */
+		int32 NumAllocations;
+	};
+
+	/** Runs given query like TimeQuery, also counting the total amount of allocations made by every query */
+	template <typename TFunc>
+	double TimeQueryAndCountAllocations(int32 Iterations, TFunc&& Func, int32& OutNumAllocations)
+	{
+		FCountingMalloc& CountingMalloc = FCountingMalloc::Install();
+		const double Time = TimeQuery(Iterations, Func);
+		CountingMalloc.Uninstall();
+
+		OutNumAllocations = CountingMalloc.GetNumAllocations();
+		return Time;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexGridSymmetryTest, "Conquest.HexGrid.Symmetry", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexGridSymmetryTest::RunTest(const FString& Parameters)
+{
+	const FVector Size(1.f);
+
+	for (int32 Rows = 1; Rows <= 8; ++Rows)
+	{
+		for (int32 Columns = 2; Columns <= 9; ++Columns)
+		{
+			const FIntPoint Dimensions(Rows, Columns);
+			const int32 NumCells = Rows * Columns;
+
+			// Offset columns only line up when mirrored onto columns with the same (or opposite when rotating) offset
+			const bool bOddColumns = (Columns % 2) == 1;
+			TestTrue(FString::Printf(TEXT("%ix%i supports mirroring columns only with odd columns"), Rows, Columns),
+				FHexGrid::SupportsSymmetry(EHexGridSymmetry::MirrorColumns, Dimensions) == bOddColumns);
+			TestTrue(FString::Printf(TEXT("%ix%i supports rotating only with even columns"), Rows, Columns),
+				FHexGrid::SupportsSymmetry(EHexGridSymmetry::Rotate, Dimensions) != bOddColumns);
+			TestFalse(FString::Printf(TEXT("%ix%i supports mirroring rows"), Rows, Columns),
+				FHexGrid::SupportsSymmetry(EHexGridSymmetry::MirrorRows, Dimensions));
+
+			const EHexGridSymmetry Symmetry = bOddColumns ? EHexGridSymmetry::MirrorColumns : EHexGridSymmetry::Rotate;
+
+			// Rotated cells are opposite each other around the center of the board
+			const FVector Center = (FHexGrid::ConvertHexToWorld(FHexGrid::CellIndexToHex(0, Dimensions), FVector::ZeroVector, Size) +
+				FHexGrid::ConvertHexToWorld(FHexGrid::CellIndexToHex(NumCells - 1, Dimensions), FVector::ZeroVector, Size)) * 0.5f;
+
+			int32 NumFailures = 0;
+			for (int32 Index = 0; Index < NumCells; ++Index)
+			{
+				const int32 MirroredIndex = FHexGrid::GetMirroredCellIndex(Index, Symmetry, Dimensions);
+				if (MirroredIndex == INDEX_NONE || FHexGrid::GetMirroredCellIndex(MirroredIndex, Symmetry, Dimensions) != Index)
+				{
+					++NumFailures;
+					continue;
+				}
+
+				const FVector Position = FHexGrid::ConvertHexToWorld(FHexGrid::CellIndexToHex(Index, Dimensions), FVector::ZeroVector, Size);
+				const FVector MirroredPosition = FHexGrid::ConvertHexToWorld(FHexGrid::CellIndexToHex(MirroredIndex, Dimensions), FVector::ZeroVector, Size);
+
+				const bool bIsMirrored = Symmetry == EHexGridSymmetry::MirrorColumns ?
+					FMath::IsNearlyEqual(Position.X, MirroredPosition.X, KINDA_SMALL_NUMBER) && FMath::IsNearlyEqual(Position.Y + MirroredPosition.Y, Center.Y * 2.f, KINDA_SMALL_NUMBER) :
+					(Position + MirroredPosition).Equals(Center * 2.f, KINDA_SMALL_NUMBER);
+
+				if (!bIsMirrored)
+				{
+					++NumFailures;
+				}
+			}
+
+			TestEqual(FString::Printf(TEXT("%ix%i cells mirrored in place"), Rows, Columns), NumFailures, 0);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FHexGridQueryTest, "Conquest.HexGrid.Queries", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+void FHexGridQueryTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	HexGridTests::GetBoardSizeTests(OutBeautifiedNames, OutTestCommands);
+}
+
+bool FHexGridQueryTest::RunTest(const FString& Parameters)
+{
+	const int32 Size = FCString::Atoi(*Parameters);
+	const FIntPoint Dimensions(Size, Size);
+
+	TArray<FHexGridCellState> Cells;
+	HexGridTests::BuildCells(Dimensions, Cells);
+
+	FRandomStream RandomStream(Size);
+
+	// Every cell should map back to itself
+	int32 RoundTripFailures = 0;
+	for (int32 Index = 0; Index < Cells.Num(); ++Index)
+	{
+		if (FHexGrid::HexToCellIndex(FHexGrid::CellIndexToHex(Index, Dimensions), Dimensions) != Index)
+		{
+			++RoundTripFailures;
+		}
+	}
+
+	TestEqual(TEXT("Cell index round trip failures"), RoundTripFailures, 0);
+
+	// Ranges and rings should find exactly the cells within distance of the origin. Distances
+	// past the offset table are included, as those rings are walked instead of read from the table
+	const int32 MaxTestDistance = FMath::Min(Size, FHexOffsetTable::MaxRadius + 2);
+	for (int32 i = 0; i < 32; ++i)
+	{
+		const FIntVector Origin = FHexGrid::CellIndexToHex(RandomStream.RandHelper(Cells.Num()), Dimensions);
+		const int32 Distance = RandomStream.RandRange(0, MaxTestDistance);
+
+		TArray<int32> ExpectedRange;
+		TArray<int32> ExpectedRing;
+		for (int32 Index = 0; Index < Cells.Num(); ++Index)
+		{
+			const int32 Displacement = FHexGrid::HexDisplacement(Origin, FHexGrid::CellIndexToHex(Index, Dimensions));
+			if (Displacement <= Distance)
+			{
+				ExpectedRange.Add(Index);
+			}
+
+			if (Displacement == Distance)
+			{
+				ExpectedRing.Add(Index);
+			}
+		}
+
+		// Range should spiral outwards, never visiting a closer ring after a further one
+		TArray<int32> FoundRange;
+		int32 LastDisplacement = 0;
+		bool bSpiralsOutwards = true;
+
+		FHexGrid::ForEachHexInRange(Origin, Distance, [&](const FIntVector& Hex)->void
+		{
+			const int32 Displacement = FHexGrid::HexDisplacement(Origin, Hex);
+			bSpiralsOutwards &= Displacement >= LastDisplacement && Displacement <= Distance;
+			LastDisplacement = Displacement;
+
+			const int32 Index = FHexGrid::HexToCellIndex(Hex, Dimensions);
+			if (Index != INDEX_NONE)
+			{
+				FoundRange.Add(Index);
+			}
+		});
+
+		TArray<int32> FoundRing;
+		FHexGrid::ForEachHexInRing(Origin, Distance, [&](const FIntVector& Hex)->void
+		{
+			const int32 Index = FHexGrid::HexToCellIndex(Hex, Dimensions);
+			if (Index != INDEX_NONE)
+			{
+				FoundRing.Add(Index);
+			}
+		});
+
+		FoundRange.Sort();
+		FoundRing.Sort();
+
+		const FString Query = FString::Printf(TEXT("(%i, %i, %i) distance %i"), Origin.X, Origin.Y, Origin.Z, Distance);
+		TestTrue(FString::Printf(TEXT("Range spirals outwards from %s"), *Query), bSpiralsOutwards);
+		TestTrue(FString::Printf(TEXT("Range matches reference for %s"), *Query), FoundRange == ExpectedRange);
+		TestTrue(FString::Printf(TEXT("Ring matches reference for %s"), *Query), FoundRing == ExpectedRing);
+	}
+
+	// Paths should exist only if the goal can be reached, and be as short as the reference search
+	FHexGridSearchScratch Scratch;
+	TArray<FIntVector> Path;
+
+	for (int32 i = 0; i < 32; ++i)
+	{
+		const int32 StartIndex = HexGridTests::PickWalkableCell(Cells, RandomStream);
+		const int32 GoalIndex = HexGridTests::PickWalkableCell(Cells, RandomStream);
+
+		const FIntVector Start = FHexGrid::CellIndexToHex(StartIndex, Dimensions);
+		const FIntVector Goal = FHexGrid::CellIndexToHex(GoalIndex, Dimensions);
+
+		int32 EndIndex = INDEX_NONE;
+		bool bReachedGoal = false;
+
+		const bool bFoundPath = FHexGrid::SearchCells(Dimensions, Cells, Start, Goal, false, Cells.Num(), Scratch, EndIndex, bReachedGoal);
+		const int32 ExpectedSteps = HexGridTests::BruteForceSteps(Dimensions, Cells, StartIndex, GoalIndex);
+
+		const FString Query = FString::Printf(TEXT("cell %i to cell %i"), StartIndex, GoalIndex);
+		if (!TestTrue(FString::Printf(TEXT("Path found matches reference for %s"), *Query), bFoundPath == (ExpectedSteps != -1)) || !bFoundPath)
+		{
+			continue;
+		}
+
+		FHexGrid::ConvertSearchToHexPath(Dimensions, Scratch, EndIndex, Path);
+		TestEqual(FString::Printf(TEXT("Path length matches reference for %s"), *Query), Path.Num() - 1, ExpectedSteps);
+		TestTrue(FString::Printf(TEXT("Path ends at goal for %s"), *Query), bReachedGoal && Path.Num() > 0 && Path[0] == Start && Path.Last() == Goal);
+
+		bool bPathIsConnected = true;
+		for (int32 Step = 1; Step < Path.Num(); ++Step)
+		{
+			const int32 Index = FHexGrid::HexToCellIndex(Path[Step], Dimensions);
+			bPathIsConnected &= Index != INDEX_NONE && Cells[Index].IsWalkable() && FHexGrid::HexDisplacement(Path[Step - 1], Path[Step]) == 1;
+		}
+
+		TestTrue(FString::Printf(TEXT("Path only steps between walkable neighbors for %s"), *Query), bPathIsConnected);
+	}
+
+	return true;
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FHexGridBenchmarkTest, "Conquest.HexGrid.Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FHexGridBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	HexGridTests::GetBoardSizeTests(OutBeautifiedNames, OutTestCommands);
+}
+
+bool FHexGridBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const int32 Size = FCString::Atoi(*Parameters);
+	const FIntPoint Dimensions(Size, Size);
+	const int32 Iterations = 1000;
+
+	TArray<FHexGridCellState> Cells;
+	HexGridTests::BuildCells(Dimensions, Cells);
+
+	// Use the same queries for each pass, so the scratch has grown as much as it needs to before we measure
+	FRandomStream RandomStream(Size);
+
+	TArray<TPair<FIntVector, FIntVector>> PathQueries;
+	for (int32 i = 0; i < Iterations; ++i)
+	{
+		const FIntVector Start = FHexGrid::CellIndexToHex(HexGridTests::PickWalkableCell(Cells, RandomStream), Dimensions);
+		const FIntVector Goal = FHexGrid::CellIndexToHex(HexGridTests::PickWalkableCell(Cells, RandomStream), Dimensions);
+
+		PathQueries.Emplace(Start, Goal);
+	}
+
+	FHexGridSearchScratch Scratch;
+	TArray<FIntVector> Path;
+
+	auto RunPathQuery = [&](int32 Index)->void
+	{
+		int32 EndIndex = INDEX_NONE;
+		bool bReachedGoal = false;
+
+		const TPair<FIntVector, FIntVector>& PathQuery = PathQueries[Index];
+		if (FHexGrid::SearchCells(Dimensions, Cells, PathQuery.Key, PathQuery.Value, true, Cells.Num(), Scratch, EndIndex, bReachedGoal))
+		{
+			FHexGrid::ConvertSearchToHexPath(Dimensions, Scratch, EndIndex, Path);
+		}
+	};
+
+	HexGridTests::TimeQuery(Iterations, RunPathQuery);
+
+	int32 PathAllocations = 0;
+	const double PathTime = HexGridTests::TimeQueryAndCountAllocations(Iterations, RunPathQuery, PathAllocations);
+
+	AddInfo(FString::Printf(TEXT("%ix%i SearchCells: %.1f ns/op, %.2f allocs/op"), Size, Size, PathTime, PathAllocations / static_cast<double>(Iterations)));
+	TestEqual(TEXT("SearchCells allocations once warmed up"), PathAllocations, 0);
+
+	for (int32 Distance : { 1, 3, 6, FHexOffsetTable::MaxRadius + 1 })
+	{
+		int32 NumWalkable = 0;
+		auto RunRangeQuery = [&](int32 Index)->void
+		{
+			FHexGrid::ForEachHexInRange(PathQueries[Index].Key, Distance, [&](const FIntVector& Hex)->void
+			{
+				const int32 CellIndex = FHexGrid::HexToCellIndex(Hex, Dimensions);
+				NumWalkable += CellIndex != INDEX_NONE && Cells[CellIndex].IsWalkable() ? 1 : 0;
+			});
+		};
+
+		int32 RangeAllocations = 0;
+		const double RangeTime = HexGridTests::TimeQueryAndCountAllocations(Iterations, RunRangeQuery, RangeAllocations);
+
+		AddInfo(FString::Printf(TEXT("%ix%i ForEachHexInRange (%i): %.1f ns/op, %.2f allocs/op (%i walkable)"),
+			Size, Size, Distance, RangeTime, RangeAllocations / static_cast<double>(Iterations), NumWalkable));
+		TestEqual(FString::Printf(TEXT("ForEachHexInRange (%i) allocations"), Distance), RangeAllocations, 0);
+	}
+
+	return true;
+}
+
+#endif
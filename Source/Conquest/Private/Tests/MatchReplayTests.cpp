@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CSKGameMode.h"
+#include "CSKMatchRecord.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "Tests/AutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace MatchReplayTests
+{
+	/** The max time (in seconds) a replay can take before failing */
+	const double ReplayTimeout = 600.0;
+
+	/** The max time (in seconds) to wait for both players to join and the replayed match to start */
+	const double MatchStartTimeout = 60.0;
+
+	/** Get the game mode of the match being played (if any) */
+	const ACSKGameMode* FindGameMode()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* World = Context.World();
+			if (World && Context.WorldType == EWorldType::Game)
+			{
+				const ACSKGameMode* GameMode = World->GetAuthGameMode<ACSKGameMode>();
+				if (GameMode)
+				{
+					return GameMode;
+				}
+			}
+		}
+
+		return nullptr;
+	}
+}
+
+/** Waits for the replay started by the loaded map to stop, then checks it matched the record */
+class FWaitForMatchReplayCommand : public IAutomationLatentCommand
+{
+public:
+
+	FWaitForMatchReplayCommand(FAutomationTestBase* InTest)
+		: Test(InTest)
+	{
+
+	}
+
+	virtual bool Update() override
+	{
+		const ACSKGameMode* GameMode = MatchReplayTests::FindGameMode();
+		if (GameMode && GameMode->HasReplayStopped())
+		{
+			// Replays stop early on the first desync, otherwise once the final checksum has been compared
+			Test->TestTrue(TEXT("Replay matched the record"), GameMode->DidReplayMatchRecord());
+			return true;
+		}
+
+		// Replays only start once the opponent slot has been filled by the AI player
+		if ((!GameMode || !GameMode->HasMatchStarted()) && GetCurrentRunTime() > MatchReplayTests::MatchStartTimeout)
+		{
+			Test->AddError(TEXT("Replayed match did not start, opponent slot was not filled"));
+			return true;
+		}
+
+		if (GetCurrentRunTime() > MatchReplayTests::ReplayTimeout)
+		{
+			Test->AddError(TEXT("Replay did not finish in time"));
+			return true;
+		}
+
+		return false;
+	}
+
+private:
+
+	/** The test waiting for the replay */
+	FAutomationTestBase* Test;
+};
+
+/** Replays every match record in the record directory. Records are replayed on the map they were recorded on,
+with the second player slot filled by an AI player, as replays only start once both players have joined */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FMatchReplayTest, "Conquest.Match.Replay", EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+void FMatchReplayTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	TArray<FString> Filenames;
+	IFileManager::Get().FindFiles(Filenames, *(FCSKMatchRecord::GetRecordDirectory() / TEXT("*.cskrecord")), true, false);
+
+	for (const FString& Filename : Filenames)
+	{
+		OutBeautifiedNames.Add(FPaths::GetBaseFilename(Filename));
+		OutTestCommands.Add(Filename);
+	}
+}
+
+bool FMatchReplayTest::RunTest(const FString& Parameters)
+{
+	FCSKMatchRecord Record;
+	if (!TestTrue(TEXT("Record loaded"), Record.LoadFromFile(FCSKMatchRecord::GetRecordDirectory() / Parameters)))
+	{
+		return false;
+	}
+
+	// Game mode loads the record itself using the replay option
+	AutomationOpenMap(FString::Printf(TEXT("%s?listen?AIPlayers=1?Replay=%s"), *Record.MapName, *Parameters));
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitForMatchReplayCommand(this));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,158 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Conquest.h"
+#include "BoardTypes.h"
+#include "Containers/HexGrid.h"
+
+class UBoardLayoutAsset;
+
+/** Settings for generating boards */
+struct CONQUEST_API FBoardGeneratorSettings
+{
+public:
+
+	FBoardGeneratorSettings();
+
+public:
+
+	/** The dimensions of the board (rows and columns) */
+	FIntPoint Dimensions;
+
+	/** The size of each cell of generated layouts */
+	float HexSize;
+
+	/** Relative chance of each element being picked (fire, water, earth then air) */
+	float ElementWeights[4];
+
+	/** Chance of a cell copying the element of a neighbouring cell, higher values result in larger element regions */
+	float ElementClumping;
+
+	/** Chance of any cell being a null tile */
+	float NullTileChance;
+
+	/** Amount of obstacles (grown clusters of null tiles) to place */
+	int32 NumObstacles;
+
+	/** Amount of cells each obstacle attempts to grow to */
+	int32 ObstacleSize;
+
+	/** Symmetry to apply so neither player is favoured. This must be supported by the dimensions (see FHexGrid::SupportsSymmetry) */
+	EHexGridSymmetry Symmetry;
+
+	/** Cell index of each players portal. Set to INDEX_NONE to use the middle of the first column and the cell mirroring it */
+	int32 PortalCells[CSK_MAX_NUM_PLAYERS];
+
+	/** The min amount of tiles the shortest path between portals must be */
+	int32 MinPortalPathLength;
+
+	/** The max amount the shortest path between portals can exceed the straight distance between them */
+	int32 MaxPortalPathDetour;
+
+	/** The max fraction of walkable cells one player can be closer to than the other */
+	float MaxTerritoryImbalance;
+
+	/** If every walkable cell must be reachable from the portals */
+	bool bRequireFullyConnected;
+};
+
+/** A generated board */
+struct CONQUEST_API FBoardCandidate
+{
+public:
+
+	FBoardCandidate()
+		: Seed(0)
+		, PortalPathLength(0)
+		, TerritoryImbalance(0.f)
+		, Score(0.f)
+	{
+		PortalCells[0] = INDEX_NONE;
+		PortalCells[1] = INDEX_NONE;
+	}
+
+public:
+
+	/** Seed this candidate was generated from */
+	int32 Seed;
+
+	/** Packed cells of this candidate. Uses the same format and order as UBoardLayoutAsset */
+	TArray<uint8> Cells;
+
+	/** Cell index of each players portal */
+	int32 PortalCells[CSK_MAX_NUM_PLAYERS];
+
+	/** Length of the shortest path between portals */
+	int32 PortalPathLength;
+
+	/** Fraction of walkable cells closer to one portal than the other */
+	float TerritoryImbalance;
+
+	/** How well this candidate met the settings, lower is better */
+	float Score;
+};
+
+/** Per thread buffers used when validating candidates */
+struct FBoardGeneratorScratch
+{
+	/** Distance of every cell from each portal. INDEX_NONE if unreachable */
+	TArray<int32> Distances[CSK_MAX_NUM_PLAYERS];
+
+	/** Cells waiting to be visited during a search */
+	TArray<int32> Queue;
+};
+
+/**
+ * Generates seeded board layouts. Candidates are generated as packed cells (the format used by UBoardLayoutAsset)
+ * rather than tiles, so thousands can be generated and validated across worker threads without touching any
+ * actors. Winning candidates are written to layout assets, which board managers spawn their grids from
+ */
+class CONQUEST_API FBoardGenerator
+{
+public:
+
+	FBoardGenerator(const FBoardGeneratorSettings& InSettings);
+
+public:
+
+	/** Generates a candidate from given seed. Candidate is not validated */
+	void GenerateCandidate(int32 Seed, FBoardCandidate& OutCandidate) const;
+
+	/** Validates given candidate, filling in its path length, imbalance and score. Get if candidate is valid */
+	bool ValidateCandidate(FBoardCandidate& Candidate, FBoardGeneratorScratch& Scratch) const;
+
+	/** Generates and validates given amount of candidates (starting from base seed) across worker
+	threads. Outputs the best valid candidates ordered by score. Get the amount of valid candidates */
+	int32 GenerateBoards(int32 NumCandidates, int32 BaseSeed, int32 NumToKeep, TArray<FBoardCandidate>& OutBoards) const;
+
+	/** Writes given candidate to layout */
+	void WriteToLayout(const FBoardCandidate& Candidate, UBoardLayoutAsset* Layout) const;
+
+public:
+
+	/** Get the settings boards are generated with */
+	FORCEINLINE const FBoardGeneratorSettings& GetSettings() const { return Settings; }
+
+private:
+
+	/** Finds the distance of every cell from origin, only walking over walkable cells */
+	void FindCellDistances(const TArray<uint8>& Cells, int32 Origin, TArray<int32>& OutDistances, TArray<int32>& Queue) const;
+
+	/** Get the element to use for a new cell */
+	uint8 PickElement(FRandomStream& Stream) const;
+
+	/** Get a random neighbour of given cell, or INDEX_NONE if it has none */
+	int32 GetRandomNeighbour(int32 CellIndex, FRandomStream& Stream) const;
+
+private:
+
+	/** Settings boards are generated with */
+	FBoardGeneratorSettings Settings;
+
+	/** Total of all element weights */
+	float TotalElementWeight;
+
+	/** Index of each cells neighbours. Cells with less than six neighbours are padded with INDEX_NONE */
+	TArray<int32> Neighbours;
+};
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Conquest.h"
+#include "Commandlets/Commandlet.h"
+#include "BoardGeneratorCommandlet.generated.h"
+
+/**
+ * Commandlet for generating board layouts using the board generator. The best valid candidates are saved as layout assets.
+ * Usage: -run=BoardGenerator [-Rows=9] [-Columns=15] [-HexSize=200] [-Candidates=10000] [-Keep=10] [-Seed=0]
+ *	[-Symmetry=MirrorColumns|Rotate|None] [-Fire=1] [-Water=1] [-Earth=1] [-Air=1] [-Clumping=0.5]
+ *	[-NullChance=0.05] [-Obstacles=3] [-ObstacleSize=4] [-MinPathLength=8] [-MaxDetour=4] [-MaxImbalance=0.1]
+ *	[-AllowIsolated] [-Output=/Game/Boards/Generated] [-Name=GeneratedBoard] [-DryRun]
+ * MirrorColumns requires an odd amount of columns and Rotate an even amount
+ */
+UCLASS()
+class CONQUEST_API UBoardGeneratorCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UBoardGeneratorCommandlet();
+
+public:
+
+	// Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet Interface
+};
@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Conquest.h"
+#include "BoardTypes.h"
+#include "Engine/DataAsset.h"
+#include "BoardLayoutAsset.generated.h"
+
+class ABoardManager;
+
+/**
+ * Packed layout of a board. Each cell is a single byte (element and null bits) stored in dense tile
+ * index order (see FHexGrid::HexToCellIndex), which is bulk serialized so loading a layout is a single
+ * copy regardless of board size. Board managers with a layout can spawn their tiles when play begins
+ * instead of having every tile saved into the level as an individual actor
+ */
+UCLASS(BlueprintType)
+class CONQUEST_API UBoardLayoutAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	UBoardLayoutAsset();
+
+public:
+
+	/** Bits of each packed cell */
+	static constexpr uint8 CellElementMask = 0x0F;
+	static constexpr uint8 CellNullBit = 0x10;
+
+public:
+
+	// Begin UObject Interface
+	virtual void Serialize(FArchive& Ar) override;
+	// End UObject Interface
+
+public:
+
+	/** Resets this layout to a board of given size. All cells will be fire tiles */
+	void InitLayout(const FIntPoint& InDimensions, float InHexSize);
+
+	/** If this layout has cells to build a board with */
+	bool IsValidLayout() const;
+
+	/** Get the amount of cells in this layout */
+	FORCEINLINE int32 GetNumCells() const { return Cells.Num(); }
+
+	/** Get the element of the cell at given dense index */
+	FORCEINLINE ECSKElementType GetCellElement(int32 Index) const { return static_cast<ECSKElementType>(Cells[Index] & CellElementMask); }
+
+	/** If the cell at given dense index is a null tile */
+	FORCEINLINE bool IsCellNull(int32 Index) const { return (Cells[Index] & CellNullBit) != 0; }
+
+	/** Sets the state of the cell at given dense index */
+	void SetCell(int32 Index, ECSKElementType Element, bool bIsNull);
+
+public:
+
+	/** The dimensions of the board (rows and columns) */
+	UPROPERTY(VisibleAnywhere, Category = "Layout")
+	FIntPoint Dimensions;
+
+	/** The size of each cell of the board */
+	UPROPERTY(EditAnywhere, Category = "Layout", meta = (ClampMin = 10))
+	float HexSize;
+
+	/** Hex value for the first players portal */
+	UPROPERTY(VisibleAnywhere, Category = "Layout")
+	FIntVector Player1PortalHex;
+
+	/** Hex value for the second players portal */
+	UPROPERTY(VisibleAnywhere, Category = "Layout")
+	FIntVector Player2PortalHex;
+
+private:
+
+	/** Packed state of each cell. This is bulk serialized rather than being a property */
+	TArray<uint8> Cells;
+};
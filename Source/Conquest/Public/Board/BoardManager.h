@@ -4,10 +4,17 @@
 
 #include "Conquest.h"
 #include "Tile.h"
+#include "Containers/BoardTileMask.h"
 #include "Containers/HexGrid.h"
+#include "Containers/LruCache.h"
+#include "Engine/NetSerialization.h"
+#include "HAL/ThreadSafeBool.h"
 #include "BoardManager.generated.h"
 
+class ABoardManager;
 class ATower;
+class UBoardLayoutAsset;
+class UHierarchicalInstancedStaticMeshComponent;
 class UMaterialInstanceConstant;
 class UMaterialInterface;
 
@@ -38,6 +45,9 @@ public:
 		bIsValid &= Dimensions.X >= 2;
 		bIsValid &= Dimensions.Y >= 2;
 
+		// Every tile needs to be referenceable by a tile handle
+		bIsValid &= Dimensions.X * Dimensions.Y <= FBoardTileHandle::MaxBoardTiles;
+
 		// Allow hex cells to have some space
 		bIsValid &= HexSize >= 9.f;
 
@@ -71,6 +81,244 @@ public:
 	TSubclassOf<ATile> TileTemplate;
 };
 
+/** State to apply to many tiles at once when editing the board */
+struct CONQUEST_API FBoardTileEdit
+{
+public:
+
+	FBoardTileEdit()
+		: Element(ECSKElementType::None)
+		, bSetElement(false)
+		, bIsNull(false)
+		, bSetNull(false)
+	{
+
+	}
+
+	/** Makes an edit that sets the element of tiles */
+	FORCEINLINE static FBoardTileEdit MakeElement(ECSKElementType InElement)
+	{
+		FBoardTileEdit Edit;
+		Edit.Element = InElement;
+		Edit.bSetElement = true;
+
+		return Edit;
+	}
+
+	/** Makes an edit that sets if tiles are null */
+	FORCEINLINE static FBoardTileEdit MakeNull(bool bInIsNull)
+	{
+		FBoardTileEdit Edit;
+		Edit.bIsNull = bInIsNull;
+		Edit.bSetNull = true;
+
+		return Edit;
+	}
+
+public:
+
+	/** Element to set */
+	ECSKElementType Element;
+
+	/** If element should be set */
+	uint8 bSetElement : 1;
+
+	/** If tiles should be null */
+	uint8 bIsNull : 1;
+
+	/** If null state should be set */
+	uint8 bSetNull : 1;
+};
+
+/** Key used to cache path queries made to the board manager */
+struct CONQUEST_API FBoardPathQueryKey
+{
+public:
+
+	FBoardPathQueryKey(const FIntVector& InStart, const FIntVector& InGoal, int32 InMaxDistance, bool bInAllowPartial)
+		: Start(InStart)
+		, Goal(InGoal)
+		, MaxDistance(InMaxDistance)
+		, bAllowPartial(bInAllowPartial)
+	{
+
+	}
+
+	FORCEINLINE bool operator == (const FBoardPathQueryKey& Other) const
+	{
+		return Start == Other.Start && Goal == Other.Goal && MaxDistance == Other.MaxDistance && bAllowPartial == Other.bAllowPartial;
+	}
+
+	FORCEINLINE friend uint32 GetTypeHash(const FBoardPathQueryKey& Key)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(Key.Start), GetTypeHash(Key.Goal));
+		return HashCombine(Hash, GetTypeHash(Key.MaxDistance) ^ static_cast<uint32>(Key.bAllowPartial));
+	}
+
+public:
+
+	FIntVector Start;
+	FIntVector Goal;
+	int32 MaxDistance;
+	bool bAllowPartial;
+};
+
+/** Key used to cache range queries made to the board manager */
+struct CONQUEST_API FBoardRangeQueryKey
+{
+public:
+
+	FBoardRangeQueryKey(const FIntVector& InOrigin, int32 InDistance, bool bInOccupiedOnly, bool bInIgnoreFilteredTiles, bool bInIgnoreOrigin)
+		: Origin(InOrigin)
+		, Distance(InDistance)
+		, Flags((bInOccupiedOnly ? 1 : 0) | (bInIgnoreFilteredTiles ? 2 : 0) | (bInIgnoreOrigin ? 4 : 0))
+	{
+
+	}
+
+	FORCEINLINE bool operator == (const FBoardRangeQueryKey& Other) const
+	{
+		return Origin == Other.Origin && Distance == Other.Distance && Flags == Other.Flags;
+	}
+
+	FORCEINLINE friend uint32 GetTypeHash(const FBoardRangeQueryKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.Origin), GetTypeHash(Key.Distance) ^ Key.Flags);
+	}
+
+public:
+
+	FIntVector Origin;
+	int32 Distance;
+	uint8 Flags;
+};
+
+/** Result of a path query kept in the board managers path cache */
+struct CONQUEST_API FBoardPathQueryResult
+{
+public:
+
+	FBoardPathQueryResult()
+		: bSuccess(false)
+	{
+
+	}
+
+	FBoardPathQueryResult(bool bInSuccess, const FBoardPath& InPath)
+		: bSuccess(bInSuccess)
+		, Path(InPath)
+	{
+
+	}
+
+public:
+
+	/** If the query succeeded. Paths can be empty even when successful (e.g. start is goal) */
+	bool bSuccess;
+
+	/** The path that was found */
+	FBoardPath Path;
+};
+
+struct FBoardTileStateArray;
+
+/** Replicated state of a single tile that has a board piece placed on it */
+USTRUCT()
+struct CONQUEST_API FBoardTileStateItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+public:
+
+	FBoardTileStateItem()
+		: TileIndex(INDEX_NONE)
+		, Occupant(nullptr)
+		, OwnerID(-1)
+	{
+
+	}
+
+	FBoardTileStateItem(int32 InTileIndex, AActor* InOccupant, int8 InOwnerID)
+		: TileIndex(InTileIndex)
+		, Occupant(InOccupant)
+		, OwnerID(InOwnerID)
+	{
+
+	}
+
+public:
+
+	// Begin FFastArraySerializerItem Interface
+	void PreReplicatedRemove(const FBoardTileStateArray& InArraySerializer);
+	void PostReplicatedAdd(const FBoardTileStateArray& InArraySerializer);
+	void PostReplicatedChange(const FBoardTileStateArray& InArraySerializer);
+	// End FFastArraySerializerItem Interface
+
+public:
+
+	/** Dense index of the tile in the hex grid */
+	UPROPERTY()
+	int32 TileIndex;
+
+	/** The board piece placed on the tile. This can be null
+	on clients if the board piece has yet to replicate */
+	UPROPERTY()
+	AActor* Occupant;
+
+	/** ID of the player who owns the board piece */
+	UPROPERTY()
+	int8 OwnerID;
+};
+
+/** Delta replicated array of every tile with a board piece placed on it */
+USTRUCT()
+struct CONQUEST_API FBoardTileStateArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+public:
+
+	FBoardTileStateArray()
+		: BoardManager(nullptr)
+	{
+
+	}
+
+public:
+
+	/** Adds the state for a tile that now has a board piece */
+	void AddTileState(int32 TileIndex, AActor* Occupant, int8 OwnerID);
+
+	/** Finds the state of given tile. Get null if tile has no board piece */
+	const FBoardTileStateItem* FindTileState(int32 TileIndex) const;
+
+	/** Removes the state for a tile that no longer has a board piece. Get if state was removed */
+	bool RemoveTileState(int32 TileIndex);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FBoardTileStateItem, FBoardTileStateArray>(Items, DeltaParms, *this);
+	}
+
+public:
+
+	/** State of each tile with a board piece */
+	UPROPERTY()
+	TArray<FBoardTileStateItem> Items;
+
+	/** The board manager that owns this array (not replicated) */
+	ABoardManager* BoardManager;
+};
+
+template<>
+struct TStructOpsTypeTraits<FBoardTileStateArray> : public TStructOpsTypeTraitsBase2<FBoardTileStateArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true
+	};
+};
+
 /**
  * Manages the board aspect of the game. Maintains each tile of the board
  * and can be used to query for paths or tiles around a specific tile
@@ -96,6 +344,7 @@ public:
 
 	// Begin AActor Interface
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Tick(float DeltaTime) override;
 	// End AActor Interface
 
@@ -108,8 +357,11 @@ protected:
 	// End AActor Interface
 
 	// Begin UObject Interface
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PostLoad() override;
 	#if WITH_EDITOR
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PostEditUndo() override;
 	#endif
 	// End UObject Interface
 
@@ -129,6 +381,9 @@ public:
 	/** Get the size of a hex cell */
 	FORCEINLINE float GetGridHexSize() const { return GridHexSize; }
 
+	/** Notify that given tile has had its occupant, element or null state changed */
+	void NotifyTileStateChanged(const ATile* Tile);
+
 	#if WITH_EDITOR
 	/** Get last tile template used to generate the grid with */
 	FORCEINLINE TSubclassOf<ATile> GetGridTileTemplate() const { return GridTileTemplate; }
@@ -146,8 +401,43 @@ public:
 
 	/** Clears portal tile used for specified player */
 	void ResetPlayerPortal(int32 Player);
+
+	/** Writes the current board into given layout asset */
+	void SaveBoardLayout(UBoardLayoutAsset* Layout) const;
+
+	/** Generates the board from given layout asset, using tile template for each tile */
+	void LoadBoardLayout(const UBoardLayoutAsset* Layout, TSubclassOf<ATile> TileTemplate);
+
+	/** Destroys every tile of the board, leaving the board to be spawned from its layout when play begins.
+	This keeps tiles out of the level, so levels with large boards load faster */
+	UFUNCTION(CallInEditor, Category = "Board|Layout")
+	void StripTilesForLayout();
+
+	/** Applies given edit to every tile in mask. Every changed tile is modified (so this should be called within
+	a transaction), but cell states, masks and highlights are only refreshed once. Get the amount of tiles changed */
+	int32 ApplyTileEdit(const FBoardTileMask& Mask, const FBoardTileEdit& Edit);
 	#endif
 
+private:
+
+	/** Spawns every tile of the board from our layout. Tiles spawned this way are not saved or replicated,
+	they are instead spawned on each machine using the same names so references to them still resolve */
+	void BuildBoardFromLayout();
+
+	/** Get the name of the tile spawned for given cell when building from our layout. Replicated references
+	to these tiles are resolved by path, so this must give the same name on every machine */
+	static FName GetLayoutTileName(int32 CellIndex);
+
+protected:
+
+	/** Layout to spawn the board from when play begins. This is only used if the level has no tiles */
+	UPROPERTY(EditAnywhere, Category = "Board|Layout")
+	UBoardLayoutAsset* BoardLayout;
+
+	/** The tile to spawn for each cell when building the board from its layout */
+	UPROPERTY(EditAnywhere, Category = "Board|Layout")
+	TSubclassOf<ATile> LayoutTileTemplate;
+
 protected:
 
 	/** The hex grid containing all tiles of the board */
@@ -162,6 +452,10 @@ protected:
 	UPROPERTY(VisibleAnywhere, Category = "Board", meta = (DisplayName="Board Dimensions"))
 	float GridHexSize;
 
+	/** How the hex grid should store its tiles. Dense storage avoids hashing when querying tiles */
+	UPROPERTY(EditAnywhere, Category = "Board", meta = (DisplayName = "Board Storage Layout"))
+	EHexGridStorageLayout GridStorageLayout;
+
 	#if WITH_EDITORONLY_DATA
 	/** Uses along side board editor mode so board settings can update appropriately */
 	UPROPERTY(VisibleAnywhere, Category = "Board", meta = (DisplayName = "Board Tile Type"))
@@ -204,7 +498,25 @@ public:
 	FORCEINLINE ATile* GetTileAt(const FIntVector& Hex) const { return HexGrid.GetTile(Hex); }
 
 	/** Get the tile at given location */
-	FORCEINLINE ATile* GetTileAtLocation(const FVector& Location) const;
+	FORCEINLINE ATile* GetTileAtLocation(const FVector& Location) const
+	{
+		return HexGrid.GetTile(FHexGrid::ConvertWorldToHex(Location, GetActorLocation(), FVector(GridHexSize)));
+	}
+
+	/** Get the handle for given tile. Handles should be used when referencing tiles in RPCs */
+	FBoardTileHandle GetTileHandle(const ATile* Tile) const;
+
+	/** Get the tile given handle refers to (can return null) */
+	FORCEINLINE ATile* GetTileFromHandle(const FBoardTileHandle& Handle) const { return GetTileAtTileIndex(Handle.GetTileIndex()); }
+
+	/** Get the amount of cells on the board. Handles to tiles on this board are always below this */
+	FORCEINLINE int32 GetNumTiles() const { return GridDimensions.X * GridDimensions.Y; }
+
+	/** If given handle is within the bounds of this board. The cell it refers to might not have a tile */
+	FORCEINLINE bool IsValidTileHandle(const FBoardTileHandle& Handle) const
+	{
+		return Handle.IsValid() && Handle.GetTileIndex() < GetNumTiles();
+	}
 
 	/** Get all the tiles with a matching element type */
 	UFUNCTION(BlueprintPure, Category = "Board|Tiles")
@@ -242,10 +554,190 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Board")
 	bool GetTilesWithinDistance(const ATile* Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreOccupiedTiles = true) const;
 
+	/** Finds all the tiles that are exactly given amount of tiles from the origin */
+	UFUNCTION(BlueprintCallable, Category = "Board")
+	bool GetTilesAtDistance(const ATile* Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreOccupiedTiles = true) const;
+
 	/** Get all the tiles that are occupied and within given amount of tiles from the origin */
 	UFUNCTION(BlueprintCallable, Category = "Board")
 	bool GetOccupiedTilesWithinDistance(const ATile* Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreNullTiles = true, bool bIgnoreOrigin = true) const;
 
+	/** Finds every tile that can be walked to from the origin within given amount of moves. The 
+	results include the amount of moves required and can be used to build the path to each tile */
+	bool GetReachableTiles(const ATile* Origin, int32 MaxDistance, FHexGridReachability& OutReachability) const;
+
+public:
+
+	/** Finds a path between start and goal on a worker thread. The search runs against a copy of the boards cell states,
+	callback will be executed on the game thread once finished. Get handle to the query (invalid if query could not be made) */
+	FBoardAsyncQueryHandle FindPathAsync(const ATile* Start, const ATile* Goal, const FBoardPathQueryFinished& Callback, bool bAllowPartial = true, int32 MaxDistance = 100);
+
+	/** Cancels a pending async query, its callback will not be executed. This will invalidate the handle */
+	void CancelAsyncQuery(FBoardAsyncQueryHandle& Handle);
+
+	/** Get if given async query has yet to finish */
+	FORCEINLINE bool IsAsyncQueryPending(const FBoardAsyncQueryHandle& Handle) const { return PendingPathQueries.Contains(Handle.GetID()); }
+
+private:
+
+	/** Data for a path query that is running on a worker thread */
+	struct FPendingPathQuery
+	{
+	public:
+
+		FPendingPathQuery()
+			: bAllowPartial(false)
+			, MaxDistance(0)
+			, bCancelled(MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>(false))
+		{
+
+		}
+
+	public:
+
+		FIntVector Start;
+		FIntVector Goal;
+		bool bAllowPartial;
+		int32 MaxDistance;
+
+		/** Callback to execute once finished */
+		FBoardPathQueryFinished Callback;
+
+		/** Flag shared with the worker, so searches that are no longer needed can be skipped */
+		TSharedRef<FThreadSafeBool, ESPMode::ThreadSafe> bCancelled;
+	};
+
+	/** Starts the search for given query on a worker thread, using the boards current state */
+	void DispatchPathQuery(uint32 QueryID);
+
+	/** Notify that the search for given query has finished. Version is the occupancy version the search was made with */
+	void OnPathQueryFinished(uint32 QueryID, uint32 Version, bool bSuccess, const TArray<FIntVector>& HexPath);
+
+private:
+
+	/** Path queries that have yet to finish, keyed by query ID */
+	TMap<uint32, FPendingPathQuery> PendingPathQueries;
+
+	/** ID to give to the next async query */
+	uint32 NextAsyncQueryID;
+
+public:
+
+	/** Get the current occupancy version. This is incremented every time a tile has its state changed */
+	FORCEINLINE uint32 GetOccupancyVersion() const { return OccupancyVersion; }
+
+private:
+
+	/** Clears all cached queries if the board has changed since they were cached */
+	void ValidateQueryCaches() const;
+
+	/** Generic function for querying tiles in range, using the range cache if enabled. Filtered tiles
+	are occupied tiles when querying all tiles or null tiles when querying only occupied tiles */
+	bool QueryTilesWithinDistance(const ATile* Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bOccupiedOnly, bool bIgnoreFilteredTiles, bool bIgnoreOrigin) const;
+
+protected:
+
+	/** If path and range queries should be cached. Cached queries are
+	cleared whenever a board piece is placed or cleared from a tile */
+	UPROPERTY(EditAnywhere, Category = "Board|Cache")
+	uint8 bEnableQueryCache : 1;
+
+	/** The max amount of path queries and range queries to cache (each) */
+	UPROPERTY(EditAnywhere, Category = "Board|Cache", meta = (ClampMin = 1, EditCondition = "bEnableQueryCache"))
+	int32 QueryCacheSize;
+
+private:
+
+	/** Version of the boards state, incremented whenever a tiles state changes */
+	uint32 OccupancyVersion;
+
+	/** The occupancy version the cached queries were made with */
+	mutable uint32 CachedQueryVersion;
+
+	/** Cache of recent path queries, including queries that failed */
+	mutable TLruCache<FBoardPathQueryKey, FBoardPathQueryResult> PathQueryCache;
+
+	/** Cache of recent range queries */
+	mutable TLruCache<FBoardRangeQueryKey, TArray<ATile*>> RangeQueryCache;
+
+public:
+
+	/** Get the mask of every cell that has a tile. Masks are indexed by dense tile index (see FHexGrid::HexToCellIndex) */
+	FORCEINLINE const FBoardTileMask& GetTileMask() const { return TileMask; }
+
+	/** Get the mask of every null tile */
+	FORCEINLINE const FBoardTileMask& GetNullTileMask() const { return NullTileMask; }
+
+	/** Get the mask of every tile with a board piece placed on it */
+	FORCEINLINE const FBoardTileMask& GetOccupiedTileMask() const { return OccupiedTileMask; }
+
+	/** Get the mask of both players portal tiles */
+	FORCEINLINE const FBoardTileMask& GetPortalTileMask() const { return PortalTileMask; }
+
+	/** Get the mask of every tile occupied by a board piece owned by given player */
+	const FBoardTileMask& GetPlayerTileMask(int32 PlayerID) const;
+
+	/** Builds the mask of every tile matching any of given elements */
+	void GetElementTileMask(ECSKElementType Elements, FBoardTileMask& OutMask) const;
+
+	/** Builds the mask of every tile connected to origin that shares both its element and null state */
+	void GetConnectedTileMask(const ATile* Origin, FBoardTileMask& OutMask) const;
+
+	/** Builds the mask of every cell within given distance of origin (including origin).
+	Masks for small distances are kept in a cache shared with the other board queries */
+	void GetRangeTileMask(const ATile* Origin, int32 Distance, FBoardTileMask& OutMask) const;
+
+	/** Calls callback with every tile set in given mask, in dense tile index order */
+	template <typename Func>
+	void ForEachTileInMask(const FBoardTileMask& Mask, Func Callback) const
+	{
+		Mask.ForEachSetBit([this, &Callback](int32 TileIndex)->void
+		{
+			if (ATile* Tile = GetTileAtTileIndex(TileIndex))
+			{
+				Callback(Tile);
+			}
+		});
+	}
+
+	/** Collects every tile set in given mask. Get if any tiles were found */
+	bool GetTilesInMask(const FBoardTileMask& Mask, TArray<ATile*>& OutTiles) const;
+
+	/** Get all the tiles within distance of origin that a tower can be built on */
+	bool GetBuildableTilesWithinDistance(const ATile* Origin, int32 Distance, TArray<ATile*>& OutTiles) const;
+
+private:
+
+	/** Rebuilds every tile mask from the grids cell states */
+	void RebuildTileMasks();
+
+	/** Updates the tile masks for the cell at given dense index */
+	void UpdateTileMasks(int32 TileIndex);
+
+	/** Sets every cell within distance of given cell in mask */
+	void BuildRangeTileMask(int32 TileIndex, int32 Distance, FBoardTileMask& OutMask) const;
+
+private:
+
+	/** Max distance range masks are cached for */
+	static constexpr int32 MaxCachedRangeMaskDistance = 8;
+
+	/** Masks of every tile, null tile, occupied tile and portal tile */
+	FBoardTileMask TileMask;
+	FBoardTileMask NullTileMask;
+	FBoardTileMask OccupiedTileMask;
+	FBoardTileMask PortalTileMask;
+
+	/** Masks of tiles for each element, indexed by element bit */
+	FBoardTileMask ElementTileMasks[4];
+
+	/** Masks of tiles occupied by each players board pieces */
+	FBoardTileMask PlayerTileMasks[CSK_MAX_NUM_PLAYERS];
+
+	/** Cache of recently used range masks, keyed by tile index and distance. Ranges don't depend on
+	the state of the board, so these are only cleared when the board is rebuilt (see QueryCacheSize) */
+	mutable TLruCache<FIntPoint, FBoardTileMask> RangeTileMaskCache;
+
 public:
 
 	/** Attempts to place the board piece on given tile. This only runs on the server */
@@ -258,9 +750,29 @@ public:
 
 private:
 
-	/** Add/Removes tile with board piece for each client */
-	UFUNCTION(NetMulticast, Reliable)
-	void Multi_SetTileWithBoardPiece(ATile* Tile, bool bHasBoardPiece);
+	friend struct FBoardTileStateItem;
+
+	/** Notify that the state of a tile has been replicated, placing its board piece if required */
+	void OnTileStateReplicated(const FBoardTileStateItem& TileState);
+
+	/** Notify that the state of a tile has been removed, clearing its board piece */
+	void OnTileStateRemoved(const FBoardTileStateItem& TileState);
+
+	/** Applies the states that were received before their tiles existed */
+	void ApplyUnresolvedTileStates();
+
+	/** Get the tile at given dense index of the grid */
+	ATile* GetTileAtTileIndex(int32 TileIndex) const;
+
+private:
+
+	/** Every tile with a board piece. This is delta replicated, so only changes to the board are sent
+	and late joiners receive the current state of the board when the board manager first replicates */
+	UPROPERTY(Replicated)
+	FBoardTileStateArray BoardState;
+
+	/** Tile indices of states received before their tiles existed (client only) */
+	TArray<int32> UnresolvedTileStates;
 
 protected:
 
@@ -303,8 +815,19 @@ public:
 
 public:
 
-	/** Determines and sets the highlight material that given tile should use */
-	void SetTilesHighlightMaterial(ATile* Tile) const;
+	/** Determines and sets the highlight material that given tile should use. This is applied
+	immediately, prefer QueueTileHighlightRefresh when changing highlights during play */
+	void SetTilesHighlightMaterial(ATile* Tile);
+
+	/** Queues given tile to have its highlight material refreshed. All queued tiles are
+	refreshed together at the end of the frame, tiles queued multiple times are only refreshed once */
+	void QueueTileHighlightRefresh(ATile* Tile);
+
+	/** Refreshes the highlight material of all tiles that have been queued */
+	void FlushTileHighlights();
+
+	/** Determines the highlight material that given tile should use. Get if a material was determined */
+	bool GetTilesHighlightMaterial(const ATile* Tile, UMaterialInterface*& OutMaterial) const;
 
 	/** Sets the color for highlight material associated with player. This will create a new material if it doesn't exist */
 	void SetHighlightColorForPlayer(int32 PlayerID, FLinearColor Color);
@@ -349,5 +872,60 @@ protected:
 	/** The player highlight material associated with player 2 */
 	UPROPERTY(Transient)
 	UMaterialInstanceDynamic* Player2HighlightMaterial;
+
+private:
+
+	/** Tiles waiting to have their highlight material refreshed */
+	UPROPERTY(Transient)
+	TSet<ATile*> PendingHighlightTiles;
+
+public:
+
+	/** Get if tiles are currently being rendered using instanced meshes */
+	FORCEINLINE bool IsUsingInstancedTileRendering() const { return bInstancedTileRenderingActive; }
+
+private:
+
+	/** Hides each tiles mesh and starts rendering all tiles using instanced meshes instead */
+	void EnableInstancedTileRendering();
+
+	/** Sets the material the instance for given tile should be rendered with */
+	void SetTilesInstancedMaterial(ATile* Tile, UMaterialInterface* Material);
+
+	/** Updates the render state of each instance component that has had instances moved, hidden or added */
+	void FlushDirtyTileInstances();
+
+	/** Get the instanced mesh component used to render tiles with given material. Will create it if it doesn't exist */
+	UHierarchicalInstancedStaticMeshComponent* GetOrCreateTileInstanceComponent(UMaterialInterface* Material, ATile* TemplateTile);
+
+protected:
+
+	/** If tiles should be rendered using instanced meshes rather than with each tiles own mesh. Tiles
+	will still exist (and handle collision) but will not be rendered. This assumes all tiles share the same mesh */
+	UPROPERTY(EditAnywhere, Category = "Board|Rendering")
+	uint8 bUseInstancedTileRendering : 1;
+
+private:
+
+	/** If tiles are currently being rendered using instanced meshes */
+	uint8 bInstancedTileRenderingActive : 1;
+
+	/** The instanced mesh components used to render tiles, there is one for each highlight material */
+	UPROPERTY(Transient)
+	TMap<UMaterialInterface*, UHierarchicalInstancedStaticMeshComponent*> TileInstanceComponents;
+
+	/** The material each tile is currently being rendered with */
+	UPROPERTY(Transient)
+	TMap<ATile*, UMaterialInterface*> InstancedTileMaterials;
+
+	/** The index of the instance rendering each tile, in the component for the tiles current material */
+	TMap<ATile*, int32> InstancedTileIndices;
+
+	/** Hidden instances of each material that can be reused when a tile switches to that material */
+	TMap<UMaterialInterface*, TArray<int32>> FreeTileInstances;
+
+	/** Materials that have had instances changed since their render state was last updated */
+	UPROPERTY(Transient)
+	TSet<UMaterialInterface*> DirtyInstancedMaterials;
 };
 
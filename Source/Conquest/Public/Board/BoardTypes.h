@@ -41,7 +41,10 @@ enum class ETileSelectionState : uint8
 	Unselectable,
 
 	/** Tile is marked as unselectable and has priority over hover */
-	UnselectablePriority
+	UnselectablePriority,
+
+	/** Tile is part of an action being previewed (e.g. the path a castle will take). Displayed as if hovered */
+	Preview
 };
 
 /** A path for traversing the board */
@@ -111,4 +114,105 @@ public:
 	/** The tiles to follow, in order from first to last */
 	UPROPERTY(BlueprintReadOnly)
 	TArray<ATile*> Path;
-};
\ No newline at end of file
+};
+
+/** Delegate for when an async path query has finished. Path will be empty if no path was found */
+DECLARE_DELEGATE_TwoParams(FBoardPathQueryFinished, bool /*bSuccess*/, const FBoardPath& /*Path*/);
+
+/** Handle to an async query made through the board manager */
+struct CONQUEST_API FBoardAsyncQueryHandle
+{
+public:
+
+	FBoardAsyncQueryHandle()
+		: ID(0)
+	{
+
+	}
+
+	explicit FBoardAsyncQueryHandle(uint32 InID)
+		: ID(InID)
+	{
+
+	}
+
+	/** If this handle refers to a query */
+	FORCEINLINE bool IsValid() const { return ID != 0; }
+
+	/** Resets this handle to no longer refer to a query */
+	FORCEINLINE void Invalidate() { ID = 0; }
+
+	/** Get the ID of the query */
+	FORCEINLINE uint32 GetID() const { return ID; }
+
+private:
+
+	/** ID of the query, zero is invalid */
+	uint32 ID;
+};
+/** Compact handle to a tile on the board. Handles are used in place of tile references when
+sending RPCs, avoiding the need to resolve tiles as network objects. A handle is the index of
+the tile in the board managers hex grid and is serialized as a packed int, so small indices use fewer bits */
+USTRUCT()
+struct CONQUEST_API FBoardTileHandle
+{
+	GENERATED_BODY()
+
+public:
+
+	FBoardTileHandle()
+		: TileIndex(InvalidIndex)
+	{
+
+	}
+
+	explicit FBoardTileHandle(int32 InTileIndex)
+		: TileIndex(InTileIndex >= 0 && InTileIndex < InvalidIndex ? static_cast<uint16>(InTileIndex) : InvalidIndex)
+	{
+
+	}
+
+	/** If this handle refers to a tile */
+	FORCEINLINE bool IsValid() const { return TileIndex != InvalidIndex; }
+
+	/** Get the index of the tile this handle refers to (INDEX_NONE if invalid) */
+	FORCEINLINE int32 GetTileIndex() const { return IsValid() ? static_cast<int32>(TileIndex) : INDEX_NONE; }
+
+	FORCEINLINE bool operator == (const FBoardTileHandle& Other) const
+	{
+		return TileIndex == Other.TileIndex;
+	}
+
+	FORCEINLINE bool operator != (const FBoardTileHandle& Other) const
+	{
+		return TileIndex != Other.TileIndex;
+	}
+
+	/** Net serializes this handle. Received indices that don't fit in a handle are read as invalid handles */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+private:
+
+	/** The value for a handle that does not refer to a tile */
+	static constexpr uint16 InvalidIndex = MAX_uint16;
+
+public:
+
+	/** The max amount of tiles a board can have for every tile to be referenced by a handle */
+	static constexpr int32 MaxBoardTiles = InvalidIndex;
+
+private:
+
+	/** Index of the tile in the board managers hex grid */
+	UPROPERTY()
+	uint16 TileIndex;
+};
+
+template<>
+struct TStructOpsTypeTraits<FBoardTileHandle> : public TStructOpsTypeTraitsBase2<FBoardTileHandle>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
@@ -20,6 +20,8 @@ UCLASS()
 class CONQUEST_API ATile : public AActor
 {
 	GENERATED_BODY()
+
+	friend class ABoardManager;
 	
 public:	
 	
@@ -140,13 +142,14 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent, Category = "Board|Tiles", meta = (DisplayName = "On Board Piece Cleared"))
 	void BP_OnBoardPieceCleared();
 
-	/** Sets the board piece to occupy this tile */
-	UFUNCTION(NetMulticast, Reliable)
-	void Multi_SetBoardPiece(AActor* BoardPiece);
+	/** Sets the board piece to occupy this tile. Clients are informed of changes through the board managers replicated board state */
+	void HandleBoardPieceSet(AActor* BoardPiece);
+
+	/** Clears the board piece occupying this tile. Clients are informed of changes through the board managers replicated board state */
+	void HandleBoardPieceCleared();
 
-	/** Clears the board piece occupying this tile */
-	UFUNCTION(NetMulticast, Reliable)
-	void Multi_ClearBoardPiece();
+	/** Informs the board manager that this tiles state has changed */
+	void NotifyBoardOfStateChange();
 
 public:
 
@@ -191,7 +194,7 @@ private:
 
 public:
 
-	/** Refreshes this tiles highlight material */
+	/** Refreshes this tiles highlight material. The refresh is deferred to the end of the frame */
 	UFUNCTION(BlueprintCallable, Category = "Board|Tiles")
 	void RefreshHighlightMaterial();
 };
@@ -5,6 +5,8 @@
 #include "Modules/ModuleInterface.h"
 #include "Modules/ModuleManager.h"
 
+class FQueuedThreadPool;
+
 class IConquestModule : public IModuleInterface
 {
 public:
@@ -14,5 +16,8 @@ public:
 	{
 		return FModuleManager::LoadModuleChecked<IConquestModule>("Conquest");
 	}
-};
 
+	/** Get the thread pool AI players search on (see FCSKMatchSearch). This
+	pool is created on first use and can only be accessed on the game thread */
+	virtual FQueuedThreadPool* GetSearchThreadPool() = 0;
+};
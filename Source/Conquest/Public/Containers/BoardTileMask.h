@@ -0,0 +1,166 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** A set of tiles stored as one bit per dense tile index (see FHexGrid::HexToCellIndex). Combining
+masks works on entire words at a time, so set queries over the board only touch a few cache lines */
+struct FBoardTileMask
+{
+public:
+
+	using WordType = uint32;
+	static constexpr int32 BitsPerWord = 32;
+
+public:
+
+	FBoardTileMask()
+		: NumBits(0)
+	{
+
+	}
+
+	/** Resizes this mask to hold given amount of bits, all set to value */
+	void Init(int32 InNumBits, bool bValue = false)
+	{
+		NumBits = FMath::Max(0, InNumBits);
+		Words.Init(bValue ? ~WordType(0) : WordType(0), FMath::DivideAndRoundUp(NumBits, BitsPerWord));
+
+		ClearSlack();
+	}
+
+	/** Get the amount of bits in this mask */
+	FORCEINLINE int32 Num() const { return NumBits; }
+
+	/** If given bit is set */
+	FORCEINLINE bool IsSet(int32 Index) const
+	{
+		checkSlow(Index >= 0 && Index < NumBits);
+		return (Words[Index / BitsPerWord] & (WordType(1) << (Index % BitsPerWord))) != 0;
+	}
+
+	/** Sets or clears given bit */
+	FORCEINLINE void SetBit(int32 Index, bool bValue = true)
+	{
+		checkSlow(Index >= 0 && Index < NumBits);
+
+		const WordType Mask = WordType(1) << (Index % BitsPerWord);
+		WordType& Word = Words[Index / BitsPerWord];
+		Word = bValue ? (Word | Mask) : (Word & ~Mask);
+	}
+
+	/** Clears every bit */
+	FORCEINLINE void ClearAll()
+	{
+		FMemory::Memzero(Words.GetData(), Words.Num() * sizeof(WordType));
+	}
+
+	/** Keeps only the bits also set in other */
+	FORCEINLINE FBoardTileMask& operator &= (const FBoardTileMask& Other)
+	{
+		check(NumBits == Other.NumBits);
+		for (int32 i = 0; i < Words.Num(); ++i)
+		{
+			Words[i] &= Other.Words[i];
+		}
+
+		return *this;
+	}
+
+	/** Adds the bits set in other */
+	FORCEINLINE FBoardTileMask& operator |= (const FBoardTileMask& Other)
+	{
+		check(NumBits == Other.NumBits);
+		for (int32 i = 0; i < Words.Num(); ++i)
+		{
+			Words[i] |= Other.Words[i];
+		}
+
+		return *this;
+	}
+
+	/** Removes the bits set in other */
+	FORCEINLINE FBoardTileMask& RemoveBits(const FBoardTileMask& Other)
+	{
+		check(NumBits == Other.NumBits);
+		for (int32 i = 0; i < Words.Num(); ++i)
+		{
+			Words[i] &= ~Other.Words[i];
+		}
+
+		return *this;
+	}
+
+	/** Get the amount of bits that are set */
+	int32 CountSetBits() const
+	{
+		int32 Count = 0;
+		for (WordType Word : Words)
+		{
+			Count += CountBits(Word);
+		}
+
+		return Count;
+	}
+
+	/** If no bits are set */
+	bool IsEmpty() const
+	{
+		for (WordType Word : Words)
+		{
+			if (Word != 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/** Calls callback with the index of every set bit, in ascending order */
+	template <typename Func>
+	void ForEachSetBit(Func Callback) const
+	{
+		for (int32 i = 0; i < Words.Num(); ++i)
+		{
+			WordType Word = Words[i];
+			while (Word != 0)
+			{
+				const int32 Bit = static_cast<int32>(FMath::CountTrailingZeros(Word));
+				Callback(i * BitsPerWord + Bit);
+
+				// Clear lowest set bit
+				Word &= Word - 1;
+			}
+		}
+	}
+
+private:
+
+	/** Clears the bits in the last word that exceed our size, so counting bits remains correct */
+	FORCEINLINE void ClearSlack()
+	{
+		const int32 SlackBits = Words.Num() * BitsPerWord - NumBits;
+		if (SlackBits > 0)
+		{
+			Words.Last() &= ~WordType(0) >> SlackBits;
+		}
+	}
+
+	/** Get the amount of set bits in given word */
+	FORCEINLINE static int32 CountBits(WordType Word)
+	{
+		Word = Word - ((Word >> 1) & 0x55555555);
+		Word = (Word & 0x33333333) + ((Word >> 2) & 0x33333333);
+		return static_cast<int32>((((Word + (Word >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+	}
+
+private:
+
+	/** The bits of this mask */
+	TArray<WordType, TInlineAllocator<16>> Words;
+
+	/** The amount of bits in this mask */
+	int32 NumBits;
+};
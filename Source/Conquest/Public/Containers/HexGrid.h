@@ -3,10 +3,101 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/HexOffsetTable.h"
 #include "HexGrid.generated.h"
 
 class ATile;
 
+/** How the hex grid stores the tiles it has generated */
+UENUM()
+enum class EHexGridStorageLayout : uint8
+{
+	/** Tiles are stored in a map keyed by their hex value */
+	Map,
+
+	/** Tiles are stored in a flat array indexed by their row and column.
+	This avoids hashing when querying tiles, but requires a rectangular grid */
+	Dense
+};
+
+/** Flags tracked per cell. These mirror the state of each tile */
+enum class EHexGridCellFlags : uint8
+{
+	None		= 0,
+
+	/** Tile is marked as a null tile (or there is no tile) */
+	Null		= 1,
+
+	/** Tile has a board piece placed on it */
+	Occupied	= 2,
+
+	/** Cell has no tile associated with it */
+	Missing		= 4,
+
+	/** Flags that prevent a cell from being moved onto */
+	Blocking	= Null | Occupied
+};
+
+ENUM_CLASS_FLAGS(EHexGridCellFlags);
+
+/** Plain state of a single cell in the grid. The grid keeps these up to date with the tiles so
+queries can run without dereferencing any tiles, allowing them to be used without a world */
+struct FHexGridCellState
+{
+public:
+
+	FHexGridCellState()
+		: Flags(EHexGridCellFlags::Null | EHexGridCellFlags::Missing)
+		, OwnerID(-1)
+		, Element(0)
+	{
+
+	}
+
+	FHexGridCellState(EHexGridCellFlags InFlags, int8 InOwnerID, uint8 InElement)
+		: Flags(InFlags)
+		, OwnerID(InOwnerID)
+		, Element(InElement)
+	{
+
+	}
+
+	/** If a tile exists for this cell */
+	FORCEINLINE bool HasTile() const { return !EnumHasAnyFlags(Flags, EHexGridCellFlags::Missing); }
+
+	/** If this cell is a null tile */
+	FORCEINLINE bool IsNull() const { return EnumHasAnyFlags(Flags, EHexGridCellFlags::Null); }
+
+	/** If this cell has a board piece placed on it */
+	FORCEINLINE bool IsOccupied() const { return EnumHasAnyFlags(Flags, EHexGridCellFlags::Occupied); }
+
+	/** If this cell can be moved onto */
+	FORCEINLINE bool IsWalkable() const { return !EnumHasAnyFlags(Flags, EHexGridCellFlags::Blocking); }
+
+	FORCEINLINE bool operator == (const FHexGridCellState& Other) const
+	{
+		return Flags == Other.Flags && OwnerID == Other.OwnerID && Element == Other.Element;
+	}
+
+	FORCEINLINE bool operator != (const FHexGridCellState& Other) const
+	{
+		return !(*this == Other);
+	}
+
+public:
+
+	/** State flags of this cell */
+	EHexGridCellFlags Flags;
+
+	/** ID of the player whose board piece occupies this cell (-1 if none) */
+	int8 OwnerID;
+
+	/** Element of the tile of this cell (see ECSKElementType) */
+	uint8 Element;
+};
+
+template <> struct TIsPODType<FHexGridCellState> { enum { Value = true }; };
+
 /** Results for performing a path find using the hex grid */
 enum class EHexGridPathFindResult
 {
@@ -35,6 +126,23 @@ enum class EHexGridPathFindResult
 	NoGridGenerated
 };
 
+/** Symmetries of a grid, used to mirror cells so neither player is favoured.
+As every second column is offset by half a row, not every grid supports every symmetry */
+enum class EHexGridSymmetry : uint8
+{
+	/** Each cell is independent */
+	None,
+
+	/** Mirror across the center column. Requires an odd amount of columns */
+	MirrorColumns,
+
+	/** Mirror across the center row. This is never supported, as mirrored offset columns would fall outside the grid */
+	MirrorRows,
+
+	/** Rotate around the center, so each portal sees the same board as the other. Requires an even amount of columns */
+	Rotate
+};
+
 /** Data about a hex grid path generation */
 struct CONQUEST_API FHexGridPathFindResultData
 {
@@ -66,7 +174,7 @@ public:
 	FORCEINLINE void Set(EHexGridPathFindResult InResult, TArray<ATile*>&& InPath)
 	{
 		Result = InResult;
-		Path = InPath;
+		Path = MoveTemp(InPath);
 	}
 
 	/** Reset result */
@@ -93,6 +201,176 @@ public:
 	TArray<ATile*> Path;
 };
 
+/** Results of a reachability search from an origin hex (see FHexGrid::FindReachableTiles) */
+struct CONQUEST_API FHexGridReachability
+{
+public:
+
+	FHexGridReachability()
+		: Origin(-1)
+	{
+
+	}
+
+public:
+
+	/** Resets the results while keeping allocated memory for the next search */
+	FORCEINLINE void Reset()
+	{
+		Origin = FIntVector(-1);
+		Hexes.Reset();
+		Tiles.Reset();
+		Steps.Reset();
+		Predecessors.Reset();
+		HexLookup.Reset();
+	}
+
+	/** Get the amount of cells reached (including the origin) */
+	FORCEINLINE int32 Num() const
+	{
+		return Hexes.Num();
+	}
+
+	/** Get the index of the entry for given hex. Returns INDEX_NONE if hex was not reached */
+	FORCEINLINE int32 Find(const FIntVector& Hex) const
+	{
+		const int32* Index = HexLookup.Find(Hex);
+		return Index ? *Index : INDEX_NONE;
+	}
+
+	/** If given hex was reached during the search */
+	FORCEINLINE bool Contains(const FIntVector& Hex) const
+	{
+		return HexLookup.Contains(Hex);
+	}
+
+	/** Get the amount of steps required to reach given hex. Returns INDEX_NONE if hex was not reached */
+	FORCEINLINE int32 GetSteps(const FIntVector& Hex) const
+	{
+		int32 Index = Find(Hex);
+		return Index != INDEX_NONE ? Steps[Index] : INDEX_NONE;
+	}
+
+	/** Get all reachable tiles, excluding the origin tile */
+	void GetReachableTiles(TArray<ATile*>& OutTiles) const;
+
+	/** Builds the path (from origin to goal) to the given hex. Get if hex was reached */
+	bool GetPathTo(const FIntVector& Goal, TArray<ATile*>& OutPath) const;
+
+public:
+
+	/** The hex the search was started from */
+	FIntVector Origin;
+
+	/** Every hex that was reached, ordered by the amount of steps required to reach it */
+	TArray<FIntVector> Hexes;
+
+	/** The tile at each reached hex */
+	TArray<ATile*> Tiles;
+
+	/** The amount of steps required to reach each hex */
+	TArray<int32> Steps;
+
+	/** Index of the entry each hex was reached from (INDEX_NONE for the origin) */
+	TArray<int32> Predecessors;
+
+private:
+
+	friend struct FHexGrid;
+
+	/** Lookup table from hex to entry index */
+	TMap<FIntVector, int32> HexLookup;
+};
+
+/** Reusable memory used by the hex grid when path finding. Each array is indexed
+by a cells dense index, with visit stamps used to avoid clearing between searches */
+struct CONQUEST_API FHexGridSearchScratch
+{
+public:
+
+	/** A cell waiting to be expanded */
+	struct FOpenNode
+	{
+		FOpenNode(int32 InIndex, int32 InCost, int32 InHeuristic)
+			: Index(InIndex)
+			, Cost(InCost)
+			, Heuristic(InHeuristic)
+		{
+
+		}
+
+		/** Dense index of the cell */
+		int32 Index;
+
+		/** Estimated total cost of a path through this cell */
+		int32 Cost;
+
+		/** Estimated distance from this cell to the goal */
+		int32 Heuristic;
+	};
+
+	/** Predicate for sorting open list (cheapest first, closest to goal breaking ties) */
+	struct FOpenNodePredicate
+	{
+		FORCEINLINE bool operator() (const FOpenNode& lhs, const FOpenNode& rhs) const
+		{
+			return lhs.Cost < rhs.Cost || (lhs.Cost == rhs.Cost && lhs.Heuristic < rhs.Heuristic);
+		}
+	};
+
+public:
+
+	FHexGridSearchScratch()
+		: SearchStamp(0)
+	{
+
+	}
+
+public:
+
+	/** Prepares the scratch for a new search over given amount of cells */
+	void BeginSearch(int32 NumCells);
+
+	/** If given cell has been reached during the current search */
+	FORCEINLINE bool IsVisited(int32 Index) const { return VisitStamps[Index] == SearchStamp; }
+
+	/** If given cell has been fully expanded during the current search */
+	FORCEINLINE bool IsClosed(int32 Index) const { return ClosedStamps[Index] == SearchStamp; }
+
+	/** Marks given cell as reached with cost and the cell it was reached from */
+	FORCEINLINE void Visit(int32 Index, int32 Cost, int32 From)
+	{
+		VisitStamps[Index] = SearchStamp;
+		CostSoFar[Index] = Cost;
+		CameFrom[Index] = From;
+	}
+
+	/** Marks given cell as fully expanded */
+	FORCEINLINE void Close(int32 Index) { ClosedStamps[Index] = SearchStamp; }
+
+public:
+
+	/** Open list of cells waiting to be expanded (as a heap) */
+	TArray<FOpenNode> OpenList;
+
+	/** The cell each cell was reached from */
+	TArray<int32> CameFrom;
+
+	/** The amount of steps taken to reach each cell */
+	TArray<int32> CostSoFar;
+
+private:
+
+	/** Stamp of the last search that reached each cell */
+	TArray<uint32> VisitStamps;
+
+	/** Stamp of the last search that expanded each cell */
+	TArray<uint32> ClosedStamps;
+
+	/** Stamp of the current search */
+	uint32 SearchStamp;
+};
+
 /**
  * A grid genereted using hexagons. This grid uses cube coordinates
  * and is specifically designed for use in CSK. I highly recommend
@@ -117,8 +395,9 @@ public:
 public:
 
 	FHexGrid()
-		: GridDimensions(0, 0)
-		, bGridGenerated(false)
+		: bGridGenerated(false)
+		, StorageLayout(EHexGridStorageLayout::Dense)
+		, GridDimensions(0, 0)
 	{
 		
 	}
@@ -133,12 +412,6 @@ private:
 		return (Hex.X + Hex.Y + Hex.Z) == 0;
 	}
 
-	FORCEINLINE static const FHex& HexDirection(int32 Index)
-	{
-		check(Index >= 0 && Index <= 5);
-		return DirectionTable[Index];
-	}
-
 	FORCEINLINE static FHex HexRound(const FFracHex& FracHex)
 	{
 		float X = FMath::RoundToFloat(FracHex.X);
@@ -171,6 +444,12 @@ private:
 
 public:
 
+	FORCEINLINE static const FHex& HexDirection(int32 Index)
+	{
+		check(Index >= 0 && Index <= 5);
+		return DirectionTable[Index];
+	}
+
 	FORCEINLINE static int32 HexLength(FHex Hex)
 	{
 		return FMath::DivideAndRoundDown(FMath::Abs(Hex.X) + FMath::Abs(Hex.Y) + FMath::Abs(Hex.Z), 2);
@@ -249,6 +528,126 @@ public:
 	/** Removes all cells starting and beyond given row and column */
 	void RemoveCellsFrom(int32 Row, int32 Column);
 
+	/** Switches how tiles are stored, moving any existing tiles into the new layout */
+	void SetStorageLayout(EHexGridStorageLayout NewLayout);
+
+	/** Get how tiles are currently being stored */
+	FORCEINLINE EHexGridStorageLayout GetStorageLayout() const { return StorageLayout; }
+
+	/** Get the dimensions (rows and columns) of the grid */
+	FORCEINLINE const FIntPoint& GetGridDimensions() const { return GridDimensions; }
+
+	/** Refreshes the cell state of the tile at given hex. This should be called
+	whenever a tile has its occupant, element or null state changed */
+	void RefreshCellState(const FHex& Hex);
+
+	/** Refreshes the cell state of every tile in the grid */
+	void RefreshAllCellStates();
+
+	/** Sets the owner of an occupied cell at given hex. Clients use this as the owner
+	of a board piece may replicate later than the board piece itself */
+	void SetCellOwnerID(const FHex& Hex, int8 OwnerID);
+
+	/** Get the state of the cell at given hex. Returns null if hex lies outside the grid */
+	FORCEINLINE const FHexGridCellState* GetCellState(const FHex& Hex) const
+	{
+		int32 Index = HexToDenseIndex(Hex);
+		return CellStates.IsValidIndex(Index) ? &CellStates[Index] : nullptr;
+	}
+
+	/** Get the state of every cell, ordered by column then row (see HexToDenseIndex) */
+	FORCEINLINE const TArray<FHexGridCellState>& GetCellStates() const { return CellStates; }
+
+	/** Serialization notify, used to migrate tiles into the current storage layout */
+	void PostSerialize(const FArchive& Ar);
+
+private:
+
+	/** Get the dense index of given hex. Returns INDEX_NONE if hex lies outside the grid */
+	FORCEINLINE int32 HexToDenseIndex(const FHex& Hex) const
+	{
+		return HexToCellIndex(Hex, GridDimensions);
+	}
+
+	/** Get the hex value of the cell at given dense index */
+	FORCEINLINE FHex DenseIndexToHex(int32 Index) const
+	{
+		return CellIndexToHex(Index, GridDimensions);
+	}
+
+public:
+
+	/** Get the index of given hex in a grid of given dimensions. Returns INDEX_NONE if hex lies outside the grid */
+	FORCEINLINE static int32 HexToCellIndex(const FHex& Hex, const FIntPoint& Dimensions)
+	{
+		// Every second column is offset by one row (see GenerateGrid)
+		const int32 Column = Hex.Y;
+		const int32 Row = Hex.X + FMath::DivideAndRoundDown(Hex.Y, 2);
+
+		if (Column >= 0 && Column < Dimensions.Y && Row >= 0 && Row < Dimensions.X)
+		{
+			return Column * Dimensions.X + Row;
+		}
+
+		return INDEX_NONE;
+	}
+
+	/** Get the hex value of the cell at given index in a grid of given dimensions */
+	FORCEINLINE static FHex CellIndexToHex(int32 Index, const FIntPoint& Dimensions)
+	{
+		const int32 Column = Index / Dimensions.X;
+		const int32 Row = Index % Dimensions.X;
+
+		return ConvertIndicesToHex(Row - FMath::DivideAndRoundDown(Column, 2), Column);
+	}
+
+	/** If given symmetry maps every cell of a grid of given dimensions onto a cell of the same grid */
+	static bool SupportsSymmetry(EHexGridSymmetry Symmetry, const FIntPoint& Dimensions);
+
+	/** Get the hex mirroring given hex with given symmetry in a grid of given dimensions. This
+	is only valid if the dimensions support the symmetry (see SupportsSymmetry) */
+	static FHex GetMirroredHex(const FHex& Hex, EHexGridSymmetry Symmetry, const FIntPoint& Dimensions);
+
+	/** Get the index of the cell mirroring given cell with given symmetry in a grid of given
+	dimensions. Returns INDEX_NONE if the dimensions don't support the symmetry */
+	static int32 GetMirroredCellIndex(int32 Index, EHexGridSymmetry Symmetry, const FIntPoint& Dimensions);
+
+private:
+
+	/** Finds the slot containing the tile at given hex. Returns null if hex is not part of the grid */
+	FORCEINLINE ATile* const* FindTile(const FHex& Hex) const
+	{
+		if (StorageLayout == EHexGridStorageLayout::Dense)
+		{
+			int32 Index = HexToDenseIndex(Hex);
+			return Index != INDEX_NONE ? &DenseTiles[Index] : nullptr;
+		}
+
+		return GridMap.Find(Hex);
+	}
+
+	/** Moves all tiles from the map into dense array */
+	void MoveTilesToDenseArray();
+
+	/** Moves all tiles from the dense array into the map */
+	void MoveTilesToMap();
+
+	/** Calculates the cell state for given tile */
+	static FHexGridCellState CalculateCellState(const ATile* Tile);
+
+	/** Get the index of the cell at hex if it has a tile. Returns INDEX_NONE otherwise */
+	FORCEINLINE int32 FindCellIndexWithTile(const FHex& Hex) const
+	{
+		int32 Index = HexToDenseIndex(Hex);
+		return CellStates.IsValidIndex(Index) && CellStates[Index].HasTile() ? Index : INDEX_NONE;
+	}
+
+	/** Get the tile at given cell index. The cell is expected to have a tile */
+	FORCEINLINE ATile* GetTileAtCellIndex(int32 Index) const
+	{
+		return StorageLayout == EHexGridStorageLayout::Dense ? DenseTiles[Index] : GridMap.FindRef(DenseIndexToHex(Index));
+	}
+
 public:
 
 	/** Get an individual tile */
@@ -258,7 +657,7 @@ public:
 
 		if (bGridGenerated)
 		{
-			ATile* const* ValuePtr = GridMap.Find(Hex);
+			ATile* const* ValuePtr = FindTile(Hex);
 			if (ValuePtr != nullptr)
 			{
 				Tile = *ValuePtr;
@@ -275,24 +674,61 @@ public:
 		
 		if (bGridGenerated)
 		{
-			GridMap.GenerateValueArray(Tiles);
+			if (StorageLayout == EHexGridStorageLayout::Dense)
+			{
+				Tiles = DenseTiles;
+			}
+			else
+			{
+				GridMap.GenerateValueArray(Tiles);
+			}
 		}
 
 		return Tiles;
 	}
 
+	/** Calls given function for every tile in the grid (tiles may be null). This avoids
+	the allocation GetAllTiles() requires and should be preferred when iterating the board */
+	template <typename TFunc>
+	FORCEINLINE void ForEachTile(TFunc&& Func) const
+	{
+		if (bGridGenerated)
+		{
+			if (StorageLayout == EHexGridStorageLayout::Dense)
+			{
+				for (ATile* Tile : DenseTiles)
+				{
+					Func(Tile);
+				}
+			}
+			else
+			{
+				for (const TPair<FIntVector, ATile*>& Pair : GridMap)
+				{
+					Func(Pair.Value);
+				}
+			}
+		}
+	}
+
+	/** If given hex is a cell of this grid */
+	FORCEINLINE bool Contains(const FHex& Hex) const
+	{
+		return bGridGenerated && FindTile(Hex) != nullptr;
+	}
+
 	/** Get all valid hex neighbors for given hex index */
 	FORCEINLINE TArray<FHex> GetNeighbors(const FHex& Hex) const
 	{
 		TArray<FHex> Neighbors;
 
-		if (bGridGenerated && GridMap.Contains(Hex))
+		if (Contains(Hex))
 		{
 			// There can be a total of six neighbours (see direction table)
 			for (int32 i = 0; i < 6; ++i)
 			{
 				FHex NeighborHex = Hex + HexDirection(i);
-				if (GridMap.Contains(NeighborHex))
+				if (FindTile(NeighborHex) != nullptr)
 				{
 					Neighbors.Add(NeighborHex);
 				}
@@ -310,29 +746,133 @@ public:
 	/** Generates a path (AStar) using two tiles. Get if result was successful  */
 	bool GeneratePath(const ATile* Start, const ATile* Goal, FHexGridPathFindResultData& OutResultData, bool bAllowPartial = false, int32 MaxDistance = INT_MAX) const;
 
+	/** Checks if a path search between start and goal is required. Returns unknown if 
+	a search is required, otherwise the result generating a path would have had */
+	EHexGridPathFindResult CheckPathTargets(const FHex& Start, const FHex& Goal, bool bAllowPartial, int32 MaxDistance) const;
+
 private:
 
 	/** Performs pathfinding using generated grid. Will generate a path if successful.
 	This function assumes only pre-checks have already been performed */
 	bool FindPath(const FHex& Start, const FHex& Goal, FHexGridPathFindResultData& OutResultData, bool bAllowPartial, int32 MaxDistance) const;
 
-	/** Converts path edges into an actual path array of tiles */
-	void ConvertEdgesToPath(const FHex& Start, const FHex& Goal, const TMap<FHex, FHex>& Edges, TArray<ATile*>& OutPath) const;
+	/** Fills out path by walking back from given cell using the came from links of the search scratch */
+	void ConvertSearchToPath(int32 GoalIndex, TArray<ATile*>& OutPath) const;
+
+public:
+
+	/** Performs an AStar search using only given cell states. Nothing else is read, so this is safe to call from any thread
+	given the scratch is not shared. Get if a path was found, the path can be built from the cell the search ended at */
+	static bool SearchCells(const FIntPoint& Dimensions, const TArray<FHexGridCellState>& Cells, const FHex& Start, const FHex& Goal,
+		bool bAllowPartial, int32 MaxDistance, FHexGridSearchScratch& Scratch, int32& OutEndIndex, bool& bOutReachedGoal);
+
+	/** Fills out path of hexes by walking back from given cell using the came from links of the search scratch */
+	static void ConvertSearchToHexPath(const FIntPoint& Dimensions, const FHexGridSearchScratch& Scratch, int32 EndIndex, TArray<FHex>& OutPath);
+
+private:
 
 	/** Heuristic used when generating a path */
-	static float PathHeuristic(const ATile* T1, const ATile* T2);
+	FORCEINLINE static int32 PathHeuristic(const FHex& H1, const FHex& H2)
+	{
+		return HexDisplacement(H1, H2);
+	}
 
 public:
 
+	/** Performs a single breadth first search from origin, finding every tile that can be reached within
+	max distance without passing through occupied or null tiles. Get if at least one tile was reached */
+	bool FindReachableTiles(const FHex& Origin, int32 MaxDistance, FHexGridReachability& OutReachability) const;
+
+private:
+
+	/** If given hex can not be moved onto (either not part of the grid, null or occupied) */
+	bool IsHexBlocked(const FHex& Hex) const;
+
+public:
+
+	/** Calls given function with every hex exactly radius away from origin. Hexes may lie outside
+	the grid. Rings within the offset table are read from it, larger rings are walked instead */
+	template <typename TFunc>
+	static void ForEachHexInRing(const FHex& Origin, int32 Radius, TFunc&& Func)
+	{
+		if (Radius < 0)
+		{
+			return;
+		}
+
+		if (Radius <= FHexOffsetTable::MaxRadius)
+		{
+			const int32 End = FHexOffsetTable::RingStart(Radius) + FHexOffsetTable::RingNum(Radius);
+			for (int32 i = FHexOffsetTable::RingStart(Radius); i < End; ++i)
+			{
+				const int32 X = HexOffsets::Spiral.X[i];
+				const int32 Y = HexOffsets::Spiral.Y[i];
+
+				Func(FHex(Origin.X + X, Origin.Y + Y, Origin.Z - X - Y));
+			}
+		}
+		else
+		{
+			// Same order as the offset table (see FHexOffsetTable)
+			FHex Hex = Origin + HexDirection(4) * Radius;
+			for (int32 Side = 0; Side < 6; ++Side)
+			{
+				for (int32 Step = 0; Step < Radius; ++Step)
+				{
+					Func(Hex);
+					Hex = Hex + HexDirection(Side);
+				}
+			}
+		}
+	}
+
+	/** Calls given function with every hex within distance of origin (including origin), spiraling outwards one ring at a time */
+	template <typename TFunc>
+	static void ForEachHexInRange(const FHex& Origin, int32 Distance, TFunc&& Func)
+	{
+		for (int32 Radius = 0; Radius <= Distance; ++Radius)
+		{
+			ForEachHexInRing(Origin, Radius, Func);
+		}
+	}
+
+	/** Calls given function with the tile and cell state of every tile exactly radius away from origin */
+	template <typename TFunc>
+	void ForEachTileInRing(const FHex& Origin, int32 Radius, TFunc&& Func) const
+	{
+		ForEachHexInRing(Origin, Radius, [this, &Func](const FHex& Hex)->void
+		{
+			int32 Index = FindCellIndexWithTile(Hex);
+			if (Index != INDEX_NONE)
+			{
+				Func(GetTileAtCellIndex(Index), CellStates[Index]);
+			}
+		});
+	}
+
+	/** Calls given function with the tile and cell state of every tile within distance of origin (including origin).
+	Unlike GetAllTilesWithinRange, this performs no allocations and should be preferred when results don't need to be kept */
+	template <typename TFunc>
+	void ForEachTileInRange(const FHex& Origin, int32 Distance, TFunc&& Func) const
+	{
+		for (int32 Radius = 0; Radius <= Distance; ++Radius)
+		{
+			ForEachTileInRing(Origin, Radius, Func);
+		}
+	}
+
 	/** Get all tiles within desired range of given hex. Get if at least one tile was in range */
 	bool GetAllTilesWithinRange(const FHex& Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreOccupiedTiles = true) const;
 
 	/** Get all occupied tiles within desired range of given hex. Get if at least one tile was in range */
 	bool GetAllOccupiedTilesWithinRange(const FHex& Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreNullTiles = true, bool bIgnoreOrigin = true) const;
 
+	/** Get all tiles exactly distance away from given hex. Get if at least one tile was found */
+	bool GetAllTilesInRing(const FHex& Origin, int32 Distance, TArray<ATile*>& OutTiles, bool bIgnoreOccupiedTiles = true) const;
+
 public:
 
-	/** Map containing all tiles in the map */
+	/** Map containing all tiles in the map (only used with map storage layout) */
 	UPROPERTY()
 	TMap<FIntVector, ATile*> GridMap;
 
@@ -342,7 +882,31 @@ public:
 
 private:
 
+	/** How tiles of this grid are stored */
+	UPROPERTY()
+	EHexGridStorageLayout StorageLayout;
+
+	/** All tiles in the grid ordered by column then row (only used with dense storage layout) */
+	UPROPERTY()
+	TArray<ATile*> DenseTiles;
+
+	/** State of each cell, indexed the same way as DenseTiles regardless of storage
+	layout. This is not saved but is rebuilt from the tiles (see RefreshAllCellStates) */
+	TArray<FHexGridCellState> CellStates;
+
+	/** Memory reused between path finds, so searches do not need to allocate */
+	mutable FHexGridSearchScratch SearchScratch;
+
 	/** Dimensions of the grid */
 	UPROPERTY()
 	FIntPoint GridDimensions;
+};
+
+template<>
+struct TStructOpsTypeTraits<FHexGrid> : public TStructOpsTypeTraitsBase2<FHexGrid>
+{
+	enum
+	{
+		WithPostSerialize = true
+	};
 };
\ No newline at end of file
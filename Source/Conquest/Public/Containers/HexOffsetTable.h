@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** The max radius offsets are precomputed for. Rings beyond this radius are walked instead */
+#ifndef HEXGRID_OFFSET_TABLE_RADIUS
+#define HEXGRID_OFFSET_TABLE_RADIUS 10
+#endif
+
+/**
+ * Cube offsets of every hex within the max radius of an origin, generated at compile time. Offsets are ordered
+ * as a spiral, starting with the origin then each ring outwards. Every ring starts at direction 4 (see
+ * FHexGrid::DirectionTable) and walks around the origin in the same order as the direction table
+ */
+struct FHexOffsetTable
+{
+public:
+
+	static constexpr int32 MaxRadius = HEXGRID_OFFSET_TABLE_RADIUS;
+	static constexpr int32 Num = 1 + 3 * MaxRadius * (MaxRadius + 1);
+
+	static_assert(MaxRadius >= 0 && MaxRadius <= MAX_int8, "Hex offsets are stored as int8");
+
+public:
+
+	constexpr FHexOffsetTable()
+		: X()
+		, Y()
+	{
+		// Matches FHexGrid::DirectionTable
+		const int32 DirectionX[6] = { +1, +1, 0, -1, -1, 0 };
+		const int32 DirectionY[6] = { -1, 0, +1, +1, 0, -1 };
+
+		int32 Index = 1;
+		for (int32 Radius = 1; Radius <= MaxRadius; ++Radius)
+		{
+			int32 OffsetX = DirectionX[4] * Radius;
+			int32 OffsetY = DirectionY[4] * Radius;
+
+			for (int32 Side = 0; Side < 6; ++Side)
+			{
+				for (int32 Step = 0; Step < Radius; ++Step)
+				{
+					X[Index] = static_cast<int8>(OffsetX);
+					Y[Index] = static_cast<int8>(OffsetY);
+					++Index;
+
+					OffsetX += DirectionX[Side];
+					OffsetY += DirectionY[Side];
+				}
+			}
+		}
+	}
+
+	/** Get the index of the first offset of given ring */
+	FORCEINLINE static constexpr int32 RingStart(int32 Radius)
+	{
+		return Radius == 0 ? 0 : 1 + 3 * Radius * (Radius - 1);
+	}
+
+	/** Get the amount of offsets in given ring */
+	FORCEINLINE static constexpr int32 RingNum(int32 Radius)
+	{
+		return Radius == 0 ? 1 : 6 * Radius;
+	}
+
+public:
+
+	/** X and Y component of each offset. Z is always -X - Y */
+	int8 X[Num];
+	int8 Y[Num];
+};
+
+namespace HexOffsets
+{
+	/** Offsets of every hex within FHexOffsetTable::MaxRadius */
+	constexpr FHexOffsetTable Spiral;
+
+	static_assert(Spiral.X[0] == 0 && Spiral.Y[0] == 0, "Spiral should start at the origin");
+	static_assert(FHexOffsetTable::MaxRadius == 0 || (Spiral.X[FHexOffsetTable::RingStart(1)] == -1 && Spiral.Y[FHexOffsetTable::RingStart(1)] == 0), "Rings should start at direction 4");
+	static_assert(FHexOffsetTable::MaxRadius == 0 || (Spiral.X[FHexOffsetTable::Num - 1] == -FHexOffsetTable::MaxRadius && Spiral.Y[FHexOffsetTable::Num - 1] == 1), "Rings should end next to where they started");
+}
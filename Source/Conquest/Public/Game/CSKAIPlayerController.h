@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Conquest.h"
+#include "CSKPlayerController.h"
+#include "CSKMatchSearch.h"
+#include "CSKAIPlayerController.generated.h"
+
+class ACSKGameMode;
+
+/**
+ * Player controller for players controlled by the server. During its action phase, this controller captures the
+ * match into a simulator state and searches for its next action on background threads (see FCSKMatchSearch), requesting
+ * the action through the same server functions used by human players. Spell effects aren't simulated, so spells are
+ * cast at the closest valid non null tile to the opponents castle. Quick effect and bonus spell selections are always skipped
+ */
+UCLASS(config=Game, ClassGroup = (CSK))
+class CONQUEST_API ACSKAIPlayerController : public ACSKPlayerController
+{
+	GENERATED_BODY()
+
+public:
+
+	ACSKAIPlayerController();
+
+public:
+
+	// Begin AActor Interface
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaTime) override;
+	// End AActor Interface
+
+protected:
+
+	// Begin ACSKPlayerController Interface
+	virtual void Client_TransitionToCoinSequence_Implementation(ACoinSequenceActor* SequenceActor) override;
+	virtual void Client_TransitionToBoard_Implementation() override;
+	// End ACSKPlayerController Interface
+
+public:
+
+	/** Overrides settings using given options string. Accepts AITurnBudget, AIThreads and AIActionDelay */
+	void InitFromOptions(const FString& Options);
+
+private:
+
+	/** Notifies the server our transition has finished. Bots have nothing to transition */
+	void FinishTransitionSequence();
+
+	/** Skips any quick effect or bonus spell we have been asked to select */
+	void SkipPendingSelections();
+
+	/** Captures the current match into given state for searching. Get if state was captured */
+	bool CaptureMatchState(const ACSKGameMode* GameMode, FCSKSimMatchState& OutState) const;
+
+	/** Starts searching for our next action on a background thread */
+	void StartSearch(const ACSKGameMode* GameMode);
+
+	/** Requests to end our action phase. If the game mode rejects it, we stop searching until our next action phase */
+	void TryEndActionPhase();
+
+	/** Cancels the search in progress (if any) */
+	void CancelSearch();
+
+	/** Notify that the search with given ID has finished */
+	void OnSearchFinished(uint32 SearchID, const FCSKMatchSearchResult& SearchResult);
+
+	/** Requests given action from the game mode. Get if the game mode accepted the request */
+	bool PerformSearchAction(ACSKGameMode* GameMode, const FCSKSimAction& Action);
+
+	/** Get the tile to cast given spell card at, null if there is no valid target */
+	ATile* FindSpellTarget(TSubclassOf<USpellCard> SpellCard) const;
+
+protected:
+
+	/** The total time (in seconds) we can spend searching for actions during each action phase */
+	UPROPERTY(EditAnywhere, Config, Category = AI, meta = (ClampMin = 0.1))
+	float TurnTimeBudget;
+
+	/** The amount of search trees to grow in parallel. Each tree occupies a thread
+	of the search thread pool (see IConquestModule::GetSearchThreadPool) */
+	UPROPERTY(EditAnywhere, Config, Category = AI, meta = (ClampMin = 1))
+	int32 NumSearchThreads;
+
+	/** The max amount of iterations to run for each action. Zero for no limit */
+	UPROPERTY(EditAnywhere, Config, Category = AI, meta = (ClampMin = 0))
+	int32 MaxSearchIterations;
+
+	/** The max amount of rounds to play out past the action phase being searched */
+	UPROPERTY(EditAnywhere, Config, Category = AI, meta = (ClampMin = 1))
+	int32 MaxPlayOutRounds;
+
+	/** The max amount of tiles considered when building towers */
+	UPROPERTY(EditAnywhere, Config, Category = AI, meta = (ClampMin = 1))
+	int32 MaxBuildCandidates;
+
+	/** The time (in seconds) to wait before performing each action, so human players can follow along */
+	UPROPERTY(EditAnywhere, Config, Category = AI, meta = (ClampMin = 0))
+	float ActionDelay;
+
+private:
+
+	/** The rules and board we search with. These don't change during the match, so are only copied once */
+	FCSKSimRules SimRules;
+	FCSKSimBoard SimBoard;
+
+	/** If rules and board have been copied */
+	uint32 bSimInitialized : 1;
+
+	/** If we were performing our action phase last tick */
+	uint32 bWasActionPhase : 1;
+
+	/** If we have an action waiting to be performed */
+	uint32 bHasPendingAction : 1;
+
+	/** If the game mode rejected ending this action phase. We wait for it to time out instead */
+	uint32 bEndActionPhaseRejected : 1;
+
+	/** The state captured for the search in progress. Used to convert the action back to classes */
+	FCSKSimMatchState SearchState;
+
+	/** The action waiting to be performed */
+	FCSKSimAction PendingAction;
+
+	/** Time remaining before we can perform the pending action */
+	float PendingActionDelay;
+
+	/** Time remaining for searching during this action phase */
+	float RemainingTurnBudget;
+
+	/** Actions the game mode rejected this action phase, as a bit for each ECSKSimActionType */
+	uint8 BlockedActionTypes;
+
+	/** ID of the search in progress, zero if not searching */
+	uint32 ActiveSearchID;
+
+	/** ID to give the next search */
+	uint32 NextSearchID;
+
+	/** Flag shared with the search in progress to stop it early */
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> bAbortSearch;
+};
@@ -6,11 +6,13 @@
 #include "GameFramework/GameModeBase.h"
 #include "BoardPieceInterface.h"
 #include "BoardTypes.h"
+#include "CSKMatchRecord.h"
 #include "CSKGameMode.generated.h"
 
 class ACastle;
 class ACastleAIController;
 class ACoinSequenceActor;
+class ACSKAIPlayerController;
 class ACSKPlayerController;
 class ACSKPlayerState;
 class APlayerStart;
@@ -101,6 +103,93 @@ private:
 	uint8 bIsSet : 1;
 };
 
+/** A tower scheduled to run its end round action */
+USTRUCT()
+struct CONQUEST_API FEndRoundActionEntry
+{
+	GENERATED_BODY()
+
+public:
+
+	FEndRoundActionEntry()
+		: Tower(nullptr)
+		, SortKey(0)
+	{
+
+	}
+
+	FEndRoundActionEntry(ATower* InTower, uint64 InSortKey)
+		: Tower(InTower)
+		, SortKey(InSortKey)
+	{
+
+	}
+
+public:
+
+	/** The tower to run the action of */
+	UPROPERTY()
+	ATower* Tower;
+
+	/** Packed key this tower is ordered by (see FEndRoundActionSchedule::MakeSortKey) */
+	uint64 SortKey;
+};
+
+/** Every tower that could run an end round action, kept sorted by the order they execute in. Towers are
+added as they are built and removed once destroyed, so the order never needs to be rebuilt each round */
+USTRUCT()
+struct CONQUEST_API FEndRoundActionSchedule
+{
+	GENERATED_BODY()
+
+public:
+
+	FEndRoundActionSchedule()
+		: NextInsertionOrder(0)
+	{
+
+	}
+
+public:
+
+	/** Packs the sort key of a tower. Towers are ordered by priority (lowest first), then by towers owned by the
+	starting player and then by the order they were added in. Every tower is given a unique key */
+	static uint64 MakeSortKey(int32 Priority, bool bOwnedByStartingPlayer, uint32 InsertionOrder);
+
+	/** Adds tower to the schedule. Priority is read at the time the tower is added */
+	void Add(ATower* Tower, bool bOwnedByStartingPlayer);
+
+	/** Removes tower from the schedule. Get if tower was scheduled */
+	bool Remove(ATower* Tower);
+
+	/** Removes all towers from the schedule */
+	void Reset();
+
+	/** Get the index of the first entry whose key is equal to or greater than given key */
+	int32 LowerBound(uint64 SortKey) const;
+
+	/** Get the amount of towers scheduled */
+	FORCEINLINE int32 Num() const { return Entries.Num(); }
+
+	/** Get the entry at given index */
+	FORCEINLINE const FEndRoundActionEntry& operator [] (int32 Index) const { return Entries[Index]; }
+
+	/** Get all entries in execution order */
+	FORCEINLINE const TArray<FEndRoundActionEntry>& GetEntries() const { return Entries; }
+
+private:
+
+	/** Every scheduled tower, sorted by key */
+	UPROPERTY()
+	TArray<FEndRoundActionEntry> Entries;
+
+	/** Key of each scheduled tower, allowing removals to binary search for the entry */
+	TMap<ATower*, uint64> TowerKeys;
+
+	/** Insertion order to give the next tower added */
+	uint32 NextInsertionOrder;
+};
+
 /**
  * Manages and handles events present in CSK
  */
@@ -109,6 +198,8 @@ class CONQUEST_API ACSKGameMode : public AGameModeBase
 {
 	GENERATED_BODY()
 
+	friend struct FCSKSimRules;
+
 public:
 
 	ACSKGameMode();
@@ -126,6 +217,11 @@ public:
 	virtual bool HasMatchStarted() const override;	
 	// End AGameModeBase Interface
 
+	// Begin AActor Interface
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaTime) override;
+	// End AActor Interface
+
 protected:
 
 	// Begin UObject Interface
@@ -154,6 +250,9 @@ private:
 	/** Finds a player start with matching tag */
 	APlayerStart* FindPlayerStartWithTag(const FName& InTag) const;
 
+	/** Spawns AI players into any free player slots, up to the amount of AI players requested */
+	void SpawnAIPlayers();
+
 public:
 
 	/** Get player ones controller */
@@ -197,6 +296,14 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Classes)
 	TSubclassOf<ACastleAIController> CastleAIControllerClass;
 
+	/** The controller to spawn for AI players */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Classes, meta = (DisplayName = "AI Player Controller Class"))
+	TSubclassOf<ACSKAIPlayerController> AIPlayerControllerClass;
+
+	/** The amount of players controlled by the server. Can be set with the AIPlayers option */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Classes, meta = (ClampMin = 0, ClampMax = 2, DisplayName = "Num AI Players"))
+	int32 NumAIPlayers;
+
 public:
 
 	/** Enters the given match state if not set already */
@@ -490,6 +597,124 @@ public:
 	/** Will attempt to skip the bonus spell target selecting without casting the spell */
 	bool RequestSkipBonusSpell();
 
+public:
+
+	/** Starts replaying given match record. Seeds and coin toss are taken from the record and each request
+	is fed back in once the match is ready for it. This must be called before the match has started.
+	The match still only starts once both players have joined, so either two players need to connect
+	or free slots need to be filled with AI players (e.g. using ?listen?AIPlayers=1), which are still spawned
+	but stay idle while replaying. Requests made by the players themselves are rejected, as the replay acts on their behalf */
+	bool StartReplay(const FCSKMatchRecord& Record);
+
+	/** If we are currently replaying a recorded match */
+	FORCEINLINE bool IsReplayingMatch() const { return bIsReplayingMatch; }
+
+	/** If a replay was started and has since stopped, either by finishing or going out of sync */
+	FORCEINLINE bool HasReplayStopped() const { return bReplayStopped; }
+
+	/** If the last replay accepted every request and finished with the same state as the recorded match */
+	FORCEINLINE bool DidReplayMatchRecord() const { return bReplayMatchedRecord; }
+
+	/** Get the record of the current match. This is only filled if recording matches */
+	FORCEINLINE const FCSKMatchRecord& GetMatchRecord() const { return MatchRecord; }
+
+	/** Calculates a checksum of the state of the match. Used to detect replays going out of sync */
+	uint32 CalculateMatchChecksum() const;
+
+private:
+
+	/** Records a request that has been accepted. When replaying, this verifies the request matches the record instead */
+	void RecordRequest(ECSKRecordedRequestType Type, const ATile* Tile, UClass* Class = nullptr, 
+		int32 SpellIndex = 0, int32 AdditionalMana = 0, bool bTimedOut = false);
+
+	/** Feeds any recorded requests the match is ready to accept */
+	void TickReplay();
+
+	/** If the match is in a state that given recorded request can be made */
+	bool CanReplayRequest(const FCSKRecordedRequest& Request) const;
+
+	/** Makes given recorded request. The request is verified against the record once accepted */
+	void ReplayRequest(const FCSKRecordedRequest& Request);
+
+	/** Stops the active replay */
+	void StopReplay(bool bDesynced);
+
+	/** If requests should be rejected as they were not made by the replay */
+	FORCEINLINE bool IsRequestBlockedByReplay() const { return bIsReplayingMatch && !bIsFeedingReplayRequest; }
+
+	/** Saves the record of the current match to the record directory */
+	void SaveMatchRecord() const;
+
+	/** Get the delay to use for given delay. Delays are skipped when replaying */
+	FORCEINLINE float GetMatchDelay(float Delay) const { return bIsReplayingMatch ? 0.f : Delay; }
+
+	/** Sets timer to call callback after given delay (see GetMatchDelay) */
+	void SetMatchTimer(FTimerHandle& Handle, void (ACSKGameMode::*Callback)(), float Delay);
+
+protected:
+
+	/** If matches should be recorded and saved once finished. This can also be enabled using the RecordMatch option */
+	UPROPERTY(EditAnywhere, Category = Replay)
+	uint32 bRecordMatches : 1;
+
+	/** Time dilation to apply while replaying a match, this speeds up sequences run by towers and spells */
+	UPROPERTY(EditAnywhere, Category = Replay, meta = (ClampMin = 1))
+	float ReplayTimeDilation;
+
+private:
+
+	/** Record of the current match */
+	FCSKMatchRecord MatchRecord;
+
+	/** Record being replayed */
+	FCSKMatchRecord ReplayRecord;
+
+	/** Index of the next request to replay */
+	int32 ReplayRequestIndex;
+
+	/** Time the replay started (in real time) */
+	double ReplayStartTime;
+
+	/** If we are replaying a match */
+	uint32 bIsReplayingMatch : 1;
+
+	/** If the replay is currently making a request */
+	uint32 bIsFeedingReplayRequest : 1;
+
+	/** If the last replay has stopped */
+	uint32 bReplayStopped : 1;
+
+	/** If the last replay stopped without going out of sync */
+	uint32 bReplayMatchedRecord : 1;
+
+private:
+
+	/** Throttles or restores the servers tick rate based on if the match is currently idle */
+	void UpdateServerTickRate();
+
+	/** Get if the match is only waiting on timers or cosmetic sequences. Action phases need the full
+	tick rate to avoid delaying player requests, while the end round phase runs sequences on the server */
+	bool IsMatchIdle() const;
+
+protected:
+
+	/** If dedicated servers should tick less often while the match is idle. Listen servers
+	are never throttled as the host would be rendering at the same rate */
+	UPROPERTY(EditAnywhere, Config, Category = Server)
+	uint32 bThrottleIdleServer : 1;
+
+	/** The tick rate (for both the world and net driver) of dedicated servers while the match is idle */
+	UPROPERTY(EditAnywhere, Config, Category = Server, meta = (ClampMin = 1, EditCondition = "bThrottleIdleServer"))
+	int32 IdleServerTickRate;
+
+private:
+
+	/** The tick rate the net driver was using before being throttled */
+	int32 ActiveServerTickRate;
+
+	/** If the servers tick rate is currently throttled */
+	uint32 bServerTickThrottled : 1;
+
 public:
 	
 	/** DO NOT CALL THIS. Casts a sub spell for current activated spell. 
@@ -734,13 +959,22 @@ public:
 	/** Notify that tower running its end round phase event has finished */
 	void NotifyEndRoundActionFinished(ATower* Tower);
 
+	/** Notify that given player now owns given tower. This schedules the towers end round action */
+	void NotifyTowerAdded(const ACSKPlayerState* Owner, ATower* Tower);
+
+	/** Notify that given tower is no longer owned by a player. This removes the tower from the end round schedule */
+	void NotifyTowerRemoved(ATower* Tower);
+
+	/** Get the towers scheduled to run their end round action */
+	FORCEINLINE const FEndRoundActionSchedule& GetEndRoundActionSchedule() const { return EndRoundActionSchedule; }
+
 private:
 
-	/** Checks all towers determine order to execute end round actions. Get if any actions are ready to be performed */
+	/** Checks if any scheduled tower will run an action this round. Get if any actions are ready to be performed */
 	bool PrepareEndRoundActionTowers();
 
-	/** Attempts to start the action for end round tower at given index. Get if starting the next towers action was successfull */
-	bool StartRunningTowersEndRoundAction(int32 Index);
+	/** Attempts to start the action of the next scheduled tower. Get if starting the next towers action was successfull */
+	bool StartNextTowersEndRoundAction();
 
 	/** Sets delay of given time before attempting to start next tower action */
 	void StartNextEndRoundActionAfterDelay(float Delay);
@@ -750,13 +984,14 @@ private:
 
 private:
 
-	/** The list of towers that will run the end round action during this end
-	round phase. This array is sorted by order of action priority (see Tower.h).*/
+	/** Every tower that has been built, sorted by order of action priority (see Tower.h). This is
+	maintained as towers are added or removed from players rather than rebuilt each round */
 	UPROPERTY()
-	TArray<ATower*> EndRoundActionTowers;
+	FEndRoundActionSchedule EndRoundActionSchedule;
 
-	/** The index of the current tower running the end round action */
-	int32 EndRoundRunningTower;
+	/** Sort key the next tower to run its action must have at least. This
+	is used instead of an index as towers can be removed mid phase */
+	uint64 EndRoundNextSortKey;
 
 	/** If we are current initiating a towers action. This helps 
 	dealing with towers whose actions conclude immediately */
@@ -804,6 +1039,9 @@ public:
 	/** Get the towers available for use */
 	FORCEINLINE const TArray<TSubclassOf<UTowerConstructionData>>& GetAvailableTowers() const { return AvailableTowers; }
 
+	/** Get the spell cards available for use */
+	FORCEINLINE const TArray<TSubclassOf<USpellCard>>& GetAvailableSpellCards() const { return AvailableSpellCards; }
+
 protected:
 
 	#if WITH_EDITORONLY_DATA
@@ -956,12 +1194,17 @@ protected:
 	UFUNCTION()
 	void OnBoardPieceHealthChanged(UHealthComponent* HealthComp, int32 NewHealth, int32 Delta);
 
-	/** Clears both health report arrays */
+	/** Clears both the active and the game states latest health reports */
 	void ClearHealthReports();
 
-	/** Caches all the active action health reports then clearing it for a new action */
+	/** Hands the active action health reports over to the game state then clears them for a new action */
 	void CacheAndClearHealthReports();
 
+	/** Get the health change reports from the previous action. These are owned by the game state. This
+	replaces the previous action health reports property, so keeps its name for Blueprints */
+	UFUNCTION(BlueprintPure, Category = "CSK|Game", meta = (DisplayName = "Previous Action Health Reports"))
+	TArray<FHealthChangeReport> GetPreviousActionHealthReports() const;
+
 private:
 
 	/** Actually destroys the towers that were destroyed during the latest action */
@@ -974,10 +1217,6 @@ protected:
 	UPROPERTY(VisibleInstanceOnly, Transient, Category = "CSK|Game")
 	TArray<FHealthChangeReport> ActiveActionHealthReports;
 
-	/** The health change reports from the previous action */
-	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "CSK|Game")
-	TArray<FHealthChangeReport> PreviousActionHealthReports;
-
 private:
 
 	/** The towers that have been destroyed during the current action (action
@@ -3,7 +3,9 @@
 #pragma once
 
 #include "Conquest.h"
+#include "CSKTowerRegistry.h"
 #include "GameFramework/GameStateBase.h"
+#include "Engine/NetSerialization.h"
 #include "CSKGameState.generated.h"
 
 class ABoardManager;
@@ -38,6 +40,216 @@ enum class ECSKTimerState : uint8
 	None UMETA(Hidden="true")
 };
 
+struct FHealthReportArray;
+
+/** Replicated health report */
+USTRUCT()
+struct CONQUEST_API FHealthReportItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+public:
+
+	FHealthReportItem()
+	{
+
+	}
+
+	FHealthReportItem(const FHealthChangeReport& InReport)
+		: Report(InReport)
+	{
+
+	}
+
+public:
+
+	// Begin FFastArraySerializerItem Interface
+	void PreReplicatedRemove(const FHealthReportArray& InArraySerializer);
+	void PostReplicatedAdd(const FHealthReportArray& InArraySerializer);
+	void PostReplicatedChange(const FHealthReportArray& InArraySerializer);
+	// End FFastArraySerializerItem Interface
+
+public:
+
+	/** The report being replicated */
+	UPROPERTY()
+	FHealthChangeReport Report;
+};
+
+/** Read only view over health reports in a health report array. As reports are partitioned by owner and type,
+a view consists of at most two ranges of partitioned indices that reference the replicated items directly */
+struct CONQUEST_API FHealthReportView
+{
+public:
+
+	FHealthReportView()
+		: Items(nullptr)
+	{
+
+	}
+
+	FHealthReportView(const TArray<FHealthReportItem>& InItems, TArrayView<const int32> InFirst, TArrayView<const int32> InSecond)
+		: Items(&InItems)
+	{
+		Ranges[0] = InFirst;
+		Ranges[1] = InSecond;
+	}
+
+public:
+
+	/** Get the amount of reports in this view */
+	FORCEINLINE int32 Num() const { return Ranges[0].Num() + Ranges[1].Num(); }
+
+	/** If this view has no reports */
+	FORCEINLINE bool IsEmpty() const { return Num() == 0; }
+
+	/** Get the report at given index */
+	FORCEINLINE const FHealthChangeReport& operator [] (int32 Index) const
+	{
+		const int32 ItemIndex = Index < Ranges[0].Num() ? Ranges[0][Index] : Ranges[1][Index - Ranges[0].Num()];
+		return (*Items)[ItemIndex].Report;
+	}
+
+	/** Calls callback for every report in this view */
+	template <typename Func>
+	void ForEach(Func Callback) const
+	{
+		for (const TArrayView<const int32>& Range : Ranges)
+		{
+			for (int32 ItemIndex : Range)
+			{
+				Callback((*Items)[ItemIndex].Report);
+			}
+		}
+	}
+
+	/** Copies the reports in this view into a new array */
+	TArray<FHealthChangeReport> ToArray() const
+	{
+		TArray<FHealthChangeReport> Reports;
+		Reports.Reserve(Num());
+		ForEach([&Reports](const FHealthChangeReport& Report) { Reports.Add(Report); });
+
+		return Reports;
+	}
+
+private:
+
+	/** The items being viewed */
+	const TArray<FHealthReportItem>* Items;
+
+	/** The ranges of item indices in this view */
+	TArrayView<const int32> Ranges[2];
+};
+
+/** Health reports of an action, partitioned by type (damaged, killed then healed) and by the owner of the damaged
+board piece. Reports are only stored once in the replicated items, partitions being indices into the items, so queries
+are returned as views rather than being copied. Item slots are reused so only reports that differ from the last action are sent */
+USTRUCT()
+struct CONQUEST_API FHealthReportArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Each owner has a partition of every type. The last owner is for reports with no valid owner */
+	static constexpr int32 NumOwnerSlots = CSK_MAX_NUM_PLAYERS + 1;
+	static constexpr int32 NumTypes = 3;
+	static constexpr int32 NumPartitions = NumOwnerSlots * NumTypes;
+
+public:
+
+	FHealthReportArray()
+		: Version(0)
+		, bPartitionsDirty(false)
+	{
+		FMemory::Memzero(PartitionStarts);
+	}
+
+public:
+
+	/** Replaces the reports with given reports. This should only be called on the server */
+	void SetReports(TArray<FHealthChangeReport>&& InReports);
+
+	/** Removes all reports. This should only be called on the server */
+	void ClearReports();
+
+	/** Get reports matching given filters. Owner can be null to include reports from every owner.
+	Returns an empty view if owner does not have a valid player ID */
+	FHealthReportView Query(bool bDamaged, const ACSKPlayerState* InOwner, bool bExcludeDead) const;
+
+	/** Get every report, sorted by partition */
+	FORCEINLINE FHealthReportView GetAllReports() const
+	{
+		UpdatePartitions();
+		return FHealthReportView(Items, TArrayView<const int32>(PartitionedIndices), TArrayView<const int32>());
+	}
+
+	/** Marks partitions as needing to be rebuilt from replicated items */
+	FORCEINLINE void MarkPartitionsDirty() const
+	{
+		bPartitionsDirty = true;
+		++Version;
+	}
+
+	/** Get the version of the reports. This is incremented every time the reports change (including on clients) */
+	FORCEINLINE uint32 GetVersion() const { return Version; }
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FHealthReportItem, FHealthReportArray>(Items, DeltaParms, *this);
+	}
+
+private:
+
+	/** Partitions the indices of the replicated items, keeping the order of items within each partition */
+	void BuildPartitions() const;
+
+	/** Rebuilds partitions from the replicated items if required */
+	void UpdatePartitions() const;
+
+	/** Get the view over the indices of given partitions (inclusive) */
+	TArrayView<const int32> GetPartitionRange(int32 FirstPartition, int32 LastPartition) const;
+
+	/** Get the partition of given report */
+	static int32 GetPartition(const FHealthChangeReport& Report);
+
+	/** Get the owner slot of given player. Players without a valid ID use the last slot */
+	static int32 GetOwnerSlot(const ACSKPlayerState* InOwner);
+
+	/** Get the type partition of given report */
+	static int32 GetTypeIndex(const FHealthChangeReport& Report);
+
+public:
+
+	/** The reports to replicate. These are in partition order on the server, but not on clients */
+	UPROPERTY()
+	TArray<FHealthReportItem> Items;
+
+private:
+
+	/** Indices of items sorted by partition. Partitions are ordered by type then owner slot */
+	mutable TArray<int32> PartitionedIndices;
+
+	/** The index of the first item index of each partition. Last entry is the total amount of reports */
+	mutable int32 PartitionStarts[NumPartitions + 1];
+
+	/** Version of the reports, incremented whenever they change */
+	mutable uint32 Version;
+
+	/** If partitions needs to be rebuilt from items */
+	mutable uint8 bPartitionsDirty : 1;
+};
+
+template<>
+struct TStructOpsTypeTraits<FHealthReportArray> : public TStructOpsTypeTraitsBase2<FHealthReportArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true
+	};
+};
+
 /** Delegate for when the round state changes */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FCSKRoundStateChanged, ECSKRoundState, NewState);
 
@@ -58,6 +270,10 @@ public:
 
 protected:
 
+	// Begin AActor Interface
+	virtual void PostInitializeComponents() override;
+	// End AActor Interface
+
 	// Begin AGameStateBase Interface
 	virtual void OnRep_ReplicatedHasBegunPlay() override;
 	// End AGameStateBase Interface
@@ -239,8 +455,29 @@ public:
 	UFUNCTION(BlueprintPure, Category = Rules)
 	int32 GetTowerInstanceCount(TSubclassOf<ATower> Tower) const;
 
-	/** Updates the latest action health reports */
-	void SetLatestActionHealthReports(const TArray<FHealthChangeReport>& InHealthReports);
+	/** Get the counts of every tower active on the board */
+	FORCEINLINE const FCSKTowerRegistry& GetBoardTowerRegistry() const { return BoardTowerRegistry; }
+
+	/** Updates the latest action health reports, taking ownership of given reports */
+	void SetLatestActionHealthReports(TArray<FHealthChangeReport>&& InHealthReports);
+
+	/** Clears the latest action health reports */
+	void ClearLatestActionHealthReports();
+
+	/** Get a view of the health reports from the latest action matching given filters. Owner can be null to include
+	reports from every player. The view references the reports directly, so is invalidated once the reports change */
+	FORCEINLINE FHealthReportView QueryLatestHealthReports(bool bDamaged, const ACSKPlayerState* InOwner, bool bExcludeDead) const
+	{
+		return LatestActionHealthReports.Query(bDamaged, InOwner, bExcludeDead);
+	}
+
+	/** Get the version of the latest action health reports. This changes whenever the reports do */
+	FORCEINLINE uint32 GetLatestHealthReportsVersion() const { return LatestActionHealthReports.GetVersion(); }
+
+	/** Get all the health reports from the latest action. This replaces the latest
+	action health reports property, so keeps its name for Blueprints */
+	UFUNCTION(BlueprintPure, Category = "CSK|Game", meta = (DisplayName = "Latest Action Health Reports"))
+	TArray<FHealthChangeReport> GetLatestActionHealthReports() const;
 
 	/** Get all the towers that were damaged during the previous action */
 	UFUNCTION(BlueprintPure, Category = "CSK|Game")
@@ -286,9 +523,6 @@ private:
 	/** Executes the custom timer finished event only if bound */
 	void ExecuteCustomTimerFinishedEvent(bool bWasSkipped);
 
-	/** Generates a new array containing health reports filtered by passed in arguments */
-	TArray<FHealthChangeReport> QueryLatestHealthReports(bool bDamaged, ACSKPlayerState* InOwner, bool bExcludeDead) const;
-
 protected:
 
 	/** ID of the player who won the coin toss */
@@ -316,13 +550,12 @@ protected:
 	UPROPERTY(Transient)
 	uint32 bTimerPaused : 1;
 
-	/** Lookup table for how many instances of a certain tower exists on the board */
-	UPROPERTY(Transient)
-	TMap<TSubclassOf<ATower>, int32> TowerInstanceTable;
+	/** Counts of every tower that exists on the board */
+	FCSKTowerRegistry BoardTowerRegistry;
 
 	/** The health reports from the latest action */
-	UPROPERTY(BlueprintReadOnly, Transient, Replicated, Category = "CSK|Game")
-	TArray<FHealthChangeReport> LatestActionHealthReports;
+	UPROPERTY(Transient, Replicated)
+	FHealthReportArray LatestActionHealthReports;
 
 private:
 
@@ -437,6 +670,10 @@ public:
 	/** Get all towers that can be built this match */
 	FORCEINLINE const TArray<TSubclassOf<UTowerConstructionData>>& GetAvailableTowers() const { return AvailableTowers; }
 
+	/** Get which of the available towers given player can build. Each bit matches the tower at the same index of
+	available towers. This is cached per player and only re-evaluated once resources or towers owned have changed */
+	const TBitArray<>& GetBuildableTowers(const ACSKPlayerState* PlayerState) const;
+
 protected:
 
 	/** Updates the rules variables by cloning rules establish by game mode */
@@ -445,6 +682,54 @@ protected:
 
 	/** Helper function for checking if given player can build or destroy given tower */
 	bool CanPlayerBuildTower(const ACSKPlayerState* PlayerState, TSubclassOf<UTowerConstructionData> TowerTemplate) const;
+
+private:
+
+	/** Updates the hash of the rules that decide which towers can be built */
+	void UpdateTowerRulesHash();
+
+	/** Notify that rules that decide which towers can be built have been replicated */
+	UFUNCTION()
+	void OnRep_TowerRules();
+
+private:
+
+	/** Towers a player could build along with the state they were evaluated with */
+	struct FBuildableTowersCache
+	{
+	public:
+
+		FBuildableTowersCache()
+			: Gold(-1)
+			, Mana(-1)
+			, OwnedTowersVersion(0)
+			, BoardTowersVersion(0)
+			, RulesHash(0)
+		{
+
+		}
+
+	public:
+
+		/** Bit for each available tower */
+		TBitArray<> Towers;
+
+		/** State towers were evaluated with */
+		int32 Gold;
+		int32 Mana;
+		uint32 OwnedTowersVersion;
+		uint32 BoardTowersVersion;
+		uint32 RulesHash;
+	};
+
+	/** Cached buildable towers for each player */
+	mutable FBuildableTowersCache BuildableTowersCache[CSK_MAX_NUM_PLAYERS];
+
+	/** Hash of the rules that decide which towers can be built. Updated whenever the rules change */
+	uint32 TowerRulesHash;
+
+	/** Returned when a player has no cache */
+	static const TBitArray<> EmptyBuildableTowers;
 	
 protected:
 
@@ -461,19 +746,19 @@ protected:
 	int32 MaxTileMovements;
 
 	/** The max number of NORMAL towers players are allowed to build */
-	UPROPERTY(BlueprintReadOnly, Transient, Replicated, Category = Rules)
+	UPROPERTY(BlueprintReadOnly, Transient, ReplicatedUsing = OnRep_TowerRules, Category = Rules)
 	int32 MaxNumTowers;
 
 	/** The max number of duplicated NORMAL towers a player can have built at once */
-	UPROPERTY(BlueprintReadOnly, Transient, Replicated, Category = Rules)
+	UPROPERTY(BlueprintReadOnly, Transient, ReplicatedUsing = OnRep_TowerRules, Category = Rules)
 	int32 MaxNumDuplicatedTowers;
 
 	/** The max amount of duplicated types of all NORMAL towers player can have built at once */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated, Category = Rules)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_TowerRules, Category = Rules)
 	int32 MaxNumDuplicatedTowerTypes;
 
 	/** The max number of LEGENDARY towers a player can have built at once */
-	UPROPERTY(BlueprintReadOnly, Transient, Replicated, Category = Rules)
+	UPROPERTY(BlueprintReadOnly, Transient, ReplicatedUsing = OnRep_TowerRules, Category = Rules)
 	int32 MaxNumLegendaryTowers;
 
 	/** The max range from the players castle they can build from */
@@ -482,7 +767,7 @@ protected:
 
 	/** The towers supported for this match */
 	// TODO: See CSKGameMode.h (ln 412) for a TODO
-	UPROPERTY(BlueprintReadOnly, Transient, Replicated, Category = Rules)
+	UPROPERTY(BlueprintReadOnly, Transient, ReplicatedUsing = OnRep_TowerRules, Category = Rules)
 	TArray<TSubclassOf<UTowerConstructionData>> AvailableTowers;
 
 public:
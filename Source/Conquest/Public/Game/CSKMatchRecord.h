@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Conquest.h"
+
+/** The type of request that was recorded */
+enum class ECSKRecordedRequestType : uint8
+{
+	EndActionPhase,
+	CastleMove,
+	BuildTower,
+	CastSpell,
+	CastQuickEffect,
+	SkipQuickEffect,
+	CastBonusSpell,
+	SkipBonusSpell
+};
+
+/** A request that was accepted by the game mode during a match */
+struct CONQUEST_API FCSKRecordedRequest
+{
+public:
+
+	FCSKRecordedRequest()
+		: Type(ECSKRecordedRequestType::EndActionPhase)
+		, PlayerID(-1)
+		, bTimedOut(false)
+		, Round(0)
+		, TileIndex(INDEX_NONE)
+		, ClassIndex(INDEX_NONE)
+		, SpellIndex(0)
+		, AdditionalMana(0)
+		, Checksum(0)
+	{
+
+	}
+
+public:
+
+	friend FArchive& operator << (FArchive& Ar, FCSKRecordedRequest& Request);
+
+public:
+
+	/** The type of request */
+	ECSKRecordedRequestType Type;
+
+	/** The player who made the request */
+	int8 PlayerID;
+
+	/** If this request was made by a timer running out rather than the player */
+	bool bTimedOut;
+
+	/** The round this request was made in */
+	int32 Round;
+
+	/** Dense index of the tile targeted by this request */
+	int32 TileIndex;
+
+	/** Index of the tower template or spell card used in the records class table */
+	int32 ClassIndex;
+
+	/** The spell of the spell card to cast */
+	int32 SpellIndex;
+
+	/** The additional mana provided to the spell */
+	int32 AdditionalMana;
+
+	/** Checksum of the match state straight after this request was accepted */
+	uint32 Checksum;
+};
+
+/**
+ * Compact log of a match. Stores the seeds the match used and every request the game
+ * mode accepted, which is enough to re-simulate the match (see ACSKGameMode::StartReplay)
+ */
+struct CONQUEST_API FCSKMatchRecord
+{
+public:
+
+	/** Magic value written at the start of every record file */
+	static const uint32 FileMagic;
+
+	/** The current version of the record format */
+	static const int32 FileVersion;
+
+public:
+
+	FCSKMatchRecord();
+
+	/** Resets this record for a new match on given map */
+	void Reset(const FString& InMapName);
+
+	/** Get the index of given class in the class table, adding it if required */
+	int32 FindOrAddClass(UClass* Class);
+
+	/** Get the class at given index of the class table, loading it if required */
+	UClass* GetClass(int32 Index) const;
+
+	/** Saves this record to given file. Get if successful */
+	bool SaveToFile(const FString& Filename) const;
+
+	/** Loads a record from given file. Get if successful */
+	bool LoadFromFile(const FString& Filename);
+
+	/** Get the directory records are saved to by default */
+	static FString GetRecordDirectory();
+
+public:
+
+	friend FArchive& operator << (FArchive& Ar, FCSKMatchRecord& Record);
+
+public:
+
+	/** The map the match was played on */
+	FString MapName;
+
+	/** ID of the player who won the coin toss */
+	int32 StartingPlayerID;
+
+	/** Seed used for shuffling players spell decks */
+	int32 DeckReshuffleSeed;
+
+	/** Every tower template and spell card used by requests */
+	TArray<FSoftClassPath> Classes;
+
+	/** Every accepted request, in the order they were accepted */
+	TArray<FCSKRecordedRequest> Requests;
+
+	/** Checksum of the match state once the match finished */
+	uint32 FinalChecksum;
+};
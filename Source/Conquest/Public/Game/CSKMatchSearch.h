@@ -0,0 +1,190 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Conquest.h"
+#include "CSKMatchSimulator.h"
+#include "Async/AsyncWork.h"
+#include "HAL/ThreadSafeBool.h"
+
+class FQueuedThreadPool;
+
+/** Settings used when searching for an action */
+struct CONQUEST_API FCSKMatchSearchSettings
+{
+public:
+
+	FCSKMatchSearchSettings();
+
+public:
+
+	/** The time (in seconds) the search is allowed to run for */
+	float TimeBudget;
+
+	/** The max amount of iterations to run across all threads. Zero for no limit */
+	int32 MaxIterations;
+
+	/** The amount of trees to search in parallel, including the one grown on the searching thread */
+	int32 NumThreads;
+
+	/** The max amount of rounds to play out after the action phase before the match is evaluated */
+	int32 MaxPlayOutRounds;
+
+	/** The max amount of cells considered when building towers (see FCSKMatchSimulator::GetAvailableActions) */
+	int32 MaxBuildCells;
+
+	/** How much to favour exploring actions that have been visited less often */
+	float ExplorationConstant;
+
+	/** Actions the search won't consider, as a bit for each ECSKSimActionType. Ending the action phase is always considered */
+	uint8 ExcludedActionTypes;
+};
+
+/** Runs part of a search on a thread pool. Searches use their own pool (see IConquestModule::GetSearchThreadPool),
+as they keep their threads busy for the entire time budget, which would otherwise starve the engines own tasks */
+class CONQUEST_API FCSKMatchSearchTask : public FNonAbandonableTask
+{
+public:
+
+	FCSKMatchSearchTask(TFunction<void()>&& InWork)
+		: Work(MoveTemp(InWork))
+	{
+
+	}
+
+	void DoWork()
+	{
+		Work();
+	}
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FCSKMatchSearchTask, STATGROUP_ThreadPoolAsyncTasks);
+	}
+
+private:
+
+	/** The work to run */
+	TFunction<void()> Work;
+};
+
+/** The result of searching for an action */
+struct CONQUEST_API FCSKMatchSearchResult
+{
+public:
+
+	FCSKMatchSearchResult()
+		: bIsValid(false)
+		, NumIterations(0)
+		, NumVisits(0)
+		, ExpectedValue(0.f)
+		, ElapsedTime(0.0)
+	{
+
+	}
+
+public:
+
+	/** The action to perform */
+	FCSKSimAction Action;
+
+	/** If an action was found */
+	bool bIsValid;
+
+	/** Total iterations ran across every tree */
+	int32 NumIterations;
+
+	/** Amount of times the action was visited across every tree */
+	int32 NumVisits;
+
+	/** The average value of the action, from zero (always lost) to one (always won) */
+	float ExpectedValue;
+
+	/** The time (in seconds) the search took */
+	double ElapsedTime;
+};
+
+/**
+ * Searches for the best action of the player performing their action phase, using Monte Carlo tree search over
+ * the match simulator. The tree branches over the actions of the current action phase, with the rest of the match
+ * being played out by the simulator. Each thread grows its own tree from the same root, sharing nothing, with the
+ * visits of the root actions being merged once every tree has finished. Trees that never got a thread in time are
+ * skipped, so the search never waits on work that hasn't started. Cards yet to be drawn and the opponents
+ * hand are hidden from players, so each tree shuffles them before searching
+ */
+class CONQUEST_API FCSKMatchSearch
+{
+public:
+
+	FCSKMatchSearch(const FCSKSimRules& InRules, const FCSKSimBoard& InBoard, const FCSKMatchSearchSettings& InSettings);
+
+public:
+
+	/** Searches for the best action from given state, which must be during an action phase in progress. This blocks
+	until the time budget or iterations have been spent. Search will stop early if abort is set from another thread.
+	Additional trees are grown on given thread pool, only a single tree is grown on the calling thread without one */
+	FCSKMatchSearchResult Search(const FCSKSimMatchState& RootState, int32 Seed, const FThreadSafeBool* bAbort = nullptr,
+		FQueuedThreadPool* ThreadPool = nullptr) const;
+
+	/** Get how favourable the match of given simulator is for given player, from zero (lost) to one (won). Matches
+	that were cut short are evaluated by how much closer each player is to their opponents portal */
+	static float EvaluateMatch(const FCSKMatchSimulator& Simulator, int32 PlayerID);
+
+private:
+
+	/** A node of a search tree, representing the state after performing its action */
+	struct FNode
+	{
+	public:
+
+		FNode(const FCSKSimAction& InAction)
+			: Action(InAction)
+			, FirstChild(INDEX_NONE)
+			, NumChildren(0)
+			, NumVisits(0)
+			, TotalValue(0.f)
+			, bIsTerminal(false)
+		{
+
+		}
+
+	public:
+
+		/** The action performed to reach this node */
+		FCSKSimAction Action;
+
+		/** Children are added together, so are stored next to each other */
+		int32 FirstChild;
+		int32 NumChildren;
+
+		int32 NumVisits;
+		float TotalValue;
+
+		/** If this node ends the action phase (or match), no more actions can be performed from here */
+		bool bIsTerminal;
+	};
+
+	/** Grows a single tree until end time or max iterations have been reached. Get the amount of iterations ran */
+	int32 GrowTree(const FCSKSimMatchState& RootState, int32 Seed, double EndTime, int32 MaxIterations,
+		const FThreadSafeBool* bAbort, TArray<FNode>& OutNodes) const;
+
+	/** Gets the actions the search considers from the current state of given simulator */
+	void GetSearchActions(FCSKMatchSimulator& Simulator, TArray<FCSKSimAction>& OutActions) const;
+
+	/** Get the child of given node to visit next */
+	int32 SelectChild(const TArray<FNode>& Nodes, int32 NodeIndex) const;
+
+	/** Shuffles every card hidden from given player (see class description) */
+	static void ShuffleHiddenCards(FCSKSimMatchState& State, int32 PlayerID, FRandomStream& Stream);
+
+private:
+
+	/** The rules matches are simulated with */
+	FCSKSimRules Rules;
+
+	/** The board matches are simulated on */
+	FCSKSimBoard Board;
+
+	/** Settings to search with */
+	FCSKMatchSearchSettings Settings;
+};
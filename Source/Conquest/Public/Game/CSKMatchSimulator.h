@@ -0,0 +1,411 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Conquest.h"
+#include "HexGrid.h"
+
+class ABoardManager;
+class ACSKGameMode;
+
+/** Data about a tower the simulator is able to build */
+struct CONQUEST_API FCSKSimTowerData
+{
+public:
+
+	FCSKSimTowerData()
+		: GoldCost(0)
+		, ManaCost(0)
+		, CollectionGold(0)
+		, CollectionMana(0)
+		, bIsLegendary(false)
+		, SourceIndex(INDEX_NONE)
+	{
+
+	}
+
+public:
+
+	/** The gold required to build this tower */
+	int32 GoldCost;
+
+	/** The mana required to build this tower */
+	int32 ManaCost;
+
+	/** Additional gold given during the collection phase. Towers calculate this in
+	blueprints, so this is only set when running balance sweeps over custom values */
+	int32 CollectionGold;
+
+	/** Additional mana given during the collection phase (see CollectionGold) */
+	int32 CollectionMana;
+
+	/** If this tower is legendary */
+	bool bIsLegendary;
+
+	/** Index of the template this tower was copied from in the game modes available towers */
+	int32 SourceIndex;
+};
+
+/** The rules of a simulated match. Mirrors the rules set on the game mode */
+struct CONQUEST_API FCSKSimRules
+{
+public:
+
+	FCSKSimRules();
+
+	/** Copies the rules, towers and spell costs from given game mode */
+	void CopyFromGameMode(const ACSKGameMode* GameMode);
+
+public:
+
+	int32 StartingGold;
+	int32 StartingMana;
+	int32 CollectionPhaseGold;
+	int32 CollectionPhaseMana;
+	int32 MaxGold;
+	int32 MaxMana;
+
+	int32 MaxNumTowers;
+	int32 MaxNumDuplicatedTowers;
+	int32 MaxNumDuplicatedTowerTypes;
+	int32 MaxNumLegendaryTowers;
+	int32 MaxBuildRange;
+
+	int32 MinTileMovements;
+	int32 MaxTileMovements;
+
+	int32 MaxSpellUses;
+	int32 MaxSpellCardsInHand;
+
+	/** The max amount of rounds before a match is considered a draw */
+	int32 MaxRounds;
+
+	/** Towers available to build */
+	TArray<FCSKSimTowerData> Towers;
+
+	/** The static cost of the first spell of each available spell card */
+	TArray<int32> SpellCosts;
+
+	/** Index of the spell card each spell cost was copied from in the game modes available spell cards */
+	TArray<int32> SpellCardIndices;
+};
+
+/** The board a simulated match is played on */
+struct CONQUEST_API FCSKSimBoard
+{
+public:
+
+	FCSKSimBoard();
+
+	/** Copies the cell states and portals from given board manager. Get if board is playable */
+	bool InitFromBoardManager(const ABoardManager* BoardManager);
+
+	/** Initializes an empty board of given size, with portals placed in the middle of the first and last columns */
+	void InitEmpty(const FIntPoint& InDimensions);
+
+	/** If this board can be used for simulating matches */
+	bool IsValid() const;
+
+public:
+
+	/** The dimensions of the grid */
+	FIntPoint Dimensions;
+
+	/** The state of every cell, indexed using FHexGrid::HexToCellIndex */
+	TArray<FHexGridCellState> Cells;
+
+	/** Each players portal. Players castles start on their own portal */
+	FHexGrid::FHex PortalHexes[CSK_MAX_NUM_PLAYERS];
+};
+
+/** How a simulated player decides on their actions */
+enum class ECSKSimPolicy : uint8
+{
+	/** Makes random moves, builds and casts */
+	Random,
+
+	/** Heads straight for the opponents portal, spending resources whenever possible */
+	Greedy
+};
+
+/** The state of a player during a simulated match */
+struct CONQUEST_API FCSKSimPlayerState
+{
+public:
+
+	FCSKSimPlayerState();
+
+public:
+
+	int32 Gold;
+	int32 Mana;
+	FHexGrid::FHex CastleHex;
+
+	int32 TilesTraversedThisRound;
+	int32 SpellsCastThisRound;
+
+	int32 NumNormalTowers;
+	int32 NumLegendaryTowers;
+
+	/** Amount of each tower owned, indexed by the rules tower index */
+	TArray<int32> TowerCounts;
+
+	/** Spells are tracked using indices into the rules spell costs */
+	TArray<int32> SpellDeck;
+	TArray<int32> SpellsInHand;
+
+	/** How this player decides on actions the simulator makes for them */
+	ECSKSimPolicy Policy;
+};
+
+/** The state of a simulated match. This can be captured from a match in progress to continue simulating it from that point */
+struct CONQUEST_API FCSKSimMatchState
+{
+public:
+
+	FCSKSimMatchState();
+
+public:
+
+	/** The state of every cell, indexed using FHexGrid::HexToCellIndex */
+	TArray<FHexGridCellState> Cells;
+
+	/** The state of each player */
+	FCSKSimPlayerState Players[CSK_MAX_NUM_PLAYERS];
+
+	/** Instances of each tower across both players (only used for legendary towers) */
+	TArray<int32> TowerInstanceCounts;
+
+	/** The current round state */
+	ECSKRoundState RoundState;
+
+	/** The player who performs their action phase first */
+	int32 StartingPlayerID;
+
+	/** The amount of rounds that have started */
+	int32 NumRounds;
+
+	/** If the player of the current action phase has yet to finish it. Action phases entered by
+	the simulator are played out immediately, so this is only set for captured matches */
+	bool bActionPhaseInProgress;
+};
+
+/** The type of action a player can perform during their action phase */
+enum class ECSKSimActionType : uint8
+{
+	EndActionPhase,
+	MoveCastle,
+	BuildTower,
+	CastSpell
+};
+
+/** An action performed during an action phase */
+struct CONQUEST_API FCSKSimAction
+{
+public:
+
+	FCSKSimAction()
+		: Type(ECSKSimActionType::EndActionPhase)
+		, CellIndex(INDEX_NONE)
+		, Index(INDEX_NONE)
+	{
+
+	}
+
+	FCSKSimAction(ECSKSimActionType InType, int32 InCellIndex, int32 InIndex)
+		: Type(InType)
+		, CellIndex(InCellIndex)
+		, Index(InIndex)
+	{
+
+	}
+
+	FORCEINLINE bool operator == (const FCSKSimAction& Other) const
+	{
+		return Type == Other.Type && CellIndex == Other.CellIndex && Index == Other.Index;
+	}
+
+public:
+
+	/** The type of action */
+	ECSKSimActionType Type;
+
+	/** The cell to move the castle to or build the tower on */
+	int32 CellIndex;
+
+	/** The tower (rules index) to build, the spell (hand index) to cast or the amount of tiles to move */
+	int32 Index;
+};
+
+/** The result of a simulated match */
+struct CONQUEST_API FCSKSimMatchResult
+{
+public:
+
+	FCSKSimMatchResult()
+		: Winner(-1)
+		, WinCondition(ECSKMatchWinCondition::Unknown)
+		, NumRounds(0)
+		, TilesTraversed(0)
+		, TowersBuilt(0)
+		, SpellsCast(0)
+	{
+
+	}
+
+public:
+
+	/** The ID of the player who won, -1 if the match was a draw */
+	int32 Winner;
+
+	/** How the winner won the match */
+	ECSKMatchWinCondition WinCondition;
+
+	/** The amount of rounds played */
+	int32 NumRounds;
+
+	/** Total stats over both players */
+	int32 TilesTraversed;
+	int32 TowersBuilt;
+	int32 SpellsCast;
+};
+
+/**
+ * Plays matches using only the rules of the game mode. There are no actors, timers or sequences involved,
+ * with each round state being entered instantly. Tower actions and spell effects are not simulated,
+ * only the resources they cost. Simulators can be reused for playing any amount of matches. Matches
+ * can also be continued from a captured state, with actions being performed one at a time
+ */
+class CONQUEST_API FCSKMatchSimulator
+{
+public:
+
+	FCSKMatchSimulator(const FCSKSimRules& InRules, const FCSKSimBoard& InBoard);
+
+public:
+
+	/** Plays an entire match using given seed. The same seed will always play out the same match */
+	FCSKSimMatchResult PlayMatch(int32 Seed, ECSKSimPolicy Player1Policy, ECSKSimPolicy Player2Policy);
+
+	/** Continues the match from given state. Seed is used for every random decision made from this point */
+	void SetMatchState(const FCSKSimMatchState& InState, int32 Seed);
+
+	/** Gets every action the player performing their action phase can perform. Towers could be built on many cells,
+	so only the given amount of buildable cells closest to the opponents castle are considered */
+	void GetAvailableActions(TArray<FCSKSimAction>& OutActions, int32 MaxBuildCells);
+
+	/** Performs given action for the player performing their action phase. Get if action was performed */
+	bool PerformAction(const FCSKSimAction& Action);
+
+	/** Plays out the rest of the match, finishing any action phase in progress using the players policy. Stops
+	early once given amount of rounds have been played. Get if the match finished within the round limit */
+	bool PlayOut(int32 MaxRoundsToPlay);
+
+	/** Get the ID of the player whose action phase it is, -1 if not in an action phase */
+	int32 GetActionPhasePlayer() const;
+
+public:
+
+	/** Get the rules we are playing with */
+	FORCEINLINE const FCSKSimRules& GetRules() const { return Rules; }
+
+	/** Get the board matches are played on */
+	FORCEINLINE const FCSKSimBoard& GetBoard() const { return Board; }
+
+	/** Get the state of the current match */
+	FORCEINLINE const FCSKSimMatchState& GetMatchState() const { return State; }
+
+	/** Get the result of the current match */
+	FORCEINLINE const FCSKSimMatchResult& GetResult() const { return Result; }
+
+	/** Get if the current match has finished (or reached the round limit of a play out) */
+	FORCEINLINE bool HasMatchFinished() const { return bMatchFinished; }
+
+private:
+
+	/** Resets the board and players for a new match */
+	void ResetMatch(int32 Seed, ECSKSimPolicy Player1Policy, ECSKSimPolicy Player2Policy);
+
+	/** Enters given round state, handling it immediately */
+	void EnterRoundState(ECSKRoundState NewState);
+
+	/** Resets the resources of given player to the starting amounts */
+	void ResetPlayerResources(int32 PlayerID);
+
+	/** Gives given player their resources for the collection phase */
+	void UpdatePlayerResources(int32 PlayerID);
+
+	/** Performs the action phase of given player. Continuing keeps the actions already performed this phase */
+	void RunActionPhase(int32 PlayerID, bool bContinue = false);
+
+	/** Moves the castle of given player based on their policy. Get if castle moved */
+	bool MoveCastle(int32 PlayerID);
+
+	/** Moves the castle of given player as far along the path to goal as their remaining moves allow. Get if castle moved */
+	bool MoveCastleTowards(int32 PlayerID, const FHexGrid::FHex& Goal);
+
+	/** Builds a tower for given player based on their policy. Get if tower was built */
+	bool BuildTower(int32 PlayerID);
+
+	/** Builds tower at index on given cell for given player. Get if tower was built */
+	bool BuildTowerAt(int32 PlayerID, int32 TowerIndex, int32 CellIndex);
+
+	/** Casts a spell in hand for given player based on their policy. Get if spell was cast */
+	bool CastSpell(int32 PlayerID);
+
+	/** Casts the spell at hand index for given player. Get if spell was cast */
+	bool CastSpellInHand(int32 PlayerID, int32 HandIndex);
+
+	/** Get if given player is allowed to build tower at index */
+	bool CanPlayerBuildTower(const FCSKSimPlayerState& Player, int32 TowerIndex) const;
+
+	/** Get if given player is allowed to build a tower on given cell */
+	bool CanPlayerBuildOnCell(const FCSKSimPlayerState& Player, int32 CellIndex) const;
+
+	/** Get if given player is allowed to cast the spell at hand index */
+	bool CanPlayerCastSpell(const FCSKSimPlayerState& Player, int32 HandIndex) const;
+
+	/** Get the amount of tiles given player can still move this round */
+	int32 GetPlayersNumRemainingMoves(const FCSKSimPlayerState& Player) const;
+
+	/** Shuffles every available spell into the players deck */
+	void ResetSpellDeck(FCSKSimPlayerState& Player);
+
+	/** Checks if given player has reached their opponents portal, ending the match if so */
+	bool CheckPortalReached(int32 PlayerID);
+
+	/** Get the opponent of given player */
+	FORCEINLINE static int32 GetOpponent(int32 PlayerID) { return PlayerID == 0 ? 1 : 0; }
+
+	/** Get the round state that follows given state */
+	static ECSKRoundState GetNextRoundState(ECSKRoundState RoundState);
+
+private:
+
+	/** The rules we are playing with */
+	FCSKSimRules Rules;
+
+	/** The board we reset to at the start of each match */
+	FCSKSimBoard Board;
+
+	/** The state of the current match */
+	FCSKSimMatchState State;
+
+	/** Stream used for all random decisions of the current match */
+	FRandomStream Stream;
+
+	/** Result of the current match */
+	FCSKSimMatchResult Result;
+
+	/** The round the current match (or play out) stops at */
+	int32 RoundLimit;
+
+	/** If the current match has finished */
+	bool bMatchFinished;
+
+	/** Memory reused for path finding and candidate collecting */
+	FHexGridSearchScratch SearchScratch;
+	TArray<FHexGrid::FHex> PathScratch;
+	TArray<int32> CandidateScratch;
+	TArray<int32> DistanceScratch;
+};
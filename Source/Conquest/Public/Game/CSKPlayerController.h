@@ -5,11 +5,14 @@
 #include "Conquest.h"
 #include "GameFramework/PlayerController.h"
 #include "BoardTypes.h"
+#include "Containers/BoardTileMask.h"
 #include "CSKPlayerController.generated.h"
 
+class ABoardManager;
 class ACastle;
 class ACastleAIController;
 class ACoinSequenceActor;
+class ACSKGameState;
 class ACSKHUD;
 class ACSKPawn;
 class ACSKPlayerCameraManager;
@@ -201,11 +204,22 @@ protected:
 	UPROPERTY()
 	ACSKHUD* CachedCSKHUD;
 
+public:
+
+	/** Get the handle for given tile. Handles should be used in place of tiles when sending RPCs */
+	FBoardTileHandle GetTileHandle(const ATile* Tile) const;
+
+	/** Get the tile referred to by a handle received from an RPC (can return null) */
+	ATile* GetTileFromHandle(const FBoardTileHandle& Handle) const;
+
+	/** If given handle received from an RPC is within the bounds of the board. Used to validate RPCs */
+	bool IsValidTileHandle(const FBoardTileHandle& Handle) const;
+
 private:
 
 	/** Executes the on select tile event on the server */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void Server_ExecuteCustomOnSelectTile(ATile* SelectedTile);
+	void Server_ExecuteCustomOnSelectTile(FBoardTileHandle SelectedTile);
 
 public:
 
@@ -294,7 +308,7 @@ public:
 	UFUNCTION(Client, Reliable)
 	void Client_OnMatchFinished(bool bIsWinner);
 
-private:
+protected:
 
 	/** Informs the server that we have either finished
 	transitioning to the coin sequence or back to the board */
@@ -455,7 +469,7 @@ public:
 
 	/** Notify that an action phase build request has been confirmed */
 	UFUNCTION(Client, Reliable)
-	void Client_OnTowerBuildRequestConfirmed(ATile* TargetTile);
+	void Client_OnTowerBuildRequestConfirmed(FBoardTileHandle TargetTile);
 
 	/** Notify that an action phase build request has finished */
 	UFUNCTION(Client, Reliable)
@@ -463,7 +477,7 @@ public:
 
 	/** Notify that a spell cast has been confirmed */
 	UFUNCTION(Client, Reliable)
-	void Client_OnCastSpellRequestConfirmed(EActiveSpellContext SpellContext, ATile* TargetTile);
+	void Client_OnCastSpellRequestConfirmed(EActiveSpellContext SpellContext, FBoardTileHandle TargetTile);
 
 	/** Notify that a spell cast has finished */
 	UFUNCTION(Client, Reliable)
@@ -472,7 +486,7 @@ public:
 	/** Notify that this player is able to counter an incoming spell cast
 	(and if the spell is selection is a nullify or post action counter )*/
 	UFUNCTION(Client, Reliable)
-	void Client_OnSelectCounterSpell(bool bNullify, TSubclassOf<USpell> SpellToCounter, ATile* TargetTile);
+	void Client_OnSelectCounterSpell(bool bNullify, TSubclassOf<USpell> SpellToCounter, FBoardTileHandle TargetTile);
 
 	/** Notify that this players spell request is pending as the opposing player is selecting a counter */
 	UFUNCTION(Client, Reliable)
@@ -492,7 +506,7 @@ public:
 
 	/** Notify that the tower on given tile is starting is end round action */
 	UFUNCTION(Client, Reliable)
-	void Client_OnTowerActionStart(ATile* TileWithTower);
+	void Client_OnTowerActionStart(FBoardTileHandle TileWithTower);
 
 public:
 
@@ -541,19 +555,19 @@ protected:
 
 	/** Makes a request to move our castle towards the goal tile */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void Server_RequestCastleMoveAction(ATile* Goal);
+	void Server_RequestCastleMoveAction(FBoardTileHandle Goal);
 
 	/** Makes a request to build a tower at given tile */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void Server_RequestBuildTowerAction(TSubclassOf<UTowerConstructionData> TowerConstructData, ATile* Target);
+	void Server_RequestBuildTowerAction(TSubclassOf<UTowerConstructionData> TowerConstructData, FBoardTileHandle Target);
 
 	/** Makes a request to cast a spell at given tile (with additional mana cost) */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void Server_RequestCastSpellAction(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, ATile* Target, int32 AdditionalMana);
+	void Server_RequestCastSpellAction(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, FBoardTileHandle Target, int32 AdditionalMana);
 
 	/** Makes a request to cast a counter spell at given tile */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void Server_RequestCastQuickEffectAction(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, ATile* Target, int32 AdditionalMana);
+	void Server_RequestCastQuickEffectAction(TSubclassOf<USpellCard> SpellCard, int32 SpellIndex, FBoardTileHandle Target, int32 AdditionalMana);
 
 	/** Makes a request to skip selecting a counter spell */
 	UFUNCTION(Server, Reliable, WithValidation)
@@ -561,7 +575,7 @@ protected:
 
 	/** Makes a request to use bonus spell at selected tile */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void Server_RequestCastBonusSpellAction(ATile* Target);
+	void Server_RequestCastBonusSpellAction(FBoardTileHandle Target);
 
 	/** Makes a request to skip using a bonus elemental spell */
 	UFUNCTION(Server, Reliable, WithValidation)
@@ -597,6 +611,82 @@ private:
 	UPROPERTY(Transient)
 	TArray<ATile*> SelectedActionTileCandidates;
 
+private:
+
+	/** Starts finding the path the castle would take to reach given tile, clearing the previous preview */
+	void RefreshMoveCastlePreview(ATile* NewTile);
+
+	/** Clears the current move castle preview, cancelling the path query if still pending */
+	void ClearMoveCastlePreview();
+
+	/** Notify that the path for previewing a castle move has been found */
+	void OnMoveCastlePreviewPathFound(bool bSuccess, const FBoardPath& Path);
+
+private:
+
+	/** Handle to the path query for the move castle preview */
+	FBoardAsyncQueryHandle MoveCastlePreviewHandle;
+
+	/** Tiles along the previewed path the castle would take when moving to the hovered tile */
+	UPROPERTY(Transient)
+	TArray<ATile*> MoveCastlePreviewTiles;
+
+private:
+
+	/** If the player is currently selecting a target for a spell */
+	bool IsSelectingSpellTarget() const;
+
+	/** Evaluates which tiles the selected spell can target, restarting if the selection or
+	state of the match has changed since last evaluated. Only evaluates a batch of tiles per call */
+	void UpdateSpellTargets();
+
+	/** Clears all evaluated spell targets, removing any highlights */
+	void ResetSpellTargets();
+
+	/** If spell targets were evaluated using the current selection and state of the match */
+	bool AreSpellTargetsCurrent(const ABoardManager* BoardManager, const ACSKGameState* GameState, const ACSKPlayerState* PlayerState) const;
+
+	/** Get if given tile has had its validity evaluated for the selected spell, outputting if it is a valid target */
+	bool GetEvaluatedSpellTarget(const ATile* Tile, bool& bOutIsValid) const;
+
+protected:
+
+	/** If every tile should be checked as a target once when selecting a spell, rather than
+	checking each tile as it is hovered. Hovering a tile then only requires a bit test */
+	UPROPERTY(EditDefaultsOnly, Category = "CSK|Spells")
+	uint8 bPrecomputeSpellTargets : 1;
+
+	/** If every valid target of the selected spell should be highlighted once evaluated */
+	UPROPERTY(EditDefaultsOnly, Category = "CSK|Spells", meta = (EditCondition = "bPrecomputeSpellTargets"))
+	uint8 bHighlightSpellTargets : 1;
+
+	/** The max amount of tiles to evaluate per frame, zero evaluates the entire board at once. Spells are
+	evaluated using blueprint events, so this spreads the cost of evaluating large boards across frames */
+	UPROPERTY(EditDefaultsOnly, Category = "CSK|Spells", meta = (ClampMin = 0, EditCondition = "bPrecomputeSpellTargets"))
+	int32 SpellTargetTilesPerFrame;
+
+private:
+
+	/** Tiles the selected spell can target, indexed by dense tile index */
+	FBoardTileMask SpellTargetMask;
+
+	/** Amount of tiles that have been evaluated, tiles are evaluated in dense tile index order */
+	int32 NumSpellTargetsEvaluated;
+
+	/** The selection the spell targets were evaluated with */
+	UPROPERTY(Transient)
+	TSubclassOf<USpellCard> SpellTargetsCard;
+	int32 SpellTargetsSpellIndex;
+	int32 SpellTargetsAdditionalMana;
+
+	/** The state of the match the spell targets were evaluated with */
+	int32 SpellTargetsPlayerMana;
+	int32 SpellTargetsPlayerDiscount;
+	uint32 SpellTargetsBoardVersion;
+
+	/** Version of the health reports the spell targets were evaluated with, spells can check the health of board pieces */
+	uint32 SpellTargetsHealthReportsVersion;
+
 public:
 
 	/** Notify that players castle has been destroyed */
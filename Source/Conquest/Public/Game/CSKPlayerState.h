@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Conquest.h"
+#include "CSKTowerRegistry.h"
 #include "GameFramework/PlayerState.h"
 #include "CSKPlayerState.generated.h"
 
@@ -105,11 +106,11 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = Board)
 	void SetBonusTileMovements(int32 Amount);
 
-	/** Adds a tower to the list of towers this player owns */
+	/** Adds a tower to the list of towers this player owns. The tower will run its end round action */
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = Board)
 	void AddTower(ATower* InTower);
 	
-	/** Removes a tower from the list of towers this player owns */
+	/** Removes a tower from the list of towers this player owns. The tower will no longer run its end round action */
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = Board)
 	void RemoveTower(ATower* InTower);
 
@@ -230,16 +231,19 @@ public:
 
 	/** Get the number of NORMAL towers this player owns */
 	UFUNCTION(BlueprintPure, Category = Board)
-	int32 GetNumNormalTowersOwned() const { return OwnedTowers.Num() - CachedNumLegendaryTowers; }
+	int32 GetNumNormalTowersOwned() const { return OwnedTowerRegistry.GetNumNormalTowers(); }
 
 	/** Get the number of LEGENDARY towers this player owns */
 	UFUNCTION(BlueprintPure, Category = Board)
-	int32 GetNumLegendaryTowersOwned() const { return CachedNumLegendaryTowers; }
+	int32 GetNumLegendaryTowersOwned() const { return OwnedTowerRegistry.GetNumLegendaryTowers(); }
 
 	/** Get the total number of towers this player owns */
 	UFUNCTION(BlueprintPure, Category = Board)
 	int32 GetNumTowersOwned() const { return OwnedTowers.Num(); }
 
+	/** Get the counts of the towers this player owns */
+	FORCEINLINE const FCSKTowerRegistry& GetOwnedTowerRegistry() const { return OwnedTowerRegistry; }
+
 	/** Get spells in this players deck */
 	FORCEINLINE const TArray<TSubclassOf<USpellCard>>& GetSpellCardDeck() const { return SpellCardDeck; }
 	
@@ -266,11 +270,6 @@ protected:
 	UFUNCTION()
 	void OnRep_OwnedTowers();
 
-private:
-
-	/** Updates our cached tower numbers based on current state of owned towers */
-	void UpdateTowerCounts();
-
 protected:
 
 	/** This players assigned color */
@@ -293,11 +292,8 @@ protected:
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, ReplicatedUsing = OnRep_OwnedTowers, Category = Resources)
 	TArray<ATower*> OwnedTowers;
 
-	/** Cached count of how many LEGENDARY towers this player owns */
-	int32 CachedNumLegendaryTowers;
-
-	/** Cached map for counting how many of a certain type of any tower this players owns */
-	TMap<TSubclassOf<ATower>, int32> CachedUniqueTowerCount;
+	/** Counts of the towers this player owns, updated as towers are added and removed */
+	FCSKTowerRegistry OwnedTowerRegistry;
 
 	/** The spells cards in the spell deck. This only exists on the server and the owners client */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated, Category = Resources) 
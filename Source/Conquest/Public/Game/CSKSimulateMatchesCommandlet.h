@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Conquest.h"
+#include "Commandlets/Commandlet.h"
+#include "CSKSimulateMatchesCommandlet.generated.h"
+
+/**
+ * Commandlet for playing headless matches using the match simulator. Reports win rates and throughput.
+ * Usage: -run=CSKSimulateMatches [-Map=/Game/Maps/Map] [-GameMode=/Game/Path/BP_GameMode.BP_GameMode_C]
+ *	[-Matches=1000] [-Seed=0] [-P1=Greedy|Random] [-P2=Greedy|Random] [-MaxRounds=100] [-Rows=9] [-Columns=15]
+ * If no map is given, an empty board of given rows and columns is used
+ */
+UCLASS()
+class CONQUEST_API UCSKSimulateMatchesCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UCSKSimulateMatchesCommandlet();
+
+public:
+
+	// Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet Interface
+};
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Conquest.h"
+
+class ATower;
+
+/**
+ * Incrementally maintained counts of a set of towers. Counts per class, legendary counts and duplicate
+ * type counts are updated as towers are added or removed so rule checks never need to walk every tower.
+ * Towers are tracked by weak pointer, which stays unique to a tower even after it has been destroyed,
+ * so a tower can still be removed after being destroyed without being mistaken for a newer tower
+ */
+struct CONQUEST_API FCSKTowerRegistry
+{
+public:
+
+	FCSKTowerRegistry();
+
+	/** Registers given tower. Get if tower was not already registered */
+	bool AddTower(const ATower* Tower);
+
+	/** Unregisters given tower. Get if tower was registered */
+	bool RemoveTower(const ATower* Tower);
+
+	/** Adds and removes towers so only given towers are registered. Null towers are ignored */
+	void SyncTowers(const TArray<ATower*>& Towers);
+
+	/** Unregisters every tower */
+	void Reset();
+
+public:
+
+	/** Get how many towers of given class are registered */
+	FORCEINLINE int32 GetNumInstances(const UClass* TowerClass) const
+	{
+		const int32* Num = ClassCounts.Find(TowerClass);
+		return Num ? *Num : 0;
+	}
+
+	/** Get the number of towers registered */
+	FORCEINLINE int32 GetNumTowers() const { return RegisteredTowers.Num(); }
+
+	/** Get the number of LEGENDARY towers registered */
+	FORCEINLINE int32 GetNumLegendaryTowers() const { return NumLegendaryTowers; }
+
+	/** Get the number of NORMAL towers registered */
+	FORCEINLINE int32 GetNumNormalTowers() const { return RegisteredTowers.Num() - NumLegendaryTowers; }
+
+	/** Get the number of tower classes with two or more instances registered */
+	FORCEINLINE int32 GetNumDuplicateTypes() const { return NumDuplicateTypes; }
+
+	/** Get the version of these counts. This changes whenever a tower is added or removed */
+	FORCEINLINE uint32 GetVersion() const { return Version; }
+
+private:
+
+	/** Updates counts for a tower of given class being added or removed */
+	void UpdateCounts(const UClass* TowerClass, bool bIsLegendary, int32 Delta);
+
+private:
+
+	/** Cached state of a registered tower, this is what we use to remove a tower */
+	struct FRegisteredTower
+	{
+		const UClass* Class;
+		bool bIsLegendary;
+	};
+
+	/** Every registered tower */
+	TMap<TWeakObjectPtr<const ATower>, FRegisteredTower> RegisteredTowers;
+
+	/** How many towers of each class are registered */
+	TMap<const UClass*, int32> ClassCounts;
+
+	/** Number of registered LEGENDARY towers */
+	int32 NumLegendaryTowers;
+
+	/** Number of classes with duplicates */
+	int32 NumDuplicateTypes;
+
+	/** Incremented with every change */
+	uint32 Version;
+};
@@ -31,6 +31,9 @@ public class ConquestEditor : ModuleRules
             "EditorStyle",
             "InputCore",
             "PropertyEditor",
+            "RenderCore",
+            "RHI",
+            "ShaderCore",
             "Slate",
             "SlateCore",
             "UnrealED"
@@ -1,14 +1,18 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "BoardEdMode.h"
+#include "BoardEditorOverlayComponent.h"
 #include "BoardToolkit.h"
+#include "Board/BoardLayoutAsset.h"
 #include "Board/BoardManager.h"
+#include "Containers/HexGrid.h"
 
 #include "EditorModeManager.h"
 #include "EditorSupportDelegates.h"
 #include "EditorViewportClient.h"
 #include "EngineUtils.h"
 
+#include "SceneView.h"
 #include "ScopedTransaction.h"
 #include "ToolkitManager.h"
 #include "Engine/Selection.h"
@@ -18,31 +22,47 @@ const FEditorModeID FEdModeBoard::EM_Board(TEXT("EM_BoardEdMode"));
 
 #define LOCTEXT_NAMESPACE "EdModeBoard"
 
-class HBoardTileHitProxy : public HHitProxy
+namespace BoardEdMode
 {
-	DECLARE_HIT_PROXY()
-
-public:
-
-	HBoardTileHitProxy(ATile* InTile)
-		: HHitProxy(HPP_World)
-		, Tile(InTile)
+	/** Get the hex grid symmetry matching given paint symmetry */
+	EHexGridSymmetry ToHexGridSymmetry(EBoardPaintSymmetry Symmetry)
 	{
-
+		switch (Symmetry)
+		{
+			case EBoardPaintSymmetry::MirrorColumns:
+			{
+				return EHexGridSymmetry::MirrorColumns;
+			}
+			case EBoardPaintSymmetry::MirrorRows:
+			{
+				return EHexGridSymmetry::MirrorRows;
+			}
+			case EBoardPaintSymmetry::Rotate:
+			{
+				return EHexGridSymmetry::Rotate;
+			}
+			default:
+			{
+				return EHexGridSymmetry::None;
+			}
+		}
 	}
-
-public:
-
-	/** Tile this hit proxy represents */
-	ATile* Tile;
-};
-
-IMPLEMENT_HIT_PROXY(HBoardTileHitProxy, HHitProxy);
+}
 
 FEdModeBoard::FEdModeBoard()
 {
 	BoardSettings = NewObject<UBoardEditorObject>(GetTransientPackage(), TEXT("BoardSettings"), RF_Transactional);
 	BoardSettings->SetEditorMode(this);
+
+	OverlayComponent = nullptr;
+	OverlayHash = 0;
+	OverlayVersion = 0;
+
+	PaintOverlayComponent = nullptr;
+	LastStrokeLocation = FVector::ZeroVector;
+	PaintPreviewHash = 0;
+	StrokeVersion = 0;
+	bIsPainting = false;
 }
 
 void FEdModeBoard::Enter()
@@ -67,10 +87,49 @@ void FEdModeBoard::Enter()
 
 	// Notify settings to match potential existing board
 	BoardSettings->NotifyEditingStart();
+
+	RefreshSelectedTiles();
+
+	// Overlay is drawn by a component we manage
+	if (!OverlayComponent)
+	{
+		OverlayComponent = NewObject<UBoardEditorOverlayComponent>(GetTransientPackage(), TEXT("BoardOverlay"));
+	}
+
+	if (!PaintOverlayComponent)
+	{
+		PaintOverlayComponent = NewObject<UBoardEditorOverlayComponent>(GetTransientPackage(), TEXT("BoardPaintOverlay"));
+	}
+
+	OverlayComponent->RegisterComponentWithWorld(GetWorld());
+	PaintOverlayComponent->RegisterComponentWithWorld(GetWorld());
+	MarkOverlayDirty();
+	UpdateOverlayIfRequired();
+
+	GEditor->RegisterForUndo(this);
 }
 
 void FEdModeBoard::Exit()
 {
+	GEditor->UnregisterForUndo(this);
+
+	if (OverlayComponent && OverlayComponent->IsRegistered())
+	{
+		OverlayComponent->UnregisterComponent();
+	}
+
+	if (PaintOverlayComponent && PaintOverlayComponent->IsRegistered())
+	{
+		PaintOverlayComponent->UnregisterComponent();
+	}
+
+	// Discard any stroke that was in progress
+	bIsPainting = false;
+	StrokeMask.Init(0);
+	HoveredTile.Reset();
+
+	SelectedTiles.Empty();
+
 	// Shutdown our toolkit
 	if (Toolkit.IsValid())
 	{
@@ -86,18 +145,12 @@ void FEdModeBoard::Exit()
 	FEdMode::Exit();
 }
 
-void FEdModeBoard::Render(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI)
+void FEdModeBoard::Tick(FEditorViewportClient* ViewportClient, float DeltaTime)
 {
-	FEdMode::Render(View, Viewport, PDI);
+	FEdMode::Tick(ViewportClient, DeltaTime);
 
-	if (BoardManager.IsValid())
-	{
-		DrawExistingBoard(View, Viewport, PDI);
-	}
-	else
-	{
-		DrawPreviewBoard(View, Viewport, PDI);
-	}
+	UpdateOverlayIfRequired();
+	UpdatePaintPreviewIfRequired();
 }
 
 bool FEdModeBoard::UsesToolkits() const
@@ -266,27 +319,125 @@ bool FEdModeBoard::InputDelta(FEditorViewportClient* InViewportClient, FViewport
 bool FEdModeBoard::HandleClick(FEditorViewportClient* InViewportClient, HHitProxy* HitProxy, const FViewportClick& Click)
 {
 	bool bResult = FEdMode::HandleClick(InViewportClient, HitProxy, Click);
-	if (!bResult && HitProxy && HitProxy->IsA(HBoardTileHitProxy::StaticGetType()))
+
+	// Overlay has no hit proxies, so we trace the board for the tile instead. We
+	// only do this when clicking on empty space or on the board itself
+	if (!bResult && BoardManager.IsValid() && InViewportClient->IsPerspective())
 	{
-		ATile* Tile = static_cast<HBoardTileHitProxy*>(HitProxy)->Tile;	
+		const AActor* HitActor = (HitProxy && HitProxy->IsA(HActor::StaticGetType())) ? static_cast<HActor*>(HitProxy)->Actor : nullptr;
+		if (!HitProxy || (HitActor && (HitActor->IsA<ATile>() || HitActor == BoardManager.Get())))
+		{
+			const FVector TraceStart = Click.GetOrigin();
+			const FVector TraceEnd = TraceStart + Click.GetDirection() * HALF_WORLD_MAX;
+
+			ATile* Tile = BoardManager->TraceBoard(TraceStart, TraceEnd);
+			if (Tile)
+			{
+				// Still allow control to select multiple actors
+				if (!Click.IsControlDown())
+				{
+					GEditor->SelectNone(true, true);
+				}
 
-		// Still allow control to select multiple actors
-		if (!Click.IsControlDown())
+				GEditor->SelectActor(Tile, !Tile->IsSelected(), true);
+
+				RefreshEditorWidget();
+				bResult = true;
+			}
+		}
+	}
+
+	return bResult;
+}
+
+bool FEdModeBoard::InputKey(FEditorViewportClient* ViewportClient, FViewport* Viewport, FKey Key, EInputEvent Event)
+{
+	if (Key == EKeys::LeftMouseButton)
+	{
+		// Finish strokes even if the tool was changed during them
+		if (Event == IE_Released && bIsPainting)
 		{
-			GEditor->SelectNone(true, true);
+			EndStroke();
+			return true;
 		}
 
-		GEditor->SelectActor(Tile, !Tile->IsSelected(), true);
+		// Alt is left for camera controls
+		if (Event == IE_Pressed && IsPaintToolActive() && !Viewport->KeyState(EKeys::LeftAlt) && !Viewport->KeyState(EKeys::RightAlt))
+		{
+			FVector Location;
+			if (TraceCursor(ViewportClient, Viewport, Viewport->GetMouseX(), Viewport->GetMouseY(), Location))
+			{
+				if (BoardSettings->PaintTool == EBoardPaintTool::Fill)
+				{
+					FillAt(Location);
+				}
+				else
+				{
+					BeginStroke(Location);
+				}
 
-		RefreshEditorWidget();
-		bResult = true;
+				return true;
+			}
+		}
 	}
 
-	return bResult;
+	return FEdMode::InputKey(ViewportClient, Viewport, Key, Event);
+}
+
+bool FEdModeBoard::MouseMove(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 x, int32 y)
+{
+	// Track the hovered tile so the brush can be previewed
+	if (IsPaintToolActive())
+	{
+		FVector Location;
+		ATile* Tile = TraceCursor(ViewportClient, Viewport, x, y, Location) ? BoardManager->GetTileAtLocation(Location) : nullptr;
+		HoveredTile = Tile;
+	}
+	else
+	{
+		HoveredTile.Reset();
+	}
+
+	return FEdMode::MouseMove(ViewportClient, Viewport, x, y);
+}
+
+bool FEdModeBoard::CapturedMouseMove(FEditorViewportClient* InViewportClient, FViewport* InViewport, int32 InMouseX, int32 InMouseY)
+{
+	if (bIsPainting)
+	{
+		FVector Location;
+		if (TraceCursor(InViewportClient, InViewport, InMouseX, InMouseY, Location))
+		{
+			HoveredTile = BoardManager->GetTileAtLocation(Location);
+
+			// Step between the last and current location so fast drags don't leave gaps
+			const float StepSize = BoardManager->GetGridHexSize() * 0.5f;
+			const float Distance = FVector::Dist(LastStrokeLocation, Location);
+			const int32 NumSteps = FMath::Max(1, FMath::CeilToInt(Distance / StepSize));
+
+			for (int32 Step = 1; Step <= NumSteps; ++Step)
+			{
+				AddBrushToStroke(FMath::Lerp(LastStrokeLocation, Location, static_cast<float>(Step) / NumSteps));
+			}
+
+			LastStrokeLocation = Location;
+		}
+
+		return true;
+	}
+
+	return FEdMode::CapturedMouseMove(InViewportClient, InViewport, InMouseX, InMouseY);
+}
+
+bool FEdModeBoard::DisallowMouseDeltaTracking() const
+{
+	// Dragging a stroke shouldn't move the camera
+	return bIsPainting;
 }
 
 void FEdModeBoard::ActorSelectionChangeNotify()
 {
+	RefreshSelectedTiles();
 	RefreshEditorWidget();
 }
 
@@ -295,6 +446,21 @@ void FEdModeBoard::AddReferencedObjects(FReferenceCollector& Collector)
 	FEdMode::AddReferencedObjects(Collector);
 
 	Collector.AddReferencedObject(BoardSettings);
+	Collector.AddReferencedObject(OverlayComponent);
+	Collector.AddReferencedObject(PaintOverlayComponent);
+	Collector.AddReferencedObjects(SelectedTiles);
+}
+
+void FEdModeBoard::PostUndo(bool bSuccess)
+{
+	// Tiles may have been restored without notifying the board
+	RefreshSelectedTiles();
+	MarkOverlayDirty();
+}
+
+void FEdModeBoard::PostRedo(bool bSuccess)
+{
+	PostUndo(bSuccess);
 }
 
 void FEdModeBoard::GenerateBoard()
@@ -302,6 +468,117 @@ void FEdModeBoard::GenerateBoard()
 	FScopedTransaction Transaction(LOCTEXT("Undo", "Generate Grid"));
 
 	// Spawn in new board if forced
+	if (SpawnBoardManagerIfRequired())
+	{
+		FBoardInitData InitData(
+			FIntPoint(BoardSettings->BoardRows, BoardSettings->BoardColumns),
+			BoardSettings->BoardHexSize,
+			BoardSettings->BoardOrigin,
+			FRotator::ZeroRotator,
+			BoardSettings->BoardTileTemplate);
+
+		BoardManager->InitBoard(InitData);
+
+		// Post generation notifies // TODO: Use a delegate?
+		BoardSettings->NotifyBoardGenerated();
+		GetBoardToolkit()->NotifyEditingStateChanged(); // TODO: rename
+
+		// We might have a tile that did exist but is now dead selected, so default to selecting the board
+		GEditor->SelectActor(BoardManager.Get(), true, true);
+	}
+	else
+	{
+		UE_LOG(LogConquestEditor, Warning, TEXT("Unable to generate grid as board manager was null"));
+		Transaction.Cancel();
+	}
+}
+
+void FEdModeBoard::SaveBoardLayout()
+{
+	UBoardLayoutAsset* Layout = BoardSettings->BoardLayout;
+	if (!BoardManager.IsValid() || !Layout)
+	{
+		UE_LOG(LogConquestEditor, Warning, TEXT("Unable to save board layout as either board manager or layout is null"));
+		return;
+	}
+
+	FScopedTransaction Transaction(LOCTEXT("SaveLayout", "Save Board Layout"));
+	BoardManager->SaveBoardLayout(Layout);
+}
+
+void FEdModeBoard::LoadBoardLayout()
+{
+	UBoardLayoutAsset* Layout = BoardSettings->BoardLayout;
+	if (!Layout || !Layout->IsValidLayout())
+	{
+		UE_LOG(LogConquestEditor, Warning, TEXT("Unable to load board layout as layout is either null or invalid"));
+		return;
+	}
+
+	FScopedTransaction Transaction(LOCTEXT("LoadLayout", "Load Board Layout"));
+
+	if (SpawnBoardManagerIfRequired())
+	{
+		BoardManager->LoadBoardLayout(Layout, BoardSettings->BoardTileTemplate);
+
+		BoardSettings->NotifyEditingStart();
+		BoardSettings->NotifyBoardGenerated();
+		GetBoardToolkit()->NotifyEditingStateChanged();
+
+		GEditor->SelectActor(BoardManager.Get(), true, true);
+	}
+	else
+	{
+		Transaction.Cancel();
+	}
+}
+
+int32 FEdModeBoard::ApplyTileEdit(const FBoardTileMask& Mask, const FBoardTileEdit& Edit, const FText& Description)
+{
+	if (!BoardManager.IsValid() || Mask.IsEmpty())
+	{
+		return 0;
+	}
+
+	FScopedTransaction Transaction(Description);
+
+	const int32 NumChanged = BoardManager->ApplyTileEdit(Mask, Edit);
+	if (NumChanged == 0)
+	{
+		// Avoid filling the undo buffer with edits that did nothing
+		Transaction.Cancel();
+	}
+	else
+	{
+		RefreshEditorWidget();
+	}
+
+	return NumChanged;
+}
+
+void FEdModeBoard::GetSelectedTileMask(FBoardTileMask& OutMask) const
+{
+	if (!BoardManager.IsValid())
+	{
+		OutMask.Init(0);
+		return;
+	}
+
+	OutMask.Init(BoardManager->GetTileMask().Num());
+
+	const FIntPoint& Dimensions = BoardManager->GetGridDimensions();
+	for (const ATile* Tile : SelectedTiles)
+	{
+		const int32 TileIndex = FHexGrid::HexToCellIndex(Tile->GetGridHexValue(), Dimensions);
+		if (TileIndex != INDEX_NONE && TileIndex < OutMask.Num())
+		{
+			OutMask.SetBit(TileIndex);
+		}
+	}
+}
+
+bool FEdModeBoard::SpawnBoardManagerIfRequired()
+{
 	if (!BoardManager.IsValid())
 	{
 		FActorSpawnParameters SpawnParams;
@@ -318,36 +595,40 @@ void FEdModeBoard::GenerateBoard()
 		else
 		{
 			UE_LOG(LogConquestEditor, Warning, TEXT("Unable to spawn new board manager"));
-			Transaction.Cancel();
 		}
 	}
 
-	if (BoardManager.IsValid())
-	{
-		FBoardInitData InitData(
-			FIntPoint(BoardSettings->BoardRows, BoardSettings->BoardColumns),
-			BoardSettings->BoardHexSize,
-			BoardSettings->BoardOrigin,
-			FRotator::ZeroRotator,
-			BoardSettings->BoardTileTemplate);
+	return BoardManager.IsValid();
+}
 
-		BoardManager->InitBoard(InitData);
+void FEdModeBoard::UpdateOverlayIfRequired()
+{
+	if (!OverlayComponent || !OverlayComponent->IsRegistered())
+	{
+		return;
+	}
 
-		// Post generation notifies // TODO: Use a delegate?
-		BoardSettings->NotifyBoardGenerated();
-		GetBoardToolkit()->NotifyEditingStateChanged(); // TODO: rename
+	const uint32 NewOverlayHash = GetOverlayHash();
+	if (NewOverlayHash == OverlayHash)
+	{
+		return;
+	}
 
-		// We might have a tile that did exist but is now dead selected, so default to selecting the board
-		GEditor->SelectActor(BoardManager.Get(), true, true);
+	TArray<FBoardOverlayHexagon> Hexagons;
+	if (BoardManager.IsValid())
+	{
+		BuildExistingBoardOverlay(Hexagons);
 	}
 	else
 	{
-		UE_LOG(LogConquestEditor, Warning, TEXT("Unable to generate grid as board manager was null"));
-		Transaction.Cancel();
+		BuildPreviewBoardOverlay(Hexagons);
 	}
+
+	OverlayComponent->SetHexagons(MoveTemp(Hexagons));
+	OverlayHash = NewOverlayHash;
 }
 
-void FEdModeBoard::DrawPreviewBoard(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI) const
+void FEdModeBoard::BuildPreviewBoardOverlay(TArray<FBoardOverlayHexagon>& OutHexagons) const
 {
 	using FHex = FHexGrid::FHex;
 
@@ -360,6 +641,8 @@ void FEdModeBoard::DrawPreviewBoard(const FSceneView* View, FViewport* Viewport,
 	const FLinearColor PreviewPerimeterColor = FLinearColor::Green;
 	const FLinearColor PreviewCenterColor = FLinearColor::Red;
 
+	OutHexagons.Reserve(Rows * Columns);
+
 	for (int32 c = 0; c < Columns; ++c)
 	{
 		int32 COffset = FMath::FloorToInt(c / 2);
@@ -369,18 +652,24 @@ void FEdModeBoard::DrawPreviewBoard(const FSceneView* View, FViewport* Viewport,
 			FHex Hex = FHexGrid::ConvertIndicesToHex(r, c);
 
 			FVector TileLocation = FHexGrid::ConvertHexToWorld(Hex, Origin, SizeVec);
-			DrawHexagon(Viewport, PDI, nullptr, TileLocation, HexSize, PreviewPerimeterColor, PreviewCenterColor);
+			OutHexagons.Emplace(TileLocation, HexSize, PreviewPerimeterColor, PreviewCenterColor);
 		}
 	}
 }
 
-void FEdModeBoard::DrawExistingBoard(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI) const
+void FEdModeBoard::BuildExistingBoardOverlay(TArray<FBoardOverlayHexagon>& OutHexagons) const
 {
 	check(BoardManager.IsValid());
 
+	const float HexSize = BoardManager->GetGridHexSize();
+	const ATile* Player1PortalTile = BoardManager->GetPlayer1PortalTile();
+	const ATile* Player2PortalTile = BoardManager->GetPlayer2PortalTile();
+
+	const FIntPoint& Dimensions = BoardManager->GetGridDimensions();
+	OutHexagons.Reserve(Dimensions.X * Dimensions.Y);
+
 	// Simply draw every tile
-	const TArray<ATile*> Tiles = BoardManager->GetHexGrid().GetAllTiles();
-	for (ATile* Tile : Tiles)
+	BoardManager->GetHexGrid().ForEachTile([&](ATile* Tile)->void
 	{
 		if (Tile)
 		{
@@ -388,13 +677,13 @@ void FEdModeBoard::DrawExistingBoard(const FSceneView* View, FViewport* Viewport
 			FLinearColor PerimeterColor = FLinearColor::Yellow;
 			FLinearColor CenterColor = FLinearColor::Black;
 
-			if (BoardManager->GetPlayer1PortalTile() == Tile)
+			if (Player1PortalTile == Tile)
 			{
 				PerimeterColor = FLinearColor::FromSRGBColor(FColor::Magenta);
 				CenterColor = FLinearColor::FromSRGBColor(FColor::Emerald);
 				Depth = 3.f;
 			}
-			else if (BoardManager->GetPlayer2PortalTile() == Tile)
+			else if (Player2PortalTile == Tile)
 			{
 				PerimeterColor = FLinearColor::FromSRGBColor(FColor::Cyan);
 				CenterColor = FLinearColor::FromSRGBColor(FColor::Emerald);
@@ -407,61 +696,245 @@ void FEdModeBoard::DrawExistingBoard(const FSceneView* View, FViewport* Viewport
 				Depth = 1.f;
 			}
 
-			DrawHexagon(Viewport, PDI, Tile, Tile->GetActorLocation(), BoardManager->GetGridHexSize(), PerimeterColor, CenterColor, Depth);
+			// Distinguish selected tiles from others
+			if (Tile->IsSelected())
+			{
+				CenterColor = CenterColor != FLinearColor::Blue ? FLinearColor::Blue : FLinearColor::FromSRGBColor(FColor::Cyan);
+			}
+
+			OutHexagons.Emplace(Tile->GetActorLocation(), HexSize, PerimeterColor, CenterColor, Depth);
 		}
+	});
+}
+
+uint32 FEdModeBoard::GetOverlayHash() const
+{
+	uint32 Hash = GetTypeHash(OverlayVersion);
+
+	if (BoardManager.IsValid())
+	{
+		// Tile states changing will change the occupancy version
+		Hash = HashCombine(Hash, GetTypeHash(BoardManager.Get()));
+		Hash = HashCombine(Hash, GetTypeHash(BoardManager->GetOccupancyVersion()));
+		Hash = HashCombine(Hash, GetTypeHash(BoardManager->GetActorLocation()));
+		Hash = HashCombine(Hash, GetTypeHash(BoardManager->GetGridDimensions()));
+		Hash = HashCombine(Hash, GetTypeHash(BoardManager->GetGridHexSize()));
+		Hash = HashCombine(Hash, GetTypeHash(BoardManager->GetPlayer1PortalTile()));
+		Hash = HashCombine(Hash, GetTypeHash(BoardManager->GetPlayer2PortalTile()));
 	}
+	else
+	{
+		Hash = HashCombine(Hash, GetTypeHash(BoardSettings->BoardRows));
+		Hash = HashCombine(Hash, GetTypeHash(BoardSettings->BoardColumns));
+		Hash = HashCombine(Hash, GetTypeHash(BoardSettings->BoardHexSize));
+		Hash = HashCombine(Hash, GetTypeHash(BoardSettings->BoardOrigin));
+	}
+
+	return Hash;
 }
 
-void FEdModeBoard::DrawHexagon(FViewport* Viewport, FPrimitiveDrawInterface* PDI, ATile* Tile, const FVector& Position,
-	float HexSize, const FLinearColor& PerimeterColor, const FLinearColor& CenterColor, float Depth) const
+bool FEdModeBoard::IsPaintToolActive() const
 {
-	check(Viewport);
-	check(PDI);
+	return BoardManager.IsValid() && BoardSettings->PaintTool != EBoardPaintTool::None && BoardManager->GetHexGrid().bGridGenerated;
+}
+
+bool FEdModeBoard::TraceCursor(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 MouseX, int32 MouseY, FVector& OutLocation) const
+{
+	if (!BoardManager.IsValid() || !ViewportClient->IsPerspective())
+	{
+		return false;
+	}
 
-	const float PerimeterSize = 5.f;
-	const float CenterSize = HexSize * 0.25f;
-	const ELevelViewportType ViewportType = static_cast<FEditorViewportClient*>(Viewport->GetClient())->ViewportType;
+	FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(Viewport, ViewportClient->GetScene(), ViewportClient->EngineShowFlags)
+		.SetRealtimeUpdate(ViewportClient->IsRealtime()));
 
-	// Connect lines to form a hexagon
-	FVector CurrentVertex = FHexGrid::ConvertHexVertexIndexToWorld(Position, HexSize, 0);
-	for (int32 i = 0; i <= 5; ++i)
+	FSceneView* View = ViewportClient->CalcSceneView(&ViewFamily);
+	FViewportCursorLocation Cursor(View, ViewportClient, MouseX, MouseY);
+
+	// Same plane the board traces against (see ABoardManager::TraceBoard)
+	const FPlane BoardPlane(BoardManager->GetActorLocation(), BoardManager->GetActorUpVector());
+	if (FMath::IsNearlyZero(Cursor.GetDirection() | BoardPlane))
 	{
-		FVector NextVertex = FHexGrid::ConvertHexVertexIndexToWorld(Position, HexSize, (i + 1) % 6);
+		return false;
+	}
+
+	OutLocation = FMath::RayPlaneIntersection(Cursor.GetOrigin(), Cursor.GetDirection(), BoardPlane);
+	return true;
+}
+
+void FEdModeBoard::AddBrushToStroke(const FVector& Location)
+{
+	const ATile* Tile = BoardManager->GetTileAtLocation(Location);
+	if (!Tile)
+	{
+		return;
+	}
 
-		if (ViewportType == LVT_Perspective)
+	FBoardTileMask BrushMask;
+	BoardManager->GetRangeTileMask(Tile, BoardSettings->BrushRadius, BrushMask);
+
+	if (BrushMask.Num() == StrokeMask.Num())
+	{
+		StrokeMask |= BrushMask;
+		++StrokeVersion;
+	}
+}
+
+void FEdModeBoard::ApplyPaintSymmetry(FBoardTileMask& Mask) const
+{
+	const EHexGridSymmetry Symmetry = BoardEdMode::ToHexGridSymmetry(BoardSettings->PaintSymmetry);
+	const FIntPoint& Dimensions = BoardManager->GetGridDimensions();
+
+	// Offset columns mean not every board can be mirrored
+	if (Symmetry == EHexGridSymmetry::None || !FHexGrid::SupportsSymmetry(Symmetry, Dimensions))
+	{
+		return;
+	}
+
+	FBoardTileMask MirroredMask;
+	MirroredMask.Init(Mask.Num());
+
+	Mask.ForEachSetBit([&](int32 TileIndex)->void
+	{
+		const int32 MirroredIndex = FHexGrid::GetMirroredCellIndex(TileIndex, Symmetry, Dimensions);
+		if (MirroredIndex != INDEX_NONE)
 		{
-			PDI->DrawLine(CurrentVertex, NextVertex, PerimeterColor, SDPG_World, PerimeterSize, Depth);
+			MirroredMask.SetBit(MirroredIndex);
 		}
+	});
+
+	Mask |= MirroredMask;
+
+	// Mirrored cells may not have tiles
+	Mask &= BoardManager->GetTileMask();
+}
 
-		CurrentVertex = NextVertex;
+FBoardTileEdit FEdModeBoard::GetPaintEdit() const
+{
+	switch (BoardSettings->PaintTarget)
+	{
+		case EBoardPaintTarget::NullTile:
+		{
+			return FBoardTileEdit::MakeNull(true);
+		}
+		case EBoardPaintTarget::SolidTile:
+		{
+			return FBoardTileEdit::MakeNull(false);
+		}
+		default:
+		{
+			return FBoardTileEdit::MakeElement(BoardSettings->PaintElement);
+		}
 	}
+}
+
+void FEdModeBoard::BeginStroke(const FVector& Location)
+{
+	check(BoardManager.IsValid());
+
+	StrokeMask.Init(BoardManager->GetTileMask().Num());
+	LastStrokeLocation = Location;
+	bIsPainting = true;
+
+	AddBrushToStroke(Location);
+}
 
-	// Draw final point to show tiles middle location
-	if (ViewportType == LVT_Perspective)
+void FEdModeBoard::EndStroke()
+{
+	bIsPainting = false;
+
+	if (BoardManager.IsValid() && StrokeMask.Num() == BoardManager->GetTileMask().Num())
 	{
-		FLinearColor PointColor = CenterColor;
+		ApplyPaintSymmetry(StrokeMask);
+		ApplyTileEdit(StrokeMask, GetPaintEdit(), LOCTEXT("PaintTiles", "Paint Board Tiles"));
+	}
 
-		if (Tile)
-		{
-			PDI->SetHitProxy(new HBoardTileHitProxy(Tile));
+	StrokeMask.Init(0);
+	++StrokeVersion;
+}
 
-			// Distinguish selected tiles from others
-			if (Tile->IsSelected())
+void FEdModeBoard::FillAt(const FVector& Location)
+{
+	check(BoardManager.IsValid());
+
+	const ATile* Tile = BoardManager->GetTileAtLocation(Location);
+	if (!Tile)
+	{
+		return;
+	}
+
+	FBoardTileMask FillMask;
+	BoardManager->GetConnectedTileMask(Tile, FillMask);
+
+	ApplyPaintSymmetry(FillMask);
+	ApplyTileEdit(FillMask, GetPaintEdit(), LOCTEXT("FillTiles", "Fill Board Tiles"));
+}
+
+void FEdModeBoard::UpdatePaintPreviewIfRequired()
+{
+	if (!PaintOverlayComponent || !PaintOverlayComponent->IsRegistered())
+	{
+		return;
+	}
+
+	const bool bShowPreview = IsPaintToolActive();
+	const ATile* Tile = HoveredTile.Get();
+
+	uint32 NewPreviewHash = bShowPreview ? 1 : 0;
+	if (bShowPreview)
+	{
+		NewPreviewHash = HashCombine(NewPreviewHash, GetTypeHash(Tile));
+		NewPreviewHash = HashCombine(NewPreviewHash, GetTypeHash(StrokeVersion));
+		NewPreviewHash = HashCombine(NewPreviewHash, GetTypeHash(static_cast<uint8>(BoardSettings->PaintTool)));
+		NewPreviewHash = HashCombine(NewPreviewHash, GetTypeHash(BoardSettings->BrushRadius));
+		NewPreviewHash = HashCombine(NewPreviewHash, GetTypeHash(static_cast<uint8>(BoardSettings->PaintSymmetry)));
+		NewPreviewHash = HashCombine(NewPreviewHash, GetTypeHash(BoardManager->GetOccupancyVersion()));
+	}
+
+	if (NewPreviewHash == PaintPreviewHash)
+	{
+		return;
+	}
+
+	TArray<FBoardOverlayHexagon> Hexagons;
+	if (bShowPreview)
+	{
+		const float HexSize = BoardManager->GetGridHexSize();
+		const FLinearColor PreviewColor = FLinearColor::White;
+
+		// Preview what would be painted if the mouse was released now
+		FBoardTileMask PreviewMask;
+		if (bIsPainting)
+		{
+			PreviewMask = StrokeMask;
+		}
+		else if (Tile)
+		{
+			if (BoardSettings->PaintTool == EBoardPaintTool::Fill)
 			{
-				if (CenterColor != FLinearColor::Blue)
-				{
-					PointColor = FLinearColor::Blue;
-				}
-				else
-				{
-					PointColor = FLinearColor::FromSRGBColor(FColor::Cyan);
-				}
+				BoardManager->GetConnectedTileMask(Tile, PreviewMask);
+			}
+			else
+			{
+				BoardManager->GetRangeTileMask(Tile, BoardSettings->BrushRadius, PreviewMask);
 			}
 		}
 
-		PDI->DrawLine(Position, Position, PointColor, SDPG_World, CenterSize);
-		PDI->SetHitProxy(nullptr);	
+		if (PreviewMask.Num() == BoardManager->GetTileMask().Num())
+		{
+			ApplyPaintSymmetry(PreviewMask);
+
+			Hexagons.Reserve(PreviewMask.CountSetBits());
+			BoardManager->ForEachTileInMask(PreviewMask, [&Hexagons, HexSize, &PreviewColor](ATile* PreviewTile)->void
+			{
+				// Drawn above the board overlay
+				Hexagons.Emplace(PreviewTile->GetActorLocation(), HexSize * 0.9f, PreviewColor, FLinearColor::Transparent, 4.f);
+			});
+		}
 	}
+
+	PaintOverlayComponent->SetHexagons(MoveTemp(Hexagons));
+	PaintPreviewHash = NewPreviewHash;
 }
 
 TSharedRef<FUICommandList> FEdModeBoard::GetUICommandList() const
@@ -508,9 +981,9 @@ TSharedPtr<FBoardToolkit> FEdModeBoard::GetBoardToolkit() const
 	return StaticCastSharedPtr<FBoardToolkit>(Toolkit);
 }
 
-TArray<ATile*> FEdModeBoard::GetAllSelectedTiles() const
+void FEdModeBoard::RefreshSelectedTiles()
 {
-	TArray<ATile*> SelectedTiles;
+	SelectedTiles.Reset();
 	for (FSelectionIterator It = GEditor->GetSelectedActorIterator(); It; ++It)
 	{
 		ATile* Tile = Cast<ATile>(*It);
@@ -520,12 +993,8 @@ TArray<ATile*> FEdModeBoard::GetAllSelectedTiles() const
 		}
 	}
 
-	return SelectedTiles;
-}
-
-int32 FEdModeBoard::GetNumSelectedTiles() const
-{
-	return GetAllSelectedTiles().Num();
+	// Selected tiles are highlighted by the overlay
+	MarkOverlayDirty();
 }
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
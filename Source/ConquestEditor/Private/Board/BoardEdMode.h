@@ -4,11 +4,16 @@
 
 #include "ConquestEditor.h"
 #include "EdMode.h"
+#include "EditorUndoClient.h"
 #include "BoardEditorObject.h"
+#include "Containers/BoardTileMask.h"
 
 class ABoardManager;
 class FBoardToolkit;
 class FUICommandList;
+class UBoardEditorOverlayComponent;
+struct FBoardOverlayHexagon;
+struct FBoardTileEdit;
 
 /** Tracks the state for when editing a board */
 enum class EBoardEditingState : uint8
@@ -21,7 +26,7 @@ enum class EBoardEditingState : uint8
 /** 
  * Editor for laying out the board in conquest 
  */
-class FEdModeBoard : public FEdMode
+class FEdModeBoard : public FEdMode, public FEditorUndoClient
 {
 public:
 
@@ -37,7 +42,7 @@ public:
 	// Begin FEdMode Interface
 	virtual void Enter() override;
 	virtual void Exit() override;
-	virtual void Render(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI) override;
+	virtual void Tick(FEditorViewportClient* ViewportClient, float DeltaTime) override;
 	virtual bool UsesToolkits() const override;
 
 	virtual EEditAction::Type GetActionEditDuplicate() override;
@@ -59,6 +64,10 @@ public:
 
 	virtual bool InputDelta(FEditorViewportClient* InViewportClient, FViewport* InViewport, FVector& InDrag, FRotator& InRot, FVector& InScale) override;
 	virtual bool HandleClick(FEditorViewportClient* InViewportClient, HHitProxy* HitProxy, const FViewportClick& Click) override;
+	virtual bool InputKey(FEditorViewportClient* ViewportClient, FViewport* Viewport, FKey Key, EInputEvent Event) override;
+	virtual bool MouseMove(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 x, int32 y) override;
+	virtual bool CapturedMouseMove(FEditorViewportClient* InViewportClient, FViewport* InViewport, int32 InMouseX, int32 InMouseY) override;
+	virtual bool DisallowMouseDeltaTracking() const override;
 
 	virtual void ActorSelectionChangeNotify() override;
 	// End FEdMode Interface
@@ -67,11 +76,33 @@ public:
 	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
 	// End FGCObject Interface
 
+	// Begin FEditorUndoClient Interface
+	virtual void PostUndo(bool bSuccess) override;
+	virtual void PostRedo(bool bSuccess) override;
+	// End FEditorUndoClient Interface
+
 public:
 
 	/** Generates a new board based off current settings */
 	void GenerateBoard();
 
+	/** Saves the current board into the layout asset set in settings */
+	void SaveBoardLayout();
+
+	/** Generates the board from the layout asset set in settings */
+	void LoadBoardLayout();
+
+	/** Applies given edit to every tile in mask as a single transaction. Get the amount of tiles changed */
+	int32 ApplyTileEdit(const FBoardTileMask& Mask, const FBoardTileEdit& Edit, const FText& Description);
+
+	/** Builds the mask of every selected tile */
+	void GetSelectedTileMask(FBoardTileMask& OutMask) const;
+
+private:
+
+	/** Spawns a board manager if one does not exist. Get if a board manager exists */
+	bool SpawnBoardManagerIfRequired();
+
 private:
 
 	/** Notify that the current level has changed */
@@ -80,17 +111,24 @@ private:
 	/** Notify that current map has changed */
 	//void OnMapChange(uint32 Event);
 
+public:
+
+	/** Forces the overlay to be rebuilt next tick */
+	FORCEINLINE void MarkOverlayDirty() { ++OverlayVersion; }
+
 private:
 
-	/** Draws a preview render of the grid currently in creation */
-	void DrawPreviewBoard(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI) const;
+	/** Rebuilds the overlay if anything it draws has changed since it was last built */
+	void UpdateOverlayIfRequired();
 
-	/** Draws the render of the existing board manager */
-	void DrawExistingBoard(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI) const;
+	/** Builds the overlay for the preview of the grid currently in creation */
+	void BuildPreviewBoardOverlay(TArray<FBoardOverlayHexagon>& OutHexagons) const;
 
-	/** Draws a hexagon of given size at given location */
-	void DrawHexagon(FViewport* Viewport, FPrimitiveDrawInterface* PDI, ATile* Tile, const FVector& Origin, float HexSize,
-		const FLinearColor& PerimeterColor, const FLinearColor& CenterColor = FLinearColor::Transparent, float Depth = 0.f) const;
+	/** Builds the overlay for the existing board manager */
+	void BuildExistingBoardOverlay(TArray<FBoardOverlayHexagon>& OutHexagons) const;
+
+	/** Get a hash of everything the overlay draws */
+	uint32 GetOverlayHash() const;
 
 public:
 
@@ -124,12 +162,83 @@ private:
 	/** The board manager we are currently editing (if it exists) */
 	TWeakObjectPtr<ABoardManager> BoardManager;
 
+	/** Component drawing the board overlay */
+	UBoardEditorOverlayComponent* OverlayComponent;
+
+	/** Hash of the state the overlay was last built with */
+	uint32 OverlayHash;
+
+	/** Incremented whenever the overlay needs rebuilding for reasons not tracked by the board */
+	uint32 OverlayVersion;
+
+private:
+
+	/** If the paint tools should handle input instead of selection */
+	bool IsPaintToolActive() const;
+
+	/** Finds where the cursor hits the plane of the board. Get if the plane was hit */
+	bool TraceCursor(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 MouseX, int32 MouseY, FVector& OutLocation) const;
+
+	/** Adds the tiles under the brush at given location to the current stroke */
+	void AddBrushToStroke(const FVector& Location);
+
+	/** Adds the tiles mirroring those in mask based on the current symmetry setting */
+	void ApplyPaintSymmetry(FBoardTileMask& Mask) const;
+
+	/** Get the edit to apply to painted tiles */
+	FBoardTileEdit GetPaintEdit() const;
+
+	/** Starts a new brush stroke at given location */
+	void BeginStroke(const FVector& Location);
+
+	/** Applies the current brush stroke */
+	void EndStroke();
+
+	/** Fills the tiles connected to the tile at given location */
+	void FillAt(const FVector& Location);
+
+	/** Rebuilds the paint preview if the brush or stroke has changed */
+	void UpdatePaintPreviewIfRequired();
+
+private:
+
+	/** Component drawing the brush and current stroke */
+	UBoardEditorOverlayComponent* PaintOverlayComponent;
+
+	/** Every tile painted by the current stroke. Symmetry is applied when the stroke ends */
+	FBoardTileMask StrokeMask;
+
+	/** Last location added to the current stroke */
+	FVector LastStrokeLocation;
+
+	/** Tile the cursor is currently hovering */
+	TWeakObjectPtr<ATile> HoveredTile;
+
+	/** Hash of the state the paint preview was last built with */
+	uint32 PaintPreviewHash;
+
+	/** Incremented whenever the stroke changes */
+	uint32 StrokeVersion;
+
+	/** If a brush stroke is in progress */
+	uint8 bIsPainting : 1;
+
 public:
 
 	/** Get all the tiles currently selected */
-	TArray<ATile*> GetAllSelectedTiles() const;
+	FORCEINLINE const TArray<ATile*>& GetAllSelectedTiles() const { return SelectedTiles; }
 
 	/** Get the amount of tiles selected */
-	int32 GetNumSelectedTiles() const;
+	FORCEINLINE int32 GetNumSelectedTiles() const { return SelectedTiles.Num(); }
+
+private:
+
+	/** Refreshes the cached selected tiles from the editors selection */
+	void RefreshSelectedTiles();
+
+private:
+
+	/** The tiles currently selected. This is only refreshed when selection changes */
+	TArray<ATile*> SelectedTiles;
 };
 
@@ -3,6 +3,7 @@
 #include "BoardEditorDetailCustomization.h"
 #include "BoardEditorObject.h"
 #include "BoardEdMode.h"
+#include "Board/BoardLayoutAsset.h"
 #include "Board/BoardManager.h"
 #include "Board/Tile.h"
 
@@ -194,6 +195,45 @@ void FBoardEditorDetailCustomization_Board::CustomizeDetails(IDetailLayoutBuilde
 		];
 	}
 
+	// Layout asset and save/load buttons
+	{
+		TSharedRef<IPropertyHandle> PropertyHandle_Layout = DetailBuilder.GetProperty(GET_MEMBER_NAME_CHECKED(UBoardEditorObject, BoardLayout));
+		BoardCategory.AddProperty(PropertyHandle_Layout);
+
+		BoardCategory.AddCustomRow(LOCTEXT("BoardLayoutRow", "Layout"))
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.f)
+			[
+				SNew(SButton)
+				.HAlign(HAlign_Center)
+				.IsEnabled_Static(&CanSaveBoardLayout)
+				.OnClicked(this, &FBoardEditorDetailCustomization_Board::OnSaveLayoutClicked)
+				[
+					SNew(STextBlock)
+					.Font(DetailBuilder.GetDetailFont())
+					.Text(LOCTEXT("SaveLayout", "Save Layout"))
+					.Justification(ETextJustify::Center)
+				]
+			]
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.f)
+			[
+				SNew(SButton)
+				.HAlign(HAlign_Center)
+				.IsEnabled_Static(&CanLoadBoardLayout)
+				.OnClicked(this, &FBoardEditorDetailCustomization_Board::OnLoadLayoutClicked)
+				[
+					SNew(STextBlock)
+					.Font(DetailBuilder.GetDetailFont())
+					.Text(LOCTEXT("LoadLayout", "Load Layout"))
+					.Justification(ETextJustify::Center)
+				]
+			]
+		];
+	}
+
 	BoardCategory.InitiallyCollapsed(false);
 }
 END_SLATE_FUNCTION_BUILD_OPTIMIZATION
@@ -221,6 +261,51 @@ FReply FBoardEditorDetailCustomization_Board::OnGenerateGridClicked()
 	return FReply::Handled();
 }
 
+bool FBoardEditorDetailCustomization_Board::CanSaveBoardLayout()
+{
+	FEdModeBoard* BoardEdMode = GetEditorMode();
+	if (BoardEdMode)
+	{
+		return BoardEdMode->GetCachedBoardManager() != nullptr && BoardEdMode->GetBoardSettings()->BoardLayout != nullptr;
+	}
+
+	return false;
+}
+
+bool FBoardEditorDetailCustomization_Board::CanLoadBoardLayout()
+{
+	FEdModeBoard* BoardEdMode = GetEditorMode();
+	if (BoardEdMode)
+	{
+		const UBoardLayoutAsset* Layout = BoardEdMode->GetBoardSettings()->BoardLayout;
+		return Layout != nullptr && Layout->IsValidLayout();
+	}
+
+	return false;
+}
+
+FReply FBoardEditorDetailCustomization_Board::OnSaveLayoutClicked()
+{
+	FEdModeBoard* BoardEdMode = GetEditorMode();
+	if (BoardEdMode)
+	{
+		BoardEdMode->SaveBoardLayout();
+	}
+
+	return FReply::Handled();
+}
+
+FReply FBoardEditorDetailCustomization_Board::OnLoadLayoutClicked()
+{
+	FEdModeBoard* BoardEdMode = GetEditorMode();
+	if (BoardEdMode)
+	{
+		BoardEdMode->LoadBoardLayout();
+	}
+
+	return FReply::Handled();
+}
+
 #undef LOCTEXT_NAMESPACE
 
 #define LOCTEXT_NAMESPACE "BoardEditor.BoardTileProperties"
@@ -417,7 +502,7 @@ FText FBoardEditorStructCustomization_BoardTileProperties::GetTileHexValueText()
 	FEdModeBoard* BoardEdMode = GetEditorMode();
 	if (BoardEdMode)
 	{
-		TArray<ATile*> SelectedTiles = BoardEdMode->GetAllSelectedTiles();
+		const TArray<ATile*>& SelectedTiles = BoardEdMode->GetAllSelectedTiles();
 		if (SelectedTiles.Num() == 1)
 		{
 			ATile* Tile = SelectedTiles[0];
@@ -447,7 +532,7 @@ ECheckBoxState FBoardEditorStructCustomization_BoardTileProperties::GetTilesIsEl
 		
 		// Cycling throug all selected tiles, we compare if the tile has the element set
 		// to bIsEnabled only if we are checking the 2nd or greater selected tile
-		TArray<ATile*> Tiles = BoardEdMode->GetAllSelectedTiles();
+		const TArray<ATile*>& Tiles = BoardEdMode->GetAllSelectedTiles();
 		for (int32 Index = 0; Index < Tiles.Num(); ++Index)
 		{
 			ATile* Tile = Tiles[Index];
@@ -479,18 +564,11 @@ void FBoardEditorStructCustomization_BoardTileProperties::SetTilesElement(ECheck
 	FEdModeBoard* BoardEdMode = GetEditorMode();
 	if (BoardEdMode)
 	{
-		TArray<ATile*> Tiles = BoardEdMode->GetAllSelectedTiles();
-		for (ATile* Tile : Tiles)
-		{
-			if (NewCheckedState == ECheckBoxState::Checked)
-			{
-				Tile->TileType = ElementType;
-			}
-			else
-			{
-				Tile->TileType = ECSKElementType::None;
-			}
-		}
+		const ECSKElementType NewElement = NewCheckedState == ECheckBoxState::Checked ? ElementType : ECSKElementType::None;
+
+		FBoardTileMask SelectedMask;
+		BoardEdMode->GetSelectedTileMask(SelectedMask);
+		BoardEdMode->ApplyTileEdit(SelectedMask, FBoardTileEdit::MakeElement(NewElement), LOCTEXT("SetTilesElement", "Set Tiles Element"));
 	}
 }
 
@@ -503,7 +581,7 @@ ECheckBoxState FBoardEditorStructCustomization_BoardTileProperties::GetTilesIsNu
 
 		// Cycling throug all selected tiles, we compare if the tile is null
 		// to bIsEnabled only if we are checking the 2nd or greater selected tile
-		TArray<ATile*> Tiles = BoardEdMode->GetAllSelectedTiles();
+		const TArray<ATile*>& Tiles = BoardEdMode->GetAllSelectedTiles();
 		for (int32 Index = 0; Index < Tiles.Num(); ++Index)
 		{
 			ATile* Tile = Tiles[Index];
@@ -531,32 +609,13 @@ void FBoardEditorStructCustomization_BoardTileProperties::SetTilesIsNull(ECheckB
 		return;
 	}
 
-	// Pre-calculate as we use this value for multiple checks
-	bool bIsNull = (NewCheckedState == ECheckBoxState::Checked);
-
 	FEdModeBoard* BoardEdMode = GetEditorMode();
 	if (BoardEdMode)
 	{
-		ABoardManager* BoardManager = BoardEdMode->GetCachedBoardManager();
-
-		TArray<ATile*> Tiles = BoardEdMode->GetAllSelectedTiles();
-		for (ATile* Tile : Tiles)
-		{
-			Tile->bIsNullTile = bIsNull;
-
-			// Spawn tiles should not be null
-			if (bIsNull)
-			{
-				if (BoardManager->GetPlayer1PortalTile() == Tile)
-				{
-					BoardManager->ResetPlayerPortal(0);
-				}
-				else if (BoardManager->GetPlayer2PortalTile() == Tile)
-				{
-					BoardManager->ResetPlayerPortal(1);
-				}
-			}
-		}
+		// Portals of tiles being nulled are reset by the board
+		FBoardTileMask SelectedMask;
+		BoardEdMode->GetSelectedTileMask(SelectedMask);
+		BoardEdMode->ApplyTileEdit(SelectedMask, FBoardTileEdit::MakeNull(NewCheckedState == ECheckBoxState::Checked), LOCTEXT("SetTilesIsNull", "Set Tiles Null"));
 	}
 }
 
@@ -576,7 +635,7 @@ bool FBoardEditorStructCustomization_BoardTileProperties::GetTileCanSetPortal(in
 	FEdModeBoard* BoardEdMode = GetEditorMode();
 	if (BoardEdMode)
 	{
-		TArray<ATile*> Tiles = BoardEdMode->GetAllSelectedTiles();
+		const TArray<ATile*>& Tiles = BoardEdMode->GetAllSelectedTiles();
 		if (Tiles.Num() == 1)
 		{
 			// Compare hex value of currently selected tile to that of currently player spawn tile
@@ -593,7 +652,7 @@ FReply FBoardEditorStructCustomization_BoardTileProperties::SetBoardPortalTile(i
 	FEdModeBoard* BoardEdMode = GetEditorMode();
 	if (BoardEdMode)
 	{
-		TArray<ATile*> Tiles = BoardEdMode->GetAllSelectedTiles();
+		const TArray<ATile*>& Tiles = BoardEdMode->GetAllSelectedTiles();
 		if (Tiles.Num() == 1)
 		{
 			ABoardManager* BoardManager = BoardEdMode->GetCachedBoardManager();
@@ -106,10 +106,22 @@ protected:
 	/** Get if tile template warning message should be displayed */
 	static EVisibility GetVisibilityTileTemplateWarning();
 
+	/** Get if the board can be saved to the layout */
+	static bool CanSaveBoardLayout();
+
+	/** Get if the board can be loaded from the layout */
+	static bool CanLoadBoardLayout();
+
 protected:
 
 	/** Notify that generate grid button has been pressed */
 	FReply OnGenerateGridClicked();
+
+	/** Notify that save layout button has been pressed */
+	FReply OnSaveLayoutClicked();
+
+	/** Notify that load layout button has been pressed */
+	FReply OnLoadLayoutClicked();
 };
 
 /** 
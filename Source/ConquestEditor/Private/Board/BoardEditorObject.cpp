@@ -2,6 +2,7 @@
 
 #include "BoardEditorObject.h"
 #include "BoardEdMode.h"
+#include "Board/BoardLayoutAsset.h"
 #include "Board/BoardManager.h"
 #include "Board/Tile.h"
 
@@ -14,6 +15,13 @@ UBoardEditorObject::UBoardEditorObject()
 	BoardHexSize = 200.f;
 	BoardOrigin = FVector::ZeroVector;
 	BoardTileTemplate = ATile::StaticClass();
+	BoardLayout = nullptr;
+
+	PaintTool = EBoardPaintTool::None;
+	PaintTarget = EBoardPaintTarget::Element;
+	PaintElement = ECSKElementType::Fire;
+	BrushRadius = 1;
+	PaintSymmetry = EBoardPaintSymmetry::None;
 
 	LastBoardsTileType = nullptr;
 	bWarnOfTileDifference = false;
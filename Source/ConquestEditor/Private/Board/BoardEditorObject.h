@@ -4,12 +4,58 @@
 
 #include "ConquestEditor.h"
 #include "SubclassOf.h"
+#include "Board/BoardTypes.h"
 #include "BoardEditorObject.generated.h"
 
 class ABoardManager;
 class ATile;
+class UBoardLayoutAsset;
 class FEdModeBoard;
 
+/** Tool used when painting tiles in the viewport */
+UENUM()
+enum class EBoardPaintTool : uint8
+{
+	/** Clicking selects tiles */
+	None,
+
+	/** Paints every tile within brush radius of the cursor while dragging */
+	Brush,
+
+	/** Paints every connected tile sharing the clicked tiles state */
+	Fill
+};
+
+/** What painting a tile changes */
+UENUM()
+enum class EBoardPaintTarget : uint8
+{
+	/** Sets the tiles element */
+	Element,
+
+	/** Sets the tile to be a null tile */
+	NullTile,
+
+	/** Sets the tile to not be a null tile */
+	SolidTile
+};
+
+/** Symmetry applied to painted tiles. Symmetries not supported by the boards dimensions are ignored (see EHexGridSymmetry) */
+UENUM()
+enum class EBoardPaintSymmetry : uint8
+{
+	None,
+
+	/** Mirror across the center column. Requires an odd amount of columns */
+	MirrorColumns,
+
+	/** Mirror across the center row. No board supports this, as every second column is offset by half a row */
+	MirrorRows UMETA(Hidden),
+
+	/** Rotate around the center, matching the portals of a two player board. Requires an even amount of columns */
+	Rotate
+};
+
 /** Properties for a tile */
 USTRUCT()
 struct FBoardTileProperties
@@ -87,10 +133,34 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Board", NoClear, meta = (DisplayName = "Tile Template"))
 	TSubclassOf<ATile> BoardTileTemplate;
 
+	/** Layout asset to save the board to or load the board from */
+	UPROPERTY(EditAnywhere, Category = "Board", meta = (DisplayName = "Layout"))
+	UBoardLayoutAsset* BoardLayout;
+
 	/** Properties for the currently selected tile */
 	UPROPERTY(EditAnywhere, Category = "Tile", meta = (ShowOnlyInnerProperties="true", BoardEdState = "Tile"))
 	FBoardTileProperties TileProperties;
 
+	/** Tool to use when clicking tiles in the viewport */
+	UPROPERTY(EditAnywhere, Category = "Paint", meta = (BoardEdState = "Edit,Tile"))
+	EBoardPaintTool PaintTool;
+
+	/** What painting changes about each tile */
+	UPROPERTY(EditAnywhere, Category = "Paint", meta = (BoardEdState = "Edit,Tile"))
+	EBoardPaintTarget PaintTarget;
+
+	/** Element to paint when painting elements */
+	UPROPERTY(EditAnywhere, Category = "Paint", meta = (BoardEdState = "Edit,Tile"))
+	ECSKElementType PaintElement;
+
+	/** Radius of the brush (in tiles) */
+	UPROPERTY(EditAnywhere, Category = "Paint", meta = (ClampMin = 0, UIMin = 0, UIMax = 10, BoardEdState = "Edit,Tile"))
+	int32 BrushRadius;
+
+	/** Symmetry to paint with */
+	UPROPERTY(EditAnywhere, Category = "Paint", meta = (BoardEdState = "Edit,Tile"))
+	EBoardPaintSymmetry PaintSymmetry;
+
 public:
 
 	/** Notify from editor mode that editing has started */
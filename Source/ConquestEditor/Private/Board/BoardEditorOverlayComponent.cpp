@@ -0,0 +1,237 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardEditorOverlayComponent.h"
+#include "Containers/HexGrid.h"
+
+#include "DynamicMeshBuilder.h"
+#include "LocalVertexFactory.h"
+#include "PrimitiveSceneProxy.h"
+#include "SceneManagement.h"
+#include "StaticMeshResources.h"
+#include "Engine/Engine.h"
+#include "Materials/Material.h"
+
+const float UBoardEditorOverlayComponent::PerimeterSize = 5.f;
+
+/** 
+ * Scene proxy for the board overlay. Geometry is built once when the proxy is 
+ * created and submitted as a single mesh batch for each view that draws it
+ */
+class FBoardEditorOverlaySceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+
+	FBoardEditorOverlaySceneProxy(const UBoardEditorOverlayComponent* InComponent)
+		: FPrimitiveSceneProxy(InComponent)
+		, VertexFactory(GetScene().GetFeatureLevel(), "FBoardEditorOverlaySceneProxy")
+		, Material(GEngine->VertexColorMaterial)
+		, MaterialRelevance(Material->GetRelevance(GetScene().GetFeatureLevel()))
+	{
+		const TArray<FBoardOverlayHexagon>& Hexagons = InComponent->GetHexagons();
+
+		// Outline is 12 vertices, center is an additional 7
+		TArray<FDynamicMeshVertex> Vertices;
+		Vertices.Reserve(Hexagons.Num() * 19);
+		IndexBuffer.Indices.Reserve(Hexagons.Num() * 54);
+
+		for (const FBoardOverlayHexagon& Hexagon : Hexagons)
+		{
+			AddHexagon(Hexagon, Vertices);
+		}
+
+		VertexBuffers.InitFromDynamicVertex(&VertexFactory, Vertices);
+
+		BeginInitResource(&VertexBuffers.PositionVertexBuffer);
+		BeginInitResource(&VertexBuffers.StaticMeshVertexBuffer);
+		BeginInitResource(&VertexBuffers.ColorVertexBuffer);
+		BeginInitResource(&IndexBuffer);
+		BeginInitResource(&VertexFactory);
+	}
+
+	virtual ~FBoardEditorOverlaySceneProxy()
+	{
+		VertexBuffers.PositionVertexBuffer.ReleaseResource();
+		VertexBuffers.StaticMeshVertexBuffer.ReleaseResource();
+		VertexBuffers.ColorVertexBuffer.ReleaseResource();
+		IndexBuffer.ReleaseResource();
+		VertexFactory.ReleaseResource();
+	}
+
+public:
+
+	// Begin FPrimitiveSceneProxy Interface
+	virtual SIZE_T GetTypeHash() const override
+	{
+		static size_t UniquePointer;
+		return reinterpret_cast<size_t>(&UniquePointer);
+	}
+
+	virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, 
+		uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+	{
+		if (IndexBuffer.Indices.Num() == 0)
+		{
+			return;
+		}
+
+		FMaterialRenderProxy* MaterialProxy = Material->GetRenderProxy(false);
+
+		for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ++ViewIndex)
+		{
+			// We only draw in perspective viewports
+			const FSceneView* View = Views[ViewIndex];
+			if (!(VisibilityMap & (1 << ViewIndex)) || !View->IsPerspectiveProjection())
+			{
+				continue;
+			}
+
+			FMeshBatch& Mesh = Collector.AllocateMesh();
+			Mesh.VertexFactory = &VertexFactory;
+			Mesh.MaterialRenderProxy = MaterialProxy;
+			Mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+			Mesh.Type = PT_TriangleList;
+			Mesh.DepthPriorityGroup = SDPG_World;
+			Mesh.bCanApplyViewModeOverrides = false;
+			Mesh.bDisableBackfaceCulling = true;
+
+			FMeshBatchElement& BatchElement = Mesh.Elements[0];
+			BatchElement.IndexBuffer = &IndexBuffer;
+			BatchElement.PrimitiveUniformBufferResource = &GetUniformBuffer();
+			BatchElement.FirstIndex = 0;
+			BatchElement.NumPrimitives = IndexBuffer.Indices.Num() / 3;
+			BatchElement.MinVertexIndex = 0;
+			BatchElement.MaxVertexIndex = VertexBuffers.PositionVertexBuffer.GetNumVertices() - 1;
+
+			Collector.AddMesh(ViewIndex, Mesh);
+		}
+	}
+
+	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+	{
+		FPrimitiveViewRelevance Result;
+		Result.bDrawRelevance = IsShown(View);
+		Result.bDynamicRelevance = true;
+		Result.bShadowRelevance = false;
+		Result.bEditorPrimitiveRelevance = UseEditorCompositing(View);
+		MaterialRelevance.SetPrimitiveViewRelevance(Result);
+
+		return Result;
+	}
+
+	virtual uint32 GetMemoryFootprint() const override
+	{
+		return sizeof(*this) + GetAllocatedSize() + IndexBuffer.Indices.GetAllocatedSize();
+	}
+	// End FPrimitiveSceneProxy Interface
+
+private:
+
+	/** Adds the geometry for given hexagon */
+	void AddHexagon(const FBoardOverlayHexagon& Hexagon, TArray<FDynamicMeshVertex>& Vertices)
+	{
+		const FVector Position = Hexagon.Position + FVector(0.f, 0.f, Hexagon.Depth);
+		const float HalfPerimeterSize = UBoardEditorOverlayComponent::PerimeterSize * 0.5f;
+
+		// Outline is a ring of quads between an inner and outer hexagon
+		{
+			const FColor PerimeterColor = Hexagon.PerimeterColor.ToFColor(true);
+			const uint32 FirstVertex = Vertices.Num();
+
+			for (int32 i = 0; i < 6; ++i)
+			{
+				Vertices.Add(MakeVertex(FHexGrid::ConvertHexVertexIndexToWorld(Position, Hexagon.Size + HalfPerimeterSize, i), PerimeterColor));
+				Vertices.Add(MakeVertex(FHexGrid::ConvertHexVertexIndexToWorld(Position, Hexagon.Size - HalfPerimeterSize, i), PerimeterColor));
+			}
+
+			for (uint32 i = 0; i < 6; ++i)
+			{
+				const uint32 Outer = FirstVertex + i * 2;
+				const uint32 Inner = Outer + 1;
+				const uint32 NextOuter = FirstVertex + ((i + 1) % 6) * 2;
+				const uint32 NextInner = NextOuter + 1;
+
+				IndexBuffer.Indices.Append({ Outer, NextOuter, Inner });
+				IndexBuffer.Indices.Append({ Inner, NextOuter, NextInner });
+			}
+		}
+
+		// Point to show the hexagons middle location
+		if (Hexagon.CenterColor.A > 0.f)
+		{
+			const FColor CenterColor = Hexagon.CenterColor.ToFColor(true);
+			const float CenterSize = Hexagon.Size * 0.125f;
+			const uint32 FirstVertex = Vertices.Num();
+
+			Vertices.Add(MakeVertex(Position, CenterColor));
+			for (int32 i = 0; i < 6; ++i)
+			{
+				Vertices.Add(MakeVertex(FHexGrid::ConvertHexVertexIndexToWorld(Position, CenterSize, i), CenterColor));
+			}
+
+			for (uint32 i = 0; i < 6; ++i)
+			{
+				IndexBuffer.Indices.Append({ FirstVertex, FirstVertex + 1 + i, FirstVertex + 1 + ((i + 1) % 6) });
+			}
+		}
+	}
+
+	/** Makes a vertex facing upwards */
+	FORCEINLINE static FDynamicMeshVertex MakeVertex(const FVector& Position, const FColor& Color)
+	{
+		return FDynamicMeshVertex(Position, FVector::ForwardVector, FVector::UpVector, FVector2D::ZeroVector, Color);
+	}
+
+private:
+
+	/** Overlay geometry */
+	FStaticMeshVertexBuffers VertexBuffers;
+	FDynamicMeshIndexBuffer32 IndexBuffer;
+	FLocalVertexFactory VertexFactory;
+
+	/** Material to draw with, this draws vertex colors */
+	UMaterialInterface* Material;
+
+	/** Cached relevance of material */
+	FMaterialRelevance MaterialRelevance;
+};
+
+UBoardEditorOverlayComponent::UBoardEditorOverlayComponent()
+{
+	CastShadow = false;
+	bSelectable = false;
+	bUseEditorCompositing = true;
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetGenerateOverlapEvents(false);
+}
+
+FPrimitiveSceneProxy* UBoardEditorOverlayComponent::CreateSceneProxy()
+{
+	if (Hexagons.Num() > 0)
+	{
+		return new FBoardEditorOverlaySceneProxy(this);
+	}
+
+	return nullptr;
+}
+
+FBoxSphereBounds UBoardEditorOverlayComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	// Hexagons are already in world space
+	FBox Bounds(ForceInit);
+	for (const FBoardOverlayHexagon& Hexagon : Hexagons)
+	{
+		const float Extent = Hexagon.Size + PerimeterSize;
+		Bounds += FBox(Hexagon.Position - FVector(Extent, Extent, 0.f), Hexagon.Position + FVector(Extent, Extent, Hexagon.Depth));
+	}
+
+	return Bounds.IsValid ? FBoxSphereBounds(Bounds) : FBoxSphereBounds(FVector::ZeroVector, FVector::ZeroVector, 0.f);
+}
+
+void UBoardEditorOverlayComponent::SetHexagons(TArray<FBoardOverlayHexagon>&& InHexagons)
+{
+	Hexagons = MoveTemp(InHexagons);
+
+	// Proxy will be re-created with new geometry
+	UpdateBounds();
+	MarkRenderStateDirty();
+}
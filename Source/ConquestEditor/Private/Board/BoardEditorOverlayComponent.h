@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "ConquestEditor.h"
+#include "Components/PrimitiveComponent.h"
+#include "BoardEditorOverlayComponent.generated.h"
+
+/** A hexagon to draw with the board overlay */
+struct FBoardOverlayHexagon
+{
+public:
+
+	FBoardOverlayHexagon(const FVector& InPosition, float InSize, const FLinearColor& InPerimeterColor, 
+		const FLinearColor& InCenterColor = FLinearColor::Transparent, float InDepth = 0.f)
+		: Position(InPosition)
+		, Size(InSize)
+		, PerimeterColor(InPerimeterColor)
+		, CenterColor(InCenterColor)
+		, Depth(InDepth)
+	{
+
+	}
+
+public:
+
+	/** Center of the hexagon */
+	FVector Position;
+
+	/** Size of the hexagon */
+	float Size;
+
+	/** Color of the hexagons outline */
+	FLinearColor PerimeterColor;
+
+	/** Color of the point drawn at the center. Transparent to skip */
+	FLinearColor CenterColor;
+
+	/** Height to raise this hexagon by, used to draw some hexagons over others */
+	float Depth;
+};
+
+/**
+ * Draws the board editors overlay. Every hexagon is batched into a single mesh that is only
+ * rebuilt when the hexagons change, rather than drawing each line of each hexagon every frame
+ */
+UCLASS(Transient, MinimalAPI)
+class UBoardEditorOverlayComponent : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UBoardEditorOverlayComponent();
+
+public:
+
+	// Begin UPrimitiveComponent Interface
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	// End UPrimitiveComponent Interface
+
+public:
+
+	/** Sets the hexagons to draw. This will rebuild the overlay */
+	void SetHexagons(TArray<FBoardOverlayHexagon>&& InHexagons);
+
+	/** Get the hexagons being drawn */
+	FORCEINLINE const TArray<FBoardOverlayHexagon>& GetHexagons() const { return Hexagons; }
+
+public:
+
+	/** The width of each hexagons outline */
+	static const float PerimeterSize;
+
+private:
+
+	/** Hexagons to draw, these are in world space */
+	TArray<FBoardOverlayHexagon> Hexagons;
+};